@@ -0,0 +1,125 @@
+#include "VariableDatabase.h"
+#include "logger.h"
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Объем уведомлений и истории на синтетических технологических сигналах: медленный процесс
+// с шумом датчика и редкими скачками уставки, опрос раз в секунду в течение часа.
+// Без фильтрации (как было) против зоны нечувствительности уведомлений и swinging door
+// в истории с допусками порядка шума датчика
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const int TAG_COUNT = 500;
+const int SAMPLES = 3600;          // Час при опросе раз в секунду
+const double SPAN = 100.0;         // Шкала сигналов 0..100
+const double NOISE = 0.05;         // СКО шума датчика
+const double DEADBAND_PERCENT = 0.5;
+const double SWINGING_DOOR = 0.25;
+
+double elapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Значения всех переменных по отсчетам: [отсчет * TAG_COUNT + переменная]
+std::vector<double> makeSignals() {
+    std::mt19937 random(17);
+    std::normal_distribution<double> noise(0.0, NOISE);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    std::vector<double> values(std::size_t(SAMPLES) * TAG_COUNT);
+    for (int tag = 0; tag < TAG_COUNT; ++tag) {
+        double setpoint = 20.0 + 60.0 * uniform(random);
+        double level = setpoint;
+        double period = 600.0 + 1200.0 * uniform(random);
+        for (int i = 0; i < SAMPLES; ++i) {
+            if (uniform(random) < 1.0 / 900) {
+                setpoint = 20.0 + 60.0 * uniform(random);  // Скачок уставки раз в ~15 минут
+            }
+            level += (setpoint - level) * 0.02;             // Инерция процесса ~50 с
+            values[std::size_t(i) * TAG_COUNT + tag] = level + 1.5 * std::sin(i * 6.2832 / period) + noise(random);
+        }
+    }
+    return values;
+}
+
+struct Result {
+    std::uint64_t notifications = 0;
+    std::uint64_t stored = 0;
+    std::size_t memory = 0;
+    double ms = 0;
+};
+
+Result run(const std::vector<double>& values, bool filtered) {
+    HistoryPolicy policy;
+    policy.capacity = SAMPLES;
+    policy.compressed = true;
+    NotifyDeadband deadband;
+    if (filtered) {
+        policy.swingingDoor = SWINGING_DOOR;
+        deadband.percent = DEADBAND_PERCENT;
+        deadband.span = SPAN;
+    }
+
+    // Уведомления - через set(); история пишется во вторую базу с отметками опроса, иначе
+    // за время прогона часы сдвинутся на миллисекунды вместо часа и наклоны дверей будут другими
+    VariableDatabase db;
+    VariableDatabase history;
+    std::vector<TagId> tags;
+    std::vector<TagId> historyTags;
+    Result result;
+    for (int i = 0; i < TAG_COUNT; ++i) {
+        std::string name = "deadband_tag_" + std::to_string(i);
+        tags.push_back(db.resolveTag(name));
+        db.setNotifyDeadband(tags.back(), deadband);
+        db.subscribe(tags.back(), [&result](double) { ++result.notifications; });
+        historyTags.push_back(history.resolveTag(name));
+        history.setHistoryPolicy(historyTags.back(), policy);
+    }
+
+    HistoryClock::time_point start = HistoryClock::now();
+    Clock::time_point begin = Clock::now();
+    for (int i = 0; i < SAMPLES; ++i) {
+        const double* row = values.data() + std::size_t(i) * TAG_COUNT;
+        HistoryClock::time_point time = start + std::chrono::seconds(i);
+        for (int tag = 0; tag < TAG_COUNT; ++tag) {
+            db.set(tags[tag], row[tag]);
+            history.addToHistory(historyTags[tag], row[tag], time);
+        }
+    }
+    result.ms = elapsedMs(begin);
+    for (TagId tag : historyTags) {
+        result.stored += history.getHistoryTotal(tag);
+    }
+    result.memory = history.getHistoryMemoryUsage();
+    return result;
+}
+
+} // namespace
+
+int main() {
+    Logger::setLevel(LogLevel::Error);
+    std::vector<double> values = makeSignals();
+
+    std::cout << TAG_COUNT << " tags, " << SAMPLES << " samples per tag, deadband " << DEADBAND_PERCENT
+              << "% of span, swinging door " << SWINGING_DOOR << "\n";
+
+    std::cout << std::fixed << std::setprecision(1);
+    Result plain = run(values, false);
+    Result filtered = run(values, true);
+    for (const Result* r : {&plain, &filtered}) {
+        std::cout << std::left << std::setw(12) << (r == &plain ? "unfiltered" : "filtered") << std::right
+                  << std::setw(10) << r->notifications << " notifications" << std::setw(10) << r->stored
+                  << " stored samples" << std::setw(9) << r->memory / 1024.0 << " KB history"
+                  << std::setw(8) << r->ms * 1e6 / (double(SAMPLES) * TAG_COUNT) << " ns per sample\n";
+    }
+    std::cout << "reduction: notifications x" << double(plain.notifications) / filtered.notifications
+              << ", stored samples x" << double(plain.stored) / filtered.stored << ", history memory x"
+              << double(plain.memory) / filtered.memory << "\n";
+    return 0;
+}
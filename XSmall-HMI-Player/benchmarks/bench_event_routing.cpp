@@ -0,0 +1,162 @@
+#include "Button.h"
+#include "EventRouter.h"
+#include "VariableDatabase.h"
+#include "logger.h"
+#include <SFML/Graphics.hpp>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Доставка событий мыши при 100, 1000 и 10 000 кнопках: прежняя рассылка каждого события
+// всем объектам (каждая кнопка сама спрашивает положение курсора и проверяет свой прямоугольник)
+// против EventRouter (сетка границ, объединение MouseMoved, нажатие - только кнопке под курсором).
+// Поток событий: 20 MouseMoved на каждый клик (нажатие + отпускание), опрос раз в 10 событий.
+// Запускать из каталога сборки (рядом с assets/)
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const int EVENT_COUNT = 20000;
+const int EVENTS_PER_POLL = 10;
+
+// Прежняя обработка событий кнопкой (до EventRouter), без изменения логики
+class LegacyButton : public VisualObject {
+public:
+    sf::RectangleShape shape;
+    bool isHovered = false;
+    bool isPressed = false;
+    int clicks = 0;
+
+    LegacyButton(float x, float y, float width, float height, VariableDatabase* db)
+        : VisualObject(x, y, "Button", db) {
+        shape.setPosition(x, y);
+        shape.setSize(sf::Vector2f(width, height));
+    }
+
+    void draw(sf::RenderTarget& target) override {}
+    void update() override {}
+
+    bool contains(float pointX, float pointY) const override {
+        return pointX >= x && pointX <= x + shape.getSize().x &&
+               pointY >= y && pointY <= y + shape.getSize().y;
+    }
+
+    void handleEvent(const sf::Event& event, sf::RenderWindow& window) override {
+        sf::Vector2i mousePos = sf::Mouse::getPosition(window);
+        bool mouseOver = contains(static_cast<float>(mousePos.x), static_cast<float>(mousePos.y));
+        if (event.type == sf::Event::MouseMoved) {
+            isHovered = mouseOver;
+        }
+        if (event.type == sf::Event::MouseButtonPressed && mouseOver) {
+            isPressed = true;
+        }
+        if (event.type == sf::Event::MouseButtonReleased) {
+            if (isPressed && mouseOver) {
+                ++clicks;
+            }
+            isPressed = false;
+        }
+    }
+};
+
+std::vector<sf::Event> makeEvents() {
+    std::vector<sf::Event> events;
+    for (int i = 0; i < EVENT_COUNT; ++i) {
+        sf::Event event;
+        int x = (i * 13) % 1024;
+        int y = (i * 7) % 768;
+        int phase = i % 22;
+        if (phase < 20) {
+            event.type = sf::Event::MouseMoved;
+            event.mouseMove.x = x;
+            event.mouseMove.y = y;
+        } else {
+            event.type = phase == 20 ? sf::Event::MouseButtonPressed : sf::Event::MouseButtonReleased;
+            event.mouseButton.button = sf::Mouse::Left;
+            event.mouseButton.x = x;
+            event.mouseButton.y = y;
+        }
+        events.push_back(event);
+    }
+    return events;
+}
+
+// Кнопки сеткой на экране 1024x768
+template <typename Make>
+std::vector<std::unique_ptr<VisualObject>> makeButtons(int count, Make make) {
+    int columns = 1;
+    while (columns * columns * 4 < count * 3) {
+        ++columns;
+    }
+    int rows = (count + columns - 1) / columns;
+    float cellWidth = 1024.0f / columns;
+    float cellHeight = 768.0f / rows;
+
+    std::vector<std::unique_ptr<VisualObject>> buttons;
+    for (int i = 0; i < count; ++i) {
+        buttons.push_back(make((i % columns) * cellWidth, (i / columns) * cellHeight,
+                               cellWidth * 0.8f, cellHeight * 0.8f));
+    }
+    return buttons;
+}
+
+double eventsPerSecond(Clock::time_point start, std::size_t events) {
+    return events / std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+} // namespace
+
+int main() {
+    Logger::setLevel(LogLevel::Error);
+
+    sf::Font font;
+    if (!font.loadFromFile("assets/fonts/helveticabold.ttf")) {
+        std::cerr << "Cannot load assets/fonts/helveticabold.ttf" << std::endl;
+        return 1;
+    }
+
+    VariableDatabase db;
+    sf::RenderWindow window;
+    std::vector<sf::Event> events = makeEvents();
+
+    std::cout << std::fixed << std::setprecision(0);
+    for (int count : {100, 1000, 10000}) {
+        std::vector<std::unique_ptr<VisualObject>> legacy = makeButtons(count, [&](float x, float y, float w, float h) {
+            return std::make_unique<LegacyButton>(x, y, w, h, &db);
+        });
+        Clock::time_point start = Clock::now();
+        for (const sf::Event& event : events) {
+            for (auto& object : legacy) {
+                object->handleEvent(event, window);
+            }
+        }
+        double broadcastRate = eventsPerSecond(start, events.size());
+
+        std::vector<std::unique_ptr<VisualObject>> buttons = makeButtons(count, [&](float x, float y, float w, float h) {
+            return std::make_unique<Button>(x, y, w, h, "B", &font, 10, sf::Color::Green, "Button", &db);
+        });
+        EventRouter router;
+        router.build(buttons);
+        start = Clock::now();
+        for (std::size_t i = 0; i < events.size(); ++i) {
+            sf::Vector2i pixel;
+            sf::Vector2f point;
+            if (EventRouter::getPixelPosition(events[i], pixel)) {
+                point = sf::Vector2f(static_cast<float>(pixel.x), static_cast<float>(pixel.y));
+            }
+            router.route(events[i], point, window);
+            if ((i + 1) % EVENTS_PER_POLL == 0) {
+                router.flush();
+            }
+        }
+        double routedRate = eventsPerSecond(start, events.size());
+
+        std::cout << count << " buttons\n";
+        std::cout << "  broadcast to all objects: " << broadcastRate << " events/s\n";
+        std::cout << "  EventRouter:              " << routedRate << " events/s\n";
+    }
+    return 0;
+}
@@ -0,0 +1,151 @@
+#include "FrameScheduler.h"
+#include <SFML/System.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+// Сравнивает старый главный цикл (setFramerateLimit(60) + sleep 16 мс в каждой итерации)
+// с FrameScheduler: равномерность кадров и задержку от клика до кадра с его результатом.
+// Клики приходят в случайные моменты; кадр считается "с результатом", если клик
+// к этому моменту был опрошен и обработан.
+// Старый цикл измеряется дважды: с точным sleep (Linux) и с системным таймером 15.6 мс,
+// как у std::this_thread::sleep_for в Windows по умолчанию
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct LoopModel {
+    std::vector<Clock::time_point> clicks;  // Моменты кликов
+    std::size_t nextClick = 0;
+    std::vector<Clock::time_point> polled;      // Опрошены, ждут такта
+    std::vector<Clock::time_point> processed;   // Обработаны, ждут кадра
+    std::vector<double> latenciesMs;
+    std::vector<Clock::time_point> frames;
+
+    explicit LoopModel(Clock::time_point start, Clock::duration duration) {
+        std::mt19937 rng(42);
+        std::uniform_int_distribution<int> gapMs(100, 300);  // Оператор кликает несколько раз в секунду
+        for (auto t = start + std::chrono::milliseconds(gapMs(rng)); t < start + duration;
+             t += std::chrono::milliseconds(gapMs(rng))) {
+            clicks.push_back(t);
+        }
+    }
+
+    // Возвращает true, если появились новые клики
+    bool poll() {
+        Clock::time_point now = Clock::now();
+        bool clicked = false;
+        while (nextClick < clicks.size() && clicks[nextClick] <= now) {
+            polled.push_back(clicks[nextClick++]);
+            clicked = true;
+        }
+        return clicked;
+    }
+
+    void tick() {
+        processed.insert(processed.end(), polled.begin(), polled.end());
+        polled.clear();
+    }
+
+    void render() {
+        // Условная стоимость отрисовки кадра
+        Clock::time_point busyUntil = Clock::now() + std::chrono::milliseconds(1);
+        while (Clock::now() < busyUntil) {
+        }
+
+        Clock::time_point now = Clock::now();
+        for (auto click : processed) {
+            latenciesMs.push_back(std::chrono::duration<double, std::milli>(now - click).count());
+        }
+        processed.clear();
+        frames.push_back(now);
+    }
+};
+
+void report(const char* title, const LoopModel& model, double seconds) {
+    std::vector<double> intervals;
+    for (std::size_t i = 1; i < model.frames.size(); ++i) {
+        intervals.push_back(std::chrono::duration<double, std::milli>(model.frames[i] - model.frames[i - 1]).count());
+    }
+
+    double mean = 0;
+    for (double v : intervals) mean += v;
+    mean /= std::max<std::size_t>(intervals.size(), 1);
+    double variance = 0;
+    for (double v : intervals) variance += (v - mean) * (v - mean);
+    double jitter = std::sqrt(variance / std::max<std::size_t>(intervals.size(), 1));
+
+    std::vector<double> latencies = model.latenciesMs;
+    std::sort(latencies.begin(), latencies.end());
+    double avgLatency = 0;
+    for (double v : latencies) avgLatency += v;
+    avgLatency /= std::max<std::size_t>(latencies.size(), 1);
+    double p95 = latencies.empty() ? 0 : latencies[latencies.size() * 95 / 100];
+    double maxLatency = latencies.empty() ? 0 : latencies.back();
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << title << "\n";
+    std::cout << "  frames: " << model.frames.size() / seconds << " FPS, interval "
+              << mean << " ms +/- " << jitter << " ms\n";
+    std::cout << "  click-to-frame latency (" << latencies.size() << " clicks): avg "
+              << avgLatency << " ms, p95 " << p95 << " ms, max " << maxLatency << " ms\n";
+}
+
+// Старый цикл: display() с лимитом 60 FPS досыпает до 1/60 с, затем sleep 16 мс.
+// timerTick > 0 моделирует грубый системный таймер: сон заканчивается на ближайшем его такте
+void runLegacyLoop(const char* title, Clock::duration duration, double seconds, Clock::duration timerTick) {
+    Clock::time_point start = Clock::now();
+    LoopModel model(start, duration);
+    sf::Clock frameLimitClock;
+    const sf::Time frameLimit = sf::seconds(1.0f / 60);
+    while (Clock::now() < start + duration) {
+        model.poll();
+        model.tick();
+        model.render();
+        sf::sleep(frameLimit - frameLimitClock.getElapsedTime());
+        frameLimitClock.restart();
+
+        Clock::time_point wake = Clock::now() + std::chrono::milliseconds(16);
+        if (timerTick > Clock::duration::zero()) {
+            auto ticks = (wake - start + timerTick - Clock::duration(1)) / timerTick;
+            wake = start + ticks * timerTick;
+        }
+        std::this_thread::sleep_until(wake);
+    }
+    report(title, model, seconds);
+}
+
+} // namespace
+
+int main() {
+    const auto duration = std::chrono::seconds(5);
+    const double seconds = 5.0;
+
+    runLegacyLoop("Legacy loop, precise sleep", duration, seconds, Clock::duration::zero());
+    runLegacyLoop("Legacy loop, 15.6 ms system timer (Windows default)", duration, seconds,
+                  std::chrono::microseconds(15625));
+
+    // FrameScheduler с настройками по умолчанию (60 Гц кадры и логика, 240 Гц ввод)
+    {
+        Clock::time_point start = Clock::now();
+        LoopModel model(start, duration);
+        FrameScheduler scheduler;
+        // Как в HmiPlayer: клик обрабатывается сразу и запрашивает кадр вне очереди
+        scheduler.setInputHandler([&]() {
+            if (model.poll()) {
+                model.tick();
+                scheduler.requestFrame();
+            }
+        });
+        scheduler.setTickHandler([&]() { model.tick(); });
+        scheduler.setRenderHandler([&]() { model.render(); });
+        scheduler.run([&]() { return Clock::now() < start + duration; });
+        report("FrameScheduler (render 60 Hz, logic 60 Hz, input 240 Hz)", model, seconds);
+    }
+    return 0;
+}
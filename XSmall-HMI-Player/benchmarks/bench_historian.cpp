@@ -0,0 +1,221 @@
+#include "Historian.h"
+#include "logger.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Архив истории на диске: сколько байт на значение занимают типичные сигналы, сколько стоит
+// запись в UI-потоке и сколько - выборка диапазона для дозаполнения тренда.
+// Переменные опрашиваются раз в секунду; объем пересчитывается на 10000 переменных за неделю
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const int TAG_COUNT = 200;
+const int SAMPLES = 6 * 3600;      // 6 часов при опросе раз в секунду
+const int QUERY_TAGS = 50;
+const double WEEK_TAGS = 10000.0;
+const double WEEK_SECONDS = 7 * 24 * 3600.0;
+const std::string DIRECTORY = "bench_historian_archive";
+
+double elapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Медленный процесс с шумом датчика и скачками уставки
+struct Process {
+    std::mt19937 random;
+    std::normal_distribution<double> noise{0.0, 0.05};
+    std::uniform_real_distribution<double> uniform{0.0, 1.0};
+    double setpoint;
+    double level;
+    double period;
+    bool running = false;  // Дискретный сигнал: насос включается и выключается раз в ~10 минут
+
+    explicit Process(unsigned seed) : random(seed) {
+        setpoint = 20.0 + 60.0 * uniform(random);
+        level = setpoint;
+        period = 600.0 + 1200.0 * uniform(random);
+    }
+
+    double toggle() {
+        if (uniform(random) < 1.0 / 600) {
+            running = !running;
+        }
+        return running ? 1.0 : 0.0;
+    }
+
+    double next(int i) {
+        if (uniform(random) < 1.0 / 900) {
+            setpoint = 20.0 + 60.0 * uniform(random);
+        }
+        level += (setpoint - level) * 0.02;
+        return level + 1.5 * std::sin(i * 6.2832 / period) + noise(random);
+    }
+};
+
+struct Signal {
+    const char* name;
+    std::function<double(Process&, int)> value;
+};
+
+struct Result {
+    std::uintmax_t bytes = 0;
+    double appendNs = 0;
+    double flushMs = 0;
+};
+
+std::string tagName(int i) {
+    return "bench_historian_" + std::to_string(i);
+}
+
+// Значения всех переменных по отсчетам: [отсчет * TAG_COUNT + переменная]
+std::vector<double> makeValues(const Signal& signal) {
+    std::vector<Process> processes;
+    for (int i = 0; i < TAG_COUNT; ++i) {
+        processes.emplace_back(101 + i);
+    }
+    std::vector<double> values(std::size_t(SAMPLES) * TAG_COUNT);
+    for (int i = 0; i < SAMPLES; ++i) {
+        for (int tag = 0; tag < TAG_COUNT; ++tag) {
+            values[std::size_t(i) * TAG_COUNT + tag] = signal.value(processes[tag], i);
+        }
+    }
+    return values;
+}
+
+// Пишет SAMPLES отсчетов всех переменных; раз в секунду таймер плеера вызывает poll()
+Result write(const std::vector<double>& values, HistoryClock::time_point start) {
+    std::filesystem::remove_all(DIRECTORY);
+    Result result;
+    Historian historian(DIRECTORY);
+    std::vector<std::string> names;
+    for (int i = 0; i < TAG_COUNT; ++i) {
+        names.push_back(tagName(i));
+    }
+
+    Clock::time_point begin = Clock::now();
+    for (int i = 0; i < SAMPLES; ++i) {
+        const double* row = values.data() + std::size_t(i) * TAG_COUNT;
+        HistoryClock::time_point time = start + std::chrono::seconds(i);
+        for (int tag = 0; tag < TAG_COUNT; ++tag) {
+            historian.append(names[tag], row[tag], time);
+        }
+        historian.poll(time);
+    }
+    result.appendNs = elapsedMs(begin) * 1e6 / (double(SAMPLES) * TAG_COUNT);
+
+    begin = Clock::now();
+    historian.flush();
+    result.flushMs = elapsedMs(begin);
+    result.bytes = historian.getDiskUsage();
+    return result;
+}
+
+// Среднее время выборки [end - range, end) по QUERY_TAGS переменным, мс
+double queryMs(Historian& historian, HistoryClock::time_point end, HistoryClock::duration range,
+               std::size_t maxCount, std::size_t& count) {
+    std::vector<double> values;
+    std::vector<HistoryClock::time_point> times;
+    count = 0;
+    Clock::time_point begin = Clock::now();
+    for (int i = 0; i < QUERY_TAGS; ++i) {
+        count += historian.query(tagName(i), end - range, end, values, times, maxCount);
+    }
+    count /= QUERY_TAGS;
+    return elapsedMs(begin) / QUERY_TAGS;
+}
+
+} // namespace
+
+int main() {
+    Logger::setLevel(LogLevel::Error);
+    HistoryClock::time_point start = HistoryClock::now() - std::chrono::seconds(SAMPLES);
+    HistoryClock::time_point end = start + std::chrono::seconds(SAMPLES);
+
+    auto analog = [](Process& p, int i) { return p.next(i); };
+    std::vector<Signal> signals = {
+        {"analog", analog},
+        {"analog 0.1", [](Process& p, int i) { return std::round(p.next(i) * 10.0) / 10.0; }},
+        {"discrete", [](Process& p, int) { return p.toggle(); }},
+    };
+
+    std::cout << TAG_COUNT << " tags, " << SAMPLES << " samples per tag at 1 Hz, written every minute; "
+              << "size scaled to " << WEEK_TAGS << " tags for a week\n" << std::fixed;
+    for (const Signal& signal : signals) {
+        Result r = write(makeValues(signal), start);
+        double perSample = double(r.bytes) / (double(SAMPLES) * TAG_COUNT);
+        std::cout << std::left << std::setw(12) << signal.name << std::right << std::setprecision(2)
+                  << std::setw(7) << perSample << " B per sample" << std::setprecision(0) << std::setw(8)
+                  << perSample * WEEK_TAGS * WEEK_SECONDS / 1e6 << " MB per week" << std::setprecision(1)
+                  << std::setw(7) << r.appendNs << " ns per append" << std::setw(8) << r.flushMs << " ms flush\n";
+    }
+
+    // Выборки по архиву сырого аналогового сигнала: первая после открытия отображает
+    // и разбирает сегменты, повторная - только разжимает куски
+    write(makeValues(signals[0]), start);
+    struct Range {
+        const char* name;
+        HistoryClock::duration range;
+        std::size_t maxCount;
+    };
+    const Range ranges[] = {
+        {"1 min", std::chrono::minutes(1), 0},
+        {"1 h", std::chrono::hours(1), 0},
+        {"6 h", std::chrono::hours(6), 0},
+        {"6 h, last 1000", std::chrono::hours(6), 1000},
+    };
+    for (bool cold : {true, false}) {
+        Historian historian(DIRECTORY);
+        if (!cold) {
+            std::size_t count;
+            queryMs(historian, end, std::chrono::hours(6), 0, count);
+        }
+        for (const Range& range : ranges) {
+            std::size_t count;
+            double ms = queryMs(historian, end, range.range, range.maxCount, count);
+            std::cout << std::left << std::setw(6) << (cold ? "cold" : "warm") << std::setw(16) << range.name
+                      << std::right << std::setw(8) << count << " samples" << std::setprecision(3)
+                      << std::setw(9) << ms << " ms per query\n";
+        }
+    }
+
+    // Неделя одной переменной
+    std::filesystem::remove_all(DIRECTORY);
+    {
+        Historian historian(DIRECTORY);
+        Process process(7);
+        const int week = int(WEEK_SECONDS);
+        HistoryClock::time_point weekStart = end - std::chrono::seconds(week);
+        for (int i = 0; i < week; ++i) {
+            historian.append(tagName(0), process.next(i), weekStart + std::chrono::seconds(i));
+        }
+    }
+    for (bool cold : {true, false}) {
+        Historian historian(DIRECTORY);
+        if (!cold) {
+            std::vector<double> values;
+            std::vector<HistoryClock::time_point> times;
+            historian.query(tagName(0), end - std::chrono::hours(24 * 7), end, values, times);
+        }
+        for (auto range : {std::chrono::hours(1), std::chrono::hours(24), std::chrono::hours(24 * 7)}) {
+            std::vector<double> values;
+            std::vector<HistoryClock::time_point> times;
+            Clock::time_point begin = Clock::now();
+            historian.query(tagName(0), end - range, end, values, times);
+            std::cout << std::left << std::setw(6) << (cold ? "cold" : "warm") << std::setw(16)
+                      << ("week tag, " + std::to_string(range.count()) + " h") << std::right << std::setw(8)
+                      << values.size() << " samples" << std::setprecision(3) << std::setw(9) << elapsedMs(begin)
+                      << " ms per query\n";
+        }
+    }
+    std::filesystem::remove_all(DIRECTORY);
+    return 0;
+}
@@ -0,0 +1,120 @@
+#include "CompressedHistory.h"
+#include "HistoryBuffer.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Память на значение и скорость записи/чтения истории: кольцевой буфер против сжатой истории
+// на типичных технологических сигналах
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const std::size_t SAMPLES = 1000000;
+
+double elapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Демо-температура: выход на уставку шагом 0.2, затем доводка и удержание
+std::vector<double> demoTemperature() {
+    std::vector<double> values;
+    values.reserve(SAMPLES);
+    double temperature = 20.0;
+    for (std::size_t i = 0; i < SAMPLES; ++i) {
+        double setpoint = 70.0 + 5.0 * ((i / 20000) % 3);
+        double difference = setpoint - temperature;
+        if (std::abs(difference) > 1.0) {
+            temperature += difference > 0 ? 0.2 : -0.2;
+        } else if (std::abs(difference) > 0.2) {
+            temperature += difference * 0.5;
+        } else {
+            temperature += difference * 0.8;
+        }
+        values.push_back(temperature);
+    }
+    return values;
+}
+
+// Датчик с АЦП: медленный дрейф и шум, значения квантованы шагом 0.01
+std::vector<double> quantizedSensor() {
+    std::vector<double> values;
+    values.reserve(SAMPLES);
+    std::mt19937 random(1);
+    std::normal_distribution<double> noise(0.0, 0.02);
+    for (std::size_t i = 0; i < SAMPLES; ++i) {
+        double value = 50.0 + 10.0 * std::sin(i * 1e-4) + noise(random);
+        values.push_back(std::round(value * 100.0) / 100.0);
+    }
+    return values;
+}
+
+// Дискретный сигнал (состояние насоса): редкие переключения
+std::vector<double> discreteState() {
+    std::vector<double> values;
+    values.reserve(SAMPLES);
+    for (std::size_t i = 0; i < SAMPLES; ++i) {
+        values.push_back(static_cast<double>((i / 5000) % 2));
+    }
+    return values;
+}
+
+void measure(const std::string& name, const std::vector<double>& values) {
+    HistoryBuffer ring(SAMPLES);
+    Clock::time_point start = Clock::now();
+    for (double value : values) {
+        ring.push(value);
+    }
+    double ringPushMs = elapsedMs(start);
+
+    CompressedHistory compressed(SAMPLES);
+    start = Clock::now();
+    for (double value : values) {
+        compressed.push(value);
+    }
+    double pushMs = elapsedMs(start);
+
+    // Чтение всей истории блоками (как при построении тренда)
+    double sum = 0;
+    start = Clock::now();
+    for (CompressedHistory::Cursor cursor(compressed, 0); cursor.next();) {
+        for (std::size_t i = 0; i < cursor.size(); ++i) {
+            sum += cursor.data()[i];
+        }
+    }
+    double decodeMs = elapsedMs(start);
+
+    double ringSum = 0;
+    HistoryView view = ring.view();
+    start = Clock::now();
+    for (double value : view) {
+        ringSum += value;
+    }
+    double ringReadMs = elapsedMs(start);
+
+    std::cout << name << (sum == ringSum ? "" : " (MISMATCH)") << "\n";
+    // Значение и отметка времени
+    std::cout << "  ring buffer: " << sizeof(double) + sizeof(HistoryClock::time_point) << ".00 bytes/sample, push "
+              << ringPushMs * 1e6 / SAMPLES << " ns, read "
+              << SAMPLES / ringReadMs / 1e3 << " M samples/s\n";
+    std::cout << "  compressed:  " << static_cast<double>(compressed.memoryUsage()) / SAMPLES
+              << " bytes/sample, push " << pushMs * 1e6 / SAMPLES << " ns, decode "
+              << SAMPLES / decodeMs / 1e3 << " M samples/s\n";
+}
+
+} // namespace
+
+int main() {
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << SAMPLES << " samples per signal\n";
+    measure("Demo temperature (setpoint tracking)", demoTemperature());
+    measure("Quantized analog sensor (0.01 step, noise)", quantizedSensor());
+    measure("Discrete state", discreteState());
+    return 0;
+}
@@ -0,0 +1,113 @@
+#include "JSONLoader.h"
+#include "VariableDatabase.h"
+#include "logger.h"
+#include <nlohmann/json.hpp>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+// Память истории на сцене из 50 000 переменных: история у каждой записываемой переменной
+// (как было) против истории только у потребителей (20 графиков) и переменных с политикой
+// в секции "tags" (100 архивных, сжатых, с зоной нечувствительности)
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using json = nlohmann::json;
+
+const int TAG_COUNT = 50000;
+const int GRAPH_COUNT = 20;
+const int ARCHIVED_COUNT = 100;
+const int ROUNDS = 200;  // Записей каждой переменной: буферы по умолчанию заполняются целиком
+const std::string JSON_FILE = "bench_history_policy.json";
+
+double elapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+std::string tagName(int i) {
+    return "policy_tag_" + std::to_string(i);
+}
+
+void writeScene() {
+    json j;
+    j["historyCapacity"] = 100;
+    j["tags"] = json::object();
+    for (int i = GRAPH_COUNT; i < GRAPH_COUNT + ARCHIVED_COUNT; ++i) {
+        j["tags"][tagName(i)] = {{"history", {{"capacity", 1000}, {"deadband", 0.05}, {"compression", true}}}};
+    }
+
+    j["objects"] = json::array();
+    for (int i = 0; i < TAG_COUNT; ++i) {
+        json obj;
+        obj["name"] = "Object " + std::to_string(i);
+        obj["x"] = (i % 250) * 8;
+        obj["y"] = (i / 250) * 8;
+        obj["variable"] = tagName(i);
+        if (i < GRAPH_COUNT) {
+            obj["type"] = "HistoryGraph";
+            obj["width"] = 200;
+            obj["height"] = 100;
+            obj["maxHistory"] = 600;
+        } else {
+            obj["type"] = "Rectangle";
+            obj["width"] = 6;
+            obj["height"] = 6;
+            obj["conditions"] = json::array({{{"value", 1}, {"color", {200, 0, 0}}}});
+        }
+        j["objects"].push_back(obj);
+    }
+    std::ofstream(JSON_FILE) << j.dump();
+}
+
+// Аналоговые сигналы с шумом, каждая переменная пишется ROUNDS раз
+double writeAll(VariableDatabase& db, const std::vector<TagId>& tags) {
+    Clock::time_point start = Clock::now();
+    for (int round = 0; round < ROUNDS; ++round) {
+        for (std::size_t i = 0; i < tags.size(); ++i) {
+            db.set(tags[i], 50.0 + 10.0 * std::sin(round * 0.05 + i) + 0.01 * ((round * 7 + i) % 5));
+        }
+    }
+    return elapsedMs(start);
+}
+
+} // namespace
+
+int main() {
+    Logger::setLevel(LogLevel::Error);
+    writeScene();
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << TAG_COUNT << " tags, " << GRAPH_COUNT << " graphs, " << ARCHIVED_COUNT
+              << " archived tags, " << ROUNDS << " writes per tag\n";
+
+    for (bool recordAll : {true, false}) {
+        VariableDatabase db;
+        auto objects = JSONLoader::loadFromFile(JSON_FILE, &db, nullptr);
+
+        std::vector<TagId> tags;
+        tags.reserve(TAG_COUNT);
+        for (int i = 0; i < TAG_COUNT; ++i) {
+            tags.push_back(db.resolveTag(tagName(i)));
+            if (recordAll) {
+                db.enableHistory(tags.back());  // Прежнее поведение: история у каждой переменной
+            }
+        }
+
+        std::size_t enabled = 0;
+        for (TagId tag : tags) {
+            enabled += db.isHistoryEnabled(tag) ? 1 : 0;
+        }
+        double ms = writeAll(db, tags);
+        double memoryMb = db.getHistoryMemoryUsage() / (1024.0 * 1024.0);
+        std::cout << std::left << std::setw(22) << (recordAll ? "history for all tags" : "opt-in history")
+                  << std::right << std::setw(8) << enabled << " histories" << std::setw(10) << memoryMb
+                  << " MB" << std::setw(10) << ms * 1e6 / (double(ROUNDS) * TAG_COUNT) << " ns per write\n";
+    }
+
+    std::filesystem::remove(JSON_FILE);
+    return 0;
+}
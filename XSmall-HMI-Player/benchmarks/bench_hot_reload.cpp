@@ -0,0 +1,148 @@
+#include "SceneReloader.h"
+#include "JSONLoader.h"
+#include "SceneRenderer.h"
+#include "EventRouter.h"
+#include "VariableDatabase.h"
+#include "logger.h"
+#include <SFML/Graphics.hpp>
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Правка одного виджета в сцене из 10 000: перезапуск (загрузка и раскладка всей сцены)
+// против горячей перезагрузки. Разбор и сравнение идут в фоновом потоке, в UI-потоке -
+// только создание измененного виджета и перестроение пакетов и индекса ввода.
+// Запускать из каталога сборки (рядом с assets/)
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using json = nlohmann::json;
+
+const int OBJECT_COUNT = 10000;
+const int EDITS = 20;
+const std::string JSON_FILE = "bench_reload.json";
+
+double elapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+json makeScene() {
+    json j;
+    j["objects"] = json::array();
+    for (int i = 0; i < OBJECT_COUNT; ++i) {
+        float x = static_cast<float>((i % 100) * 19);
+        float y = static_cast<float>((i / 100) * 10);
+        std::string tag = "reload_tag_" + std::to_string(i % 2000);
+
+        json obj;
+        obj["name"] = "Widget " + std::to_string(i);
+        obj["x"] = x;
+        obj["y"] = y;
+        switch (i % 4) {
+        case 0:
+            obj["type"] = "Rectangle";
+            obj["width"] = 16;
+            obj["height"] = 8;
+            obj["color"] = {40, 40, 40};
+            obj["variable"] = tag;
+            obj["conditions"] = json::array({{{"value", 1}, {"color", {200, 0, 0}}}});
+            break;
+        case 1:
+            obj["type"] = "Text";
+            obj["content"] = "0.0";
+            obj["fontSize"] = 8;
+            obj["variable"] = tag;
+            obj["format"] = "%.1f";
+            break;
+        case 2:
+            obj["type"] = "Line";
+            obj["x2"] = x + 16;
+            obj["y2"] = y + 8;
+            break;
+        default:
+            obj["type"] = "Button";
+            obj["width"] = 16;
+            obj["height"] = 8;
+            obj["text"] = "Go";
+            obj["fontSize"] = 8;
+            break;
+        }
+        j["objects"].push_back(obj);
+    }
+    return j;
+}
+
+} // namespace
+
+int main() {
+    Logger::setLevel(LogLevel::Error);
+
+    sf::Font font;
+    if (!font.loadFromFile("assets/fonts/helveticabold.ttf")) {
+        std::cerr << "Cannot load assets/fonts/helveticabold.ttf" << std::endl;
+        return 1;
+    }
+
+    json scene = makeScene();
+    std::ofstream(JSON_FILE) << scene.dump();
+
+    VariableDatabase db;
+    SceneRenderer renderer;
+    EventRouter router;
+
+    // Перезапуск: загрузка и раскладка всей сцены
+    Clock::time_point restartStart = Clock::now();
+    std::vector<std::unique_ptr<VisualObject>> objects = JSONLoader::loadFromFile(JSON_FILE, &db, &font);
+    renderer.build(objects);
+    router.build(objects);
+    double restartMs = elapsedMs(restartStart);
+
+    SceneSnapshot snapshot;
+    SceneReloader::diff(snapshot, scene);
+
+    double parseMs = 0, diffMs = 0, applyMs = 0, worstApplyMs = 0;
+    for (int edit = 0; edit < EDITS; ++edit) {
+        // Меняем цвет одного прямоугольника и сохраняем файл
+        json& widget = scene["objects"][(edit * 997) % OBJECT_COUNT / 4 * 4];
+        widget["color"] = {edit * 10 % 256, 0, 0};
+        std::string text = scene.dump();
+
+        // Фоновый поток: разбор файла и сравнение с предыдущей версией
+        Clock::time_point parseStart = Clock::now();
+        json parsed = json::parse(text);
+        parseMs += elapsedMs(parseStart);
+
+        Clock::time_point diffStart = Clock::now();
+        ScenePatch patch = SceneReloader::diff(snapshot, parsed);
+        diffMs += elapsedMs(diffStart);
+
+        // UI-поток: то же, что HmiPlayer::reloadScene
+        Clock::time_point applyStart = Clock::now();
+        std::vector<std::unique_ptr<VisualObject>> removed;
+        SceneReloader::applyPatch(patch, objects, &db, &font, removed);
+        renderer.build(objects);
+        router.build(objects);
+        removed.clear();
+        double ms = elapsedMs(applyStart);
+        applyMs += ms;
+        worstApplyMs = std::max(worstApplyMs, ms);
+    }
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << OBJECT_COUNT << " widgets, " << EDITS << " single-widget edits\n";
+    std::cout << "Restart (load + batch + input index)\n";
+    std::cout << "  UI thread: " << restartMs << " ms\n";
+    std::cout << "Hot reload\n";
+    std::cout << "  background parse: " << parseMs / EDITS << " ms, diff: " << diffMs / EDITS << " ms\n";
+    std::cout << "  UI thread: " << applyMs / EDITS << " ms avg, " << worstApplyMs << " ms worst\n";
+
+    std::filesystem::remove(JSON_FILE);
+    return 0;
+}
@@ -0,0 +1,57 @@
+#include "VariableDatabase.h"
+#include "logger.h"
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+// Измеряет пропускную способность setVariable при разных уровнях логирования.
+// Вывод логгера перенаправляется в пустой поток, чтобы мерить стоимость вызова, а не консоли
+namespace {
+
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+};
+
+double measureWritesPerSecond(VariableDatabase& db, TagId tag, int writes) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < writes; ++i) {
+        db.set(tag, static_cast<double>(i));
+    }
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return writes / elapsed;
+}
+
+} // namespace
+
+int main() {
+    NullBuffer nullBuffer;
+    std::ostream nullStream(&nullBuffer);
+    Logger::setStreams(nullStream, nullStream);
+
+    VariableDatabase db;
+    TagId tag = db.resolveTag("bench_value");
+    const int writes = 1000000;
+
+    // Прогрев (выделение буфера истории и т.п.)
+    measureWritesPerSecond(db, tag, writes / 10);
+
+    Logger::setLevel(LogLevel::Info);
+    double disabled = measureWritesPerSecond(db, tag, writes);
+
+    Logger::setLevel(LogLevel::Debug);
+    std::uint64_t droppedBefore = Logger::droppedCount();
+    double enabled = measureWritesPerSecond(db, tag, writes);
+    std::uint64_t dropped = Logger::droppedCount() - droppedBefore;
+    Logger::flush();
+    Logger::setLevel(LogLevel::Info);
+
+    std::cout << "setVariable throughput (" << writes << " writes)\n";
+    std::cout << "  DEBUG logging disabled: " << static_cast<long long>(disabled) << " writes/s\n";
+    std::cout << "  DEBUG logging enabled:  " << static_cast<long long>(enabled) << " writes/s"
+              << " (" << dropped << " messages dropped by full log buffer)\n";
+    std::cout << "  HMI_LOG_MIN_LEVEL=" << HMI_LOG_MIN_LEVEL << "\n";
+    return 0;
+}
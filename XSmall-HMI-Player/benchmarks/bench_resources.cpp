@@ -0,0 +1,149 @@
+#include "Image.h"
+#include "ResourceManager.h"
+#include "VariableDatabase.h"
+#include "logger.h"
+#include <SFML/Graphics.hpp>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Запуск и кадр сцены из 200 изображений: прежний Image (своя текстура на объект,
+// перебор шести путей, загрузка шрифта заглушки в каждом кадре) против Image
+// с общими ресурсами из ResourceManager.
+// 180 объектов показывают один и тот же логотип, 20 ссылаются на отсутствующий файл
+// (прежний Image подставлял вместо него логотип, а шрифт грузил, только если не нашелся и он).
+// Запускать из каталога сборки (рядом с assets/)
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const int IMAGE_COUNT = 200;
+const int MISSING_COUNT = 20;
+const int FRAME_COUNT = 100;
+
+// Прежняя реализация Image (до ResourceManager), перенесенная без изменений логики
+class LegacyImage {
+public:
+    sf::Texture texture;
+    sf::Sprite sprite;
+    float x, y, width, height;
+    bool textureLoaded;
+    std::size_t* fontLoads;
+
+    LegacyImage(float x, float y, float width, float height, const std::string& path, std::size_t* fontLoads)
+        : x(x), y(y), width(width), height(height), fontLoads(fontLoads) {
+        textureLoaded = loadTexture(path);
+        sprite.setPosition(x, y);
+        if (textureLoaded) {
+            sprite.setScale(width / sprite.getLocalBounds().width, height / sprite.getLocalBounds().height);
+        }
+    }
+
+    bool loadTexture(const std::string& path) {
+        std::vector<std::string> possiblePaths = {
+            path, "../" + path, "../../" + path, "C:/projects/XSmall-HMI-Player/" + path,
+            "assets/images/logo.png", "../assets/images/logo.png"
+        };
+        for (const auto& testPath : possiblePaths) {
+            if (texture.loadFromFile(testPath)) {
+                sprite.setTexture(texture);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void draw(sf::RenderTarget& target) {
+        if (textureLoaded) {
+            target.draw(sprite);
+            return;
+        }
+        sf::RectangleShape placeholder(sf::Vector2f(width, height));
+        placeholder.setPosition(x, y);
+        target.draw(placeholder);
+
+        // Шрифт читался с диска в каждом кадре (там, где путь существовал)
+        sf::Font font;
+        ++*fontLoads;
+        if (font.loadFromFile("assets/fonts/helveticabold.ttf")) {
+            sf::Text errorText("Image not found", font, 16);
+            errorText.setPosition(x + 10, y + height / 2 - 10);
+            target.draw(errorText);
+        }
+    }
+};
+
+std::string imagePath(int i) {
+    return i < IMAGE_COUNT - MISSING_COUNT ? "assets/images/logo.png" : "assets/images/missing.png";
+}
+
+template <typename Draw>
+double measureFrames(sf::RenderTarget& target, Draw drawScene) {
+    Clock::time_point start = Clock::now();
+    for (int frame = 0; frame < FRAME_COUNT; ++frame) {
+        target.clear();
+        drawScene();
+    }
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count() / FRAME_COUNT;
+}
+
+void report(const char* title, double startupMs, double frameMs, std::size_t textures, std::size_t fontLoads) {
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << title << "\n";
+    std::cout << "  startup: " << startupMs << " ms, texture objects: " << textures << "\n";
+    std::cout << "  frame: " << frameMs << " ms, font loads per frame: "
+              << static_cast<double>(fontLoads) / FRAME_COUNT << "\n";
+}
+
+} // namespace
+
+int main() {
+    Logger::setLevel(LogLevel::Error);
+
+    sf::RenderTexture target;
+    if (!target.create(1024, 768)) {
+        std::cerr << "Cannot create render texture (no OpenGL context?)" << std::endl;
+        return 1;
+    }
+
+    {
+        std::size_t fontLoads = 0;
+        Clock::time_point start = Clock::now();
+        std::vector<std::unique_ptr<LegacyImage>> images;
+        std::size_t textures = 0;
+        for (int i = 0; i < IMAGE_COUNT; ++i) {
+            images.push_back(std::make_unique<LegacyImage>((i % 20) * 50.0f, (i / 20) * 70.0f, 45, 60,
+                                                           imagePath(i), &fontLoads));
+            textures += images.back()->textureLoaded ? 1 : 0;
+        }
+        double startupMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        double frameMs = measureFrames(target, [&]() {
+            for (auto& image : images) image->draw(target);
+        });
+        report("Legacy Image (own texture, per-frame font load)", startupMs, frameMs, textures, fontLoads);
+    }
+
+    {
+        VariableDatabase db;
+        ResourceManager& resources = ResourceManager::instance();
+        Clock::time_point start = Clock::now();
+        resources.setDefaultFont(resources.getFont("assets/fonts/helveticabold.ttf"));
+        std::vector<std::unique_ptr<Image>> images;
+        for (int i = 0; i < IMAGE_COUNT; ++i) {
+            images.push_back(std::make_unique<Image>((i % 20) * 50.0f, (i / 20) * 70.0f, 45, 60,
+                                                     imagePath(i), "Image", &db));
+        }
+        double startupMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        double frameMs = measureFrames(target, [&]() {
+            for (auto& image : images) image->draw(target);
+        });
+        report("Image with ResourceManager", startupMs, frameMs, resources.getTextureCount(), 0);
+        std::cout << "  files read from disk: " << resources.getLoadCount() << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,114 @@
+#include "VariableDatabase.h"
+#include "HistoryRollup.h"
+#include "logger.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Масштабирование тренда от 1 минуты до 30 суток (800 столбцов): проход по исходным
+// значениям против запроса к пирамиде агрегатов. 30 суток значений раз в секунду
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using namespace std::chrono;
+
+const std::size_t COLUMNS = 800;
+const int SAMPLES = 30 * 24 * 3600;
+const int QUERY_RUNS = 20;
+
+volatile double sink = 0;  // Не дает компилятору выбросить результаты запросов
+
+double elapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+struct Sample {
+    HistoryClock::time_point time;
+    double value;
+};
+
+// Столбцы по исходным значениям: двоичный поиск начала окна и проход по всем значениям в нем
+std::vector<HistoryAggregate> scanRaw(const std::vector<Sample>& samples, HistoryClock::time_point from,
+                                      HistoryClock::time_point to) {
+    std::vector<HistoryAggregate> result(COLUMNS);
+    auto it = std::lower_bound(samples.begin(), samples.end(), from,
+                               [](const Sample& sample, HistoryClock::time_point time) { return sample.time < time; });
+    double scale = static_cast<double>(COLUMNS) / (to - from).count();
+    for (; it != samples.end() && it->time < to; ++it) {
+        std::size_t column = std::min(static_cast<std::size_t>((it->time - from).count() * scale), COLUMNS - 1);
+        result[column].add(it->value);
+    }
+    return result;
+}
+
+} // namespace
+
+int main() {
+    Logger::setLevel(LogLevel::Error);
+
+    HistoryClock::time_point start = HistoryClock::time_point(hours(24 * 365));
+    std::vector<Sample> samples;
+    samples.reserve(SAMPLES);
+    for (int i = 0; i < SAMPLES; ++i) {
+        double value = 70.0 + 5.0 * std::sin(i * 2e-5) + 0.5 * std::sin(i * 0.01);
+        samples.push_back({start + seconds(i), value});
+    }
+
+    VariableDatabase plainDb;
+    TagId plainTag = plainDb.resolveTag("plant.temperature");
+    Clock::time_point addStart = Clock::now();
+    for (const Sample& sample : samples) {
+        plainDb.addToHistory(plainTag, sample.value, sample.time);
+    }
+    double plainAddMs = elapsedMs(addStart);
+
+    VariableDatabase db;
+    TagId tag = db.resolveTag("plant.temperature");
+    db.enableRollups(tag);
+    addStart = Clock::now();
+    for (const Sample& sample : samples) {
+        db.addToHistory(tag, sample.value, sample.time);
+    }
+    double rollupAddMs = elapsedMs(addStart);
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << SAMPLES << " samples (30 days at 1 Hz), " << COLUMNS << " columns\n";
+    std::cout << "addToHistory: " << plainAddMs * 1e6 / SAMPLES << " ns plain, "
+              << rollupAddMs * 1e6 / SAMPLES << " ns with rollups\n";
+
+    struct Zoom {
+        const char* name;
+        HistoryClock::duration span;
+    };
+    const Zoom zooms[] = {{"1 minute", minutes(1)}, {"1 hour", hours(1)}, {"1 day", hours(24)},
+                          {"7 days", hours(24 * 7)}, {"30 days", hours(24 * 30)}};
+
+    HistoryClock::time_point end = samples.back().time + seconds(1);
+    std::cout << std::left << std::setw(10) << "window" << std::right << std::setw(14) << "raw scan ms"
+              << std::setw(14) << "rollup ms" << std::setw(8) << "level" << "\n";
+    for (const Zoom& zoom : zooms) {
+        HistoryClock::time_point from = end - zoom.span;
+
+        Clock::time_point queryStart = Clock::now();
+        for (int run = 0; run < QUERY_RUNS; ++run) {
+            sink = sink + scanRaw(samples, from, end)[COLUMNS / 2].max;
+        }
+        double rawMs = elapsedMs(queryStart) / QUERY_RUNS;
+
+        queryStart = Clock::now();
+        for (int run = 0; run < QUERY_RUNS; ++run) {
+            sink = sink + db.getAggregated(tag, from, end, COLUMNS)[COLUMNS / 2].max;
+        }
+        double rollupMs = elapsedMs(queryStart) / QUERY_RUNS;
+
+        std::size_t level = HistoryRollup::selectLevel(zoom.span / static_cast<HistoryClock::duration::rep>(COLUMNS));
+        std::cout << std::left << std::setw(10) << zoom.name << std::right << std::setw(14) << rawMs
+                  << std::setw(14) << rollupMs << std::setw(8)
+                  << duration_cast<seconds>(HistoryRollup::getLevelWidth(level)).count() << "s\n";
+    }
+    return 0;
+}
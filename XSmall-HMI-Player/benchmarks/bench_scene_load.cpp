@@ -0,0 +1,155 @@
+#include "JSONLoader.h"
+#include "BinaryScene.h"
+#include "VariableDatabase.h"
+#include "logger.h"
+#include <SFML/Graphics.hpp>
+#include <nlohmann/json.hpp>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Запуск экрана из 50 000 объектов: разбор objects.json против скомпилированной сцены
+// (отображение файла в память и создание объектов прямо из записей).
+// Смесь типов как на типичной мнемосхеме: индикаторы с условиями, значения, подписи, линии, кнопки.
+// Запускать из каталога сборки (рядом с assets/)
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using json = nlohmann::json;
+
+const int OBJECT_COUNT = 50000;
+const int RUNS = 3;
+const std::string JSON_FILE = "bench_scene.json";
+const std::string SCENE_FILE = "bench_scene.hmiscene";
+
+double elapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+void writeScene() {
+    json j;
+    j["historyCapacity"] = 100;
+    j["objects"] = json::array();
+    for (int i = 0; i < OBJECT_COUNT; ++i) {
+        float x = static_cast<float>((i % 250) * 8);
+        float y = static_cast<float>((i / 250) * 8);
+        std::string tag = "bench_tag_" + std::to_string(i % 5000);
+
+        json obj;
+        obj["name"] = "Object " + std::to_string(i);
+        obj["x"] = x;
+        obj["y"] = y;
+        switch (i % 5) {
+        case 0:
+            obj["type"] = "Rectangle";
+            obj["width"] = 6;
+            obj["height"] = 6;
+            obj["color"] = {40, 40, 40};
+            obj["variable"] = tag;
+            obj["conditions"] = json::array({
+                {{"value", 0}, {"color", {0, 160, 0}}},
+                {{"value", 1}, {"color", {200, 0, 0}}}
+            });
+            break;
+        case 1:
+            obj["type"] = "Text";
+            obj["content"] = "0.0";
+            obj["fontSize"] = 8;
+            obj["color"] = {255, 255, 255};
+            obj["variable"] = tag;
+            obj["format"] = "%.1f";
+            break;
+        case 2:
+            obj["type"] = "Text";
+            obj["content"] = "Pump " + std::to_string(i % 100);
+            obj["fontSize"] = 8;
+            obj["color"] = {200, 200, 200};
+            break;
+        case 3:
+            obj["type"] = "Line";
+            obj["x2"] = x + 6;
+            obj["y2"] = y;
+            obj["color"] = {128, 128, 128};
+            break;
+        default:
+            obj["type"] = "Button";
+            obj["width"] = 6;
+            obj["height"] = 6;
+            obj["text"] = "Go";
+            obj["fontSize"] = 8;
+            obj["color"] = {200, 200, 200};
+            obj["textColor"] = {0, 0, 0};
+            obj["action"] = "increase_temp";
+            break;
+        }
+        j["objects"].push_back(obj);
+    }
+
+    std::ofstream(JSON_FILE) << j.dump();
+}
+
+// Лучшее время из нескольких запусков: каждый раз новая база переменных, как при старте плеера
+template <typename Load>
+double measureLoad(Load load, std::size_t& created) {
+    double best = 0.0;
+    for (int run = 0; run < RUNS; ++run) {
+        VariableDatabase db;
+        Clock::time_point start = Clock::now();
+        created = load(db);
+        double ms = elapsedMs(start);
+        best = run == 0 ? ms : std::min(best, ms);
+    }
+    return best;
+}
+
+} // namespace
+
+int main() {
+    Logger::setLevel(LogLevel::Error);
+
+    sf::Font font;
+    if (!font.loadFromFile("assets/fonts/helveticabold.ttf")) {
+        std::cerr << "Cannot load assets/fonts/helveticabold.ttf" << std::endl;
+        return 1;
+    }
+
+    writeScene();
+
+    Clock::time_point compileStart = Clock::now();
+    if (!JSONLoader::compileScene(JSON_FILE, SCENE_FILE)) {
+        std::cerr << "Cannot compile " << JSON_FILE << std::endl;
+        return 1;
+    }
+    double compileMs = elapsedMs(compileStart);
+
+    std::size_t jsonObjects = 0;
+    double jsonMs = measureLoad([&font](VariableDatabase& db) {
+        return JSONLoader::loadFromFile(JSON_FILE, &db, &font).size();
+    }, jsonObjects);
+
+    std::size_t binaryObjects = 0;
+    double binaryMs = measureLoad([&font](VariableDatabase& db) {
+        BinaryScene scene;
+        if (!scene.open(SCENE_FILE) || !scene.isUpToDate(JSON_FILE)) {
+            return std::size_t(0);
+        }
+        return scene.instantiate(&db, &font).size();
+    }, binaryObjects);
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << OBJECT_COUNT << " objects, best of " << RUNS << " runs\n";
+    std::cout << "JSON (" << std::filesystem::file_size(JSON_FILE) / 1024 << " KiB)\n";
+    std::cout << "  load: " << jsonMs << " ms, objects: " << jsonObjects << "\n";
+    std::cout << "Compiled scene (" << std::filesystem::file_size(SCENE_FILE) / 1024 << " KiB)\n";
+    std::cout << "  compile once: " << compileMs << " ms\n";
+    std::cout << "  load: " << binaryMs << " ms, objects: " << binaryObjects << "\n";
+
+    std::filesystem::remove(JSON_FILE);
+    std::filesystem::remove(SCENE_FILE);
+    return 0;
+}
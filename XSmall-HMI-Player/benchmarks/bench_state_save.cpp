@@ -0,0 +1,85 @@
+#include "StateManager.h"
+#include "VariableDatabase.h"
+#include "logger.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+// Автосохранение 100 000 переменных: сборка JSON и запись прямо в UI-потоке (как было,
+// только для всех переменных) против StateManager - копия значений в UI-потоке,
+// JSON, fsync и атомарная замена файла в фоновом потоке
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using json = nlohmann::json;
+
+const int TAG_COUNT = 100000;
+const int RUNS = 5;
+const std::string STATE_FILE = "bench_state.json";
+
+double elapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+void saveOnUiThread(const VariableDatabase& db) {
+    json variables = json::object();
+    for (TagId tag = 0; tag < db.tagCount(); ++tag) {
+        variables[db.getTagName(tag)] = db.get(tag);
+    }
+    json j;
+    j["variables"] = std::move(variables);
+    std::ofstream(STATE_FILE) << j.dump(2);
+}
+
+} // namespace
+
+int main() {
+    Logger::setLevel(LogLevel::Error);
+
+    VariableDatabase db;
+    for (int i = 0; i < TAG_COUNT; ++i) {
+        db.setVariable("plant.area" + std::to_string(i % 50) + ".tag" + std::to_string(i), i * 0.1);
+    }
+
+    double syncAvg = 0, syncWorst = 0;
+    for (int run = 0; run < RUNS; ++run) {
+        Clock::time_point start = Clock::now();
+        saveOnUiThread(db);
+        double ms = elapsedMs(start);
+        syncAvg += ms / RUNS;
+        syncWorst = std::max(syncWorst, ms);
+    }
+
+    double uiAvg = 0, uiWorst = 0, writeAvg = 0;
+    {
+        StateManager manager(STATE_FILE);
+        for (int run = 0; run < RUNS; ++run) {
+            Clock::time_point start = Clock::now();
+            manager.saveState(db);
+            double ms = elapsedMs(start);
+            uiAvg += ms / RUNS;
+            uiWorst = std::max(uiWorst, ms);
+
+            // Фоновая запись (в плеере UI-поток ее не ждет)
+            Clock::time_point writeStart = Clock::now();
+            manager.flush();
+            writeAvg += elapsedMs(writeStart) / RUNS;
+        }
+    }
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << TAG_COUNT << " variables, " << RUNS << " saves\n";
+    std::cout << "JSON and write on the UI thread\n";
+    std::cout << "  UI thread: " << syncAvg << " ms avg, " << syncWorst << " ms worst\n";
+    std::cout << "StateManager (snapshot + background write with fsync)\n";
+    std::cout << "  UI thread: " << uiAvg << " ms avg, " << uiWorst << " ms worst\n";
+    std::cout << "  background: " << writeAvg << " ms avg\n";
+
+    std::filesystem::remove(STATE_FILE);
+    return 0;
+}
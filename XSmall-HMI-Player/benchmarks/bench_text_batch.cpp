@@ -0,0 +1,86 @@
+#include "SceneRenderer.h"
+#include "Text.h"
+#include "VariableDatabase.h"
+#include "logger.h"
+#include <SFML/Graphics.hpp>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Кадр мнемосхемы из 2000 надписей со значениями переменных: каждая надпись - отдельный
+// sf::Text и свой вызов draw (как до TextRun) против общего пакета глифов в SceneRenderer.
+// В каждом кадре меняется каждая десятая переменная.
+// Запускать из каталога сборки (рядом с assets/)
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const int LABEL_COUNT = 2000;
+const int FRAME_COUNT = 200;
+const int CHANGED_PER_FRAME = LABEL_COUNT / 10;
+
+std::string tagName(int i) {
+    return "bench_label_" + std::to_string(i);
+}
+
+// Меняет часть переменных и рисует кадр; возвращает среднее время кадра в мс
+template <typename Draw>
+double measureFrames(VariableDatabase& db, const std::vector<TagId>& tags, sf::RenderTarget& target, Draw drawScene) {
+    Clock::time_point start = Clock::now();
+    for (int frame = 0; frame < FRAME_COUNT; ++frame) {
+        for (int i = 0; i < CHANGED_PER_FRAME; ++i) {
+            std::size_t index = (static_cast<std::size_t>(frame) * CHANGED_PER_FRAME + i) % tags.size();
+            db.set(tags[index], 20.0 + (frame + i) % 500 * 0.1);
+        }
+        target.clear();
+        drawScene();
+    }
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count() / FRAME_COUNT;
+}
+
+} // namespace
+
+int main() {
+    Logger::setLevel(LogLevel::Error);
+
+    sf::Font font;
+    if (!font.loadFromFile("assets/fonts/helveticabold.ttf")) {
+        std::cerr << "Cannot load assets/fonts/helveticabold.ttf" << std::endl;
+        return 1;
+    }
+
+    sf::RenderTexture target;
+    if (!target.create(1920, 1080)) {
+        std::cerr << "Cannot create render texture (no OpenGL context?)" << std::endl;
+        return 1;
+    }
+
+    VariableDatabase db;
+    std::vector<TagId> tags;
+    std::vector<std::unique_ptr<VisualObject>> objects;
+    for (int i = 0; i < LABEL_COUNT; ++i) {
+        tags.push_back(db.resolveTag(tagName(i)));
+        objects.push_back(std::make_unique<Text>((i % 20) * 95.0f, (i / 20) * 10.8f, "", &font, 9,
+                                                 sf::Color::White, "Label", &db, tagName(i), "%f C"));
+    }
+
+    // Без пакетов: отдельный draw на каждую надпись
+    double separateMs = measureFrames(db, tags, target, [&]() {
+        for (auto& object : objects) object->draw(target);
+    });
+
+    SceneRenderer renderer;
+    renderer.build(objects);
+    double batchedMs = measureFrames(db, tags, target, [&]() { renderer.draw(target); });
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << LABEL_COUNT << " labels, " << CHANGED_PER_FRAME << " changed per frame\n";
+    std::cout << "Separate sf::Text draws\n";
+    std::cout << "  draw calls per frame: " << LABEL_COUNT << ", frame: " << separateMs << " ms\n";
+    std::cout << "Glyph batch (TextRun + SceneRenderer)\n";
+    std::cout << "  draw calls per frame: " << renderer.getStepCount() << ", frame: " << batchedMs << " ms\n";
+    return 0;
+}
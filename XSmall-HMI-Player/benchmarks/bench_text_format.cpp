@@ -0,0 +1,131 @@
+#include "Text.h"
+#include "VariableDatabase.h"
+#include "logger.h"
+#include <SFML/Graphics.hpp>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Обновление 10 000 текстовых виджетов с форматом "Value: %f units":
+// прежний Text::update (stringstream, substr и setString на каждое уведомление)
+// против Text с разобранным заранее шаблоном, std::to_chars и пропуском setString,
+// если строка не изменилась.
+// Два режима: значения меняются при каждом обновлении и значения стоят на месте
+// (типичная мнемосхема - большинство переменных между опросами не меняется).
+// Запускать из каталога сборки (рядом с assets/)
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const int WIDGET_COUNT = 10000;
+const int ROUND_COUNT = 20;
+const char* FORMAT = "Value: %f units";
+
+// Прежняя реализация Text::update, перенесенная без изменений логики
+class LegacyText {
+public:
+    sf::Text text;
+    std::string formatString;
+    VariableDatabase* database;
+    TagId tag;
+
+    LegacyText(sf::Font& font, const std::string& format, VariableDatabase* db, TagId tag)
+        : formatString(format), database(db), tag(tag) {
+        text.setFont(font);
+        text.setCharacterSize(14);
+        db->subscribe(tag, [this](double) { update(); });
+        update();
+    }
+
+    void update() {
+        double value = database->get(tag);
+        std::string displayText;
+        if (!formatString.empty()) {
+            size_t pos = formatString.find("%f");
+            if (pos != std::string::npos) {
+                std::stringstream ss;
+                ss << std::fixed << std::setprecision(1) << value;
+                displayText = formatString.substr(0, pos) + ss.str() + formatString.substr(pos + 2);
+            } else {
+                displayText = formatString + std::to_string(value);
+            }
+        } else {
+            displayText = std::to_string(value);
+        }
+        text.setString(displayText);
+    }
+};
+
+std::string tagName(int i) {
+    return "bench_text_" + std::to_string(i);
+}
+
+// Возвращает число обновлений виджетов в секунду
+double measureUpdates(VariableDatabase& db, const std::vector<TagId>& tags, bool changing) {
+    Clock::time_point start = Clock::now();
+    for (int round = 0; round < ROUND_COUNT; ++round) {
+        for (std::size_t i = 0; i < tags.size(); ++i) {
+            double value = changing ? 20.0 + (round * 7 + i) % 1000 * 0.1 : 20.0 + i % 1000 * 0.1;
+            db.set(tags[i], value);
+        }
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return static_cast<double>(ROUND_COUNT) * tags.size() / seconds;
+}
+
+void report(const char* title, double changingRate, double steadyRate) {
+    std::cout << std::fixed << std::setprecision(0);
+    std::cout << title << "\n";
+    std::cout << "  changing values: " << changingRate << " updates/s\n";
+    std::cout << "  steady values:   " << steadyRate << " updates/s\n";
+}
+
+} // namespace
+
+int main() {
+    Logger::setLevel(LogLevel::Error);
+
+    sf::Font font;
+    if (!font.loadFromFile("assets/fonts/helveticabold.ttf")) {
+        std::cerr << "Cannot load assets/fonts/helveticabold.ttf" << std::endl;
+        return 1;
+    }
+
+    double legacyChanging = 0, legacySteady = 0;
+    {
+        VariableDatabase db;
+        std::vector<TagId> tags;
+        std::vector<std::unique_ptr<LegacyText>> widgets;
+        for (int i = 0; i < WIDGET_COUNT; ++i) {
+            tags.push_back(db.resolveTag(tagName(i)));
+            widgets.push_back(std::make_unique<LegacyText>(font, FORMAT, &db, tags.back()));
+        }
+        legacyChanging = measureUpdates(db, tags, true);
+        legacySteady = measureUpdates(db, tags, false);
+    }
+    report("Legacy Text (stringstream, setString on every update)", legacyChanging, legacySteady);
+
+    double changing = 0, steady = 0;
+    {
+        VariableDatabase db;
+        std::vector<TagId> tags;
+        std::vector<std::unique_ptr<Text>> widgets;
+        for (int i = 0; i < WIDGET_COUNT; ++i) {
+            tags.push_back(db.resolveTag(tagName(i)));
+            widgets.push_back(std::make_unique<Text>(0.0f, 0.0f, "", &font, 14, sf::Color::Black,
+                                                     "Text", &db, tagName(i), FORMAT));
+        }
+        changing = measureUpdates(db, tags, true);
+        steady = measureUpdates(db, tags, false);
+    }
+    report("Text with NumberFormat (to_chars, skip unchanged)", changing, steady);
+
+    std::cout << std::setprecision(2);
+    std::cout << "Speedup: changing x" << changing / legacyChanging
+              << ", steady x" << steady / legacySteady << "\n";
+    return 0;
+}
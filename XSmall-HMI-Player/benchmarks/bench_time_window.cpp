@@ -0,0 +1,117 @@
+#include "HistoryBuffer.h"
+#include "CompressedHistory.h"
+#include "TrendCurve.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+
+// Окно тренда по времени: поиск границы окна просмотром отметок против двоичного поиска
+// и стоимость кадра графика с осью времени. История 1 кГц, 1 000 000 значений (~17 минут)
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using namespace std::chrono;
+
+const std::size_t SAMPLES = 1000000;
+const int LOOKUP_RUNS = 200;
+const int FRAMES = 3600;  // Минута при 60 кадрах в секунду
+
+volatile std::size_t sink = 0;  // Не дает компилятору выбросить результаты поиска
+
+double elapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+double sampleValue(std::size_t i) {
+    return 70.0 + 5.0 * std::sin(i * 2e-4) + 0.5 * std::sin(i * 0.05);
+}
+
+// Граница окна просмотром всех отметок от старых к новым
+std::size_t scanLowerBound(const HistoryView& view, HistoryClock::time_point time) {
+    std::size_t i = 0;
+    while (i < view.size() && view.time(i) < time) {
+        ++i;
+    }
+    return i;
+}
+
+} // namespace
+
+int main() {
+    HistoryClock::time_point start = HistoryClock::time_point(hours(24 * 365));
+    HistoryBuffer buffer(SAMPLES);
+    CompressedHistory compressed(SAMPLES);
+    for (std::size_t i = 0; i < SAMPLES; ++i) {
+        HistoryClock::time_point time = start + milliseconds(i);
+        buffer.push(sampleValue(i), time);
+        compressed.push(sampleValue(i), time);
+    }
+    HistoryClock::time_point end = start + milliseconds(SAMPLES);
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << SAMPLES << " samples at 1 kHz\n";
+    std::cout << std::left << std::setw(10) << "window" << std::right << std::setw(14) << "scan us"
+              << std::setw(16) << "binary us" << std::setw(20) << "compressed us" << "\n";
+
+    const seconds windows[] = {seconds(10), seconds(60), seconds(600)};
+    HistoryView view = buffer.view();
+    for (seconds window : windows) {
+        HistoryClock::time_point from = end - window;
+
+        Clock::time_point lookupStart = Clock::now();
+        for (int run = 0; run < LOOKUP_RUNS; ++run) {
+            sink = sink + scanLowerBound(view, from);
+        }
+        double scanUs = elapsedMs(lookupStart) * 1000 / LOOKUP_RUNS;
+
+        lookupStart = Clock::now();
+        for (int run = 0; run < LOOKUP_RUNS; ++run) {
+            sink = sink + view.lowerBound(from);
+        }
+        double binaryUs = elapsedMs(lookupStart) * 1000 / LOOKUP_RUNS;
+
+        lookupStart = Clock::now();
+        for (int run = 0; run < LOOKUP_RUNS; ++run) {
+            sink = sink + compressed.lowerBound(from);
+        }
+        double compressedUs = elapsedMs(lookupStart) * 1000 / LOOKUP_RUNS;
+
+        std::cout << std::left << std::setw(10) << (std::to_string(window.count()) + " s") << std::right
+                  << std::setw(14) << scanUs << std::setw(16) << binaryUs << std::setw(20) << compressedUs << "\n";
+    }
+
+    // Кадр графика 400 px с окном 60 с: 1 кГц - около 17 новых значений на кадр
+    for (bool useCompressed : {false, true}) {
+        HistoryBuffer live(SAMPLES);
+        CompressedHistory liveCompressed(SAMPLES);
+        for (std::size_t i = 0; i < 120000; ++i) {
+            live.push(sampleValue(i), start + milliseconds(i));
+            liveCompressed.push(sampleValue(i), start + milliseconds(i));
+        }
+
+        TrendCurve curve;
+        curve.configureTime(seconds(60), 400);
+        std::size_t next = 120000;
+        std::size_t vertices = 0;
+        Clock::time_point frameStart = Clock::now();
+        for (int frame = 1; frame <= FRAMES; ++frame) {
+            HistoryClock::time_point now = start + milliseconds(120000) + microseconds(frame * 16667);
+            for (; start + milliseconds(next) <= now; ++next) {
+                live.push(sampleValue(next), start + milliseconds(next));
+                liveCompressed.push(sampleValue(next), start + milliseconds(next));
+            }
+            if (useCompressed) {
+                curve.sync(liveCompressed, now);
+            } else {
+                curve.sync(live.view(), live.total(), now);
+            }
+            vertices = std::max(vertices, curve.getVertexCount());
+        }
+        double frameUs = elapsedMs(frameStart) * 1000 / FRAMES;
+        std::cout << (useCompressed ? "compressed" : "plain") << " history, 60 s window: " << frameUs
+                  << " us per frame (including appends), up to " << vertices << " vertices\n";
+    }
+    return 0;
+}
@@ -0,0 +1,115 @@
+#include "StateManager.h"
+#include "VariableDatabase.h"
+#include "WriteAheadLog.h"
+#include "logger.h"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+// Журнал записей оператора: цена set() с журналом и без него (в UI-потоке),
+// число групповых фиксаций и время восстановления журнала из 1 000 000 записей
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const int TAG_COUNT = 1000;
+const int WRITES = 1000000;
+const std::string STATE_FILE = "bench_wal_state.json";
+const std::string JOURNAL_PREFIX = "bench_wal_state.wal.";
+
+double elapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+void removeJournal() {
+    for (const auto& entry : std::filesystem::directory_iterator(".")) {
+        if (entry.path().filename().string().rfind(JOURNAL_PREFIX, 0) == 0) {
+            std::filesystem::remove(entry.path());
+        }
+    }
+    std::filesystem::remove(STATE_FILE);
+}
+
+std::uintmax_t journalSize() {
+    std::uintmax_t size = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(".")) {
+        if (entry.path().filename().string().rfind(JOURNAL_PREFIX, 0) == 0) {
+            size += entry.file_size();
+        }
+    }
+    return size;
+}
+
+std::vector<TagId> registerTags(VariableDatabase& db) {
+    std::vector<TagId> tags;
+    for (int i = 0; i < TAG_COUNT; ++i) {
+        tags.push_back(db.resolveTag("plant.area" + std::to_string(i % 50) + ".setpoint" + std::to_string(i)));
+    }
+    return tags;
+}
+
+double writeAll(VariableDatabase& db, const std::vector<TagId>& tags, WriteSource source) {
+    Clock::time_point start = Clock::now();
+    for (int i = 0; i < WRITES; ++i) {
+        db.set(tags[i % TAG_COUNT], i * 0.5, source);
+    }
+    return elapsedMs(start);
+}
+
+} // namespace
+
+int main() {
+    Logger::setLevel(LogLevel::Error);
+    removeJournal();
+
+    double plainMs = 0;
+    {
+        VariableDatabase db;
+        plainMs = writeAll(db, registerTags(db), WriteSource::Operator);
+    }
+
+    double journalMs = 0, drainMs = 0;
+    std::uint64_t commits = 0;
+    {
+        VariableDatabase db;
+        StateManager manager(STATE_FILE);
+        manager.enableJournal(db);
+        manager.loadState(db);
+        journalMs = writeAll(db, registerTags(db), WriteSource::Operator);
+
+        Clock::time_point drainStart = Clock::now();
+        manager.flush();
+        drainMs = elapsedMs(drainStart);
+        commits = manager.getJournal()->getCommitCount();
+    }
+    std::uintmax_t size = journalSize();
+
+    double recoverMs = 0;
+    std::size_t replayed = 0;
+    {
+        VariableDatabase db;
+        registerTags(db);
+        StateManager manager(STATE_FILE);
+        manager.enableJournal(db);
+        Clock::time_point start = Clock::now();
+        manager.loadState(db);
+        recoverMs = elapsedMs(start);
+        replayed = manager.getJournal()->getLastSequence();
+    }
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << WRITES << " operator writes to " << TAG_COUNT << " variables\n";
+    std::cout << "set() without journal: " << plainMs * 1e6 / WRITES << " ns/write\n";
+    std::cout << "set() with journal:    " << journalMs * 1e6 / WRITES << " ns/write\n";
+    std::cout << "  background drain after last write: " << drainMs << " ms\n";
+    std::cout << "  group commits (fsync): " << commits << ", "
+              << static_cast<double>(WRITES) / std::max<std::uint64_t>(commits, 1) << " records each\n";
+    std::cout << "  journal size: " << size / (1024.0 * 1024.0) << " MB\n";
+    std::cout << "Recovery of " << replayed << " records: " << recoverMs << " ms\n";
+
+    removeJournal();
+    return 0;
+}
@@ -0,0 +1,164 @@
+#include "JSONLoader.h"
+#include "WidgetRegistry.h"
+#include "ThreadPool.h"
+#include "VariableDatabase.h"
+#include "logger.h"
+#include <SFML/Graphics.hpp>
+#include <nlohmann/json.hpp>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Загрузка objects.json из 100 000 объектов: разбор файла целиком в одно дерево и
+// последовательное создание объектов (как было) против JSONLoader::loadFromFile -
+// деление файла на объекты и их разбор в пуле потоков, создание в порядке файла.
+// Запускать из каталога сборки (рядом с assets/)
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using json = nlohmann::json;
+
+const int OBJECT_COUNT = 100000;
+const int RUNS = 3;
+const std::string JSON_FILE = "bench_widgets.json";
+
+double elapsedMs(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+void writeScene() {
+    json j;
+    j["historyCapacity"] = 100;
+    j["objects"] = json::array();
+    for (int i = 0; i < OBJECT_COUNT; ++i) {
+        float x = static_cast<float>((i % 250) * 8);
+        float y = static_cast<float>((i / 250) * 8);
+        std::string tag = "widget_tag_" + std::to_string(i % 10000);
+
+        json obj;
+        obj["name"] = "Object " + std::to_string(i);
+        obj["x"] = x;
+        obj["y"] = y;
+        switch (i % 5) {
+        case 0:
+            obj["type"] = "Rectangle";
+            obj["width"] = 6;
+            obj["height"] = 6;
+            obj["color"] = {40, 40, 40};
+            obj["variable"] = tag;
+            obj["conditions"] = json::array({
+                {{"value", 0}, {"color", {0, 160, 0}}},
+                {{"value", 1}, {"color", {200, 0, 0}}}
+            });
+            break;
+        case 1:
+            obj["type"] = "Text";
+            obj["content"] = "0.0";
+            obj["fontSize"] = 8;
+            obj["color"] = {255, 255, 255};
+            obj["variable"] = tag;
+            obj["format"] = "%.1f";
+            break;
+        case 2:
+            obj["type"] = "Polyline";
+            obj["points"] = json::array({{x, y}, {x + 3, y + 6}, {x + 6, y}});
+            obj["color"] = {128, 128, 128};
+            break;
+        case 3:
+            obj["type"] = "Line";
+            obj["x2"] = x + 6;
+            obj["y2"] = y;
+            obj["color"] = {128, 128, 128};
+            break;
+        default:
+            obj["type"] = "Button";
+            obj["width"] = 6;
+            obj["height"] = 6;
+            obj["text"] = "Go";
+            obj["fontSize"] = 8;
+            obj["color"] = {200, 200, 200};
+            obj["textColor"] = {0, 0, 0};
+            obj["action"] = "increase_temp";
+            break;
+        }
+        j["objects"].push_back(obj);
+    }
+
+    std::ofstream(JSON_FILE) << j.dump(2);
+}
+
+// Прежняя загрузка: одно дерево на весь файл, объекты по очереди
+std::size_t loadSequential(VariableDatabase& db, sf::Font& font, double& parseMs) {
+    Clock::time_point start = Clock::now();
+    json j;
+    std::ifstream(JSON_FILE) >> j;
+    db.setDefaultHistoryCapacity(j["historyCapacity"].get<std::size_t>());
+    parseMs = elapsedMs(start);
+
+    std::vector<std::unique_ptr<VisualObject>> objects;
+    for (const auto& objJson : j["objects"]) {
+        auto obj = JSONLoader::createObject(objJson, &db, &font);
+        if (obj) {
+            objects.push_back(std::move(obj));
+        }
+    }
+    return objects.size();
+}
+
+} // namespace
+
+int main() {
+    Logger::setLevel(LogLevel::Error);
+
+    sf::Font font;
+    if (!font.loadFromFile("assets/fonts/helveticabold.ttf")) {
+        std::cerr << "Cannot load assets/fonts/helveticabold.ttf" << std::endl;
+        return 1;
+    }
+
+    writeScene();
+
+    // Пул и реестр создаются заранее, как при запуске плеера
+    ThreadPool::instance();
+    WidgetRegistry::instance();
+
+    double sequentialMs = 0, sequentialParseMs = 0, parallelMs = 0;
+    std::size_t sequentialObjects = 0, parallelObjects = 0;
+    for (int run = 0; run < RUNS; ++run) {
+        {
+            VariableDatabase db;
+            double parseMs = 0;
+            Clock::time_point start = Clock::now();
+            sequentialObjects = loadSequential(db, font, parseMs);
+            double ms = elapsedMs(start);
+            if (run == 0 || ms < sequentialMs) {
+                sequentialMs = ms;
+                sequentialParseMs = parseMs;
+            }
+        }
+        {
+            VariableDatabase db;
+            Clock::time_point start = Clock::now();
+            parallelObjects = JSONLoader::loadFromFile(JSON_FILE, &db, &font).size();
+            double ms = elapsedMs(start);
+            parallelMs = run == 0 ? ms : std::min(parallelMs, ms);
+        }
+    }
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << OBJECT_COUNT << " objects (" << std::filesystem::file_size(JSON_FILE) / 1024
+              << " KiB), best of " << RUNS << " runs\n";
+    std::cout << "Single tree, sequential construction\n";
+    std::cout << "  load: " << sequentialMs << " ms (parse " << sequentialParseMs
+              << " ms), objects: " << sequentialObjects << "\n";
+    std::cout << "Streamed split, parallel parse (" << ThreadPool::instance().getThreadCount() << " threads)\n";
+    std::cout << "  load: " << parallelMs << " ms, objects: " << parallelObjects << "\n";
+
+    std::filesystem::remove(JSON_FILE);
+    return 0;
+}
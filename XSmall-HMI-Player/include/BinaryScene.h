@@ -0,0 +1,290 @@
+#ifndef BINARYSCENE_H
+#define BINARYSCENE_H
+
+#include "MappedFile.h"
+#include "PlayerSettings.h"
+#include "VariableDatabase.h"
+#include "VisualObject.h"
+#include <SFML/Graphics.hpp>
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Скомпилированная сцена (objects.hmiscene) - бинарный снимок objects.json для быстрого запуска.
+ *
+ * Формат (все участки выровнены на 8 байт, порядок байт - платформенный):
+ * - заголовок: сигнатура, версия, размер и время изменения исходного JSON, настройки плеера;
+ * - таблица строк: пары (смещение, длина) и общий блок символов, каждая строка хранится один раз;
+ * - таблица переменных: индексы строк с именами, на переменную ссылаются по номеру;
+ * - записи объектов: заголовок записи и плоские поля своего типа, цвета уже разобраны;
+ * - политики истории и зоны нечувствительности переменных из секции "tags".
+ * Файл отображается в память, объекты создаются прямо из записей без разбора текста.
+ */
+
+constexpr std::uint32_t SCENE_NO_INDEX = 0xFFFFFFFFu;
+
+enum class SceneObjectType : std::uint16_t {
+    Rectangle = 1,
+    Text,
+    Line,
+    Polyline,
+    InputField,
+    Button,
+    HistoryGraph,
+    Image
+};
+
+// Настройки плеера уже с примененными значениями по умолчанию
+struct SceneSettingsRecord {
+    double renderRate;
+    double tickRate;
+    double inputRate;
+    std::int32_t maxTicksPerFrame;
+    std::int32_t timerResolutionMs;
+    std::int32_t autosaveIntervalMs;
+    std::int32_t demoIntervalMs;
+    std::uint32_t atlasCacheDir;  // Индекс строки
+    std::uint32_t stateTags;      // Индекс строки: имена через '\n', пустая - все переменные
+    std::uint32_t historianDir;   // Индекс строки
+    std::int32_t historianRetentionDays;
+    std::int32_t historianChunkSeconds;
+    std::uint32_t reserved;
+};
+
+struct SceneFileHeader {
+    char magic[4];
+    std::uint32_t version;
+    std::uint64_t fileSize;
+    std::uint64_t sourceSize;        // Размер исходного JSON
+    std::int64_t sourceTime;         // Время изменения исходного JSON (тики file_time_type)
+    std::uint64_t historyCapacity;   // 0 - в JSON не задана
+    SceneSettingsRecord settings;
+    std::uint32_t stringCount;
+    std::uint32_t tagCount;
+    std::uint32_t objectCount;
+    std::uint32_t policyCount;
+    std::uint32_t deadbandCount;
+    std::uint32_t reserved;
+    std::uint64_t stringsOffset;     // Таблица (смещение, длина), за ней символы
+    std::uint64_t tagsOffset;
+    std::uint64_t recordsOffset;
+    std::uint64_t policiesOffset;
+    std::uint64_t deadbandsOffset;
+
+    static constexpr char MAGIC[4] = {'H', 'M', 'I', 'S'};
+    static constexpr std::uint32_t VERSION = 6;
+};
+
+// Политика истории переменной (HistoryPolicy)
+struct SceneHistoryPolicyRecord {
+    std::uint32_t tag;  // Индекс переменной
+    std::uint32_t flags;
+    std::uint64_t capacity;
+    double deadband;
+    double swingingDoor;
+
+    static constexpr std::uint32_t COMPRESSED = 1;
+    static constexpr std::uint32_t PERSISTENT = 2;
+};
+
+// Зона нечувствительности уведомлений (NotifyDeadband)
+struct SceneNotifyDeadbandRecord {
+    std::uint32_t tag;  // Индекс переменной
+    std::uint32_t reserved;
+    double absolute;
+    double percent;
+    double span;
+};
+
+struct SceneStringEntry {
+    std::uint32_t offset;  // От начала блока символов
+    std::uint32_t length;
+};
+
+// Общее начало каждой записи; size - полный размер записи вместе с хвостом переменной длины
+struct SceneRecordHeader {
+    SceneObjectType type;
+    std::uint16_t reserved;
+    std::uint32_t size;
+    float x;
+    float y;
+    std::uint32_t name;  // Индекс строки
+    std::uint32_t tag;   // Индекс переменной или SCENE_NO_INDEX
+};
+
+struct SceneConditionRecord {
+    double value;
+    std::uint32_t color;
+    std::uint32_t reserved;
+};
+
+// За записью следуют conditionCount записей SceneConditionRecord
+struct SceneRectangleRecord {
+    static constexpr SceneObjectType TYPE = SceneObjectType::Rectangle;
+    SceneRecordHeader header;
+    float width;
+    float height;
+    std::uint32_t color;
+    std::uint32_t conditionCount;
+};
+
+struct SceneTextRecord {
+    static constexpr SceneObjectType TYPE = SceneObjectType::Text;
+    SceneRecordHeader header;
+    std::uint32_t content;
+    std::uint32_t format;
+    std::uint32_t fontSize;
+    std::uint32_t color;
+};
+
+struct SceneLineRecord {
+    static constexpr SceneObjectType TYPE = SceneObjectType::Line;
+    SceneRecordHeader header;
+    float x2;
+    float y2;
+    std::uint32_t color;
+    std::uint32_t reserved;
+};
+
+// За записью следуют pointCount пар координат (float x, float y)
+struct ScenePolylineRecord {
+    static constexpr SceneObjectType TYPE = SceneObjectType::Polyline;
+    SceneRecordHeader header;
+    std::uint32_t color;
+    std::uint32_t pointCount;
+};
+
+struct SceneInputFieldRecord {
+    static constexpr SceneObjectType TYPE = SceneObjectType::InputField;
+    SceneRecordHeader header;
+    float width;
+    float height;
+    std::uint32_t fontSize;
+    std::uint32_t reserved;
+};
+
+struct SceneButtonRecord {
+    static constexpr SceneObjectType TYPE = SceneObjectType::Button;
+    SceneRecordHeader header;
+    float width;
+    float height;
+    std::uint32_t text;
+    std::uint32_t fontSize;
+    std::uint32_t color;
+    std::uint32_t textColor;
+    std::uint32_t action;  // Индекс строки или SCENE_NO_INDEX
+    std::uint32_t reserved;
+};
+
+struct SceneHistoryGraphRecord {
+    static constexpr SceneObjectType TYPE = SceneObjectType::HistoryGraph;
+    SceneRecordHeader header;
+    float width;
+    float height;
+    std::uint64_t maxHistory;
+    std::uint32_t lineColor;
+    std::uint32_t gridColor;
+    double timeWindow;  // Секунды (0 - окно по числу значений)
+    double sampleRate;  // Гц (0 - без передискретизации)
+};
+
+struct SceneImageRecord {
+    static constexpr SceneObjectType TYPE = SceneObjectType::Image;
+    SceneRecordHeader header;
+    float width;
+    float height;
+    std::uint32_t path;
+    std::uint32_t reserved;
+};
+
+/**
+ * Собирает бинарную сцену в памяти и записывает ее на диск.
+ * Запись идет во временный файл с последующим переименованием: плеер никогда
+ * не увидит наполовину записанную сцену.
+ */
+class SceneWriter {
+private:
+    SceneFileHeader header;
+    std::vector<SceneStringEntry> stringEntries;
+    std::string stringData;
+    std::unordered_map<std::string, std::uint32_t> stringIndices;
+    std::vector<std::uint32_t> tags;
+    std::unordered_map<std::string, std::uint32_t> tagIndices;
+    std::vector<char> records;
+    std::vector<SceneHistoryPolicyRecord> policies;
+    std::vector<SceneNotifyDeadbandRecord> deadbands;
+
+    void appendRecord(SceneRecordHeader& recordHeader, std::size_t recordSize,
+                      const void* extra, std::size_t extraSize);
+
+public:
+    SceneWriter();
+
+    // Индекс строки в таблице (одинаковые строки хранятся один раз)
+    std::uint32_t intern(const std::string& str);
+
+    // Индекс переменной; пустое имя - SCENE_NO_INDEX (объект не привязан)
+    std::uint32_t tag(const std::string& name);
+
+    void setHistoryCapacity(std::size_t capacity) { header.historyCapacity = capacity; }
+    void setSettings(const PlayerSettings& settings);
+    void addHistoryPolicy(const std::string& tagName, const HistoryPolicy& policy);
+    void addNotifyDeadband(const std::string& tagName, const NotifyDeadband& deadband);
+
+    // Размер и время изменения JSON, из которого собрана сцена
+    void setSource(std::uint64_t size, std::int64_t time);
+
+    // Добавляет запись объекта; поле header заполняется заранее (кроме type и size)
+    template <typename Record>
+    void add(Record& record, const void* extra = nullptr, std::size_t extraSize = 0) {
+        record.header.type = Record::TYPE;
+        appendRecord(record.header, sizeof(Record), extra, extraSize);
+    }
+
+    std::size_t getObjectCount() const { return header.objectCount; }
+
+    bool write(const std::string& path) const;
+};
+
+/**
+ * Скомпилированная сцена, отображенная в память.
+ */
+class BinaryScene {
+private:
+    MappedFile file;
+    const SceneFileHeader* header;
+
+    std::string getString(std::uint32_t index) const;
+
+public:
+    BinaryScene();
+
+    // Отображает файл и проверяет заголовок. Поврежденный или чужой файл - false
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return header != nullptr; }
+
+    // Сцена собрана из текущей версии JSON (совпадают размер и время изменения)
+    bool isUpToDate(const std::string& jsonFile) const;
+
+    std::size_t getObjectCount() const { return header ? header->objectCount : 0; }
+
+    // Переносит сохраненные настройки плеера
+    void readPlayerSettings(PlayerSettings& settings) const;
+
+    // Создает объекты сцены в порядке записей. Емкость истории по умолчанию и политики
+    // истории переменных применяются к db до создания объектов
+    std::vector<std::unique_ptr<VisualObject>> instantiate(VariableDatabase* db, sf::Font* font) const;
+
+    // Путь скомпилированной сцены рядом с JSON: objects.json -> objects.hmiscene
+    static std::string pathFor(const std::string& jsonFile);
+
+    // Размер и время изменения файла для проверки актуальности; false, если файла нет
+    static bool getSourceStamp(const std::string& path, std::uint64_t& size, std::int64_t& time);
+};
+
+#endif
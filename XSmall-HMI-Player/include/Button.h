@@ -3,6 +3,8 @@
 
 #include "VisualObject.h"
 #include "VariableDatabase.h"
+#include "RenderBatch.h"
+#include "TextRun.h"
 #include <SFML/Graphics.hpp>
 #include <functional>
 #include <string>
@@ -13,6 +15,7 @@ private:
     sf::Text text;
     sf::Font* font;
     std::string variableName;
+    TagId tag;
     sf::Color normalColor;
     sf::Color hoverColor;
     sf::Color pressedColor;
@@ -24,6 +27,13 @@ private:
     // Новое поле для идентификации действия
     std::string actionType;
 
+    // Фон, рамка и надпись кнопки в пакете страницы атласа шрифта
+    BatchRange batchRange;
+    TextRun textRun;
+
+    // Меняет цвет фона, в том числе в пакете
+    void setFillColor(const sf::Color& color);
+
 public:
     Button(float x, float y, float width, float height,
            const std::string& buttonText, sf::Font* font, unsigned int fontSize,
@@ -31,11 +41,19 @@ public:
            const std::string& varName = "", std::function<void()> onClickFunc = nullptr,
            const sf::Color& textClr = sf::Color::Black);  
     
-    void draw(sf::RenderWindow& window) override;
+    void draw(sf::RenderTarget& target) override;
     void update() override;
     void handleEvent(const sf::Event& event, sf::RenderWindow& window) override;
+    bool isInteractive() const override { return true; }
+    void setHovered(bool hovered) override;
+
+    void attachToBatch(RenderBatch& batch) override;
+    const sf::Texture* getBatchTexture() const override { return TextRun::getTexture(text); }
+    bool hasOverlay() const override { return !textRun.attached(); }
+    void drawOverlay(sf::RenderTarget& target) override;
+    sf::FloatRect getBounds() const override;
     
-    bool contains(float pointX, float pointY) const;
+    bool contains(float pointX, float pointY) const override;
     void setOnClick(std::function<void()> onClickFunc);
     void setTextColor(const sf::Color& color);
     
@@ -0,0 +1,105 @@
+#ifndef COMPRESSEDHISTORY_H
+#define COMPRESSEDHISTORY_H
+
+#include "HistoryBuffer.h"
+#include <vector>
+#include <deque>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Сжатая история значений переменной.
+ *
+ * Значения хранятся блоками по BLOCK_SAMPLES: первое значение блока целиком, следующие -
+ * XOR с предыдущим (TimeSeriesEncoder, тот же код, что в архиве на диске): повтор значения
+ * занимает 1 бит, медленно меняющееся значение - только биты, отличающиеся от предыдущего.
+ * Самый новый блок не сжат, поэтому запись O(1) без разбора битов; заполненный блок
+ * сжимается один раз.
+ *
+ * Отметки времени сжимаются в том же коде разностью разностей: при записи с постоянным
+ * периодом (передискретизация) отметка занимает 1 бит. Отметка первого значения блока
+ * хранится несжатой - по ней окно времени ищется без разжатия блоков.
+ *
+ * Емкость соблюдается с точностью до блока: самый старый блок вытесняется целиком,
+ * когда без него остается не меньше capacity значений.
+ * Читается история по блокам курсором (Cursor), который разжимает по одному блоку.
+ */
+class CompressedHistory {
+public:
+    static constexpr std::size_t BLOCK_SAMPLES = 128;
+
+private:
+    struct Block {
+        std::vector<std::uint64_t> bits;
+        std::uint32_t count;
+        HistoryClock::time_point firstTime;
+    };
+
+    std::deque<Block> blocks;
+    std::vector<double> tail;  // Самый новый, несжатый блок
+    std::vector<HistoryClock::time_point> tailTimes;
+    HistoryClock::time_point lastSealedTime;  // Отметка последнего значения сжатых блоков
+    std::size_t maxSize;
+    std::size_t sealedSize;    // Значений в сжатых блоках
+    std::uint64_t pushed;      // Номер следующего значения (растет монотонно)
+
+    void seal();
+    static void decode(const Block& block, double* out, HistoryClock::time_point* outTimes);
+
+public:
+    // firstIndex - номер первого записываемого значения (продолжение счетчика другой истории)
+    explicit CompressedHistory(std::size_t capacity, std::uint64_t firstIndex = 0);
+
+    // Без отметки - текущее время. Отметки не убывают (как в HistoryBuffer::push)
+    void push(double value);
+    void push(double value, HistoryClock::time_point time);
+    void setCapacity(std::size_t capacity);
+
+    std::size_t capacity() const { return maxSize; }
+    std::size_t size() const { return sealedSize + tail.size(); }
+
+    // Монотонный счетчик записей и номер самого старого хранимого значения
+    std::uint64_t total() const { return pushed; }
+    std::uint64_t firstIndex() const { return pushed - size(); }
+
+    // Номер первого значения с отметкой не раньше time (total(), если таких нет).
+    // Двоичный поиск по блокам, разжимается не больше одного блока
+    std::uint64_t lowerBound(HistoryClock::time_point time) const;
+
+    // Занятая память в байтах (блоки и несжатый хвост)
+    std::size_t memoryUsage() const;
+
+    void clear();
+
+    /**
+     * Последовательное чтение по блокам, от старых значений к новым.
+     * Действителен до следующей записи в историю.
+     */
+    class Cursor {
+    public:
+        // from - номер первого нужного значения (раньше firstIndex() - с начала истории)
+        Cursor(const CompressedHistory& history, std::uint64_t from);
+
+        // Переходит к следующему блоку. false - значений больше нет
+        bool next();
+
+        const double* data() const { return current; }
+        const HistoryClock::time_point* times() const { return currentTimes; }
+        std::size_t size() const { return currentSize; }
+        std::uint64_t index() const { return currentIndex; }  // Номер значения data()[0]
+
+    private:
+        const CompressedHistory* history;
+        std::size_t block;           // Следующий блок (blocks.size() - хвост)
+        std::uint64_t blockIndex;    // Номер первого значения следующего блока
+        std::uint64_t from;
+        const double* current;
+        const HistoryClock::time_point* currentTimes;
+        std::size_t currentSize;
+        std::uint64_t currentIndex;
+        double scratch[BLOCK_SAMPLES];
+        HistoryClock::time_point scratchTimes[BLOCK_SAMPLES];
+    };
+};
+
+#endif
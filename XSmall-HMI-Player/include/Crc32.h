@@ -0,0 +1,11 @@
+#ifndef CRC32_H
+#define CRC32_H
+
+#include <cstddef>
+#include <cstdint>
+
+// CRC-32 (IEEE 802.3) для проверки записей на диске (журнал, архив истории).
+// crc - результат по предыдущей части данных, если данные считаются по частям
+std::uint32_t crc32(const char* data, std::size_t size, std::uint32_t crc = 0);
+
+#endif
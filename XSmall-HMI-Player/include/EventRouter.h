@@ -0,0 +1,74 @@
+#ifndef EVENTROUTER_H
+#define EVENTROUTER_H
+
+#include "VisualObject.h"
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include <memory>
+#include <cstddef>
+
+/**
+ * Доставка событий ввода объектам сцены по пространственному индексу.
+ *
+ * При загрузке сцены границы интерактивных объектов (VisualObject::isInteractive)
+ * раскладываются по равномерной сетке. Событие мыши проверяет только объекты
+ * своей ячейки, поэтому стоимость доставки не зависит от общего числа объектов:
+ * - нажатие и колесо - верхнему (последнему в порядке отрисовки) объекту под курсором;
+ * - отпускание - объекту, получившему нажатие (даже если курсор ушел с него);
+ * - MouseMoved только запоминает положение курсора, наведение пересчитывается один раз
+ *   в flush() (или перед ближайшим событием кнопки мыши);
+ * - клавиатура и ввод текста - только объекту в фокусе. Фокус получает объект,
+ *   принимающий его (acceptsFocus), по нажатию; нажатие в другом месте фокус снимает.
+ * Положение объектов считается неизменным до следующего build().
+ */
+class EventRouter {
+private:
+    struct Entry {
+        VisualObject* object;
+        std::size_t order;  // Порядок отрисовки: больший - выше
+    };
+
+    float cellSize;
+    sf::Vector2f origin;       // Левый верхний угол сетки (координаты сцены)
+    std::size_t columns;
+    std::size_t rows;
+    std::vector<std::vector<Entry>> cells;
+    std::vector<Entry> unbounded;  // Объекты с границами больше сетки проверяются всегда
+    std::size_t indexedCount;
+
+    VisualObject* hovered;
+    VisualObject* focused;
+    VisualObject* captured;  // Получил нажатие кнопки мыши, ждет отпускания
+
+    bool movePending;        // Есть MouseMoved, не учтенный в наведении
+    sf::Vector2f movePoint;
+
+    void setHoveredObject(VisualObject* object);
+
+public:
+    explicit EventRouter(float cellSize = 64.f);
+
+    // Строит индекс интерактивных объектов заново. Наведение и фокус остаются только
+    // у объектов, которые есть в новом списке
+    void build(const std::vector<std::unique_ptr<VisualObject>>& objects);
+
+    // Доставляет событие адресатам. point - положение курсора в координатах сцены
+    // (для событий мыши; см. getPixelPosition)
+    void route(const sf::Event& event, const sf::Vector2f& point, sf::RenderWindow& window);
+
+    // Учитывает последнее положение курсора после серии MouseMoved (раз в кадр)
+    void flush();
+
+    // Верхний интерактивный объект в точке или nullptr
+    VisualObject* hitTest(const sf::Vector2f& point) const;
+
+    // Положение курсора из события мыши в пикселях окна; false - событие без координат
+    static bool getPixelPosition(const sf::Event& event, sf::Vector2i& pixel);
+
+    VisualObject* getHovered() const { return hovered; }
+    VisualObject* getFocused() const { return focused; }
+    std::size_t getIndexedCount() const { return indexedCount; }
+    std::size_t getCellCount() const { return cells.size(); }
+};
+
+#endif
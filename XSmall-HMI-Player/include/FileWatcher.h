@@ -0,0 +1,49 @@
+#ifndef FILEWATCHER_H
+#define FILEWATCHER_H
+
+#include <string>
+#include <thread>
+#include <atomic>
+#include <functional>
+#include <chrono>
+
+/**
+ * Наблюдение за изменениями одного файла в фоновом потоке.
+ *
+ * На Linux используется inotify на каталоге файла (редакторы часто сохраняют через
+ * временный файл и переименование), на остальных платформах - опрос размера и времени
+ * изменения. Серия событий за короткий интервал (запись по частям) дает один вызов.
+ * Обработчик вызывается в потоке наблюдателя: один раз сразу после запуска
+ * (начальное состояние файла) и затем после каждого изменения.
+ */
+class FileWatcher {
+private:
+    std::string path;
+    std::function<void()> onChange;
+    std::thread thread;
+    std::atomic<bool> running;
+
+    void run();
+    void poll();
+#ifdef __linux__
+    bool watchInotify();
+#endif
+
+public:
+    // Пауза после события, за которую собираются следующие события той же записи
+    static constexpr std::chrono::milliseconds SETTLE_TIME{50};
+    // Период опроса без inotify и проверки флага остановки
+    static constexpr std::chrono::milliseconds POLL_INTERVAL{100};
+
+    explicit FileWatcher(const std::string& path);
+    ~FileWatcher();
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    void start(std::function<void()> handler);
+    void stop();
+    bool isRunning() const { return running.load(); }
+};
+
+#endif
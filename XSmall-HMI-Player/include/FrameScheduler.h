@@ -0,0 +1,84 @@
+#ifndef FRAMESCHEDULER_H
+#define FRAMESCHEDULER_H
+
+#include "TimerWheel.h"
+#include <chrono>
+#include <functional>
+#include <cstdint>
+
+// Частоты главного цикла (задаются в секции "player" файла objects.json)
+struct SchedulerConfig {
+    double renderRate = 60.0;    // Кадров в секунду
+    double tickRate = 60.0;      // Логических тактов в секунду (фиксированный шаг)
+    double inputRate = 240.0;    // Опросов событий ввода в секунду
+    int maxTicksPerFrame = 5;    // Предел догоняющих тактов после задержки
+    int timerResolutionMs = 10;  // Точность колеса таймеров
+};
+
+/**
+ * Планировщик главного цикла с фиксированным шагом.
+ *
+ * Ввод, логика и отрисовка выполняются каждая со своей частотой по собственным срокам,
+ * между сроками поток спит. Логические такты идут с фиксированным шагом: после задержки
+ * пропущенные такты догоняются (не больше maxTicksPerFrame), сроки отрисовки и опроса
+ * ввода не накапливаются. Периодические задачи выполняются колесом таймеров.
+ * В пределах одного момента порядок: ввод, такты, таймеры, отрисовка.
+ * Действие пользователя может запросить кадр вне очереди (requestFrame), чтобы его
+ * результат появился на экране без ожидания следующего срока.
+ */
+class FrameScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit FrameScheduler(const SchedulerConfig& config = SchedulerConfig());
+
+    void setInputHandler(std::function<void()> handler) { inputHandler = std::move(handler); }
+    void setTickHandler(std::function<void()> handler) { tickHandler = std::move(handler); }
+    void setRenderHandler(std::function<void()> handler) { renderHandler = std::move(handler); }
+
+    TimerWheel& getTimers() { return timers; }
+
+    // Просит вывести кадр на ближайшем шаге, не дожидаясь срока (например, после клика).
+    // Следующие кадры идут с обычной частотой уже от этого кадра
+    void requestFrame() { frameRequested = true; }
+
+    // Выполняет всё, срок чего наступил к моменту now. Возвращает ближайший следующий срок
+    Clock::time_point step(Clock::time_point now);
+
+    // Главный цикл: step() и сон до следующего срока, пока running() возвращает true
+    void run(const std::function<bool()>& running);
+
+    // Длительность логического такта (шаг симуляции)
+    Clock::duration getTickInterval() const { return tickInterval; }
+
+    std::uint64_t getTickCount() const { return tickCount; }
+    std::uint64_t getFrameCount() const { return frameCount; }
+    std::uint64_t getInputPollCount() const { return inputPollCount; }
+
+private:
+    SchedulerConfig config;
+    TimerWheel timers;
+
+    Clock::duration inputInterval;
+    Clock::duration tickInterval;
+    Clock::duration renderInterval;
+
+    Clock::time_point nextInput;
+    Clock::time_point nextTick;
+    Clock::time_point nextRender;
+    Clock::time_point lastTimerUpdate;
+    bool started;
+    bool frameRequested;
+
+    std::function<void()> inputHandler;
+    std::function<void()> tickHandler;
+    std::function<void()> renderHandler;
+
+    std::uint64_t tickCount;
+    std::uint64_t frameCount;
+    std::uint64_t inputPollCount;
+
+    static Clock::duration toInterval(double rate);
+};
+
+#endif
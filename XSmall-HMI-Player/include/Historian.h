@@ -0,0 +1,210 @@
+#ifndef HISTORIAN_H
+#define HISTORIAN_H
+
+#include "VariableDatabase.h"
+#include "MappedFile.h"
+#include "TimeSeriesCodec.h"
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <unordered_map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Архив истории на диске: история переменных переживает перезапуск, и тренды после
+ * запуска дозаполняются из него (backfill).
+ *
+ * У каждой переменной свои сегменты <каталог>/<имя>.<номер>.hist: заголовок и куски
+ * [crc32][длина в битах][первая отметка][длительность][число значений][биты].
+ * Кусок - до CHUNK_SAMPLES значений, сжатых TimeSeriesEncoder (XOR значений, разность
+ * разностей отметок). Отметки - миллисекунды Unix-времени, чтобы после перезагрузки
+ * машины они остались на своих местах.
+ *
+ * append() в UI-потоке только дописывает значение в открытый кусок переменной. Раз в
+ * chunkAge новые биты открытого куска уходят в очередь, фоновый поток дописывает их в тот же
+ * кусок на диске и переписывает его заголовок: заголовок и разбор оплачиваются один раз на
+ * CHUNK_SAMPLES значений, а не на каждый период записи. Заполненный кусок закрывается,
+ * следующий начинается в том же сегменте, пока тот меньше segmentBytes; сегменты,
+ * не менявшиеся дольше retention, удаляются.
+ *
+ * crc куска считается по заголовку и битам до его длины: сбой между записью битов и
+ * заголовка оставляет прежний заголовок верным. Куски не сбрасываются на диск fsync:
+ * после отключения питания архив может потерять недописанный кусок. Поврежденный кусок
+ * при чтении отбрасывается по crc, а сегмент, оборванный сбоем, не дописывается -
+ * следующий кусок начинает новый. Кусок, открытый при остановке, после запуска
+ * не продолжается.
+ *
+ * Чтение отображает сегменты в память и находит куски диапазона двоичным поиском по
+ * отметкам, разжимаются только они. Закрытые куски в очереди и открытые куски читаются
+ * из памяти: открытый кусок на диске меняет фоновый поток, и чтение его не касается.
+ */
+class Historian {
+public:
+    static constexpr std::size_t CHUNK_SAMPLES = 1024;
+
+private:
+    // Кусок в очереди на запись: все его слова на момент отправки (отметки - мс Unix-времени).
+    // Закрытый кусок читается из очереди, пока не записан; незакрытый нужен только фоновому потоку
+    struct TagState;
+    struct Chunk {
+        TagState* tag;
+        std::vector<std::uint64_t> words;
+        std::uint64_t bits;
+        std::uint32_t count;
+        std::int64_t firstTime;
+        std::int64_t lastTime;
+        std::size_t fromWord;  // Слова до него уже отправлены на запись и не менялись
+        bool complete;         // Следующее значение начнет новый кусок
+    };
+
+    // Кусок сегмента в индексе чтения; crc проверяется при первом чтении куска
+    enum class ChunkCheck : std::uint8_t { Unchecked, Valid, Damaged };
+    struct ChunkRef {
+        std::int64_t firstTime;
+        std::int64_t lastTime;
+        std::uint64_t offset;
+        std::uint32_t count;
+        ChunkCheck check;
+    };
+
+    // Сегмент, отображенный для чтения; индекс кусков строится по мере роста файла
+    struct SegmentView {
+        std::uint32_t number = 0;
+        MappedFile file;
+        std::vector<ChunkRef> chunks;
+        std::uint64_t indexed = 0;  // Разобрано байт от начала файла
+        bool complete = false;      // Сегмент закрыт и разобран целиком
+        bool broken = false;        // Дальше indexed кусок поврежден
+    };
+
+    struct TagState {
+        std::string name;
+        std::string fileName;  // Имя в каталоге без номера сегмента
+
+        // UI-поток: открытый кусок
+        TimeSeriesEncoder encoder;
+        std::vector<std::uint64_t> words;
+        std::int64_t firstTime = 0;
+        std::int64_t lastTime = 0;
+        std::size_t sentWords = 0;       // Слов открытого куска в очереди на запись
+        bool unsent = false;             // В открытом куске есть значения, не отправленные на запись
+        std::int64_t unsentSince = 0;    // Отметка первого из них
+        std::vector<std::unique_ptr<SegmentView>> views;  // По возрастанию номеров
+
+        // Под mutex: записанная часть архива (закрытые куски)
+        std::uint32_t firstSegment = 0;    // Самый старый сегмент (0 - сегментов нет)
+        std::uint32_t durableSegment = 0;  // Сегмент с последним закрытым куском
+        std::uint64_t durableSize = 0;     // Байт до конца этого куска
+
+        // Фоновый поток: сегмент, куда идет запись (0 - еще не выбран), конец данных в нем
+        // и начало открытого куска (0 - открытого куска на диске нет)
+        std::uint32_t appendSegment = 0;
+        std::uint64_t appendSize = 0;
+        std::uint64_t openOffset = 0;
+        bool appendFailed = false;
+        std::uint32_t closedSegment = 0;  // Конец последнего записанного закрытого куска
+        std::uint64_t closedSize = 0;
+    };
+
+    std::string directory;
+    std::chrono::hours retention;
+    std::size_t segmentBytes;
+    std::int64_t chunkAgeMs;
+    std::int64_t unixOffset;  // Unix-время минус HistoryClock, нс
+
+    // Переменные по имени и по дескриптору подключенной базы (UI-поток)
+    std::unordered_map<std::string, std::unique_ptr<TagState>> tags;
+    std::unordered_map<std::string, std::vector<std::uint32_t>> diskSegments;  // Найденные при открытии
+    VariableDatabase* attachedDb;
+    std::vector<TagState*> byTag;
+
+    std::thread writer;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable idle;
+    std::deque<Chunk> queue;  // Куски остаются в очереди, пока не записаны
+    bool stopping;
+    bool failed;
+    std::uint64_t chunksWritten;
+    std::uint64_t bytesWritten;
+
+    // Фоновый поток
+    void writerLoop();
+    bool writeChunks(TagState& tag, const Chunk* const* chunks, std::size_t count, std::uint64_t& written);
+    void nextSegment(TagState& tag);
+    void removeExpired(TagState& tag);
+
+    TagState* findState(const std::string& name);
+    TagState& state(const std::string& name);
+    void append(TagState& tag, double value, HistoryClock::time_point time);
+
+    // Отправляет новые биты открытого куска на запись; complete - закрыть кусок
+    void send(TagState& tag, bool complete);
+
+    // Доводит индекс сегментов [first, last] до записанной части (lastSize байт последнего)
+    // и возвращает куски, пересекающие [from, to), по возрастанию отметок
+    void collectChunks(TagState& tag, std::uint32_t first, std::uint32_t last, std::uint64_t lastSize,
+                       std::int64_t from, std::int64_t to,
+                       std::vector<std::pair<SegmentView*, std::size_t>>& chunks);
+    bool indexSegment(TagState& tag, SegmentView& view, std::uint64_t limit);
+    static void releaseViews(TagState& tag);
+
+    std::string segmentPath(const TagState& tag, std::uint32_t segment) const;
+    std::int64_t toUnixMs(HistoryClock::time_point time) const;
+    HistoryClock::time_point fromUnixMs(std::int64_t ms) const;
+
+public:
+    // Открывает архив в каталоге (создает его) и удаляет сегменты старше retention
+    explicit Historian(const std::string& directory, std::chrono::hours retention = std::chrono::hours(24 * 7));
+    ~Historian();
+
+    Historian(const Historian&) = delete;
+    Historian& operator=(const Historian&) = delete;
+
+    // Размер сегмента и наибольшее время до записи нового значения (задавать до первой записи)
+    void setSegmentBytes(std::size_t bytes);
+    void setChunkAge(std::chrono::milliseconds age);
+
+    // Пишет в архив каждое значение, которое db сохраняет в историю (UI-поток).
+    // База должна жить, пока архив подключен: деструктор архива отключает ее
+    void attach(VariableDatabase& db);
+
+    // Значение переменной (UI-поток). Отметки одной переменной не убывают
+    void append(const std::string& name, double value, HistoryClock::time_point time);
+
+    // Отправляет на запись значения, ждущие дольше chunkAge к моменту now (таймер UI-потока)
+    void poll(HistoryClock::time_point now);
+
+    // Отправляет на запись все значения и дожидается, пока очередь окажется в файлах.
+    // Открытые куски остаются открытыми
+    void flush();
+
+    // Значения переменной с отметками в [from, to) по возрастанию отметок (UI-поток).
+    // maxCount > 0 - только последние maxCount значений диапазона. Возвращает их число
+    std::size_t query(const std::string& name, HistoryClock::time_point from, HistoryClock::time_point to,
+                      std::vector<double>& values, std::vector<HistoryClock::time_point>& times,
+                      std::size_t maxCount = 0);
+
+    // Заполняет пустую историю переменных db, для которых она ведется, последними значениями
+    // из архива не старше window - не больше емкости истории (запуск плеера, после загрузки
+    // сцены). История, восстановленная из файла состояния, не заменяется. Возвращает число
+    // переменных
+    std::size_t backfill(VariableDatabase& db, HistoryClock::duration window);
+
+    // Закрытых кусков и байт, записанных с открытия архива
+    std::uint64_t getChunksWritten();
+    std::uint64_t getBytesWritten();
+
+    // Размер всех сегментов в каталоге, байт
+    std::uintmax_t getDiskUsage() const;
+
+    const std::string& getDirectory() const { return directory; }
+};
+
+#endif
@@ -0,0 +1,126 @@
+#ifndef HISTORYBUFFER_H
+#define HISTORYBUFFER_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <chrono>
+
+// Емкость истории по умолчанию (если ни один потребитель не запросил больше)
+constexpr std::size_t DEFAULT_HISTORY_CAPACITY = 100;
+
+// Часы отметок времени истории (монотонные: перевод системных часов не ломает тренды)
+using HistoryClock = std::chrono::steady_clock;
+
+/**
+ * Представление истории без копирования: два непрерывных участка кольцевого буфера.
+ * Сначала идут более старые значения (first), затем более новые (second).
+ * Отметки времени лежат в параллельных участках (firstTimes, secondTimes) и не убывают.
+ * Действительно до следующей записи в соответствующий HistoryBuffer.
+ */
+struct HistoryView {
+    const double* first = nullptr;
+    std::size_t firstSize = 0;
+    const double* second = nullptr;
+    std::size_t secondSize = 0;
+    const HistoryClock::time_point* firstTimes = nullptr;
+    const HistoryClock::time_point* secondTimes = nullptr;
+
+    std::size_t size() const { return firstSize + secondSize; }
+    bool empty() const { return size() == 0; }
+
+    double operator[](std::size_t i) const {
+        return i < firstSize ? first[i] : second[i - firstSize];
+    }
+    double front() const { return (*this)[0]; }
+    double back() const { return (*this)[size() - 1]; }
+
+    // Отметка времени i-го значения (без отметок - эпоха часов)
+    HistoryClock::time_point time(std::size_t i) const {
+        if (!firstTimes) {
+            return HistoryClock::time_point();
+        }
+        return i < firstSize ? firstTimes[i] : secondTimes[i - firstSize];
+    }
+
+    // Номер первого значения с отметкой не раньше time (size(), если таких нет).
+    // Двоичный поиск: O(log n) вместо просмотра всей истории
+    std::size_t lowerBound(HistoryClock::time_point time) const;
+
+    // Последние n значений (или вся история, если значений меньше)
+    HistoryView last(std::size_t n) const;
+
+    // Значения с отметкой не раньше time
+    HistoryView since(HistoryClock::time_point time) const { return last(size() - lowerBound(time)); }
+
+    // Итератор для использования со стандартными алгоритмами
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = double;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const double*;
+        using reference = const double&;
+
+        const_iterator(const HistoryView* view, std::size_t index) : view(view), index(index) {}
+
+        reference operator*() const {
+            return index < view->firstSize ? view->first[index] : view->second[index - view->firstSize];
+        }
+        const_iterator& operator++() { ++index; return *this; }
+        const_iterator operator++(int) { const_iterator tmp = *this; ++index; return tmp; }
+        bool operator==(const const_iterator& other) const { return index == other.index; }
+        bool operator!=(const const_iterator& other) const { return index != other.index; }
+
+    private:
+        const HistoryView* view;
+        std::size_t index;
+    };
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, size()); }
+};
+
+/**
+ * Кольцевой буфер истории фиксированной емкости.
+ * Запись O(1) без сдвига данных; память выделяется по мере заполнения.
+ * Каждое значение хранится с отметкой времени (параллельный массив той же емкости).
+ */
+class HistoryBuffer {
+private:
+    std::vector<double> data;
+    std::vector<HistoryClock::time_point> times;
+    std::size_t maxSize;
+    std::size_t head;  // Позиция следующей записи после заполнения буфера
+    std::uint64_t pushed;  // Сколько значений записано за все время
+
+public:
+    explicit HistoryBuffer(std::size_t capacity = DEFAULT_HISTORY_CAPACITY);
+
+    // Добавляет значение с текущим временем, вытесняя самое старое при переполнении
+    void push(double value);
+
+    // То же с явной отметкой. Отметка раньше предыдущей заменяется предыдущей:
+    // отметки истории не убывают, иначе по ним нельзя искать двоичным поиском
+    void push(double value, HistoryClock::time_point time);
+
+    // Меняет емкость, сохраняя самые новые значения
+    void setCapacity(std::size_t capacity);
+
+    std::size_t capacity() const { return maxSize; }
+    std::size_t size() const { return data.size(); }
+
+    // Монотонный счетчик записей: по разнице потребитель узнает, сколько значений новые
+    std::uint64_t total() const { return pushed; }
+
+    // Занятая память в байтах (значения и отметки)
+    std::size_t memoryUsage() const {
+        return data.capacity() * sizeof(double) + times.capacity() * sizeof(HistoryClock::time_point);
+    }
+
+    HistoryView view() const;
+    void clear();
+};
+
+#endif
@@ -3,6 +3,8 @@
 
 #include "VisualObject.h"
 #include "VariableDatabase.h"
+#include "RenderBatch.h"
+#include "TrendCurve.h"
 #include <SFML/Graphics.hpp>
 #include <vector>
 
@@ -11,9 +13,16 @@ private:
     float width, height;
     sf::RectangleShape background;
     std::string variableName;
+    TagId tag;
     size_t maxHistorySize;
     sf::Color lineColor;
     sf::Color gridColor;
+    double timeWindow;  // Окно по времени в секундах (0 - последние maxHistorySize значений)
+    double sampleRate;  // Частота отсчетов истории в Гц (0 - значение на каждую запись)
+    HistoryClock::time_point syncedAt;  // Правый край оси времени, до которого построена кривая
+
+    // Кривая строится инкрементально и прореживается до ~4 точек на пиксель ширины
+    TrendCurve curve;
 
 public:
     HistoryGraph(float x, float y, float width, float height,
@@ -23,12 +32,37 @@ public:
                  const sf::Color& lineClr = sf::Color::Blue,
                  const sf::Color& gridClr = sf::Color(200, 200, 200, 100));
     
-    void draw(sf::RenderWindow& window) override;
+    void draw(sf::RenderTarget& target) override;
     void update() override;
+
+    // Ось времени: показываются последние seconds секунд. При rate > 0 история переменной
+    // записывается отсчетами rate раз в секунду (выборка с удержанием) и вмещает все окно
+    void setTimeWindow(double seconds, double rate = 0.0);
+    double getTimeWindow() const { return timeWindow; }
+    double getSampleRate() const { return sampleRate; }
+
+    // Рамка и сетка статичны и уходят в пакет, кривая рисуется отдельно
+    void attachToBatch(RenderBatch& batch) override;
+    void drawOverlay(sf::RenderTarget& target) override;
+    sf::FloatRect getBounds() const override;
+    bool isStatic() const override { return tag == INVALID_TAG; }
+
+    // Окно по времени сдвигается и без новых значений: кадр нужен, когда сдвиг дорос до пикселя
+    bool needsFrame(HistoryClock::time_point now) const override;
     
 private:
-    void drawGrid(sf::RenderWindow& window);
-    void drawGraph(sf::RenderWindow& window);
+    void drawGrid(sf::RenderTarget& target);
+    void drawGraph(sf::RenderTarget& target);
+
+    // Дописывает в кривую значения, появившиеся в истории с прошлой синхронизации
+    void syncHistory(HistoryClock::time_point now);
+    sf::FloatRect plotArea() const { return sf::FloatRect(x, y, width, height); }
+
+public:
+    // Точки кривой в экранных координатах (для тестов и отладки); now - правый край оси времени
+    std::vector<sf::Vector2f> getCurvePoints();
+    std::vector<sf::Vector2f> getCurvePoints(HistoryClock::time_point now);
+    std::size_t getCurveVertexCount();
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,64 @@
+#ifndef HISTORYROLLUP_H
+#define HISTORYROLLUP_H
+
+#include "HistoryBuffer.h"
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+// Минимум, максимум, сумма и число значений за интервал
+struct HistoryAggregate {
+    double min = 0.0;
+    double max = 0.0;
+    double sum = 0.0;
+    std::uint64_t count = 0;
+
+    double average() const { return count > 0 ? sum / count : 0.0; }
+    void add(double value);
+    void merge(const HistoryAggregate& other);
+};
+
+/**
+ * Пирамида агрегатов истории по времени: интервалы 1 с, 1 мин и 1 ч.
+ *
+ * Каждое значение сразу учитывается на всех уровнях (O(1) на запись). Уровень - кольцо
+ * интервалов фиксированной длины; положение интервала в кольце определяется его номером
+ * (время / длина интервала), поэтому отметки времени не хранятся. Кольцо уровня выделяется
+ * при первой записи.
+ *
+ * Запрос берет самый грубый уровень, интервал которого не длиннее столбца результата:
+ * стоимость запроса не зависит от числа исходных значений и не больше
+ * 60 интервалов уровня на столбец. Часть окна старше хранимой на этом уровне
+ * достраивается следующим, более грубым уровнем.
+ */
+class HistoryRollup {
+public:
+    static constexpr std::size_t LEVEL_COUNT = 3;
+
+    HistoryRollup();
+
+    void add(HistoryClock::time_point time, double value);
+
+    // Агрегаты buckets равных интервалов [from, to). count == 0 - значений за интервал нет
+    std::vector<HistoryAggregate> query(HistoryClock::time_point from, HistoryClock::time_point to,
+                                        std::size_t buckets) const;
+
+    // Уровень, которым будет отвечен запрос со столбцом длины interval
+    static std::size_t selectLevel(HistoryClock::duration interval);
+
+    static HistoryClock::duration getLevelWidth(std::size_t level);
+    static std::size_t getLevelCapacity(std::size_t level);
+
+    std::size_t memoryUsage() const;
+
+private:
+    struct Level {
+        std::vector<HistoryAggregate> buckets;  // Кольцо, позиция - номер интервала % емкость
+        std::int64_t newest;                    // Номер самого нового интервала
+        std::int64_t oldest;                    // Номер самого старого хранимого интервала
+    };
+
+    Level levels[LEVEL_COUNT];
+};
+
+#endif
@@ -4,8 +4,15 @@
 #include <SFML/Graphics.hpp>
 #include <vector>
 #include <memory>
+#include <chrono>
 #include "VariableDatabase.h"  
 #include "VisualObject.h"     
+#include "SceneRenderer.h"
+#include "EventRouter.h"
+#include "PlayerSettings.h"
+#include "SceneReloader.h"
+#include "StateManager.h"
+#include "Historian.h"
 
 /**
  * Управляющий класс приложения. Реализует главный цикл (game loop):
@@ -18,7 +25,26 @@ private:
     sf::RenderWindow window;   // Главное окно
     VariableDatabase database; // База данных переменных
     std::vector<std::unique_ptr<VisualObject>> objects;  // Все визуальные объекты
-    sf::Font font;  // Основной шрифт
+    SceneRenderer sceneRenderer;  // Пакетная отрисовка объектов
+    EventRouter eventRouter;      // Доставка ввода объектам под курсором и в фокусе
+    PlayerSettings settings;      // Частоты главного цикла и периоды задач (из objects.json)
+    std::shared_ptr<sf::Font> font;  // Основной шрифт (из ResourceManager)
+    std::unique_ptr<SceneReloader> sceneReloader;  // Перезагрузка objects.json при изменении
+    StateManager stateManager;    // Снимки значений переменных (пишутся в фоновом потоке)
+    std::unique_ptr<Historian> historian;  // Архив истории на диске (если задан в настройках)
+
+    // Перерисовка по требованию: кадр выводится только после событий ввода
+    // или изменений в базе переменных
+    bool redrawNeeded;
+    std::uint64_t renderedRevision;  // Ревизия базы, соответствующая кадру на экране
+
+    // Замер задержки от ввода до вывода кадра
+    bool inputPending;
+    std::chrono::steady_clock::time_point inputTime;
+
+    // Дескрипторы переменных демо-симуляции (разрешаются один раз)
+    TagId temperatureTag;
+    TagId setpointTag;
     
 public:
     HmiPlayer();
@@ -30,9 +56,16 @@ public:
     void run();
 
     // Методы главного цикла
-    void handleEvents();
+    // Возвращает true, если было действие пользователя (клик, клавиша, ввод текста)
+    bool handleEvents();
     void update();
     void render();
+
+    // Применяет изменения objects.json, подготовленные в фоне. Возвращает true, если сцена изменилась
+    bool reloadScene();
+
+    // Шаг демо-симуляции температуры (периодическая задача)
+    void simulateDemo();
 };
 
 #endif
\ No newline at end of file
@@ -3,24 +3,46 @@
 
 #include "VisualObject.h"
 #include <SFML/Graphics.hpp>
+#include <memory>
 
 class Image : public VisualObject {
 private:
-    sf::Texture texture;
+    // Текстура общая для всех изображений с тем же файлом (ResourceManager);
+    // если изображение упаковано в атлас - страница атласа и участок на ней
+    std::shared_ptr<const sf::Texture> texture;
+    sf::IntRect textureRect;
     sf::Sprite sprite;
     float imgWidth, imgHeight;
     std::string imagePath;
     bool textureLoaded;
 
+    // Заглушка строится один раз; надпись - шрифтом плеера
+    sf::RectangleShape placeholder;
+    std::shared_ptr<sf::Font> placeholderFont;
+    sf::Text placeholderText;
+
+    void buildPlaceholder();
+
 public:
     Image(float x, float y, float width, float height,
           const std::string& path, const std::string& name,
           VariableDatabase* db);
     
-    void draw(sf::RenderWindow& window) override;
+    void draw(sf::RenderTarget& target) override;
+    sf::FloatRect getBounds() const override;
+    bool isStatic() const override { return true; }
+
+    // Спрайт - прямоугольник в пакете своей текстуры: изображения одного атласа рисуются
+    // одним вызовом. Заглушка - в нетекстурированном пакете, надпись поверх
+    void attachToBatch(RenderBatch& batch) override;
+    const sf::Texture* getBatchTexture() const override { return textureLoaded ? texture.get() : nullptr; }
+    bool hasOverlay() const override { return !textureLoaded && placeholderFont != nullptr; }
+    void drawOverlay(sf::RenderTarget& target) override;
     void update() override {};
     
     bool loadTexture(const std::string& path);
+    bool isLoaded() const { return textureLoaded; }
+    const sf::Texture* getTexture() const { return texture.get(); }
 };
 
-#endif
\ No newline at end of file
+#endif
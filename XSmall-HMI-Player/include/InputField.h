@@ -3,6 +3,9 @@
 
 #include "VisualObject.h"
 #include "VariableDatabase.h"
+#include "RenderBatch.h"
+#include "NumberFormat.h"
+#include "TextRun.h"
 #include <SFML/Graphics.hpp>
 
 class InputField : public VisualObject {
@@ -11,21 +14,44 @@ private:
     sf::Text text;
     sf::Font* font;
     std::string variableName;
+    TagId tag;
     bool isActive;
     std::string inputText;
 
+    NumberFormat valueFormat;  // Вывод значения переменной (6 знаков, как std::to_string)
+    std::string formatted;     // Буфер форматирования, переиспользуется между обновлениями
+
+    // Фон, рамка и текст поля в пакете страницы атласа шрифта
+    BatchRange batchRange;
+    TextRun textRun;
+
+    // Переписывает вершины фона и рамки (рамка меняется при активации)
+    void writeBatchGeometry();
+
+    // Меняет отображаемую строку, в том числе в пакете
+    void setDisplayedText(const std::string& str);
+
 public:
     InputField(float x, float y, float width, float height,
                sf::Font* font, unsigned int fontSize,
                const std::string& name, VariableDatabase* db,
                const std::string& varName = "");
     
-    void draw(sf::RenderWindow& window) override;
+    void draw(sf::RenderTarget& target) override;
     void update() override;
     void handleEvent(const sf::Event& event, sf::RenderWindow& window) override;
+    bool isInteractive() const override { return true; }
+    bool acceptsFocus() const override { return true; }
+    void setFocused(bool focused) override;
+
+    void attachToBatch(RenderBatch& batch) override;
+    const sf::Texture* getBatchTexture() const override { return TextRun::getTexture(text); }
+    bool hasOverlay() const override { return !textRun.attached(); }
+    void drawOverlay(sf::RenderTarget& target) override;
+    sf::FloatRect getBounds() const override;
     
     void setActive(bool active);
-    bool contains(float pointX, float pointY) const;
+    bool contains(float pointX, float pointY) const override;
 };
 
 #endif
\ No newline at end of file
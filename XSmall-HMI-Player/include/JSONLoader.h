@@ -4,8 +4,11 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <utility>
 #include "VariableDatabase.h"
 #include "VisualObject.h"
+#include "PlayerSettings.h"
+#include "WidgetRegistry.h"
 
 // Простое объявление - заголовок будет скачан отдельно
 #include <nlohmann/json.hpp>
@@ -14,6 +17,8 @@ namespace sf {
     class Font;
 }
 
+class SceneWriter;
+
 class JSONLoader {
 public:
     // Загружает объекты из JSON файла
@@ -22,18 +27,63 @@ public:
         VariableDatabase* db,
         sf::Font* font);
     
+    // Читает секцию "player" (частоты главного цикла, периоды задач).
+    // Возвращает false, если файл не удалось прочитать
+    static bool loadPlayerSettings(const std::string& filename, PlayerSettings& settings);
+
+    // Компилирует JSON в бинарную сцену (см. BinaryScene): настройки плеера, емкость истории
+    // и объекты с уже примененными значениями по умолчанию. Возвращает false при ошибке
+    static bool compileScene(const std::string& jsonFile, const std::string& sceneFile);
+
     // Создает демо-сцену и сохраняет в JSON
     static bool createDemoConfig(const std::string& filename);
-    
-private:
-    // Создает объект из JSON
+
+    // Создает объект из JSON фабрикой WidgetRegistry (nullptr для неизвестного типа)
     static std::unique_ptr<VisualObject> createObject(
         const nlohmann::json& objJson,
         VariableDatabase* db,
         sf::Font* font);
+
+    // Политики истории из секции "tags": {"имя": {"history": {"capacity": 3600,
+    // "deadband": 0.1, "swingingDoor": 0.05, "compression": true, "persist": true}}};
+    // "history": true - политика по умолчанию. Переменные без секции пишут историю,
+    // только если у них есть потребитель
+    static std::vector<std::pair<std::string, HistoryPolicy>> readHistoryPolicies(const nlohmann::json& root);
+
+    // Читает политику одной переменной; false - история для нее в конфигурации не включена
+    static bool readHistoryPolicy(const nlohmann::json& tagJson, HistoryPolicy& policy);
+
+    // Зоны нечувствительности уведомлений из секции "tags": "deadband": 0.5 (абсолютная)
+    // или "deadband": {"absolute": 0.5, "percent": 1, "range": [0, 150]}
+    static std::vector<std::pair<std::string, NotifyDeadband>> readNotifyDeadbands(const nlohmann::json& root);
+
+    // Читает зону одной переменной; false - зона не задана
+    static bool readNotifyDeadband(const nlohmann::json& tagJson, NotifyDeadband& deadband);
+
+    // Цвет из массива [r, g, b] или [r, g, b, a]; иначе белый
+    static sf::Color jsonToColor(const nlohmann::json& colorJson);
+    
+private:
+    // Объект сцены, разобранный в пуле потоков; тип уже найден в реестре
+    struct ParsedObject {
+        nlohmann::json json;
+        WidgetTypeId type = INVALID_WIDGET_TYPE;
+    };
+
+    // Читает файл сцены: файл отображается в память и делится JsonScanner на объекты,
+    // которые разбираются параллельно в ThreadPool. Остальные члены верхнего уровня
+    // попадают в root. Порядок объектов - как в файле. false - файл не прочитан
+    static bool parseFile(const std::string& filename, nlohmann::json& root,
+                          std::vector<ParsedObject>& objects);
+
+    // Добавляет объект в бинарную сцену (те же поля и значения по умолчанию, что у встроенных
+    // фабрик WidgetRegistry). false - у типа нет бинарной записи
+    static bool compileObject(const nlohmann::json& objJson, SceneWriter& writer);
+
+    // Применяет секцию "player" к настройкам
+    static void readPlayerSettings(const nlohmann::json& j, PlayerSettings& settings);
     
     // Вспомогательные функции
-    static sf::Color jsonToColor(const nlohmann::json& colorJson);
     static nlohmann::json colorToJson(const sf::Color& color);
 };
 
@@ -0,0 +1,45 @@
+#ifndef JSONSCANNER_H
+#define JSONSCANNER_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+// Участок исходного текста JSON (данные не копируются)
+struct JsonSlice {
+    const char* data;
+    std::size_t size;
+
+    std::string str() const { return std::string(data, size); }
+};
+
+/**
+ * Потоковый разбор структуры JSON без построения дерева.
+ *
+ * За один проход по тексту находит границы членов объекта или элементов массива:
+ * строки с экранированием и парность скобок учитываются, значения не разбираются.
+ * Большой файл так делится на независимые участки (объекты сцены), которые затем
+ * разбираются параллельно. Содержимое участков проверяет уже их разбор.
+ */
+class JsonScanner {
+public:
+    struct Member {
+        std::string key;
+        JsonSlice value;
+    };
+
+    // Члены объекта верхнего уровня в порядке файла. false - нарушена структура
+    static bool scanObject(JsonSlice text, std::vector<Member>& members);
+
+    // Элементы массива в порядке файла. false - нарушена структура
+    static bool scanArray(JsonSlice text, std::vector<JsonSlice>& elements);
+
+private:
+    static const char* skipSpace(const char* p, const char* end);
+
+    // Позиция после строки или значения; nullptr - нарушена структура
+    static const char* skipString(const char* p, const char* end);
+    static const char* skipValue(const char* p, const char* end);
+};
+
+#endif
@@ -2,6 +2,7 @@
 #define LINE_H
 
 #include "VisualObject.h"
+#include "RenderBatch.h"
 #include <SFML/Graphics.hpp>
 
 class Line : public VisualObject {
@@ -14,8 +15,13 @@ public:
          const sf::Color& color, const std::string& name,
          VariableDatabase* db);
     
-    void draw(sf::RenderWindow& window) override;
+    void draw(sf::RenderTarget& target) override;
     void update() override {};
+
+    void attachToBatch(RenderBatch& batch) override;
+    bool hasOverlay() const override { return false; }
+    bool isStatic() const override { return true; }
+    sf::FloatRect getBounds() const override;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,36 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <string>
+#include <cstddef>
+
+/**
+ * Файл, отображенный в память только для чтения (mmap / CreateFileMapping).
+ * Страницы читаются с диска по мере обращения, без копирования в буфер процесса.
+ */
+class MappedFile {
+private:
+    const char* data;
+    std::size_t size;
+#ifdef _WIN32
+    void* fileHandle;
+    void* mappingHandle;
+#endif
+
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Отображает файл целиком. Пустой или недоступный файл - false
+    bool open(const std::string& path);
+    void close();
+
+    bool isOpen() const { return data != nullptr; }
+    const char* getData() const { return data; }
+    std::size_t getSize() const { return size; }
+};
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef NUMBERFORMAT_H
+#define NUMBERFORMAT_H
+
+#include <string>
+#include <cstddef>
+
+/**
+ * Шаблон вывода числа (поле "format" у Text), разобранный один раз при создании объекта.
+ *
+ * Поддерживается один спецификатор в стиле printf: %[-][0][ширина][.точность]f или %d,
+ * текст до и после него (например, единицы измерения) и %% для знака процента:
+ *   "Temperature: %.1f °C", "%8.3f", "%05d %%".
+ * Совместимость с прежним форматированием:
+ *   - %f без точности - один знак после запятой;
+ *   - шаблон без спецификатора - префикс, за ним значение с 6 знаками (как std::to_string);
+ *   - пустой шаблон - только значение с 6 знаками.
+ *
+ * format() пишет результат через std::to_chars без промежуточных строк и потоков;
+ * емкость выходной строки переиспользуется, поэтому в установившемся режиме память не выделяется.
+ */
+class NumberFormat {
+private:
+    std::string prefix;
+    std::string suffix;
+    int precision;
+    int width;
+    bool leftAlign;
+    bool zeroPad;
+
+public:
+    // Значение с 6 знаками после запятой, без текста вокруг
+    NumberFormat();
+    explicit NumberFormat(const std::string& pattern);
+
+    // Записывает значение по шаблону в out (прежнее содержимое заменяется)
+    void format(double value, std::string& out) const;
+    std::string format(double value) const;
+
+    int getPrecision() const { return precision; }
+};
+
+#endif
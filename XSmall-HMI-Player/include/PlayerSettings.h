@@ -0,0 +1,23 @@
+#ifndef PLAYERSETTINGS_H
+#define PLAYERSETTINGS_H
+
+#include "FrameScheduler.h"
+#include <string>
+#include <vector>
+
+/**
+ * Настройки плеера из секции "player" файла objects.json.
+ * Отсутствующие ключи сохраняют значения по умолчанию.
+ */
+struct PlayerSettings {
+    SchedulerConfig scheduler;      // Частоты ввода, логики и отрисовки
+    int autosaveIntervalMs = 30000; // Период автосохранения состояния
+    int demoIntervalMs = 200;       // Шаг демо-симуляции температуры
+    std::string atlasCacheDir;      // Каталог кэша атласа изображений (пустой - без кэша)
+    std::vector<std::string> stateTags;  // Переменные сохраняемого состояния (пусто - все)
+    std::string historianDir;       // Каталог архива истории на диске (пустой - без архива)
+    int historianRetentionDays = 7; // Срок хранения архива
+    int historianChunkSeconds = 60; // Период записи в архив: столько теряется при сбое питания
+};
+
+#endif
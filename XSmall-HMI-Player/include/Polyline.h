@@ -3,6 +3,7 @@
 
 #include "VisualObject.h"
 #include "VariableDatabase.h"
+#include "TrendCurve.h"
 #include <SFML/Graphics.hpp>
 #include <vector>
 
@@ -11,13 +12,20 @@ private:
     std::vector<sf::Vertex> points;
     sf::Color color;
     std::string variableName;
+    TagId tag;
+
+    // Ломаная, привязанная к истории: тренд в области 400x200 от (20, 220)
+    TrendCurve trend;
+    static sf::FloatRect trendArea() { return sf::FloatRect(20, 220, 400, 200); }
 
 public:
     Polyline(const std::vector<sf::Vector2f>& points, 
              const sf::Color& color, const std::string& name,
              VariableDatabase* db, const std::string& varName = "");
     
-    void draw(sf::RenderWindow& window) override;
+    void draw(sf::RenderTarget& target) override;
+    sf::FloatRect getBounds() const override;
+    bool isStatic() const override { return tag == INVALID_TAG; }
     void update() override;
     void updatePoints(const std::vector<sf::Vector2f>& newPoints);
 };
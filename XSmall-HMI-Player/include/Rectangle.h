@@ -3,6 +3,7 @@
 
 #include "VisualObject.h"
 #include "VariableDatabase.h"
+#include "RenderBatch.h"
 #include <SFML/Graphics.hpp>
 
 /**
@@ -15,6 +16,7 @@ private:
     sf::RectangleShape shape;
     sf::Color defaultColor;   // Цвет по умолчанию
     std::string variableName; // Имя связанной переменной
+    TagId tag;                // Дескриптор переменной (разрешается при создании)
     
     // Условия изменения цвета: значение -> цвет
     struct ColorCondition {
@@ -23,14 +25,21 @@ private:
     };
     std::vector<ColorCondition> conditions;
 
+    BatchRange batchRange;    // Вершины прямоугольника в общем пакете
+
 public:
     Rectangle(float x, float y, float width, float height, 
               const sf::Color& color, const std::string& name,
               VariableDatabase* db, const std::string& varName = "");
     
-    void draw(sf::RenderWindow& window) override;
+    void draw(sf::RenderTarget& target) override;
     void update() override;
 
+    void attachToBatch(RenderBatch& batch) override;
+    bool hasOverlay() const override { return false; }
+    bool isStatic() const override { return tag == INVALID_TAG; }
+    sf::FloatRect getBounds() const override;
+
     // Добавляет условие: при значении `value` прямоугольник окрашивается в `color`
     void addCondition(double value, const sf::Color& color);
 };
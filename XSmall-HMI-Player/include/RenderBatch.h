@@ -0,0 +1,81 @@
+#ifndef RENDERBATCH_H
+#define RENDERBATCH_H
+
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include <cstddef>
+
+class RenderBatch;
+
+/**
+ * Участок вершин, выделенный объекту в общем пакете.
+ * Объект хранит его у себя и при изменении цвета/геометрии переписывает только свои вершины.
+ */
+struct BatchRange {
+    RenderBatch* batch = nullptr;
+    std::size_t offset = 0;
+    std::size_t count = 0;
+
+    bool attached() const { return batch != nullptr; }
+};
+
+/**
+ * Пакет геометрии: все примитивы хранятся треугольниками в одном массиве вершин
+ * и рисуются одним вызовом draw. Пакет либо нетекстурированный, либо весь рисуется
+ * с одной текстурой (например, страницей атласа).
+ * Если видеокарта поддерживает VBO, вершины лежат в sf::VertexBuffer
+ * и догружаются только изменившимся диапазоном.
+ */
+class RenderBatch {
+private:
+    std::vector<sf::Vertex> vertices;
+    const sf::Texture* texture;
+    sf::VertexBuffer buffer;
+    bool useBuffer;
+
+    // Диапазон вершин, измененных после последней отрисовки
+    std::size_t dirtyBegin;
+    std::size_t dirtyEnd;
+
+public:
+    // Вершин на один прямоугольник (два треугольника)
+    static constexpr std::size_t QUAD_VERTICES = 6;
+    // Вершин на рамку прямоугольника (четыре полосы)
+    static constexpr std::size_t OUTLINE_VERTICES = 4 * QUAD_VERTICES;
+
+    explicit RenderBatch(const sf::Texture* texture = nullptr);
+
+    // Выделяет объекту count вершин в конце пакета
+    BatchRange allocate(std::size_t count);
+
+    // Доступ к вершинам участка для записи; после изменения нужно вызвать markDirty()
+    sf::Vertex* data(const BatchRange& range) { return vertices.data() + range.offset; }
+    void markDirty(const BatchRange& range);
+
+    void draw(sf::RenderTarget& target);
+
+    std::size_t getVertexCount() const { return vertices.size(); }
+    const sf::Vertex& getVertex(std::size_t index) const { return vertices[index]; }
+    bool empty() const { return vertices.empty(); }
+    const sf::Texture* getTexture() const { return texture; }
+
+    // Запись примитивов в вершины участка (все возвращают указатель за последней вершиной)
+    static sf::Vertex* writeQuad(sf::Vertex* out, const sf::FloatRect& rect, const sf::Color& color);
+    // Прямоугольник с участком текстуры textureRect (в пикселях текстуры)
+    static sf::Vertex* writeTexturedQuad(sf::Vertex* out, const sf::FloatRect& rect,
+                                         const sf::IntRect& textureRect, const sf::Color& color = sf::Color::White);
+    // Рамка снаружи прямоугольника, как у sf::Shape с положительной толщиной контура
+    static sf::Vertex* writeOutline(sf::Vertex* out, const sf::FloatRect& rect,
+                                    float thickness, const sf::Color& color);
+    // Линия толщиной 1px (вместо sf::Lines, которые нельзя смешивать с треугольниками)
+    static sf::Vertex* writeLine(sf::Vertex* out, const sf::Vector2f& from, const sf::Vector2f& to,
+                                 const sf::Color& color);
+
+    // Перекрашивает count вершин, начиная с out
+    static void setColor(sf::Vertex* out, std::size_t count, const sf::Color& color);
+
+    // Задает всем count вершинам одну точку текстуры (сплошная заливка в текстурированном пакете)
+    static void setTexCoords(sf::Vertex* out, std::size_t count, const sf::Vector2f& texCoords);
+};
+
+#endif
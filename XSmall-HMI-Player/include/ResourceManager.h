@@ -0,0 +1,90 @@
+#ifndef RESOURCEMANAGER_H
+#define RESOURCEMANAGER_H
+
+#include "TextureAtlas.h"
+#include <SFML/Graphics.hpp>
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <cstddef>
+
+/**
+ * Общий кэш текстур и шрифтов.
+ *
+ * Ресурс загружается один раз на разрешенный путь: владельцы держат shared_ptr,
+ * кэш - только weak_ptr, поэтому ресурс выгружается, когда его перестают использовать.
+ * Относительные пути ищутся по единому списку корней ("", "../", "../../" и добавленным),
+ * результат поиска запоминается.
+ * Изображения сцены можно заранее упаковать в атлас (buildAtlas): тогда getTextureRegion
+ * отдает страницу атласа и прямоугольник изображения на ней.
+ * Потокобезопасен: объекты сцены можно создавать из нескольких потоков.
+ */
+
+// Изображение для отрисовки: текстура (отдельная или страница атласа) и участок на ней
+struct TextureRegion {
+    std::shared_ptr<const sf::Texture> texture;
+    sf::IntRect rect;
+
+    explicit operator bool() const { return texture != nullptr; }
+};
+
+class ResourceManager {
+private:
+    mutable std::mutex mutex;
+    std::vector<std::string> searchPaths;
+    std::unordered_map<std::string, std::string> resolved;  // Путь -> найденный файл ("" - не найден)
+    std::unordered_map<std::string, std::weak_ptr<const sf::Texture>> textures;
+    std::unordered_map<std::string, std::weak_ptr<sf::Font>> fonts;
+    std::shared_ptr<sf::Font> defaultFont;
+    std::shared_ptr<TextureAtlas> atlas;
+    std::string atlasCacheDir;
+    std::size_t loadCount;  // Сколько раз файлы реально читались с диска
+
+    std::string resolveLocked(const std::string& path);
+    std::shared_ptr<const sf::Texture> getTextureLocked(const std::string& file);
+
+public:
+    ResourceManager();
+
+    ResourceManager(const ResourceManager&) = delete;
+    ResourceManager& operator=(const ResourceManager&) = delete;
+
+    // Общий экземпляр плеера
+    static ResourceManager& instance();
+
+    // Добавляет корень поиска относительных путей (проверяется после стандартных)
+    void addSearchPath(const std::string& root);
+
+    // Нормализованный путь к существующему файлу или пустая строка
+    std::string resolvePath(const std::string& path);
+
+    // nullptr, если файл не найден или не загрузился
+    std::shared_ptr<const sf::Texture> getTexture(const std::string& path);
+
+    // Участок атласа, если изображение упаковано, иначе отдельная текстура целиком
+    TextureRegion getTextureRegion(const std::string& path);
+
+    // Упаковывает изображения в атлас (заменяет предыдущий; уже выданные участки остаются
+    // действительными, пока ими пользуются). Возвращает число упакованных изображений
+    std::size_t buildAtlas(const std::vector<std::string>& paths);
+
+    // Каталог кэша атласа на диске (пустая строка - не кэшировать)
+    void setAtlasCacheDir(const std::string& dir);
+
+    // Шрифт не константный: объекты сцены принимают sf::Font*
+    std::shared_ptr<sf::Font> getFont(const std::string& path);
+
+    // Шрифт плеера: заглушки и служебные надписи используют его, а не загружают свой
+    void setDefaultFont(std::shared_ptr<sf::Font> font);
+    std::shared_ptr<sf::Font> getDefaultFont() const;
+
+    // Статистика для тестов и замеров
+    std::size_t getLoadCount() const;
+    std::size_t getTextureCount() const;  // Текстур, которые сейчас используются
+    std::size_t getFontCount() const;
+    std::size_t getAtlasPageCount() const;
+};
+
+#endif
@@ -0,0 +1,103 @@
+#ifndef SCENERELOADER_H
+#define SCENERELOADER_H
+
+#include "FileWatcher.h"
+#include "VariableDatabase.h"
+#include "VisualObject.h"
+#include <nlohmann/json.hpp>
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <unordered_map>
+#include <utility>
+#include <cstddef>
+
+namespace sf {
+    class Font;
+}
+
+// Изменения сцены между двумя версиями objects.json
+struct ScenePatch {
+    std::vector<std::string> order;                            // Ключи всех объектов в порядке файла
+    std::unordered_map<std::string, nlohmann::json> created;   // Новые и измененные объекты
+    std::size_t added = 0;
+    std::size_t changed = 0;
+    std::size_t removed = 0;
+    bool hasHistoryCapacity = false;
+    std::size_t historyCapacity = 0;
+    std::vector<std::pair<std::string, HistoryPolicy>> historyPolicies;  // Новые и измененные политики
+    std::vector<std::pair<std::string, NotifyDeadband>> notifyDeadbands; // Новые, измененные и снятые зоны
+
+    bool empty() const {
+        return added == 0 && changed == 0 && removed == 0 && !hasHistoryCapacity && historyPolicies.empty() &&
+               notifyDeadbands.empty();
+    }
+};
+
+// Разобранная версия objects.json: описания объектов по ключам
+struct SceneSnapshot {
+    std::unordered_map<std::string, nlohmann::json> objects;
+    nlohmann::json historyCapacity;
+    nlohmann::json tags;  // Секция "tags" (политики истории и зоны нечувствительности)
+};
+
+/**
+ * Перезагрузка objects.json без перезапуска плеера.
+ *
+ * Фоновый поток следит за файлом (FileWatcher), разбирает новую версию и сравнивает
+ * объекты с предыдущей по имени: неизмененные объекты остаются как есть, вместе
+ * с состоянием (текст поля ввода, наведение, фокус). В UI-потоке applyPatch создает
+ * только добавленные и измененные объекты; VariableDatabase (значения, история,
+ * подписки оставшихся объектов) не пересоздается.
+ * Объекты с одинаковыми именами различаются по порядковому номеру среди одноименных.
+ */
+class SceneReloader {
+private:
+    std::string configFile;
+    FileWatcher watcher;
+
+    // Последняя разобранная версия (поток наблюдателя)
+    SceneSnapshot baseline;
+    bool hasBaseline;
+
+    // Изменения, ожидающие применения в UI-потоке
+    std::mutex mutex;
+    std::vector<ScenePatch> pending;
+    std::atomic<bool> pendingFlag;
+
+    void onFileChanged();
+
+    static std::string makeKey(const std::string& name, std::size_t occurrence);
+
+public:
+    explicit SceneReloader(const std::string& configFile);
+
+    // Запускает наблюдение. Начальная версия файла разбирается в фоне и служит
+    // точкой отсчета - изменения до ее чтения не отслеживаются
+    void start();
+    void stop();
+
+    // Есть изменения, которые еще не забрал UI-поток (без блокировки)
+    bool hasPending() const { return pendingFlag.load(std::memory_order_acquire); }
+
+    // Забирает накопленные изменения в порядке их появления
+    std::vector<ScenePatch> takePending();
+
+    // Ключи объектов сцены (имя и порядковый номер среди одноименных)
+    static std::vector<std::string> objectKeys(const nlohmann::json& objects);
+
+    // Сравнивает новую версию файла с предыдущей и обновляет ее
+    static ScenePatch diff(SceneSnapshot& previous, const nlohmann::json& scene);
+
+    // Применяет изменения к списку объектов (UI-поток). Созданные объекты синхронизируются
+    // с переменными; удаленные переносятся в removed, а не уничтожаются сразу: вызывающий
+    // освобождает их после перестроения SceneRenderer и EventRouter
+    static void applyPatch(const ScenePatch& patch,
+                           std::vector<std::unique_ptr<VisualObject>>& objects,
+                           VariableDatabase* db, sf::Font* font,
+                           std::vector<std::unique_ptr<VisualObject>>& removed);
+};
+
+#endif
@@ -0,0 +1,85 @@
+#ifndef SCENERENDERER_H
+#define SCENERENDERER_H
+
+#include "RenderBatch.h"
+#include "VisualObject.h"
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include <memory>
+
+/**
+ * Отрисовка сцены пакетами (retained mode).
+ *
+ * При построении объекты обходятся в порядке отрисовки: нетекстурированная геометрия
+ * (фон, рамки, линии) записывается в общий пакет, спрайты - в пакет своей текстуры
+ * (страницы атласа), надписи вместе с фоном кнопок и полей - в пакет страницы атласа
+ * шрифта (см. TextRun), а то, что в пакет не попадает (кривые графиков), рисуется
+ * поверх пакетов в исходном порядке.
+ * Новая группа пакетов начинается только там, где геометрия объекта перекрывает уже отложенный
+ * поверх пакетов объект, а новый пакет с той же текстурой - там, где объект перекрыл бы
+ * более поздний пакет с другой текстурой. Иначе порядок наложения не изменится.
+ *
+ * Статические объекты (см. VisualObject::isStatic) рисуются один раз в текстуру
+ * статического слоя, и каждый кадр выводится только эта текстура и динамический слой.
+ * Статический объект, лежащий поверх динамического, остается в динамическом слое.
+ */
+class SceneRenderer {
+private:
+    // Шаг кадра: пакет геометрии или отдельная отрисовка объекта
+    struct Step {
+        RenderBatch* batch;
+        VisualObject* object;
+    };
+
+    struct Layer {
+        std::vector<std::unique_ptr<RenderBatch>> batches;
+        std::vector<Step> steps;
+        std::size_t objectCount = 0;
+    };
+
+    Layer staticLayer;
+    Layer dynamicLayer;
+
+    sf::RenderTexture staticTexture;
+    sf::Color background;
+    bool staticTextureValid;   // Текстура содержит актуальный статический слой
+    bool staticCacheAvailable; // Текстуру удалось создать (иначе статический слой рисуется каждый кадр)
+
+    static void buildLayer(Layer& layer, const std::vector<VisualObject*>& objects);
+    static void drawLayer(const Layer& layer, sf::RenderTarget& target);
+
+    // Перерисовывает статический слой в текстуру размером с видимую область target
+    bool renderStaticLayer(const sf::RenderTarget& target);
+
+public:
+    SceneRenderer();
+
+    // Раскладывает объекты по слоям и пакетам (заново, с нуля). Объекты ссылаются на свои участки
+    // в пакетах, поэтому после замены набора объектов build нужно вызвать снова
+    void build(const std::vector<std::unique_ptr<VisualObject>>& objects);
+
+    // Рисует кадр целиком, включая фон
+    void draw(sf::RenderTarget& target);
+
+    // Какому-то объекту динамического слоя нужен кадр и без изменений в базе (см. VisualObject::needsFrame)
+    bool needsFrame(HistoryClock::time_point now) const;
+
+    // Цвет фона сцены (статический слой непрозрачен и закрывает весь кадр)
+    void setBackground(const sf::Color& color);
+
+    // Статический слой будет перерисован в следующем кадре (например, после изменения размера окна)
+    void invalidateStaticLayer() { staticTextureValid = false; }
+
+    std::size_t getBatchCount() const { return staticLayer.batches.size() + dynamicLayer.batches.size(); }
+
+    // Пакеты нумеруются подряд: сначала статического слоя, затем динамического
+    const RenderBatch& getBatch(std::size_t index) const;
+
+    // Число вызовов draw при полной перерисовке (без учета вызовов внутри самих объектов)
+    std::size_t getStepCount() const { return staticLayer.steps.size() + dynamicLayer.steps.size(); }
+
+    std::size_t getStaticObjectCount() const { return staticLayer.objectCount; }
+    std::size_t getDynamicObjectCount() const { return dynamicLayer.objectCount; }
+};
+
+#endif
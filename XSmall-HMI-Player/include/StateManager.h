@@ -1,143 +1,94 @@
 #ifndef STATEMANAGER_H
 #define STATEMANAGER_H
 
-#include <logger.h>
 #include "VariableDatabase.h"
+#include "WriteAheadLog.h"
 #include <string>
-#include <fstream>
-#include <iomanip>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 #include <ctime>
 
 /**
- * Сохраняет и загружает состояние системы в формате JSON.
- * Автоматически вызывается из HmiPlayer при запуске и закрытии.
+ * Сохраняет и загружает состояние системы (значения переменных) в формате JSON.
+ *
+ * saveState в UI-потоке только снимает копию значений (дескриптор и число на переменную),
+ * разбор в JSON и запись идут в фоновом потоке: файл пишется во временный, сбрасывается
+ * на диск (fsync) и атомарно заменяет прежний - при сбое остается старый или новый
+ * снимок целиком. Если предыдущий снимок еще пишется, новый ждет очереди, а
+ * накопившиеся снимки схлопываются в последний.
+ * Сохраняются все переменные, которым присваивалось значение, или заданный список,
+ * и история переменных с политикой persist (отметки - в миллисекундах Unix-времени).
+ * База должна жить, пока идет запись: деструктор дожидается ее завершения.
+ *
+ * С журналом (enableJournal) каждое значение, введенное оператором, дописывается в WAL
+ * рядом с файлом состояния. Снимок запоминает номер последней вошедшей в него записи
+ * журнала; после надежной записи снимка старые сегменты удаляются. loadState применяет
+ * снимок, затем записи журнала с большими номерами.
  */
 class StateManager {
 private:
+    // Копия значений на момент сохранения
+    struct Snapshot {
+        const VariableDatabase* db;  // Имена переменных читаются в фоновом потоке
+        std::vector<TagId> tags;
+        std::vector<double> values;
+        std::vector<TagId> historyTags;
+        std::vector<std::vector<double>> historyValues;
+        std::vector<std::vector<std::int64_t>> historyTimes;  // Миллисекунды Unix-времени
+        std::time_t time;
+        std::uint64_t walSequence;  // Последняя запись журнала, вошедшая в снимок
+        std::uint32_t walSegment;   // Сегменты до этого номера не нужны после записи снимка
+    };
+
     std::string filename;
+    std::vector<TagId> configuredTags;  // Пусто - все переменные
+
+    std::unique_ptr<WriteAheadLog> journal;
+    VariableDatabase* journalDb;
+
+    std::thread writer;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable idle;
+    std::unique_ptr<Snapshot> pending;
+    bool writing;
+    bool stopping;
+
+    void writerLoop();
+    bool writeSnapshot(const Snapshot& snapshot);
+    bool loadSnapshot(VariableDatabase& db, std::uint64_t& walSequence);
 
 public:
-    StateManager(const std::string& file = "../saved_state.json") : filename(file) {}
-    
-     // Сохраняет ключевые переменные в JSON-файл
-    void saveState(const VariableDatabase& db) {
-        std::ofstream file(filename);
-        if (file.is_open()) {
-            // Получаем текущее время
-            std::time_t now = std::time(nullptr);
-            std::tm* localTime = std::localtime(&now);
-            
-            // Начинаем JSON
-            file << "{\n";
-            
-            // Сохраняем переменные в формате JSON
-            file << "  \"temperature_value\": " << std::fixed << std::setprecision(2) 
-                 << db.getVariable("temperature_value") << ",\n";
-            file << "  \"pressure_value\": " << std::fixed << std::setprecision(2) 
-                 << db.getVariable("pressure_value") << ",\n";
-            file << "  \"setpoint_value\": " << std::fixed << std::setprecision(2) 
-                 << db.getVariable("setpoint_value") << ",\n";
-            file << "  \"panel_status\": " << static_cast<int>(db.getVariable("panel_status")) << ",\n";
-            
-            // Сохраняем время в читаемом формате
-            char timeStr[100];
-            std::strftime(timeStr, sizeof(timeStr), "%Y-%m-%d %H:%M:%S", localTime);
-            file << "  \"saved_at\": \"" << timeStr << "\",\n";
-            
-            // Сохраняем timestamp (секунды с 1970-01-01)
-            file << "  \"timestamp\": " << now << "\n";
-            
-            // Заканчиваем JSON
-            file << "}\n";
-            
-            file.close();
-            Logger::info("State saved to " + filename);
-        } else {
-            Logger::error("Failed to save state to " + filename);
-        }
-    }
-    
-    void loadState(VariableDatabase& db) {
-        std::ifstream file(filename);
-        if (!file.is_open()) {
-            Logger::warning("State file not found: " + filename);
-            return;
-        }
-        
-        // Простой парсинг JSON
-        std::string line;
-        std::string content;
-        while (std::getline(file, line)) {
-            content += line;
-        }
-        file.close();
-        
-        // Ищем и парсим значения
-        size_t pos;
-        
-        // Температура
-        pos = content.find("\"temperature_value\":");
-        if (pos != std::string::npos) {
-            pos += 20;
-            size_t end = content.find(",", pos);
-            std::string valueStr = content.substr(pos, end - pos);
-            try {
-                double value = std::stod(valueStr);
-                db.setVariable("temperature_value", value);
-                Logger::info("Loaded temperature_value = " + std::to_string(value));
-            } catch (...) {}
-        }
-        
-        // Давление
-        pos = content.find("\"pressure_value\":");
-        if (pos != std::string::npos) {
-            pos += 18;
-            size_t end = content.find(",", pos);
-            std::string valueStr = content.substr(pos, end - pos);
-            try {
-                double value = std::stod(valueStr);
-                db.setVariable("pressure_value", value);
-                Logger::info("Loaded pressure_value = " + std::to_string(value));
-            } catch (...) {}
-        }
-        
-        // Уставка
-        pos = content.find("\"setpoint_value\":");
-        if (pos != std::string::npos) {
-            pos += 18;
-            size_t end = content.find(",", pos);
-            std::string valueStr = content.substr(pos, end - pos);
-            try {
-                double value = std::stod(valueStr);
-                db.setVariable("setpoint_value", value);
-                Logger::info("Loaded setpoint_value = " + std::to_string(value));
-            } catch (...) {}
-        }
-        
-        // Статус панели
-        pos = content.find("\"panel_status\":");
-        if (pos != std::string::npos) {
-            pos += 15;
-            size_t end = content.find(",", pos);
-            std::string valueStr = content.substr(pos, end - pos);
-            try {
-                double value = std::stod(valueStr);
-                db.setVariable("panel_status", value);
-                Logger::info("Loaded panel_status = " + std::to_string(value));
-            } catch (...) {}
-        }
-        
-        // Читаем время сохранения (если есть)
-        pos = content.find("\"saved_at\":");
-        if (pos != std::string::npos) {
-            pos += 11;
-            size_t end = content.find("\"", pos + 1);
-            std::string savedTime = content.substr(pos + 1, end - pos - 1);
-            Logger::info("File was saved at: " + savedTime);
-        }
-        
-        Logger::info("State loaded from " + filename);
-    }
+    StateManager(const std::string& file = "../saved_state.json");
+    ~StateManager();
+
+    StateManager(const StateManager&) = delete;
+    StateManager& operator=(const StateManager&) = delete;
+
+    // Журналирует записи оператора в db между снимками. Вызывать до loadState
+    void enableJournal(VariableDatabase& db);
+    WriteAheadLog* getJournal() { return journal.get(); }
+
+    // Сохранять только перечисленные переменные (пустой список - все)
+    void setTags(VariableDatabase& db, const std::vector<std::string>& names);
+
+    // Снимает копию значений и ставит запись в очередь фонового потока (UI-поток)
+    void saveState(const VariableDatabase& db);
+
+    // Дожидается записи всех поставленных снимков и записей журнала
+    void flush();
+
+    // Восстанавливает значения и сохраненную историю из файла и доигрывает журнал поверх них.
+    // false - файла нет или он поврежден (журнал при этом все равно применяется)
+    bool loadState(VariableDatabase& db);
+
+    const std::string& getFilename() const { return filename; }
+
+    // Записывает файл через временный с fsync и атомарной заменой
+    static bool writeFileAtomically(const std::string& path, const std::string& content);
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,56 @@
+#ifndef SWINGINGDOOR_H
+#define SWINGINGDOOR_H
+
+#include "HistoryBuffer.h"
+
+/**
+ * Сжатие истории методом вращающейся двери (swinging door trending).
+ *
+ * Из потока значений сохраняются только точки излома: значение отбрасывается, если линия
+ * от последней сохраненной точки до следующей проходит от него не дальше deviation.
+ * От сохраненной точки A "двери" - наклоны к (значение ± deviation) принятых значений:
+ * нижняя только поднимается, верхняя только опускается. Пока нижняя не выше верхней,
+ * через все принятые значения проходит одна прямая из A; когда двери открываются шире
+ * параллели, сохраняется точка этой прямой в момент предыдущего принятого значения
+ * (не дальше deviation от него) и она становится новой точкой A.
+ *
+ * Последнее принятое значение не сохраняется, пока следующее не закроет дверь:
+ * тренды, которым нужно текущее значение, берут его через getHeldValue().
+ * Линейная интерполяция между сохраненными точками отличается от любого принятого
+ * значения не больше чем на deviation. O(1) на значение, без выделений памяти.
+ */
+class SwingingDoor {
+public:
+    explicit SwingingDoor(double deviation = 0.0);
+
+    void setDeviation(double value) { deviation = value; }
+    double getDeviation() const { return deviation; }
+
+    // Принимает значение. true - точку (archivedTime, archivedValue) нужно сохранить в историю.
+    // Первое значение сохраняется сразу
+    bool add(HistoryClock::time_point time, double value,
+             HistoryClock::time_point& archivedTime, double& archivedValue);
+
+    // Принятое, но еще не сохраненное значение
+    bool hasHeld() const { return holding; }
+    HistoryClock::time_point getHeldTime() const { return heldTime; }
+    double getHeldValue() const { return heldValue; }
+
+    // Начать заново: следующее значение сохраняется сразу
+    void reset();
+
+private:
+    double deviation;
+    bool started;                       // Есть сохраненная точка A
+    bool holding;                       // Есть принятое несохраненное значение
+    HistoryClock::time_point pivotTime; // Точка A
+    double pivotValue;
+    HistoryClock::time_point heldTime;
+    double heldValue;
+    double slopeLow;                    // Наклоны дверей, единицы в секунду
+    double slopeHigh;
+
+    void openDoors(HistoryClock::time_point time, double value);
+};
+
+#endif
@@ -3,6 +3,8 @@
 
 #include "VisualObject.h"
 #include "VariableDatabase.h"
+#include "NumberFormat.h"
+#include "TextRun.h"
 #include <SFML/Graphics.hpp>
 
 class Text : public VisualObject {
@@ -10,16 +12,32 @@ private:
     sf::Text text;
     std::string formatString;
     std::string variableName;
+    TagId tag;
     sf::Font* font;
 
+    // Шаблон разбирается один раз; строки переиспользуются между обновлениями
+    NumberFormat numberFormat;
+    std::string formatted;  // Результат последнего форматирования
+    std::string displayed;  // Строка, переданная в sf::Text
+
+    TextRun textRun;  // Глифы надписи в общем пакете текста (см. SceneRenderer)
+
 public:
     Text(float x, float y, const std::string& content, 
          sf::Font* font, unsigned int size, const sf::Color& color,
          const std::string& name, VariableDatabase* db, 
          const std::string& varName = "", const std::string& format = "");
     
-    void draw(sf::RenderWindow& window) override;
+    void draw(sf::RenderTarget& target) override;
+    sf::FloatRect getBounds() const override;
+    bool isStatic() const override { return tag == INVALID_TAG; }
     void update() override;
+
+    // Текст рисуется глифами из атласа шрифта в пакете вместе с остальными надписями
+    void attachToBatch(RenderBatch& batch) override;
+    const sf::Texture* getBatchTexture() const override { return TextRun::getTexture(text); }
+    bool hasOverlay() const override { return !textRun.attached(); }
+
     void setString(const std::string& str);
 };
 
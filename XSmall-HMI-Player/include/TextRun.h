@@ -0,0 +1,51 @@
+#ifndef TEXTRUN_H
+#define TEXTRUN_H
+
+#include "RenderBatch.h"
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+
+/**
+ * Надпись (sf::Text), выложенная глифами в общий пакет вместо отдельного вызова draw.
+ *
+ * Глифы берутся из атласа шрифта для нужного размера символов (sf::Font::getTexture) -
+ * он общий для всех надписей этого шрифта и размера, поэтому текст всех виджетов
+ * попадает в один пакет и рисуется одним вызовом. Раскладка повторяет sf::Text
+ * (кернинг, пробелы, табуляция, перевод строки), без поворота и масштаба.
+ *
+ * Участок в пакете выделяется с запасом на capacity глифов: при смене строки
+ * переписываются только вершины этого участка, неиспользованные глифы вырождаются в точку.
+ * Если строка не помещается, участок переносится в конец пакета.
+ */
+class TextRun {
+private:
+    BatchRange range;
+    std::size_t capacity;  // Сколько глифов помещается в участок
+
+    // Записывает глифы text в участок и гасит оставшиеся вершины
+    void write(const sf::Text& text);
+
+public:
+    // Координаты белого квадрата 2x2, который sf::Font резервирует в углу каждой страницы атласа.
+    // Сплошная заливка (фон кнопки, рамка поля) рисуется в том же пакете, что и текст
+    static const sf::Vector2f SOLID_TEX_COORDS;
+
+    TextRun();
+
+    // Текстура пакета для надписи (страница атласа шрифта) или nullptr, если шрифта нет
+    static const sf::Texture* getTexture(const sf::Text& text);
+
+    // Число глифов строки (пробелы и переводы строк геометрии не дают)
+    static std::size_t countGlyphs(const sf::String& string);
+
+    // Выделяет участок не меньше чем на minCapacity глифов и выкладывает текст
+    void attach(RenderBatch& batch, const sf::Text& text, std::size_t minCapacity = 0);
+
+    // Переписывает глифы после изменения строки, цвета или позиции text
+    void update(const sf::Text& text);
+
+    bool attached() const { return range.attached(); }
+    std::size_t getCapacity() const { return capacity; }
+};
+
+#endif
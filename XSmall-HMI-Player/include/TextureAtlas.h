@@ -0,0 +1,68 @@
+#ifndef TEXTUREATLAS_H
+#define TEXTUREATLAS_H
+
+#include <SFML/Graphics.hpp>
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Атлас текстур: изображения сцены упаковываются полками в одну или несколько страниц,
+ * и спрайты рисуются из прямоугольников страниц. Спрайты с общей страницей
+ * попадают в один пакет отрисовки (см. SceneRenderer).
+ *
+ * Готовый атлас можно сохранить на диск: ключ кэша - хеш путей и содержимого файлов,
+ * поэтому при неизменных изображениях следующий запуск загружает страницы целиком,
+ * без декодирования каждого файла и упаковки.
+ */
+class TextureAtlas {
+public:
+    // Положение изображения в атласе
+    struct Entry {
+        std::size_t page;
+        sf::IntRect rect;
+    };
+
+private:
+    unsigned int pageSize;
+    unsigned int padding;  // Промежуток между изображениями (без просачивания соседних пикселей)
+
+    std::vector<std::pair<std::string, sf::Image>> pending;  // Добавленные, еще не упакованные
+    std::vector<std::unique_ptr<sf::Texture>> pages;        // Адреса страниц не меняются
+    std::vector<sf::Image> pageImages;                       // Пиксели страниц (для сохранения в кэш)
+    std::unordered_map<std::string, Entry> entries;
+    bool loadedFromCache;
+
+    bool loadCache(const std::string& indexFile, std::uint64_t hash);
+    bool saveCache(const std::string& cacheDir, const std::string& indexFile, std::uint64_t hash) const;
+
+public:
+    explicit TextureAtlas(unsigned int pageSize = 2048, unsigned int padding = 1);
+
+    // Добавляет изображение под ключом key (упаковка - в pack())
+    void add(const std::string& key, const sf::Image& image);
+
+    // Раскладывает добавленные изображения по страницам и загружает страницы в видеопамять.
+    // Изображения больше страницы не упаковываются. Возвращает false, если упаковано не все
+    bool pack();
+
+    // Загружает файлы (пути уже разрешены) и упаковывает их.
+    // cacheDir - каталог кэша атласа (пустая строка - без кэша)
+    bool loadFiles(const std::vector<std::string>& files, const std::string& cacheDir = "");
+
+    // nullptr, если изображения нет в атласе
+    const Entry* find(const std::string& key) const;
+
+    const sf::Texture& getPage(std::size_t index) const { return *pages[index]; }
+    std::size_t getPageCount() const { return pages.size(); }
+    std::size_t getEntryCount() const { return entries.size(); }
+    bool isLoadedFromCache() const { return loadedFromCache; }
+
+    // Хеш FNV-1a путей и содержимого файлов (ключ кэша)
+    static std::uint64_t hashFiles(const std::vector<std::string>& files);
+};
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <cstddef>
+
+/**
+ * Пул рабочих потоков для параллельной обработки независимых элементов.
+ *
+ * parallelFor раздает индексы [0, count) порциями через общий счетчик и ждет, пока
+ * обработаны все; вызывающий поток работает вместе с пулом. Задача не должна бросать
+ * исключения - ошибки элемент сохраняет у себя.
+ * Вызовы parallelFor из разных потоков выполняются по очереди.
+ */
+class ThreadPool {
+private:
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    std::mutex runMutex;  // Один parallelFor за раз
+
+    // Текущее задание
+    const std::function<void(std::size_t)>* task;
+    std::size_t count;
+    std::size_t chunk;
+    std::atomic<std::size_t> next;
+    std::size_t generation;   // Номер задания: рабочий поток берет каждое один раз
+    std::size_t activeWorkers;
+    bool stopping;
+
+    void workerLoop();
+    void runChunks();
+
+public:
+    // threads = 0 - по числу ядер (минус вызывающий поток)
+    explicit ThreadPool(std::size_t threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Сколько потоков обрабатывают задание вместе с вызывающим
+    std::size_t getThreadCount() const { return workers.size() + 1; }
+
+    void parallelFor(std::size_t count, const std::function<void(std::size_t)>& task);
+
+    // Общий пул плеера
+    static ThreadPool& instance();
+};
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef TIMESERIESCODEC_H
+#define TIMESERIESCODEC_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Сжатие ряда значений с отметками времени (Gorilla): значение - XOR с предыдущим,
+ * отметка - разность разностей с предыдущими. Повтор значения при постоянном периоде
+ * отметок занимает 2 бита.
+ *
+ * Биты дописываются от старших к младшим в 64-битные слова. Кодировщик хранит состояние
+ * между вызовами: ряд дописывается по одному значению, уже записанные слова не меняются,
+ * кроме младших свободных битов последнего. Отметка первого значения в битах не хранится -
+ * ее держит вызывающий и передает при разборе.
+ */
+class TimeSeriesEncoder {
+public:
+    TimeSeriesEncoder();
+
+    // Дописывает значение с отметкой в words. Отметки не убывают
+    void add(std::vector<std::uint64_t>& words, double value, std::int64_t time);
+
+    // Начинает новый ряд (слова вызывающий очищает сам)
+    void reset();
+
+    std::size_t count() const { return samples; }
+    std::uint64_t bitCount() const { return bits; }
+
+private:
+    void write(std::vector<std::uint64_t>& words, std::uint64_t value, unsigned count);
+
+    std::uint64_t bits;         // Записано битов
+    std::size_t samples;
+    std::int64_t previousTime;
+    std::int64_t previousDelta;
+    std::uint64_t previousValue;
+    unsigned windowLeading;     // Окно значимых битов предыдущего XOR
+    unsigned windowTrailing;
+    bool hasWindow;
+};
+
+// Разбирает count значений с отметками, записанных TimeSeriesEncoder; firstTime - отметка первого
+void decodeTimeSeries(const std::uint64_t* words, std::size_t count, std::int64_t firstTime,
+                      double* values, std::int64_t* times);
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+
+#include <chrono>
+#include <functional>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Колесо таймеров для периодических задач (автосохранение, симуляция и т.п.).
+ *
+ * Время делится на такты фиксированной длительности, таймеры раскладываются по слотам
+ * (срок % число слотов). Продвижение на такт обрабатывает только один слот,
+ * поэтому стоимость не зависит от общего числа таймеров.
+ * Используется из одного потока (главного цикла).
+ */
+class TimerWheel {
+public:
+    using Duration = std::chrono::steady_clock::duration;
+    using TimerId = std::uint64_t;
+    using Callback = std::function<void()>;
+
+    static constexpr TimerId INVALID_TIMER = 0;
+
+    explicit TimerWheel(std::chrono::milliseconds resolution = std::chrono::milliseconds(10),
+                        std::size_t slotCount = 256);
+
+    // Периодический таймер: первый вызов через interval, далее каждые interval.
+    // Пропущенные из-за задержки периоды не навёрстываются (один вызов вместо нескольких)
+    TimerId scheduleEvery(Duration interval, Callback callback);
+
+    // Однократный таймер через delay
+    TimerId scheduleOnce(Duration delay, Callback callback);
+
+    // Отменяет таймер (можно вызывать и из его же обработчика)
+    void cancel(TimerId id);
+
+    // Продвигает колесо на elapsed и вызывает таймеры, срок которых наступил.
+    // Возвращает число вызовов
+    std::size_t advance(Duration elapsed);
+
+    std::chrono::milliseconds getResolution() const { return resolution; }
+    std::size_t getTimerCount() const { return timerCount; }
+
+private:
+    struct Timer {
+        TimerId id;
+        std::uint64_t expiry;    // Такт срабатывания
+        std::uint64_t interval;  // Период в тактах (0 - однократный)
+        Callback callback;
+    };
+
+    std::chrono::milliseconds resolution;
+    std::vector<std::vector<Timer>> slots;
+    std::uint64_t currentTick;
+    Duration remainder;          // Время, не набравшее полного такта
+    TimerId nextId;
+    std::size_t timerCount;
+
+    // Таймер, обработчик которого выполняется сейчас (для отмены изнутри обработчика)
+    TimerId firingId;
+    bool firingCancelled;
+
+    TimerId schedule(Duration delay, std::uint64_t intervalTicks, Callback callback);
+    std::uint64_t toTicks(Duration duration) const;
+    void insert(Timer timer);
+};
+
+#endif
@@ -0,0 +1,151 @@
+#ifndef TRENDCURVE_H
+#define TRENDCURVE_H
+
+#include "HistoryBuffer.h"
+#include "CompressedHistory.h"
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include <deque>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Кривая тренда по окну последних значений истории.
+ *
+ * Вершины хранятся в координатах (номер значения, значение) и переводятся в экранные
+ * преобразованием (getTransform), поэтому изменение диапазона не требует пересчета вершин.
+ *
+ * В режиме оси времени (configureTime) окно - последние span по отметкам значений,
+ * x вершины - секунды от отметки originTime. Границу окна находит двоичный поиск по
+ * отметкам; в окно входит и одно значение перед ней, вершина которого переносится на
+ * левый край (линия входит в окно, а не начинается с первого значения). Последнее
+ * значение удерживается до правого края (now). Число значений в окне меняется, поэтому
+ * прореживание включается и выключается по текущему числу значений. Значение, еще не
+ * попавшее в историю (setPending, например удержанное swinging door), рисуется после
+ * последнего сохраненного и удерживается вместо него.
+ *
+ * Пока значений в окне не больше 4 на столбец пикселей, на значение приходится одна вершина:
+ * новое значение - одна новая вершина, минимум и максимум окна - монотонные очереди.
+ *
+ * При более длинном окне включается прореживание M4: от значений каждого столбца пикселей
+ * остаются первое, минимальное, максимальное и последнее. Растеризованная линия совпадает
+ * с непрореженной, а вершин не больше 4 на пиксель ширины независимо от размера окна.
+ * По мере поступления значения сворачиваются в блоки по ~sqrt(значений на столбец) с готовыми
+ * минимумом и максимумом; столбцы собираются из блоков, и только неполные блоки на границах
+ * столбцов просматриваются поэлементно.
+ *
+ * Сжатая история разжимается только в новых значениях: кривая держит несжатую копию
+ * своего окна (mirror) и дописывает в нее значения, появившиеся с прошлой синхронизации.
+ */
+class TrendCurve {
+private:
+    struct Point {
+        std::uint64_t index;
+        double value;
+    };
+
+    // Минимум и максимум блока значений (блоки выровнены по номеру значения)
+    struct Block {
+        Point min, max;
+    };
+
+    std::size_t window;           // Сколько последних значений показывается
+    std::size_t columns;          // Ширина области в пикселях
+    std::size_t blockSize;        // Значений в блоке (0 - без прореживания)
+
+    // Ось времени: длина окна (0 - окно по числу значений), правый край и отсчет x
+    HistoryClock::duration span;
+    HistoryClock::time_point windowEnd;
+    double originTime;            // Секунды часов истории, соответствующие x = 0
+    HistoryClock::time_point decimatedEnd;  // Правый край на момент последнего прореживания
+    std::size_t held;             // Вершин в конце кривой от удержания до now (и несохраненного значения)
+    bool pending;                 // Есть значение после последнего сохраненного
+    HistoryClock::time_point pendingTime;
+    double pendingValue;
+
+    std::vector<sf::Vertex> vertices;
+    std::size_t start;            // Первая вершина окна
+    std::uint64_t originIndex;    // Номер значения, соответствующий x = 0
+    double valueBase;             // Значение, соответствующее y = 0 (сохраняет точность float)
+    std::uint64_t firstIndex;     // Номер первого значения окна
+    std::uint64_t count;          // Значений в окне
+    double minValue, maxValue;    // Диапазон окна
+    std::uint64_t syncedTotal;    // Счетчик истории на момент последней синхронизации
+    bool stale;                   // Параметры изменились - при синхронизации строим заново
+    sf::Color color;
+
+    // Без прореживания: скользящие минимум и максимум окна
+    std::deque<Point> minQueue;
+    std::deque<Point> maxQueue;
+
+    // С прореживанием: блоки окна, blockBase - номер блока blocks.front()
+    std::deque<Block> blocks;
+    std::uint64_t blockBase;
+
+    // Для сжатой истории: несжатые последние значения окна
+    HistoryBuffer mirror;
+    std::uint64_t mirroredTotal;  // Счетчик сжатой истории на момент последнего копирования
+
+    void rebuild(const HistoryView& history, std::uint64_t total);
+    void append(std::uint64_t index, double value, HistoryClock::time_point time);
+    void slide(std::uint64_t total, std::size_t size);
+    void compact();
+
+    void appendToBlock(std::uint64_t index, double value);
+    void decimate(const HistoryView& history);
+    void decimateColumn(const HistoryView& history, std::uint64_t from, std::uint64_t to, bool& first);
+
+    // Ось времени
+    bool isTimeAxis() const { return span > HistoryClock::duration::zero(); }
+    float positionX(std::uint64_t index, HistoryClock::time_point time) const;
+    void selectDecimation(std::size_t count);
+    void clipEntry(const HistoryView& history);
+    void holdLast(const HistoryView& history);
+    void mirrorFrom(const CompressedHistory& history, std::uint64_t from);
+
+public:
+    TrendCurve();
+
+    // Размер окна в значениях и ширина области в пикселях (при изменении кривая перестраивается)
+    void configure(std::size_t window, std::size_t columns);
+
+    // Окно по времени: последние span до момента синхронизации
+    void configureTime(HistoryClock::duration span, std::size_t columns);
+    void setColor(const sf::Color& newColor);
+
+    // Значение после последнего сохраненного в истории (только на оси времени)
+    void setPending(HistoryClock::time_point time, double value);
+    void clearPending();
+
+    // Дописывает значения, появившиеся в истории с прошлого вызова.
+    // history - последние значения истории, total - счетчик записей истории
+    void sync(const HistoryView& history, std::uint64_t total);
+
+    // То же для сжатой истории: разжимаются только значения, появившиеся с прошлого вызова
+    void sync(const CompressedHistory& history);
+
+    // Синхронизация на момент now: окно по времени сдвигается и без новых значений.
+    // В режиме окна по числу значений now не используется
+    void sync(const HistoryView& history, std::uint64_t total, HistoryClock::time_point now);
+    void sync(const CompressedHistory& history, HistoryClock::time_point now);
+
+    // Вершины окна для отрисовки линией (sf::LineStrip) с преобразованием getTransform
+    const sf::Vertex* getVertices() const { return vertices.data() + start; }
+    std::size_t getVertexCount() const { return vertices.size() - start; }
+
+    // Преобразование в экранные координаты области area (минимум - внизу, максимум - вверху)
+    sf::Transform getTransform(const sf::FloatRect& area) const;
+
+    std::size_t getSampleCount() const { return static_cast<std::size_t>(count); }
+    bool isDecimated() const { return blockSize > 0; }
+
+    // Есть что рисовать: на оси времени достаточно одного значения (оно удерживается до now)
+    bool isDrawable() const { return getVertexCount() > 1 && (count > 1 || isTimeAxis()); }
+
+    void draw(sf::RenderTarget& target, const sf::FloatRect& area) const;
+
+    // Точки кривой в экранных координатах (для тестов и отладки)
+    std::vector<sf::Vector2f> getScreenPoints(const sf::FloatRect& area) const;
+};
+
+#endif
@@ -6,43 +6,322 @@
 #include <functional>
 #include <vector>
 #include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <shared_mutex>
+#include "HistoryBuffer.h"
+#include "CompressedHistory.h"
+#include "HistoryRollup.h"
+#include "SwingingDoor.h"
 
-// Центральное хранилице переменных SCADA-системы 
+// Целочисленный дескриптор переменной (индекс в плотных массивах базы).
+// Разрешается по имени один раз при загрузке сцены, дальше используется без хеширования строк
+using TagId = std::size_t;
+constexpr TagId INVALID_TAG = static_cast<TagId>(-1);
 
+// Режим доставки уведомлений подписчикам
+enum class NotifyMode {
+    Immediate,  // Подписчики вызываются прямо из set()
+    Deferred    // set() только помечает переменную измененной, доставка - в dispatchPending()
+};
+
+// Политика хранения истории переменной (секция "tags" в objects.json)
+struct HistoryPolicy {
+    std::size_t capacity = 0;  // 0 - емкость по умолчанию базы
+    double deadband = 0.0;     // Запись, отличающаяся от последней записанной меньше чем на deadband, пропускается
+    bool compressed = false;   // Хранить сжатой (CompressedHistory)
+    bool persistent = false;   // Сохранять историю вместе с состоянием (StateManager)
+    double swingingDoor = 0.0; // Допуск сжатия swinging door (0 - сохраняется каждое значение)
+};
+
+// Зона нечувствительности уведомлений: запись, отличающаяся от последнего доставленного
+// значения меньше чем на порог, обновляет значение, но подписчики не вызываются и история
+// не пишется. Порог - наибольший из absolute и percent % от span (без span - от модуля
+// последнего доставленного значения)
+struct NotifyDeadband {
+    double absolute = 0.0;
+    double percent = 0.0;
+    double span = 0.0;  // Шкала переменной (max - min)
+};
+
+// Источник записи: значения от оператора (кнопки, поля ввода) журналируются
+enum class WriteSource {
+    Process,
+    Operator
+};
+
+/**
+ * Центральное хранилице переменных SCADA-системы.
+ *
+ * Потокобезопасность:
+ * - resolveTag/findTag, getTagName, get/getVariable, hasValue и post/postVariable можно
+ *   вызывать из любого потока;
+ * - set/setVariable, история, подписки и dispatchPending - только из UI-потока.
+ * Фоновые потоки сбора данных пишут через post(): значение сразу видно читателям,
+ * а подписчики вызываются позже в UI-потоке из dispatchPending().
+ */
 class VariableDatabase {
 private:
-    // Основное хранилище переменных
-    std::unordered_map<std::string, double> variables;
-    
-    // История изменений для каждой переменной (используется для графиков)
-    std::unordered_map<std::string, std::vector<double>> historyVariables;
-    
-    // Подписчики на изменения переменных: имя переменной -> список callback-функций
-    std::unordered_map<std::string, std::vector<std::function<void(double)>>> subscribers;
+    // Узел lock-free очереди изменений (встроен в слот переменной, без выделений памяти)
+    struct ChangeNode {
+        std::atomic<ChangeNode*> next{nullptr};
+        TagId tag = INVALID_TAG;
+    };
+
+    // Подписчик; owner позволяет снять подписку, когда владелец удаляется
+    struct Subscriber {
+        std::function<void(double)> callback;
+        const void* owner;
+    };
+
+    // История переменной; создается, только когда у нее появляется потребитель или политика
+    struct TagHistory {
+        TagId tag;
+        HistoryPolicy policy;
+        HistoryBuffer buffer;
+        std::unique_ptr<CompressedHistory> compressed;  // Если задан - история хранится в нем
+        std::unique_ptr<HistoryRollup> rollup;          // Агрегаты по времени (по запросу)
+        std::unique_ptr<SwingingDoor> door;             // Прореживание swinging door (по политике)
+        HistoryClock::duration samplePeriod{0};         // Период передискретизации (0 - по записям)
+        HistoryClock::time_point nextSample;            // Срок следующего отсчета
+        double lastRecorded = 0.0;                      // Для зоны нечувствительности
+        bool recorded = false;
+
+        TagHistory(TagId tag, std::size_t capacity) : tag(tag), buffer(capacity) {}
+    };
+
+    // Фильтр уведомлений переменной с зоной нечувствительности
+    struct NotifyFilter {
+        NotifyDeadband deadband;
+        double lastNotified = 0.0;
+        bool notified = false;  // Было хотя бы одно уведомление
+        bool force = false;     // Следующее уведомление доставляется без проверки (запись оператора)
+
+        bool accept(double value);
+    };
+
+    // Слот переменной. Адрес слота не меняется после регистрации
+    struct TagSlot {
+        std::string name;
+        std::atomic<double> value{0.0};
+        std::atomic<bool> assigned{false};  // Значение хотя бы раз устанавливалось
+        std::atomic<bool> queued{false};    // Переменная уже стоит в очереди изменений
+        ChangeNode node;
+
+        // Доступны только из UI-потока
+        std::unique_ptr<TagHistory> history;  // nullptr - история переменной не ведется
+        std::unique_ptr<NotifyFilter> filter; // nullptr - уведомляется каждая запись
+        std::vector<Subscriber> subscribers;
+    };
+
+    // Слоты хранятся блоками фиксированного размера: регистрация новой переменной
+    // не перемещает существующие, поэтому чтение по TagId не требует блокировок
+    static constexpr std::size_t SLOT_CHUNK_SIZE = 1024;
+    static constexpr std::size_t MAX_SLOT_CHUNKS = 4096;
+    std::unique_ptr<std::unique_ptr<TagSlot[]>[]> slotChunks;
+    std::atomic<std::size_t> slotCount;
+
+    // Таблица имен: имя переменной -> дескриптор
+    mutable std::shared_mutex namesMutex;
+    std::unordered_map<std::string, TagId> tagIds;
+
+    // Очередь изменений (MPSC, алгоритм Вьюкова): пишут любые потоки, читает UI-поток
+    ChangeNode queueStub;
+    std::atomic<ChangeNode*> queueHead;
+    ChangeNode* queueTail;
+
+    std::atomic<std::size_t> defaultHistoryCapacity;
+    NotifyMode notifyMode;
+    std::uint64_t revision;  // Счетчик изменений, видимых на экране (UI-поток)
+    std::function<void(TagId, double)> operatorWriteHandler;
+    std::function<void(TagId, double, HistoryClock::time_point)> historyArchiveHandler;
+    std::vector<TagId> resampledTags;  // Переменные с передискретизацией истории (UI-поток)
+    std::vector<TagId> historyTags;    // Переменные, для которых ведется история (UI-поток)
+
+    TagSlot& slot(TagId tag) const { return slotChunks[tag / SLOT_CHUNK_SIZE][tag % SLOT_CHUNK_SIZE]; }
+    bool isValid(TagId tag) const { return tag < slotCount.load(std::memory_order_acquire); }
+
+    void enqueueChange(ChangeNode* node);
+    ChangeNode* dequeueChange();
+
+    // Записывает значение в историю и вызывает подписчиков (UI-поток)
+    void notify(TagId tag, double value);
+    void recordHistory(TagHistory& h, double value, HistoryClock::time_point time);
+    // pushHistory - история и агрегаты без архива (восстановление), commitHistory - история и архив
+    void pushHistory(TagHistory& h, double value, HistoryClock::time_point time);
+    void commitHistory(TagHistory& h, double value, HistoryClock::time_point time);
+    static void storeHistory(TagHistory& h, double value, HistoryClock::time_point time);
+    static void setHistoryCapacity(TagHistory& h, std::size_t capacity);
+
+    // История переменной, создается при первом обращении (tag должен быть действителен)
+    TagHistory& history(TagId tag);
+    const TagHistory* findHistory(TagId tag) const;
 
 public:
     VariableDatabase();
-    
+
+    VariableDatabase(const VariableDatabase&) = delete;
+    VariableDatabase& operator=(const VariableDatabase&) = delete;
+
+    // Возвращает дескриптор переменной, регистрируя её при первом обращении
+    TagId resolveTag(const std::string& name);
+
+    // Возвращает дескриптор существующей переменной или INVALID_TAG
+    TagId findTag(const std::string& name) const;
+
+    // Имя переменной по дескриптору
+    const std::string& getTagName(TagId tag) const;
+
+    // Количество зарегистрированных переменных
+    std::size_t tagCount() const { return slotCount.load(std::memory_order_acquire); }
+
+    // Быстрый доступ по дескриптору (без поиска по имени)
+    void set(TagId tag, double value, WriteSource source = WriteSource::Process);
+    double get(TagId tag) const;
+
+    // Значение переменной хотя бы раз устанавливалось
+    bool hasValue(TagId tag) const;
+
     // Устанавливает значение и уведомляет подписчиков
     void setVariable(const std::string& name, double value);
-    
+
     // Возвращает значение переменной
     double getVariable(const std::string& name) const;
-    
+
     // Проверяет существование переменной
     bool variableExists(const std::string& name) const;
-    
-    // Добавляет значение в историю (автоматически обрезается до 100 значений)
+
+    // Запись из фонового потока: значение публикуется сразу, уведомление откладывается.
+    // Несколько записей до dispatchPending() схлопываются в одно уведомление (последнее значение)
+    void post(TagId tag, double value);
+    void postVariable(const std::string& name, double value);
+
+    // Доставляет отложенные изменения подписчикам (UI-поток). Возвращает число переменных
+    std::size_t dispatchPending();
+
+    // В режиме Deferred частые записи одной переменной между кадрами дают одно уведомление
+    void setNotifyMode(NotifyMode mode) { notifyMode = mode; }
+    NotifyMode getNotifyMode() const { return notifyMode; }
+
+    // Вызывается из set() для каждой записи оператора (журнал состояния). Пустой - отключить
+    void setOperatorWriteHandler(std::function<void(TagId, double)> handler) {
+        operatorWriteHandler = std::move(handler);
+    }
+
+    // Вызывается для каждого значения, сохраненного в историю (после зон нечувствительности
+    // и swinging door), - архив истории на диске. Восстановленная история (restoreHistory)
+    // через него не проходит. Пустой - отключить
+    void setHistoryArchiveHandler(std::function<void(TagId, double, HistoryClock::time_point)> handler) {
+        historyArchiveHandler = std::move(handler);
+    }
+
+    // Растет при каждом уведомлении подписчиков и записи в историю (UI-поток).
+    // Если значение не изменилось с прошлого кадра, перерисовывать нечего
+    std::uint64_t getRevision() const { return revision; }
+
+    // История ведется только для переменных с потребителем (график, ломаная, агрегаты,
+    // передискретизация) или с политикой из конфигурации: запись остальных переменных
+    // обновляет значение и подписчиков, но не занимает память под историю.
+    // Явная запись в историю (addToHistory) тоже включает ее
+
+    // Включает историю переменной с политикой по умолчанию (ничего не меняет, если уже включена)
+    void enableHistory(TagId tag);
+    bool isHistoryEnabled(TagId tag) const;
+
+    // Переменные, для которых ведется история (в порядке включения)
+    const std::vector<TagId>& getHistoryTags() const { return historyTags; }
+
+    // Применяет политику: включает историю, запрашивает емкость, переключает сжатие
+    void setHistoryPolicy(TagId tag, const HistoryPolicy& policy);
+
+    // Действующая политика (емкость и сжатие - фактические). Без истории - политика по умолчанию
+    HistoryPolicy getHistoryPolicy(TagId tag) const;
+
+    // Значение, принятое сжатием swinging door, но еще не сохраненное в историю (последняя
+    // точка тренда). false - такого нет
+    bool getPendingHistory(TagId tag, HistoryClock::time_point& time, double& value) const;
+
+    // Зона нечувствительности уведомлений (нулевая - снять). Записи оператора доставляются всегда
+    void setNotifyDeadband(TagId tag, const NotifyDeadband& deadband);
+    NotifyDeadband getNotifyDeadband(TagId tag) const;
+
+    // Переменные, история которых сохраняется вместе с состоянием
+    std::vector<TagId> getPersistentHistoryTags() const;
+
+    // Копия хранимой истории от старых значений к новым (в том числе сжатой) вместе
+    // с еще не сохраненным значением swinging door
+    void copyHistory(TagId tag, std::vector<double>& values, std::vector<HistoryClock::time_point>& times) const;
+
+    // Заменяет историю переменной сохраненной (загрузка состояния, архив на диске): история
+    // включается, емкость не меньше числа значений. persistent - пометить историю сохраняемой
+    // вместе с состоянием
+    void restoreHistory(TagId tag, const std::vector<double>& values,
+                        const std::vector<HistoryClock::time_point>& times, bool persistent = true);
+
+    // Память под историю всех переменных в байтах (буферы, сжатые блоки, агрегаты)
+    std::size_t getHistoryMemoryUsage() const;
+
+    // Добавляет значение в историю (кольцевой буфер, самые старые значения вытесняются)
+    void addToHistory(TagId tag, double value);
     void addToHistory(const std::string& name, double value);
-    
-    // Возвращает историю изменений переменной
-    const std::vector<double>& getHistory(const std::string& name) const;
-    
-    // Подписывает callback на изменения переменной
+
+    // То же с явной отметкой времени (загрузка архива, тесты)
+    void addToHistory(TagId tag, double value, HistoryClock::time_point time);
+
+    // Возвращает историю изменений переменной (от старых значений к новым).
+    // Для сжатой истории представление пустое - она читается через getCompressedHistory()
+    HistoryView getHistory(TagId tag) const;
+    HistoryView getHistory(const std::string& name) const;
+
+    // Сколько значений записано в историю переменной за все время (растет монотонно)
+    std::uint64_t getHistoryTotal(TagId tag) const;
+
+    // Запрашивает емкость истории не меньше capacity (берется максимум по всем потребителям).
+    // Включает историю переменной
+    void requestHistoryCapacity(TagId tag, std::size_t capacity);
+    std::size_t getHistoryCapacity(TagId tag) const;
+
+    // Хранить историю переменной сжатой (значения сохраняются при переключении)
+    void setHistoryCompression(TagId tag, bool enabled);
+
+    // Сжатая история переменной или nullptr, если история хранится кольцевым буфером
+    const CompressedHistory* getCompressedHistory(TagId tag) const;
+
+    // Вести для переменной агрегаты по 1 с, 1 мин и 1 ч (с этого момента)
+    void enableRollups(TagId tag);
+
+    // Минимум/максимум/среднее за buckets равных интервалов [from, to) по самому грубому
+    // уровню агрегатов, который дает такую детализацию. Без агрегатов - пустые интервалы
+    std::vector<HistoryAggregate> getAggregated(TagId tag, HistoryClock::time_point from,
+                                                HistoryClock::time_point to, std::size_t buckets) const;
+
+    // Записывать историю переменной не при каждой записи, а отсчетами с периодом period:
+    // в каждый срок в историю попадает текущее значение (выборка с удержанием).
+    // Из нескольких запросов действует самый частый
+    void requestHistoryResampling(TagId tag, HistoryClock::duration period);
+    HistoryClock::duration getHistoryResampling(TagId tag) const;
+
+    // Дописывает отсчеты передискретизируемых переменных, срок которых наступил к now
+    // (вызывается из логического такта). Отметка отсчета - его срок, а не момент вызова.
+    // Отсчеты проходят зоны нечувствительности и swinging door, как обычные записи.
+    // Возвращает число взятых отсчетов (сохраненных может быть меньше)
+    std::size_t sampleHistory(HistoryClock::time_point now);
+
+    // Емкость истории для переменных, которым потребители ничего не запрашивали
+    // (и для истории, включенной позже)
+    void setDefaultHistoryCapacity(std::size_t capacity);
+
+    // Подписывает callback на изменения переменной.
+    // owner - необязательный владелец подписки для последующей отписки
+    void subscribe(TagId tag, std::function<void(double)> callback, const void* owner = nullptr);
     void subscribe(const std::string& variable, std::function<void(double)> callback);
-    
+
+    // Снимает все подписки владельца на переменную (объект сцены удаляется)
+    void unsubscribe(TagId tag, const void* owner);
+
     // Инициализирует тестовые переменные для демо-режима
     void initializeDemoVariables();
 };
 
-#endif
\ No newline at end of file
+#endif
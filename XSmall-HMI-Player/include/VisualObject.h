@@ -4,9 +4,12 @@
 #include <SFML/Graphics.hpp>
 #include <string>
 #include <memory>
+#include <vector>
+#include <functional>
 #include <VariableDatabase.h>
 
 class VariableDatabase;
+class RenderBatch;
 
 /** Базовый класс для всех графический элементов 
  * Определяет интерфейс для отрисовки, обновления и обработки событий
@@ -18,16 +21,65 @@ protected:
     std::string name;            // Уникальное имя объекта
     VariableDatabase* database;  // Ссылка на базу данных для синхронизации
 
+    // Подписка на переменную, которая снимается при удалении объекта
+    // (сцену можно перезагрузить, не пересоздавая базу данных)
+    void subscribe(TagId tag, std::function<void(double)> callback);
+
+private:
+    std::vector<TagId> subscriptions;
+
 public:
     VisualObject(float x, float y, const std::string& name, VariableDatabase* db);
-    virtual ~VisualObject() = default;
+    virtual ~VisualObject();
+
+    VisualObject(const VisualObject&) = delete;
+    VisualObject& operator=(const VisualObject&) = delete;
     
     // Чисто виртуальные методы (должны быть реализованы в наследниках)
-    virtual void draw(sf::RenderWindow& window) = 0;
+    virtual void draw(sf::RenderTarget& target) = 0;
     virtual void update() = 0;
 
     // Виртуальный метод с реализацией по умолчанию
     virtual void handleEvent(const sf::Event& event, sf::RenderWindow& window) {};
+
+    // Маршрутизация ввода (см. EventRouter). События получают только интерактивные объекты:
+    // события мыши - верхний объект под курсором, клавиатура - объект в фокусе
+    virtual bool isInteractive() const { return false; }
+    // Объект получает фокус клавиатуры по клику (поле ввода)
+    virtual bool acceptsFocus() const { return false; }
+    // Курсор вошел в объект или покинул его (серия MouseMoved за кадр - одно изменение)
+    virtual void setHovered(bool hovered) {}
+    // Объект получил или потерял фокус клавиатуры
+    virtual void setFocused(bool focused) {}
+    // Попадание точки (координаты сцены) в объект; по умолчанию - в getBounds()
+    virtual bool contains(float pointX, float pointY) const;
+
+    // Пакетная отрисовка (см. SceneRenderer). Объект может записать свою
+    // геометрию в общий пакет и дальше обновлять только свои вершины.
+    // По умолчанию объект в пакет ничего не пишет и целиком рисуется через draw()
+    virtual void attachToBatch(RenderBatch& batch) {}
+
+    // Текстура пакета, в который объект пишет геометрию (nullptr - нетекстурированный пакет)
+    virtual const sf::Texture* getBatchTexture() const { return nullptr; }
+
+    // Есть ли у объекта часть, которая рисуется отдельно от пакета (текст, текстуры)
+    virtual bool hasOverlay() const { return true; }
+
+    // Отрисовка части, не попавшей в пакет
+    virtual void drawOverlay(sf::RenderTarget& target) { draw(target); }
+
+    // Внешний вид объекта не меняется после создания (нет привязки к переменным и реакции на ввод).
+    // Такие объекты рисуются один раз в статический слой
+    virtual bool isStatic() const { return false; }
+
+    // Вид объекта меняется со временем и без записей в базу (тренд на оси времени):
+    // к моменту now экран устарел и нужен новый кадр. Проверяется только у объектов,
+    // которые рисуются поверх пакетов (drawOverlay)
+    virtual bool needsFrame(HistoryClock::time_point now) const { return false; }
+
+    // Область экрана, которую занимает объект (с учетом контура).
+    // По умолчанию - весь экран: такой объект не даст объединить в пакет геометрию поверх него
+    virtual sf::FloatRect getBounds() const;
     
     // Вспомогательные методы
     void setPosition(float newX, float newY);
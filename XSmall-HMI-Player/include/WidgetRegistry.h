@@ -0,0 +1,64 @@
+#ifndef WIDGETREGISTRY_H
+#define WIDGETREGISTRY_H
+
+#include "VariableDatabase.h"
+#include "VisualObject.h"
+#include <nlohmann/json.hpp>
+#include <string>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <unordered_map>
+#include <cstdint>
+
+namespace sf {
+    class Font;
+}
+
+// Номер типа объекта в реестре (имя типа разрешается один раз)
+using WidgetTypeId = std::uint32_t;
+constexpr WidgetTypeId INVALID_WIDGET_TYPE = 0xFFFFFFFFu;
+
+/**
+ * Реестр типов объектов сцены: имя типа ("Rectangle", "Button", ...) -> фабрика.
+ *
+ * Встроенные типы регистрируются при создании реестра, новые добавляются вызовом add()
+ * из своего модуля - загрузчик править не нужно. Регистрация - при запуске, до загрузки сцен;
+ * find() после этого можно вызывать из любого потока, фабрики - только из UI-потока
+ * (объекты подписываются на переменные и раскладывают текст шрифтом).
+ */
+class WidgetRegistry {
+public:
+    using Factory = std::function<std::unique_ptr<VisualObject>(
+        const nlohmann::json& objJson, VariableDatabase* db, sf::Font* font)>;
+
+private:
+    std::unordered_map<std::string, WidgetTypeId> typeIds;
+    std::vector<std::string> typeNames;
+    std::vector<Factory> factories;
+
+    void registerBuiltinTypes();
+
+public:
+    WidgetRegistry();
+
+    WidgetRegistry(const WidgetRegistry&) = delete;
+    WidgetRegistry& operator=(const WidgetRegistry&) = delete;
+
+    // Общий реестр плеера
+    static WidgetRegistry& instance();
+
+    // Регистрирует тип или заменяет фабрику уже зарегистрированного. Возвращает номер типа
+    WidgetTypeId add(const std::string& type, Factory factory);
+
+    // Номер типа или INVALID_WIDGET_TYPE
+    WidgetTypeId find(const std::string& type) const;
+
+    const std::string& getTypeName(WidgetTypeId id) const { return typeNames[id]; }
+
+    // Создает объект зарегистрированного типа (nullptr для INVALID_WIDGET_TYPE)
+    std::unique_ptr<VisualObject> create(WidgetTypeId id, const nlohmann::json& objJson,
+                                         VariableDatabase* db, sf::Font* font) const;
+};
+
+#endif
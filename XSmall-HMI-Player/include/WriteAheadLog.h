@@ -0,0 +1,100 @@
+#ifndef WRITEAHEADLOG_H
+#define WRITEAHEADLOG_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+/**
+ * Журнал упреждающей записи (WAL) для значений, введенных оператором между снимками состояния.
+ *
+ * Журнал состоит из сегментов <base>.<номер>: заголовок и записи
+ * [crc32][длина имени][номер записи][значение][имя]. Номера записей растут монотонно
+ * через все сегменты и перезапуски.
+ * append() в UI-потоке только кодирует запись в буфер; фоновый поток пишет накопившиеся
+ * записи одним блоком и один раз сбрасывает их на диск (групповая фиксация).
+ * При восстановлении записи читаются до первой поврежденной или недописанной:
+ * хвост, оборванный сбоем, отбрасывается.
+ *
+ * Снимок состояния вызывает rotate(): следующие записи идут в новый сегмент, а прежние
+ * удаляются removeSegmentsBefore(), когда снимок надежно записан.
+ */
+class WriteAheadLog {
+public:
+    using ApplyRecord = std::function<void(const std::string& name, double value)>;
+
+private:
+    // Записи одного сегмента, ожидающие записи на диск
+    struct Batch {
+        std::uint32_t segment;
+        std::string data;
+        std::uint64_t lastSequence;
+    };
+
+    std::string basePath;
+
+    std::thread writer;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable durable;
+    std::deque<Batch> batches;
+    std::uint64_t nextSequence;
+    std::uint64_t durableSequence;  // Все записи до этого номера на диске
+    std::uint32_t activeSegment;
+    bool recovered;
+    bool writing;
+    bool stopping;
+    std::uint64_t commitCount;
+
+    // Доступны только фоновому потоку
+    std::FILE* file;
+    std::uint32_t openSegment;
+    bool failed;
+
+    void writerLoop();
+    bool openSegmentFile(std::uint32_t segment);
+    void closeSegmentFile();
+    std::string segmentPath(std::uint32_t segment) const;
+
+    // Номера существующих сегментов по возрастанию
+    std::vector<std::uint32_t> listSegments() const;
+
+public:
+    explicit WriteAheadLog(const std::string& basePath);
+    ~WriteAheadLog();
+
+    WriteAheadLog(const WriteAheadLog&) = delete;
+    WriteAheadLog& operator=(const WriteAheadLog&) = delete;
+
+    // Читает все сегменты и применяет записи с номером больше afterSequence (в порядке записи).
+    // Вызывается один раз до первой записи; новые записи пойдут в новый сегмент.
+    // Возвращает число примененных записей
+    std::size_t recover(std::uint64_t afterSequence, const ApplyRecord& apply);
+
+    // Ставит запись в очередь (UI-поток). Возвращает ее номер
+    std::uint64_t append(const std::string& name, double value);
+
+    // Начинает новый сегмент. Возвращает номер последней записи в прежних сегментах
+    std::uint64_t rotate(std::uint32_t& newSegment);
+
+    // Удаляет сегменты с номером меньше segment (их записи вошли в снимок)
+    void removeSegmentsBefore(std::uint32_t segment);
+
+    // Дожидается, пока все поставленные записи окажутся на диске
+    void flush();
+
+    // Сколько раз записи сбрасывались на диск (каждый раз - группа записей)
+    std::uint64_t getCommitCount();
+    std::uint64_t getLastSequence();
+
+    const std::string& getBasePath() const { return basePath; }
+};
+
+#endif
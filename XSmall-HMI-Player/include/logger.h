@@ -3,29 +3,296 @@
 
 #include <iostream>
 #include <string>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <memory>
+#include <cstdint>
 
 /**
- * Простая система логирования с тремя уровнями:
+ * Асинхронная система логирования с четырьмя уровнями:
+ * - DEBUG: Отладочные сообщения (частые, по умолчанию выключены)
  * - INFO: Информационные сообщения
  * - WARNING: Предупреждения
  * - ERROR: Критические ошибки
- * 
- * Все сообщения выводятся в консоль с соответствующими префиксами.
+ *
+ * Сообщения кладутся в lock-free кольцевой буфер и выводятся фоновым потоком,
+ * поэтому вызов логгера не блокирует UI-поток и не делает flush на каждую строку.
+ * При переполнении буфера сообщения отбрасываются (с подсчетом), а не ждут.
+ *
+ * Фильтрация по уровню:
+ * - во время компиляции: HMI_LOG_MIN_LEVEL (0 - DEBUG ... 4 - выключено);
+ * - во время работы: Logger::setLevel().
+ * Макросы LOG_* вычисляют текст сообщения только если уровень включен,
+ * а LOG_*_RATE_LIMITED дополнительно ограничивают частоту сообщений из одного места кода.
  */
 
+#ifndef HMI_LOG_MIN_LEVEL
+#define HMI_LOG_MIN_LEVEL 0
+#endif
+
+enum class LogLevel : int {
+    Debug = 0,
+    Info = 1,
+    Warning = 2,
+    Error = 3,
+    Off = 4
+};
+
 class Logger {
 public:
+    static void debug(const std::string& message) {
+        log(LogLevel::Debug, message);
+    }
+    
     static void info(const std::string& message) {
-        std::cout << "[INFO] " << message << std::endl;
+        log(LogLevel::Info, message);
     }
     
     static void error(const std::string& message) {
-        std::cerr << "[ERROR] " << message << std::endl;
+        log(LogLevel::Error, message);
     }
     
     static void warning(const std::string& message) {
-        std::cout << "[WARNING] " << message << std::endl;
+        log(LogLevel::Warning, message);
+    }
+
+    static void log(LogLevel level, std::string message) {
+        if (isEnabled(level)) {
+            instance().push(level, std::move(message));
+        }
+    }
+
+    static bool isEnabled(LogLevel level) {
+        return static_cast<int>(level) >= HMI_LOG_MIN_LEVEL &&
+               static_cast<int>(level) >= runtimeLevel().load(std::memory_order_relaxed);
+    }
+
+    // Минимальный уровень, который выводится во время работы (по умолчанию INFO)
+    static void setLevel(LogLevel level) {
+        runtimeLevel().store(static_cast<int>(level), std::memory_order_relaxed);
+    }
+
+    static LogLevel getLevel() {
+        return static_cast<LogLevel>(runtimeLevel().load(std::memory_order_relaxed));
+    }
+
+    // Перенаправляет вывод (например, в файл или в пустой поток для бенчмарков)
+    static void setStreams(std::ostream& out, std::ostream& err) {
+        Logger& logger = instance();
+        logger.out.store(&out);
+        logger.err.store(&err);
+    }
+
+    // Дожидается вывода всех сообщений, поставленных в очередь до вызова
+    static void flush() {
+        Logger& logger = instance();
+        std::uint64_t target = logger.enqueued.load(std::memory_order_acquire);
+        logger.wakeup.notify_one();
+        for (int i = 0; i < 1000 && logger.written.load(std::memory_order_acquire) < target; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    // Количество сообщений, отброшенных из-за переполнения буфера
+    static std::uint64_t droppedCount() {
+        return instance().dropped.load(std::memory_order_relaxed);
+    }
+
+    ~Logger() {
+        stopping.store(true);
+        wakeup.notify_one();
+        if (writer.joinable()) {
+            writer.join();
+        }
+    }
+
+private:
+    // Ячейка кольцевого буфера (ограниченная очередь Вьюкова)
+    struct Cell {
+        std::atomic<std::size_t> sequence;
+        LogLevel level;
+        std::string text;
+    };
+
+    static constexpr std::size_t QUEUE_SIZE = 8192;  // Степень двойки
+
+    std::unique_ptr<Cell[]> cells;
+    std::atomic<std::size_t> enqueuePos{0};
+    std::size_t dequeuePos = 0;  // Только фоновый поток
+
+    std::atomic<std::uint64_t> enqueued{0};
+    std::atomic<std::uint64_t> written{0};
+    std::atomic<std::uint64_t> dropped{0};
+    std::atomic<std::ostream*> out{&std::cout};
+    std::atomic<std::ostream*> err{&std::cerr};
+
+    std::atomic<bool> stopping{false};
+    std::mutex wakeupMutex;
+    std::condition_variable wakeup;
+    std::thread writer;
+
+    Logger() : cells(std::make_unique<Cell[]>(QUEUE_SIZE)) {
+        for (std::size_t i = 0; i < QUEUE_SIZE; ++i) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        writer = std::thread([this]() { writerLoop(); });
+    }
+
+    static Logger& instance() {
+        static Logger logger;
+        return logger;
+    }
+
+    static std::atomic<int>& runtimeLevel() {
+        static std::atomic<int> level(static_cast<int>(LogLevel::Info));
+        return level;
+    }
+
+    static const char* prefix(LogLevel level) {
+        switch (level) {
+            case LogLevel::Debug: return "[DEBUG] ";
+            case LogLevel::Info: return "[INFO] ";
+            case LogLevel::Warning: return "[WARNING] ";
+            default: return "[ERROR] ";
+        }
+    }
+
+    // Вызывается из любого потока, без блокировок
+    void push(LogLevel level, std::string&& message) {
+        std::size_t pos = enqueuePos.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells[pos & (QUEUE_SIZE - 1)];
+            std::size_t seq = cell.sequence.load(std::memory_order_acquire);
+            std::intptr_t diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.level = level;
+                    cell.text = std::move(message);
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    enqueued.fetch_add(1, std::memory_order_release);
+                    break;
+                }
+            } else if (diff < 0) {
+                // Буфер заполнен - не блокируем вызывающий поток
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            } else {
+                pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        // Ошибки выводим без задержки, остальное - пачками
+        if (level >= LogLevel::Error) {
+            wakeup.notify_one();
+        }
+    }
+
+    void writerLoop() {
+        std::uint64_t reportedDrops = 0;
+        for (;;) {
+            bool any = false;
+            for (;;) {
+                Cell& cell = cells[dequeuePos & (QUEUE_SIZE - 1)];
+                std::size_t seq = cell.sequence.load(std::memory_order_acquire);
+                if (seq != dequeuePos + 1) {
+                    break;
+                }
+
+                std::ostream& stream = cell.level >= LogLevel::Error ? *err.load() : *out.load();
+                stream << prefix(cell.level) << cell.text << '\n';
+                cell.text.clear();
+                cell.sequence.store(dequeuePos + QUEUE_SIZE, std::memory_order_release);
+                ++dequeuePos;
+                written.fetch_add(1, std::memory_order_release);
+                any = true;
+            }
+
+            std::uint64_t drops = dropped.load(std::memory_order_relaxed);
+            if (drops != reportedDrops) {
+                *out.load() << "[WARNING] Logger dropped " << (drops - reportedDrops) << " messages\n";
+                reportedDrops = drops;
+                any = true;
+            }
+
+            if (any) {
+                // Один flush на пачку сообщений вместо std::endl на каждую строку
+                out.load()->flush();
+                err.load()->flush();
+                continue;
+            }
+            if (stopping.load()) {
+                break;
+            }
+
+            std::unique_lock<std::mutex> lock(wakeupMutex);
+            wakeup.wait_for(lock, std::chrono::milliseconds(10));
+        }
     }
 };
 
-#endif
\ No newline at end of file
+/**
+ * Ограничитель частоты сообщений для одного места вызова (не более perSecond в секунду).
+ * Пропущенные сообщения подсчитываются и упоминаются в следующем выведенном.
+ */
+class LogRateLimiter {
+private:
+    std::int64_t intervalNs;
+    std::atomic<std::int64_t> nextAllowedNs{0};
+    std::atomic<std::uint32_t> suppressed{0};
+
+public:
+    explicit LogRateLimiter(double perSecond)
+        : intervalNs(static_cast<std::int64_t>(1e9 / (perSecond > 0 ? perSecond : 1.0))) {}
+
+    // true, если сообщение можно вывести; suppressedCount - сколько пропущено с прошлого раза
+    bool allow(std::uint32_t& suppressedCount) {
+        std::int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+        std::int64_t next = nextAllowedNs.load(std::memory_order_relaxed);
+        if (now < next || !nextAllowedNs.compare_exchange_strong(next, now + intervalNs, std::memory_order_relaxed)) {
+            suppressed.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        suppressedCount = suppressed.exchange(0, std::memory_order_relaxed);
+        return true;
+    }
+};
+
+// Текст сообщения вычисляется только если уровень включен (во время компиляции и работы)
+#define HMI_LOG(level, message)                                                      \
+    do {                                                                             \
+        if (static_cast<int>(level) >= HMI_LOG_MIN_LEVEL && Logger::isEnabled(level)) { \
+            Logger::log(level, message);                                             \
+        }                                                                            \
+    } while (0)
+
+// Не чаще perSecond сообщений в секунду из данного места кода
+#define HMI_LOG_RATE_LIMITED(level, perSecond, message)                              \
+    do {                                                                             \
+        if (static_cast<int>(level) >= HMI_LOG_MIN_LEVEL && Logger::isEnabled(level)) { \
+            static LogRateLimiter hmiLogLimiter(perSecond);                          \
+            std::uint32_t hmiLogSuppressed = 0;                                      \
+            if (hmiLogLimiter.allow(hmiLogSuppressed)) {                             \
+                std::string hmiLogText = (message);                                  \
+                if (hmiLogSuppressed > 0) {                                          \
+                    hmiLogText += " (" + std::to_string(hmiLogSuppressed) + " similar suppressed)"; \
+                }                                                                    \
+                Logger::log(level, std::move(hmiLogText));                           \
+            }                                                                        \
+        }                                                                            \
+    } while (0)
+
+#define LOG_DEBUG(message) HMI_LOG(LogLevel::Debug, message)
+#define LOG_INFO(message) HMI_LOG(LogLevel::Info, message)
+#define LOG_WARNING(message) HMI_LOG(LogLevel::Warning, message)
+#define LOG_ERROR(message) HMI_LOG(LogLevel::Error, message)
+
+#define LOG_DEBUG_RATE_LIMITED(perSecond, message) HMI_LOG_RATE_LIMITED(LogLevel::Debug, perSecond, message)
+#define LOG_INFO_RATE_LIMITED(perSecond, message) HMI_LOG_RATE_LIMITED(LogLevel::Info, perSecond, message)
+#define LOG_WARNING_RATE_LIMITED(perSecond, message) HMI_LOG_RATE_LIMITED(LogLevel::Warning, perSecond, message)
+#define LOG_ERROR_RATE_LIMITED(perSecond, message) HMI_LOG_RATE_LIMITED(LogLevel::Error, perSecond, message)
+
+#endif
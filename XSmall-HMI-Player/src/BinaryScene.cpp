@@ -0,0 +1,497 @@
+#include "BinaryScene.h"
+#include "Rectangle.h"
+#include "Text.h"
+#include "Line.h"
+#include "Polyline.h"
+#include "InputField.h"
+#include "Button.h"
+#include "HistoryGraph.h"
+#include "Image.h"
+#include "ResourceManager.h"
+#include "logger.h"
+#include <filesystem>
+#include <fstream>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+
+namespace {
+    constexpr std::size_t SCENE_ALIGNMENT = 8;
+
+    std::size_t alignUp(std::size_t size) {
+        return (size + SCENE_ALIGNMENT - 1) & ~(SCENE_ALIGNMENT - 1);
+    }
+
+    void padTo(std::vector<char>& buffer, std::size_t size) {
+        buffer.resize(size, 0);
+    }
+
+    void append(std::vector<char>& buffer, const void* data, std::size_t size) {
+        const char* bytes = static_cast<const char*>(data);
+        buffer.insert(buffer.end(), bytes, bytes + size);
+    }
+
+    // Запись нужного типа, если она целиком (вместе с хвостом) помещается в объявленный размер
+    template <typename Record>
+    const Record* recordAs(const SceneRecordHeader* header) {
+        return header->size >= sizeof(Record) ? reinterpret_cast<const Record*>(header) : nullptr;
+    }
+}
+
+// SceneWriter
+
+SceneWriter::SceneWriter() {
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, SceneFileHeader::MAGIC, sizeof(header.magic));
+    header.version = SceneFileHeader::VERSION;
+    header.settings.atlasCacheDir = SCENE_NO_INDEX;
+    header.settings.historianDir = SCENE_NO_INDEX;
+    intern("");  // Строка 0 - пустая
+}
+
+std::uint32_t SceneWriter::intern(const std::string& str) {
+    auto it = stringIndices.find(str);
+    if (it != stringIndices.end()) {
+        return it->second;
+    }
+
+    std::uint32_t index = static_cast<std::uint32_t>(stringEntries.size());
+    stringEntries.push_back({static_cast<std::uint32_t>(stringData.size()),
+                             static_cast<std::uint32_t>(str.size())});
+    stringData += str;
+    stringIndices.emplace(str, index);
+    return index;
+}
+
+std::uint32_t SceneWriter::tag(const std::string& name) {
+    if (name.empty()) {
+        return SCENE_NO_INDEX;
+    }
+
+    auto it = tagIndices.find(name);
+    if (it != tagIndices.end()) {
+        return it->second;
+    }
+
+    std::uint32_t index = static_cast<std::uint32_t>(tags.size());
+    tags.push_back(intern(name));
+    tagIndices.emplace(name, index);
+    return index;
+}
+
+void SceneWriter::setSettings(const PlayerSettings& settings) {
+    SceneSettingsRecord& record = header.settings;
+    record.renderRate = settings.scheduler.renderRate;
+    record.tickRate = settings.scheduler.tickRate;
+    record.inputRate = settings.scheduler.inputRate;
+    record.maxTicksPerFrame = settings.scheduler.maxTicksPerFrame;
+    record.timerResolutionMs = settings.scheduler.timerResolutionMs;
+    record.autosaveIntervalMs = settings.autosaveIntervalMs;
+    record.demoIntervalMs = settings.demoIntervalMs;
+    record.atlasCacheDir = intern(settings.atlasCacheDir);
+    record.historianDir = intern(settings.historianDir);
+    record.historianRetentionDays = settings.historianRetentionDays;
+    record.historianChunkSeconds = settings.historianChunkSeconds;
+
+    std::string stateTags;
+    for (const auto& name : settings.stateTags) {
+        stateTags += stateTags.empty() ? name : "\n" + name;
+    }
+    record.stateTags = intern(stateTags);
+}
+
+void SceneWriter::addHistoryPolicy(const std::string& tagName, const HistoryPolicy& policy) {
+    SceneHistoryPolicyRecord record = {};
+    record.tag = tag(tagName);
+    record.flags = (policy.compressed ? SceneHistoryPolicyRecord::COMPRESSED : 0) |
+                   (policy.persistent ? SceneHistoryPolicyRecord::PERSISTENT : 0);
+    record.capacity = policy.capacity;
+    record.deadband = policy.deadband;
+    record.swingingDoor = policy.swingingDoor;
+    policies.push_back(record);
+}
+
+void SceneWriter::addNotifyDeadband(const std::string& tagName, const NotifyDeadband& deadband) {
+    SceneNotifyDeadbandRecord record = {};
+    record.tag = tag(tagName);
+    record.absolute = deadband.absolute;
+    record.percent = deadband.percent;
+    record.span = deadband.span;
+    deadbands.push_back(record);
+}
+
+void SceneWriter::setSource(std::uint64_t size, std::int64_t time) {
+    header.sourceSize = size;
+    header.sourceTime = time;
+}
+
+void SceneWriter::appendRecord(SceneRecordHeader& recordHeader, std::size_t recordSize,
+                               const void* extra, std::size_t extraSize) {
+    recordHeader.reserved = 0;
+    recordHeader.size = static_cast<std::uint32_t>(alignUp(recordSize + extraSize));
+
+    std::size_t start = records.size();
+    append(records, &recordHeader, recordSize);
+    if (extraSize > 0) {
+        append(records, extra, extraSize);
+    }
+    padTo(records, start + recordHeader.size);
+    ++header.objectCount;
+}
+
+bool SceneWriter::write(const std::string& path) const {
+    SceneFileHeader fileHeader = header;
+    fileHeader.stringCount = static_cast<std::uint32_t>(stringEntries.size());
+    fileHeader.tagCount = static_cast<std::uint32_t>(tags.size());
+    fileHeader.policyCount = static_cast<std::uint32_t>(policies.size());
+    fileHeader.deadbandCount = static_cast<std::uint32_t>(deadbands.size());
+
+    // Раскладка: заголовок, таблица строк, символы, переменные, записи объектов, политики истории,
+    // зоны нечувствительности
+    std::vector<char> buffer;
+    buffer.reserve(sizeof(fileHeader) + stringEntries.size() * sizeof(SceneStringEntry) +
+                   stringData.size() + tags.size() * sizeof(std::uint32_t) + records.size() +
+                   policies.size() * sizeof(SceneHistoryPolicyRecord) +
+                   deadbands.size() * sizeof(SceneNotifyDeadbandRecord) + 32);
+    padTo(buffer, alignUp(sizeof(fileHeader)));
+
+    fileHeader.stringsOffset = buffer.size();
+    append(buffer, stringEntries.data(), stringEntries.size() * sizeof(SceneStringEntry));
+    append(buffer, stringData.data(), stringData.size());
+    padTo(buffer, alignUp(buffer.size()));
+
+    fileHeader.tagsOffset = buffer.size();
+    append(buffer, tags.data(), tags.size() * sizeof(std::uint32_t));
+    padTo(buffer, alignUp(buffer.size()));
+
+    fileHeader.recordsOffset = buffer.size();
+    append(buffer, records.data(), records.size());
+    padTo(buffer, alignUp(buffer.size()));
+
+    fileHeader.policiesOffset = buffer.size();
+    append(buffer, policies.data(), policies.size() * sizeof(SceneHistoryPolicyRecord));
+
+    fileHeader.deadbandsOffset = buffer.size();
+    append(buffer, deadbands.data(), deadbands.size() * sizeof(SceneNotifyDeadbandRecord));
+
+    fileHeader.fileSize = buffer.size();
+    std::memcpy(buffer.data(), &fileHeader, sizeof(fileHeader));
+
+    std::string tempPath = path + ".tmp";
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            Logger::error("Cannot write compiled scene: " + tempPath);
+            return false;
+        }
+        out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        if (!out) {
+            Logger::error("Failed to write compiled scene: " + tempPath);
+            std::remove(tempPath.c_str());
+            return false;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempPath, path, error);
+    if (error) {
+        Logger::error("Cannot replace compiled scene " + path + ": " + error.message());
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+// BinaryScene
+
+BinaryScene::BinaryScene() : header(nullptr) {}
+
+bool BinaryScene::open(const std::string& path) {
+    close();
+    if (!file.open(path)) {
+        return false;
+    }
+
+    const char* data = file.getData();
+    std::size_t size = file.getSize();
+    const SceneFileHeader* candidate = reinterpret_cast<const SceneFileHeader*>(data);
+
+    // Таблицы должны лежать внутри файла, иначе сцена повреждена или от другой версии
+    bool valid = size >= sizeof(SceneFileHeader) &&
+                 std::memcmp(candidate->magic, SceneFileHeader::MAGIC, sizeof(candidate->magic)) == 0 &&
+                 candidate->version == SceneFileHeader::VERSION &&
+                 candidate->fileSize == size &&
+                 candidate->stringsOffset + std::uint64_t(candidate->stringCount) * sizeof(SceneStringEntry) <= size &&
+                 candidate->tagsOffset + std::uint64_t(candidate->tagCount) * sizeof(std::uint32_t) <= size &&
+                 candidate->recordsOffset <= size &&
+                 candidate->policiesOffset + std::uint64_t(candidate->policyCount) * sizeof(SceneHistoryPolicyRecord) <= size &&
+                 candidate->deadbandsOffset + std::uint64_t(candidate->deadbandCount) * sizeof(SceneNotifyDeadbandRecord) <= size &&
+                 candidate->stringsOffset % SCENE_ALIGNMENT == 0 &&
+                 candidate->tagsOffset % SCENE_ALIGNMENT == 0 &&
+                 candidate->recordsOffset % SCENE_ALIGNMENT == 0 &&
+                 candidate->policiesOffset % SCENE_ALIGNMENT == 0 &&
+                 candidate->deadbandsOffset % SCENE_ALIGNMENT == 0;
+    if (!valid) {
+        Logger::warning("Ignoring invalid compiled scene: " + path);
+        file.close();
+        return false;
+    }
+
+    header = candidate;
+    return true;
+}
+
+void BinaryScene::close() {
+    header = nullptr;
+    file.close();
+}
+
+std::string BinaryScene::getString(std::uint32_t index) const {
+    if (index >= header->stringCount) {
+        return std::string();
+    }
+
+    const char* data = file.getData();
+    const SceneStringEntry* entries = reinterpret_cast<const SceneStringEntry*>(data + header->stringsOffset);
+    std::uint64_t charsOffset = header->stringsOffset + std::uint64_t(header->stringCount) * sizeof(SceneStringEntry);
+    const SceneStringEntry& entry = entries[index];
+    if (charsOffset + entry.offset + entry.length > file.getSize()) {
+        return std::string();
+    }
+    return std::string(data + charsOffset + entry.offset, entry.length);
+}
+
+bool BinaryScene::isUpToDate(const std::string& jsonFile) const {
+    std::uint64_t size = 0;
+    std::int64_t time = 0;
+    return header && getSourceStamp(jsonFile, size, time) &&
+           header->sourceSize == size && header->sourceTime == time;
+}
+
+void BinaryScene::readPlayerSettings(PlayerSettings& settings) const {
+    if (!header) {
+        return;
+    }
+
+    const SceneSettingsRecord& record = header->settings;
+    settings.scheduler.renderRate = record.renderRate;
+    settings.scheduler.tickRate = record.tickRate;
+    settings.scheduler.inputRate = record.inputRate;
+    settings.scheduler.maxTicksPerFrame = record.maxTicksPerFrame;
+    settings.scheduler.timerResolutionMs = record.timerResolutionMs;
+    settings.autosaveIntervalMs = record.autosaveIntervalMs;
+    settings.demoIntervalMs = record.demoIntervalMs;
+    settings.atlasCacheDir = getString(record.atlasCacheDir);
+    settings.historianDir = getString(record.historianDir);
+    settings.historianRetentionDays = record.historianRetentionDays;
+    settings.historianChunkSeconds = record.historianChunkSeconds;
+
+    settings.stateTags.clear();
+    std::string stateTags = getString(record.stateTags);
+    for (std::size_t begin = 0; begin < stateTags.size();) {
+        std::size_t end = std::min(stateTags.find('\n', begin), stateTags.size());
+        settings.stateTags.push_back(stateTags.substr(begin, end - begin));
+        begin = end + 1;
+    }
+}
+
+std::vector<std::unique_ptr<VisualObject>> BinaryScene::instantiate(VariableDatabase* db, sf::Font* font) const {
+    std::vector<std::unique_ptr<VisualObject>> objects;
+    if (!header) {
+        return objects;
+    }
+
+    if (header->historyCapacity > 0 && db) {
+        db->setDefaultHistoryCapacity(header->historyCapacity);
+    }
+
+    // Имена переменных собираем один раз, записи ссылаются на них по номеру
+    const std::uint32_t* tagTable = reinterpret_cast<const std::uint32_t*>(file.getData() + header->tagsOffset);
+    std::vector<std::string> tagNames;
+    tagNames.reserve(header->tagCount);
+    for (std::uint32_t i = 0; i < header->tagCount; ++i) {
+        tagNames.push_back(getString(tagTable[i]));
+    }
+    static const std::string noTag;
+    auto tagName = [&tagNames](std::uint32_t index) -> const std::string& {
+        return index < tagNames.size() ? tagNames[index] : noTag;
+    };
+
+    // Политики истории - до объектов, как и в JSONLoader
+    const SceneHistoryPolicyRecord* policies =
+        reinterpret_cast<const SceneHistoryPolicyRecord*>(file.getData() + header->policiesOffset);
+    for (std::uint32_t i = 0; i < header->policyCount && db; ++i) {
+        const std::string& name = tagName(policies[i].tag);
+        if (name.empty()) {
+            continue;
+        }
+        HistoryPolicy policy;
+        policy.capacity = static_cast<std::size_t>(policies[i].capacity);
+        policy.deadband = policies[i].deadband;
+        policy.swingingDoor = policies[i].swingingDoor;
+        policy.compressed = (policies[i].flags & SceneHistoryPolicyRecord::COMPRESSED) != 0;
+        policy.persistent = (policies[i].flags & SceneHistoryPolicyRecord::PERSISTENT) != 0;
+        db->setHistoryPolicy(db->resolveTag(name), policy);
+    }
+    const SceneNotifyDeadbandRecord* deadbands =
+        reinterpret_cast<const SceneNotifyDeadbandRecord*>(file.getData() + header->deadbandsOffset);
+    for (std::uint32_t i = 0; i < header->deadbandCount && db; ++i) {
+        const std::string& name = tagName(deadbands[i].tag);
+        if (name.empty()) {
+            continue;
+        }
+        NotifyDeadband deadband;
+        deadband.absolute = deadbands[i].absolute;
+        deadband.percent = deadbands[i].percent;
+        deadband.span = deadbands[i].span;
+        db->setNotifyDeadband(db->resolveTag(name), deadband);
+    }
+
+    // Проверенные границы записей: первый проход нужен и для атласа изображений
+    std::vector<const SceneRecordHeader*> recordHeaders;
+    recordHeaders.reserve(header->objectCount);
+    std::size_t offset = header->recordsOffset;
+    for (std::uint32_t i = 0; i < header->objectCount; ++i) {
+        if (offset + sizeof(SceneRecordHeader) > file.getSize()) {
+            break;
+        }
+        const SceneRecordHeader* record = reinterpret_cast<const SceneRecordHeader*>(file.getData() + offset);
+        if (record->size < sizeof(SceneRecordHeader) || record->size % SCENE_ALIGNMENT != 0 ||
+            offset + record->size > file.getSize()) {
+            break;
+        }
+        recordHeaders.push_back(record);
+        offset += record->size;
+    }
+    if (recordHeaders.size() != header->objectCount) {
+        Logger::warning("Compiled scene is truncated, loaded " + std::to_string(recordHeaders.size()) +
+                        " of " + std::to_string(header->objectCount) + " objects");
+    }
+
+    // Изображения упаковываем в атлас до создания объектов, как и при загрузке из JSON
+    std::vector<std::string> imagePaths;
+    for (const SceneRecordHeader* record : recordHeaders) {
+        if (record->type == SceneObjectType::Image) {
+            if (const SceneImageRecord* image = recordAs<SceneImageRecord>(record)) {
+                std::string path = getString(image->path);
+                if (!path.empty()) {
+                    imagePaths.push_back(std::move(path));
+                }
+            }
+        }
+    }
+    if (!imagePaths.empty()) {
+        ResourceManager::instance().buildAtlas(imagePaths);
+    }
+
+    objects.reserve(recordHeaders.size());
+    for (const SceneRecordHeader* record : recordHeaders) {
+        float x = record->x;
+        float y = record->y;
+        std::string name = getString(record->name);
+        const std::string& variable = tagName(record->tag);
+
+        std::unique_ptr<VisualObject> obj;
+        switch (record->type) {
+        case SceneObjectType::Rectangle:
+            if (const SceneRectangleRecord* r = recordAs<SceneRectangleRecord>(record)) {
+                if (sizeof(*r) + std::size_t(r->conditionCount) * sizeof(SceneConditionRecord) > record->size) {
+                    break;
+                }
+                auto rect = std::make_unique<Rectangle>(x, y, r->width, r->height, sf::Color(r->color),
+                                                        name, db, variable);
+                const SceneConditionRecord* conditions = reinterpret_cast<const SceneConditionRecord*>(r + 1);
+                for (std::uint32_t c = 0; c < r->conditionCount; ++c) {
+                    rect->addCondition(conditions[c].value, sf::Color(conditions[c].color));
+                }
+                obj = std::move(rect);
+            }
+            break;
+        case SceneObjectType::Text:
+            if (const SceneTextRecord* t = recordAs<SceneTextRecord>(record)) {
+                obj = std::make_unique<Text>(x, y, getString(t->content), font, t->fontSize, sf::Color(t->color),
+                                             name, db, variable, getString(t->format));
+            }
+            break;
+        case SceneObjectType::Line:
+            if (const SceneLineRecord* l = recordAs<SceneLineRecord>(record)) {
+                obj = std::make_unique<Line>(x, y, l->x2, l->y2, sf::Color(l->color), name, db);
+            }
+            break;
+        case SceneObjectType::Polyline:
+            if (const ScenePolylineRecord* p = recordAs<ScenePolylineRecord>(record)) {
+                if (sizeof(*p) + std::size_t(p->pointCount) * 2 * sizeof(float) > record->size) {
+                    break;
+                }
+                const float* coords = reinterpret_cast<const float*>(p + 1);
+                std::vector<sf::Vector2f> points;
+                points.reserve(p->pointCount);
+                for (std::uint32_t k = 0; k < p->pointCount; ++k) {
+                    points.emplace_back(coords[2 * k], coords[2 * k + 1]);
+                }
+                obj = std::make_unique<Polyline>(points, sf::Color(p->color), name, db, variable);
+            }
+            break;
+        case SceneObjectType::InputField:
+            if (const SceneInputFieldRecord* f = recordAs<SceneInputFieldRecord>(record)) {
+                obj = std::make_unique<InputField>(x, y, f->width, f->height, font, f->fontSize, name, db, variable);
+            }
+            break;
+        case SceneObjectType::Button:
+            if (const SceneButtonRecord* b = recordAs<SceneButtonRecord>(record)) {
+                auto button = std::make_unique<Button>(x, y, b->width, b->height, getString(b->text), font,
+                                                       b->fontSize, sf::Color(b->color), name, db, variable,
+                                                       nullptr, sf::Color(b->textColor));
+                if (b->action != SCENE_NO_INDEX) {
+                    button->setAction(getString(b->action), db);
+                }
+                obj = std::move(button);
+            }
+            break;
+        case SceneObjectType::HistoryGraph:
+            if (const SceneHistoryGraphRecord* g = recordAs<SceneHistoryGraphRecord>(record)) {
+                auto graph = std::make_unique<HistoryGraph>(x, y, g->width, g->height, name, db, variable,
+                                                            static_cast<std::size_t>(g->maxHistory),
+                                                            sf::Color(g->lineColor), sf::Color(g->gridColor));
+                if (g->timeWindow > 0) {
+                    graph->setTimeWindow(g->timeWindow, g->sampleRate);
+                }
+                obj = std::move(graph);
+            }
+            break;
+        case SceneObjectType::Image:
+            if (const SceneImageRecord* image = recordAs<SceneImageRecord>(record)) {
+                obj = std::make_unique<Image>(x, y, image->width, image->height, getString(image->path), name, db);
+            }
+            break;
+        }
+
+        if (obj) {
+            objects.push_back(std::move(obj));
+        } else {
+            Logger::warning("Skipping invalid compiled scene record: " + name);
+        }
+    }
+
+    return objects;
+}
+
+std::string BinaryScene::pathFor(const std::string& jsonFile) {
+    return std::filesystem::path(jsonFile).replace_extension(".hmiscene").string();
+}
+
+bool BinaryScene::getSourceStamp(const std::string& path, std::uint64_t& size, std::int64_t& time) {
+    std::error_code error;
+    std::uintmax_t fileSize = std::filesystem::file_size(path, error);
+    if (error) {
+        return false;
+    }
+    auto writeTime = std::filesystem::last_write_time(path, error);
+    if (error) {
+        return false;
+    }
+
+    size = fileSize;
+    time = static_cast<std::int64_t>(writeTime.time_since_epoch().count());
+    return true;
+}
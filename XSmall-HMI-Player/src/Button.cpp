@@ -7,6 +7,7 @@ Button::Button(float x, float y, float width, float height,
                const std::string& varName, std::function<void()> onClickFunc,
                const sf::Color& textClr)  
     : VisualObject(x, y, name, db), font(font), variableName(varName),
+      tag(!varName.empty() && db ? db->resolveTag(varName) : INVALID_TAG),
       normalColor(color), 
       hoverColor(sf::Color(std::max(0, color.r - 30), std::max(0, color.g - 30), std::max(0, color.b - 30), color.a)),
       pressedColor(sf::Color(std::max(0, color.r - 50), std::max(0, color.g - 50), std::max(0, color.b - 50), color.a)),
@@ -31,57 +32,88 @@ Button::Button(float x, float y, float width, float height,
     text.setOrigin(textBounds.left + textBounds.width / 2, 
                    textBounds.top + textBounds.height / 2);
     
-    if (!variableName.empty() && database) {
-        database->subscribe(variableName, [this](double value) {
+    if (tag != INVALID_TAG) {
+        subscribe(tag, [this](double value) {
             this->update();
         });
     }
 }
 
-void Button::draw(sf::RenderWindow& window) {
-    window.draw(shape);
-    window.draw(text);
+void Button::draw(sf::RenderTarget& target) {
+    target.draw(shape);
+    target.draw(text);
+}
+
+void Button::attachToBatch(RenderBatch& batch) {
+    batchRange = batch.allocate(RenderBatch::QUAD_VERTICES + RenderBatch::OUTLINE_VERTICES);
+    sf::FloatRect rect(x, y, shape.getSize().x, shape.getSize().y);
+    sf::Vertex* out = RenderBatch::writeQuad(batch.data(batchRange), rect, shape.getFillColor());
+    RenderBatch::writeOutline(out, rect, shape.getOutlineThickness(), shape.getOutlineColor());
+    if (batch.getTexture()) {
+        // Заливка берется из белого участка атласа шрифта - надпись ложится в тот же пакет
+        RenderBatch::setTexCoords(batch.data(batchRange), batchRange.count, TextRun::SOLID_TEX_COORDS);
+    }
+    textRun.attach(batch, text);
+}
+
+void Button::drawOverlay(sf::RenderTarget& target) {
+    target.draw(text);
+}
+
+sf::FloatRect Button::getBounds() const {
+    float outline = shape.getOutlineThickness();
+    return sf::FloatRect(x - outline, y - outline,
+                         shape.getSize().x + 2 * outline, shape.getSize().y + 2 * outline);
+}
+
+void Button::setFillColor(const sf::Color& color) {
+    shape.setFillColor(color);
+
+    // Перекрашиваем только фон (первые вершины участка), рамка не меняется
+    if (batchRange.attached()) {
+        RenderBatch::setColor(batchRange.batch->data(batchRange), RenderBatch::QUAD_VERTICES, color);
+        batchRange.batch->markDirty(batchRange);
+    }
 }
 
 void Button::update() {
-    if (!variableName.empty() && database) {
+    if (tag != INVALID_TAG) {
         // Кнопка, привязанная к переменной: цвет зависит от значения
-        double value = database->getVariable(variableName);
+        double value = database->get(tag);
         if (value == 0) {
-            shape.setFillColor(normalColor);
+            setFillColor(normalColor);
         } else {
-            shape.setFillColor(pressedColor);
+            setFillColor(pressedColor);
         }
     } else {
         // Обычная кнопка: цвет зависит от состояние мыши
         if (isPressed) {
-            shape.setFillColor(pressedColor);
+            setFillColor(pressedColor);
         } else if (isHovered) {
-            shape.setFillColor(hoverColor);
+            setFillColor(hoverColor);
         } else {
-            shape.setFillColor(normalColor);
+            setFillColor(normalColor);
         }
     }
 }
 
+void Button::setHovered(bool hovered) {
+    isHovered = hovered;
+    update();
+}
+
 void Button::handleEvent(const sf::Event& event, sf::RenderWindow& window) {
-    sf::Vector2i mousePos = sf::Mouse::getPosition(window);
-    bool mouseOver = contains(static_cast<float>(mousePos.x), static_cast<float>(mousePos.y));
-    
-    if (event.type == sf::Event::MouseMoved) {
-        isHovered = mouseOver;
-        update();
-    }
-    
+    // События приходят от EventRouter: нажатие - только если курсор над кнопкой,
+    // отпускание - если нажатие было на ней; наведение уже пересчитано по положению курсора
     if (event.type == sf::Event::MouseButtonPressed) {
-        if (event.mouseButton.button == sf::Mouse::Left && mouseOver) {
+        if (event.mouseButton.button == sf::Mouse::Left) {
             isPressed = true;
             update();
         }
     }
     
     if (event.type == sf::Event::MouseButtonReleased) {
-        if (event.mouseButton.button == sf::Mouse::Left && isPressed && mouseOver) {
+        if (event.mouseButton.button == sf::Mouse::Left && isPressed && isHovered) {
             if (onClick) {
                 onClick();
             }
@@ -109,44 +141,50 @@ void Button::setOnClick(std::function<void()> onClickFunc) {
 void Button::setTextColor(const sf::Color& color) {
     textColor = color;
     text.setFillColor(textColor);
+    textRun.update(text);
 }
 
 void Button::setAction(const std::string& action, VariableDatabase* db) {
     actionType = action;
     
     if (action == "change_color") {
-        onClick = [db]() {
+        TagId panelTag = db->resolveTag("panel_status");
+        onClick = [db, panelTag]() {
             static int status = 0;
             status = (status + 1) % 10;
-            db->setVariable("panel_status", static_cast<double>(status));
+            db->set(panelTag, static_cast<double>(status), WriteSource::Operator);
             Logger::info("Panel status changed to: " + std::to_string(status));
         };
     }
     else if (action == "increase_temp") {
-        onClick = [db]() {
-            double current = db->getVariable("temperature_value");
-            db->setVariable("temperature_value", current + 1.0);
+        TagId temperatureTag = db->resolveTag("temperature_value");
+        onClick = [db, temperatureTag]() {
+            double current = db->get(temperatureTag);
+            db->set(temperatureTag, current + 1.0, WriteSource::Operator);
             Logger::info("Temperature increased to: " + std::to_string(current + 1.0));
         };
     }
     else if (action == "decrease_temp") {
-        onClick = [db]() {
-            double current = db->getVariable("temperature_value");
-            db->setVariable("temperature_value", current - 1.0);
+        TagId temperatureTag = db->resolveTag("temperature_value");
+        onClick = [db, temperatureTag]() {
+            double current = db->get(temperatureTag);
+            db->set(temperatureTag, current - 1.0, WriteSource::Operator);
             Logger::info("Temperature decreased to: " + std::to_string(current - 1.0));
         };
     }
     else if (action == "increase_pressure") {
-        onClick = [db]() {
-            double current = db->getVariable("pressure_value");
-            db->setVariable("pressure_value", current + 0.5);
+        TagId pressureTag = db->resolveTag("pressure_value");
+        onClick = [db, pressureTag]() {
+            double current = db->get(pressureTag);
+            db->set(pressureTag, current + 0.5, WriteSource::Operator);
             Logger::info("Pressure increased to: " + std::to_string(current + 0.5));
         };
     }
     else if (action == "decrease_pressure") {
-        onClick = [db]() {
-            double current = db->getVariable("pressure_value");
-            db->setVariable("pressure_value", current - 0.5);
+        TagId pressureTag = db->resolveTag("pressure_value");
+        onClick = [db, pressureTag]() {
+            double current = db->get(pressureTag);
+            db->set(pressureTag, current - 0.5, WriteSource::Operator);
             Logger::info("Pressure decreased to: " + std::to_string(current - 0.5));
         };
     }
@@ -167,8 +205,9 @@ void Button::setAction(const std::string& action, VariableDatabase* db) {
             
             try {
                 double value = std::stod(value_str);
-                onClick = [db, var_name, value]() {
-                    db->setVariable(var_name, value);
+                TagId varTag = db->resolveTag(var_name);
+                onClick = [db, var_name, varTag, value]() {
+                    db->set(varTag, value, WriteSource::Operator);
                     Logger::info("Variable '" + var_name + "' set to: " + std::to_string(value));
                 };
             } catch (...) {
@@ -192,11 +231,12 @@ void Button::setAction(const std::string& action, VariableDatabase* db) {
                 int min_val = std::stoi(min_str);
                 int max_val = std::stoi(max_str);
                 
-                onClick = [db, var_name, min_val, max_val]() {
-                    double current = db->getVariable(var_name);
+                TagId varTag = db->resolveTag(var_name);
+                onClick = [db, var_name, varTag, min_val, max_val]() {
+                    double current = db->get(varTag);
                     double next = static_cast<double>(((static_cast<int>(current) + 1) % (max_val + 1)));
                     if (next < min_val) next = min_val;
-                    db->setVariable(var_name, next);
+                    db->set(varTag, next, WriteSource::Operator);
                     Logger::info("Variable '" + var_name + "' toggled to: " + std::to_string(next));
                 };
             } catch (...) {
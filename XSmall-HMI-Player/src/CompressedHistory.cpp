@@ -0,0 +1,155 @@
+#include "CompressedHistory.h"
+#include "TimeSeriesCodec.h"
+#include <algorithm>
+
+CompressedHistory::CompressedHistory(std::size_t capacity, std::uint64_t firstIndex)
+    : maxSize(std::max<std::size_t>(capacity, 1)), sealedSize(0), pushed(firstIndex) {}
+
+void CompressedHistory::push(double value) {
+    push(value, HistoryClock::now());
+}
+
+void CompressedHistory::push(double value, HistoryClock::time_point time) {
+    if (!tailTimes.empty()) {
+        time = std::max(time, tailTimes.back());
+    } else if (!blocks.empty()) {
+        time = std::max(time, lastSealedTime);
+    }
+
+    ++pushed;
+    tail.push_back(value);
+    tailTimes.push_back(time);
+    if (tail.size() == BLOCK_SAMPLES) {
+        seal();
+    }
+
+    // Самый старый блок уходит, когда и без него история вмещает capacity значений
+    while (!blocks.empty() && size() - blocks.front().count >= maxSize) {
+        sealedSize -= blocks.front().count;
+        blocks.pop_front();
+    }
+}
+
+void CompressedHistory::seal() {
+    Block block;
+    block.count = static_cast<std::uint32_t>(tail.size());
+    block.firstTime = tailTimes[0];
+    TimeSeriesEncoder encoder;
+    for (std::size_t i = 0; i < tail.size(); ++i) {
+        encoder.add(block.bits, tail[i], tailTimes[i].time_since_epoch().count());
+    }
+
+    block.bits.shrink_to_fit();
+    sealedSize += block.count;
+    lastSealedTime = tailTimes.back();
+    blocks.push_back(std::move(block));
+    tail.clear();  // Память хвоста остается для следующего блока
+    tailTimes.clear();
+}
+
+void CompressedHistory::decode(const Block& block, double* out, HistoryClock::time_point* outTimes) {
+    std::int64_t times[BLOCK_SAMPLES];
+    decodeTimeSeries(block.bits.data(), block.count, block.firstTime.time_since_epoch().count(), out, times);
+    for (std::uint32_t i = 0; i < block.count; ++i) {
+        outTimes[i] = HistoryClock::time_point(HistoryClock::duration(times[i]));
+    }
+}
+
+void CompressedHistory::setCapacity(std::size_t capacity) {
+    maxSize = std::max<std::size_t>(capacity, 1);
+    while (!blocks.empty() && size() - blocks.front().count >= maxSize) {
+        sealedSize -= blocks.front().count;
+        blocks.pop_front();
+    }
+}
+
+std::uint64_t CompressedHistory::lowerBound(HistoryClock::time_point time) const {
+    // Последний блок, начинающийся раньше time: искомое значение в нем или сразу после него
+    auto after = std::partition_point(blocks.begin(), blocks.end(),
+                                      [&](const Block& block) { return block.firstTime < time; });
+    std::uint64_t index = firstIndex();
+    for (auto it = blocks.begin(); it != after; ++it) {
+        index += it->count;
+    }
+
+    const HistoryClock::time_point* times;
+    std::size_t count;
+    HistoryClock::time_point scratchTimes[BLOCK_SAMPLES];
+    double scratch[BLOCK_SAMPLES];
+    if (after != blocks.begin()) {
+        const Block& block = *(after - 1);
+        index -= block.count;
+        decode(block, scratch, scratchTimes);
+        times = scratchTimes;
+        count = block.count;
+        if (!(scratchTimes[count - 1] < time)) {
+            return index + (std::lower_bound(times, times + count, time) - times);
+        }
+        index += count;
+        if (after != blocks.end()) {
+            return index;  // Следующий блок начинается не раньше time
+        }
+    } else if (after != blocks.end()) {
+        return index;
+    }
+
+    // Значения после сжатых блоков - в хвосте
+    return index + (std::lower_bound(tailTimes.begin(), tailTimes.end(), time) - tailTimes.begin());
+}
+
+std::size_t CompressedHistory::memoryUsage() const {
+    std::size_t bytes = tail.capacity() * sizeof(double) + tailTimes.capacity() * sizeof(HistoryClock::time_point) +
+                        blocks.size() * sizeof(Block);
+    for (const auto& block : blocks) {
+        bytes += block.bits.capacity() * sizeof(std::uint64_t);
+    }
+    return bytes;
+}
+
+void CompressedHistory::clear() {
+    blocks.clear();
+    tail.clear();
+    tailTimes.clear();
+    sealedSize = 0;
+}
+
+CompressedHistory::Cursor::Cursor(const CompressedHistory& history, std::uint64_t from)
+    : history(&history), block(0), blockIndex(history.firstIndex()), from(from),
+      current(nullptr), currentTimes(nullptr), currentSize(0), currentIndex(0) {
+    // Блоки целиком до from не разжимаем
+    while (block < history.blocks.size() && blockIndex + history.blocks[block].count <= from) {
+        blockIndex += history.blocks[block].count;
+        ++block;
+    }
+}
+
+bool CompressedHistory::Cursor::next() {
+    while (block <= history->blocks.size()) {
+        const double* values;
+        const HistoryClock::time_point* times;
+        std::size_t count;
+        if (block < history->blocks.size()) {
+            const Block& sealed = history->blocks[block];
+            decode(sealed, scratch, scratchTimes);
+            values = scratch;
+            times = scratchTimes;
+            count = sealed.count;
+        } else {
+            values = history->tail.data();
+            times = history->tailTimes.data();
+            count = history->tail.size();
+        }
+        ++block;
+
+        std::size_t skip = from > blockIndex ? static_cast<std::size_t>(std::min<std::uint64_t>(from - blockIndex, count)) : 0;
+        current = values + skip;
+        currentTimes = times + skip;
+        currentSize = count - skip;
+        currentIndex = blockIndex + skip;
+        blockIndex += count;
+        if (currentSize > 0) {
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,30 @@
+#include "Crc32.h"
+
+namespace {
+
+struct Crc32Table {
+    std::uint32_t values[256];
+
+    Crc32Table() {
+        for (std::uint32_t i = 0; i < 256; ++i) {
+            std::uint32_t c = i;
+            for (int bit = 0; bit < 8; ++bit) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            values[i] = c;
+        }
+    }
+};
+
+} // namespace
+
+// Табличный вариант
+std::uint32_t crc32(const char* data, std::size_t size, std::uint32_t crc) {
+    static const Crc32Table table;
+
+    crc = ~crc;
+    for (std::size_t i = 0; i < size; ++i) {
+        crc = table.values[(crc ^ static_cast<unsigned char>(data[i])) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
@@ -0,0 +1,215 @@
+#include "EventRouter.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Объекты крупнее (например, с границами по умолчанию - весь экран) в сетку не кладутся
+const float MAX_INDEXED_SIZE = 100000.f;
+
+} // namespace
+
+EventRouter::EventRouter(float cellSize)
+    : cellSize(cellSize), columns(0), rows(0), indexedCount(0),
+      hovered(nullptr), focused(nullptr), captured(nullptr), movePending(false) {}
+
+void EventRouter::build(const std::vector<std::unique_ptr<VisualObject>>& objects) {
+    cells.clear();
+    unbounded.clear();
+    columns = rows = 0;
+    indexedCount = 0;
+    movePending = false;
+
+    // При перестроении (перезагрузка сцены) наведение, фокус и захват остаются
+    // у объектов, которые есть в новом списке; удаленные объекты их теряют
+    VisualObject* previousHovered = hovered;
+    VisualObject* previousFocused = focused;
+    VisualObject* previousCaptured = captured;
+    hovered = focused = captured = nullptr;
+
+    // Границы сетки - объединение границ интерактивных объектов
+    std::vector<Entry> entries;
+    std::vector<sf::FloatRect> bounds;
+    float left = 0, top = 0, right = 0, bottom = 0;
+    for (std::size_t i = 0; i < objects.size(); ++i) {
+        VisualObject* object = objects[i].get();
+        if (!object->isInteractive()) {
+            continue;
+        }
+        ++indexedCount;
+        if (object == previousHovered) hovered = object;
+        if (object == previousFocused) focused = object;
+        if (object == previousCaptured) captured = object;
+
+        sf::FloatRect rect = object->getBounds();
+        if (rect.width > MAX_INDEXED_SIZE || rect.height > MAX_INDEXED_SIZE) {
+            unbounded.push_back({object, i});
+            continue;
+        }
+        if (entries.empty()) {
+            left = rect.left;
+            top = rect.top;
+            right = rect.left + rect.width;
+            bottom = rect.top + rect.height;
+        } else {
+            left = std::min(left, rect.left);
+            top = std::min(top, rect.top);
+            right = std::max(right, rect.left + rect.width);
+            bottom = std::max(bottom, rect.top + rect.height);
+        }
+        entries.push_back({object, i});
+        bounds.push_back(rect);
+    }
+    if (entries.empty()) {
+        return;
+    }
+
+    origin = sf::Vector2f(left, top);
+    columns = static_cast<std::size_t>((right - left) / cellSize) + 1;
+    rows = static_cast<std::size_t>((bottom - top) / cellSize) + 1;
+    cells.resize(columns * rows);
+
+    // Объект попадает во все ячейки, которые пересекают его границы
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+        const sf::FloatRect& rect = bounds[i];
+        std::size_t firstColumn = static_cast<std::size_t>((rect.left - left) / cellSize);
+        std::size_t lastColumn = std::min(columns - 1, static_cast<std::size_t>((rect.left + rect.width - left) / cellSize));
+        std::size_t firstRow = static_cast<std::size_t>((rect.top - top) / cellSize);
+        std::size_t lastRow = std::min(rows - 1, static_cast<std::size_t>((rect.top + rect.height - top) / cellSize));
+        for (std::size_t row = firstRow; row <= lastRow; ++row) {
+            for (std::size_t column = firstColumn; column <= lastColumn; ++column) {
+                cells[row * columns + column].push_back(entries[i]);
+            }
+        }
+    }
+}
+
+VisualObject* EventRouter::hitTest(const sf::Vector2f& point) const {
+    const Entry* best = nullptr;
+
+    if (!cells.empty() && point.x >= origin.x && point.y >= origin.y) {
+        std::size_t column = static_cast<std::size_t>((point.x - origin.x) / cellSize);
+        std::size_t row = static_cast<std::size_t>((point.y - origin.y) / cellSize);
+        if (column < columns && row < rows) {
+            // Ячейка заполнялась в порядке отрисовки - идем с конца, первое попадание сверху
+            const std::vector<Entry>& cell = cells[row * columns + column];
+            for (auto it = cell.rbegin(); it != cell.rend(); ++it) {
+                if (it->object->contains(point.x, point.y)) {
+                    best = &*it;
+                    break;
+                }
+            }
+        }
+    }
+
+    for (const Entry& entry : unbounded) {
+        if ((!best || entry.order > best->order) && entry.object->contains(point.x, point.y)) {
+            best = &entry;
+        }
+    }
+    return best ? best->object : nullptr;
+}
+
+bool EventRouter::getPixelPosition(const sf::Event& event, sf::Vector2i& pixel) {
+    switch (event.type) {
+        case sf::Event::MouseMoved:
+            pixel = sf::Vector2i(event.mouseMove.x, event.mouseMove.y);
+            return true;
+        case sf::Event::MouseButtonPressed:
+        case sf::Event::MouseButtonReleased:
+            pixel = sf::Vector2i(event.mouseButton.x, event.mouseButton.y);
+            return true;
+        case sf::Event::MouseWheelScrolled:
+            pixel = sf::Vector2i(event.mouseWheelScroll.x, event.mouseWheelScroll.y);
+            return true;
+        default:
+            return false;
+    }
+}
+
+void EventRouter::setHoveredObject(VisualObject* object) {
+    if (object == hovered) {
+        return;
+    }
+    if (hovered) {
+        hovered->setHovered(false);
+    }
+    hovered = object;
+    if (hovered) {
+        hovered->setHovered(true);
+    }
+}
+
+void EventRouter::flush() {
+    if (movePending) {
+        movePending = false;
+        setHoveredObject(hitTest(movePoint));
+    }
+}
+
+void EventRouter::route(const sf::Event& event, const sf::Vector2f& point, sf::RenderWindow& window) {
+    switch (event.type) {
+        case sf::Event::MouseMoved:
+            // Промежуточные положения курсора не нужны - учитываем последнее
+            movePending = true;
+            movePoint = point;
+            break;
+
+        case sf::Event::MouseButtonPressed: {
+            movePending = false;
+            VisualObject* target = hitTest(point);
+            setHoveredObject(target);
+
+            // Фокус переходит к объекту под курсором (или снимается, если он фокус не принимает)
+            if (focused && focused != target) {
+                focused->setFocused(false);
+            }
+            focused = target && target->acceptsFocus() ? target : nullptr;
+            if (focused) {
+                focused->setFocused(true);
+            }
+
+            captured = target;
+            if (target) {
+                target->handleEvent(event, window);
+            }
+            break;
+        }
+
+        case sf::Event::MouseButtonReleased: {
+            movePending = false;
+            VisualObject* target = hitTest(point);
+            setHoveredObject(target);
+
+            // Отпускание получает объект, на котором кнопку нажали
+            VisualObject* receiver = captured ? captured : target;
+            captured = nullptr;
+            if (receiver) {
+                receiver->handleEvent(event, window);
+            }
+            break;
+        }
+
+        case sf::Event::MouseWheelScrolled:
+            if (VisualObject* target = hitTest(point)) {
+                target->handleEvent(event, window);
+            }
+            break;
+
+        case sf::Event::MouseLeft:
+            movePending = false;
+            setHoveredObject(nullptr);
+            break;
+
+        case sf::Event::KeyPressed:
+        case sf::Event::KeyReleased:
+        case sf::Event::TextEntered:
+            if (focused) {
+                focused->handleEvent(event, window);
+            }
+            break;
+
+        default:
+            break;
+    }
+}
@@ -0,0 +1,142 @@
+#include "FileWatcher.h"
+#include "logger.h"
+#include <filesystem>
+#include <system_error>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+
+namespace {
+
+struct FileStamp {
+    std::uintmax_t size = 0;
+    std::filesystem::file_time_type time;
+    bool exists = false;
+
+    bool operator!=(const FileStamp& other) const {
+        return exists != other.exists || size != other.size || time != other.time;
+    }
+};
+
+FileStamp stampOf(const std::string& path) {
+    FileStamp stamp;
+    std::error_code error;
+    stamp.size = std::filesystem::file_size(path, error);
+    if (!error) {
+        stamp.time = std::filesystem::last_write_time(path, error);
+        stamp.exists = !error;
+    }
+    return stamp;
+}
+
+} // namespace
+
+FileWatcher::FileWatcher(const std::string& path) : path(path), running(false) {}
+
+FileWatcher::~FileWatcher() {
+    stop();
+}
+
+void FileWatcher::start(std::function<void()> handler) {
+    stop();
+    onChange = std::move(handler);
+    running = true;
+    thread = std::thread([this]() { run(); });
+}
+
+void FileWatcher::stop() {
+    running = false;
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+void FileWatcher::run() {
+    onChange();
+
+#ifdef __linux__
+    if (watchInotify()) {
+        return;
+    }
+    Logger::warning("inotify is unavailable, polling " + path + " for changes");
+#endif
+    poll();
+}
+
+void FileWatcher::poll() {
+    FileStamp last = stampOf(path);
+    while (running) {
+        std::this_thread::sleep_for(POLL_INTERVAL);
+        FileStamp current = stampOf(path);
+        if (current != last) {
+            // Ждем, пока запись закончится (размер и время перестанут меняться)
+            do {
+                last = current;
+                std::this_thread::sleep_for(SETTLE_TIME);
+                current = stampOf(path);
+            } while (current != last && running);
+
+            if (running && current.exists) {
+                onChange();
+            }
+        }
+    }
+}
+
+#ifdef __linux__
+bool FileWatcher::watchInotify() {
+    std::filesystem::path file(path);
+    std::string directory = file.has_parent_path() ? file.parent_path().string() : ".";
+    std::string fileName = file.filename().string();
+
+    int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    // Закрытие после записи и переименование поверх файла - файл сохранен целиком
+    if (inotify_add_watch(fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+        close(fd);
+        return false;
+    }
+
+    // Читает накопившиеся события; true, если среди них есть наш файл
+    auto drain = [fd, &fileName]() {
+        alignas(inotify_event) char buffer[4096];
+        bool matched = false;
+        ssize_t length;
+        while ((length = read(fd, buffer, sizeof(buffer))) > 0) {
+            for (ssize_t offset = 0; offset < length;) {
+                const inotify_event* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+                if (event->len > 0 && fileName == event->name) {
+                    matched = true;
+                }
+                offset += sizeof(inotify_event) + event->len;
+            }
+        }
+        return matched;
+    };
+
+    pollfd descriptor = {fd, POLLIN, 0};
+    const int timeoutMs = static_cast<int>(POLL_INTERVAL.count());
+    while (running) {
+        if (::poll(&descriptor, 1, timeoutMs) <= 0 || !drain()) {
+            continue;
+        }
+
+        // Собираем события той же записи, пока они идут
+        while (running && ::poll(&descriptor, 1, static_cast<int>(SETTLE_TIME.count())) > 0) {
+            drain();
+        }
+        if (running) {
+            onChange();
+        }
+    }
+
+    close(fd);
+    return true;
+}
+#endif
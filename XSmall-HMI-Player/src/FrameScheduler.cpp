@@ -0,0 +1,95 @@
+#include "FrameScheduler.h"
+#include <SFML/System.hpp>
+#include <algorithm>
+
+namespace {
+    // Следующий срок периодической работы: без дрейфа, пока успеваем,
+    // и от текущего момента после задержки (пропущенные сроки не выполняются подряд)
+    FrameScheduler::Clock::time_point nextDeadline(FrameScheduler::Clock::time_point deadline,
+                                                   FrameScheduler::Clock::duration interval,
+                                                   FrameScheduler::Clock::time_point now) {
+        deadline += interval;
+        return deadline > now ? deadline : now + interval;
+    }
+}
+
+FrameScheduler::FrameScheduler(const SchedulerConfig& config)
+    : config(config),
+      timers(std::chrono::milliseconds(std::max(config.timerResolutionMs, 1))),
+      inputInterval(toInterval(config.inputRate)),
+      tickInterval(toInterval(config.tickRate)),
+      renderInterval(toInterval(config.renderRate)),
+      started(false), frameRequested(false),
+      tickCount(0), frameCount(0), inputPollCount(0) {}
+
+FrameScheduler::Clock::duration FrameScheduler::toInterval(double rate) {
+    if (rate <= 0) {
+        rate = 60.0;
+    }
+    return std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / rate));
+}
+
+FrameScheduler::Clock::time_point FrameScheduler::step(Clock::time_point now) {
+    if (!started) {
+        nextInput = nextTick = nextRender = lastTimerUpdate = now;
+        started = true;
+    }
+
+    // Ввод - первым, чтобы такт и кадр в этот же момент уже учитывали его
+    if (now >= nextInput) {
+        if (inputHandler) {
+            inputHandler();
+        }
+        ++inputPollCount;
+        nextInput = nextDeadline(nextInput, inputInterval, now);
+    }
+
+    if (frameRequested) {
+        nextRender = std::min(nextRender, now);
+        frameRequested = false;
+    }
+
+    // Логика с фиксированным шагом: догоняем пропущенные такты, но не бесконечно
+    int ticks = 0;
+    while (now >= nextTick && ticks < config.maxTicksPerFrame) {
+        if (tickHandler) {
+            tickHandler();
+        }
+        ++tickCount;
+        ++ticks;
+        nextTick += tickInterval;
+    }
+    if (now >= nextTick) {
+        // Отставание слишком большое - отбрасываем его, иначе цикл не выйдет из догоняния
+        nextTick = now + tickInterval;
+    }
+
+    timers.advance(now - lastTimerUpdate);
+    lastTimerUpdate = now;
+
+    if (now >= nextRender) {
+        if (renderHandler) {
+            renderHandler();
+        }
+        ++frameCount;
+        nextRender = nextDeadline(nextRender, renderInterval, now);
+    }
+
+    Clock::time_point next = std::min({nextInput, nextTick, nextRender});
+    if (timers.getTimerCount() > 0) {
+        next = std::min(next, now + timers.getResolution());
+    }
+    return next;
+}
+
+void FrameScheduler::run(const std::function<bool()>& running) {
+    while (running()) {
+        Clock::time_point next = step(Clock::now());
+
+        // sf::sleep повышает точность системного таймера (важно для Windows)
+        auto wait = std::chrono::duration_cast<std::chrono::microseconds>(next - Clock::now());
+        if (wait.count() > 0) {
+            sf::sleep(sf::microseconds(wait.count()));
+        }
+    }
+}
@@ -0,0 +1,771 @@
+#include "Historian.h"
+#include "Crc32.h"
+#include "logger.h"
+#include <filesystem>
+#include <algorithm>
+#include <functional>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+struct SegmentHeader {
+    char magic[4];
+    std::uint32_t version;
+};
+
+const char SEGMENT_MAGIC[4] = {'H', 'M', 'I', 'A'};
+const std::uint32_t SEGMENT_VERSION = 1;
+const std::string SEGMENT_EXTENSION = ".hist";
+
+// Длительность куска хранится в 32 битах: кусок длиннее суток закрывается раньше CHUNK_SAMPLES
+const std::int64_t MAX_CHUNK_SPAN_MS = 24 * 3600 * 1000;
+
+// Значение с отметкой занимает не больше 68 + 77 битов
+const std::uint32_t MAX_SAMPLE_BITS = 145;
+
+// Заголовок куска; за ним биты сжатых значений и отметок в 64-битных словах.
+// Все участки сегмента кратны 8 байтам, поэтому слова в отображенном файле выровнены
+struct ChunkHeader {
+    std::uint32_t crc;       // По остальным полям заголовка и битам до длины куска
+    std::uint32_t bits;
+    std::int64_t firstTime;  // Мс Unix-времени
+    std::uint32_t span;      // Последняя отметка минус первая, мс
+    std::uint32_t count;
+};
+
+std::uint64_t wordCount(std::uint64_t bits) {
+    return (bits + 63) / 64;
+}
+
+std::uint32_t chunkCrc(const ChunkHeader& header, const std::uint64_t* words) {
+    const char* fields = reinterpret_cast<const char*>(&header) + sizeof(header.crc);
+    std::uint32_t crc = crc32(fields, sizeof(header) - sizeof(header.crc));
+    std::uint64_t count = wordCount(header.bits);
+    if (count == 0) {
+        return crc;
+    }
+    crc = crc32(reinterpret_cast<const char*>(words), (count - 1) * sizeof(std::uint64_t), crc);
+
+    // Свободные младшие биты последнего слова открытый кусок еще дописывает
+    std::uint64_t last = words[count - 1] & (~0ull << (count * 64 - header.bits));
+    return crc32(reinterpret_cast<const char*>(&last), sizeof(last), crc);
+}
+
+// Заголовок куска по смещению offset, если кусок целиком помещается в size байт
+bool readChunkHeader(const char* data, std::uint64_t size, std::uint64_t offset, ChunkHeader& header) {
+    if (offset + sizeof(header) > size) {
+        return false;
+    }
+    std::memcpy(&header, data + offset, sizeof(header));
+    return header.count > 0 && header.count <= Historian::CHUNK_SAMPLES &&
+           header.bits >= 64 && header.bits <= header.count * MAX_SAMPLE_BITS &&
+           wordCount(header.bits) * sizeof(std::uint64_t) <= size - offset - sizeof(header);
+}
+
+std::uint64_t chunkSize(const ChunkHeader& header) {
+    return sizeof(header) + wordCount(header.bits) * sizeof(std::uint64_t);
+}
+
+const std::uint64_t* chunkWords(const char* data, std::uint64_t offset) {
+    return reinterpret_cast<const std::uint64_t*>(data + offset + sizeof(ChunkHeader));
+}
+
+bool hasSegmentHeader(const char* data, std::uint64_t size) {
+    SegmentHeader header;
+    if (size < sizeof(header)) {
+        return false;
+    }
+    std::memcpy(&header, data, sizeof(header));
+    return std::memcmp(header.magic, SEGMENT_MAGIC, sizeof(SEGMENT_MAGIC)) == 0 &&
+           header.version == SEGMENT_VERSION;
+}
+
+// Сегмент прошлого запуска можно дописывать, только если он не оборван сбоем:
+// куски идут вплотную до конца файла, последний цел
+bool segmentIsIntact(const std::string& path, std::uint64_t& size) {
+    MappedFile mapped;
+    if (!mapped.open(path) || !hasSegmentHeader(mapped.getData(), mapped.getSize())) {
+        return false;
+    }
+    const char* data = mapped.getData();
+    size = mapped.getSize();
+
+    std::uint64_t offset = sizeof(SegmentHeader);
+    std::uint64_t last = 0;
+    ChunkHeader header;
+    while (offset < size && readChunkHeader(data, size, offset, header)) {
+        last = offset;
+        offset += chunkSize(header);
+    }
+    if (offset != size) {
+        return false;
+    }
+    if (last != 0) {
+        std::memcpy(&header, data + last, sizeof(header));
+        return chunkCrc(header, chunkWords(data, last)) == header.crc;
+    }
+    return true;
+}
+
+// Имя переменной в имени файла: буквы, цифры, '_' и '-' как есть, остальное - %XX
+std::string fileNameFor(const std::string& name) {
+    static const char HEX[] = "0123456789ABCDEF";
+    std::string result;
+    result.reserve(name.size());
+    for (unsigned char c : name) {
+        if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' || c == '-') {
+            result += static_cast<char>(c);
+        } else {
+            result += '%';
+            result += HEX[c >> 4];
+            result += HEX[c & 15];
+        }
+    }
+    return result;
+}
+
+} // namespace
+
+Historian::Historian(const std::string& directory, std::chrono::hours retention)
+    : directory(directory), retention(retention), segmentBytes(1024 * 1024), chunkAgeMs(60000),
+      attachedDb(nullptr), stopping(false), failed(false), chunksWritten(0), bytesWritten(0) {
+    auto systemNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch());
+    auto steadyNs = std::chrono::duration_cast<std::chrono::nanoseconds>(HistoryClock::now().time_since_epoch());
+    unixOffset = (systemNs - steadyNs).count();
+
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+
+    // Сегменты переменных: <имя>.<номер>.hist. Не менявшиеся дольше retention удаляются сразу
+    auto now = std::filesystem::file_time_type::clock::now();
+    for (const auto& entry : std::filesystem::directory_iterator(directory, error)) {
+        std::string name = entry.path().filename().string();
+        if (name.size() <= SEGMENT_EXTENSION.size() ||
+            name.compare(name.size() - SEGMENT_EXTENSION.size(), SEGMENT_EXTENSION.size(), SEGMENT_EXTENSION) != 0) {
+            continue;
+        }
+        std::string stem = name.substr(0, name.size() - SEGMENT_EXTENSION.size());
+        std::size_t dot = stem.rfind('.');
+        if (dot == std::string::npos || dot == 0) {
+            continue;
+        }
+        std::string number = stem.substr(dot + 1);
+        if (number.empty() || number.size() > 9 ||
+            !std::all_of(number.begin(), number.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+            continue;
+        }
+
+        std::error_code timeError;
+        auto modified = std::filesystem::last_write_time(entry.path(), timeError);
+        if (!timeError && now - modified > retention) {
+            std::filesystem::remove(entry.path(), timeError);
+            continue;
+        }
+        diskSegments[stem.substr(0, dot)].push_back(static_cast<std::uint32_t>(std::stoul(number)));
+    }
+    for (auto& it : diskSegments) {
+        std::sort(it.second.begin(), it.second.end());
+    }
+
+    writer = std::thread(&Historian::writerLoop, this);
+}
+
+Historian::~Historian() {
+    if (attachedDb) {
+        attachedDb->setHistoryArchiveHandler(nullptr);
+    }
+    for (auto& it : tags) {
+        send(*it.second, false);
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    writer.join();
+}
+
+void Historian::setSegmentBytes(std::size_t bytes) {
+    segmentBytes = std::max<std::size_t>(bytes, sizeof(SegmentHeader) + sizeof(ChunkHeader));
+}
+
+void Historian::setChunkAge(std::chrono::milliseconds age) {
+    chunkAgeMs = std::clamp<std::int64_t>(age.count(), 1, MAX_CHUNK_SPAN_MS);
+}
+
+std::string Historian::segmentPath(const TagState& tag, std::uint32_t segment) const {
+    return (std::filesystem::path(directory) / (tag.fileName + "." + std::to_string(segment) + SEGMENT_EXTENSION)).string();
+}
+
+std::int64_t Historian::toUnixMs(HistoryClock::time_point time) const {
+    std::int64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count() + unixOffset;
+    return ns >= 0 ? ns / 1000000 : -((-ns + 999999) / 1000000);
+}
+
+HistoryClock::time_point Historian::fromUnixMs(std::int64_t ms) const {
+    std::chrono::nanoseconds ns(ms * 1000000 - unixOffset);
+    return HistoryClock::time_point(std::chrono::duration_cast<HistoryClock::duration>(ns));
+}
+
+Historian::TagState& Historian::state(const std::string& name) {
+    auto it = tags.find(name);
+    if (it != tags.end()) {
+        return *it->second;
+    }
+
+    auto tag = std::make_unique<TagState>();
+    tag->name = name;
+    tag->fileName = fileNameFor(name);
+
+    // Архив прошлых запусков; фоновый поток увидит эти поля, получив первый кусок через очередь
+    auto disk = diskSegments.find(tag->fileName);
+    if (disk != diskSegments.end()) {
+        tag->firstSegment = disk->second.front();
+        tag->durableSegment = disk->second.back();
+        std::error_code error;
+        std::uintmax_t size = std::filesystem::file_size(segmentPath(*tag, tag->durableSegment), error);
+        tag->durableSize = error ? 0 : size;
+    }
+
+    TagState& result = *tag;
+    tags.emplace(name, std::move(tag));
+    return result;
+}
+
+Historian::TagState* Historian::findState(const std::string& name) {
+    auto it = tags.find(name);
+    if (it != tags.end()) {
+        return it->second.get();
+    }
+    return diskSegments.count(fileNameFor(name)) ? &state(name) : nullptr;
+}
+
+void Historian::attach(VariableDatabase& db) {
+    attachedDb = &db;
+    byTag.clear();
+    db.setHistoryArchiveHandler([this](TagId tag, double value, HistoryClock::time_point time) {
+        if (tag >= byTag.size()) {
+            byTag.resize(tag + 1, nullptr);
+        }
+        TagState*& archived = byTag[tag];
+        if (!archived) {
+            archived = &state(attachedDb->getTagName(tag));
+        }
+        append(*archived, value, time);
+    });
+}
+
+void Historian::append(const std::string& name, double value, HistoryClock::time_point time) {
+    append(state(name), value, time);
+}
+
+void Historian::append(TagState& tag, double value, HistoryClock::time_point time) {
+    std::int64_t ms = toUnixMs(time);
+    if (tag.encoder.count() > 0) {
+        ms = std::max(ms, tag.lastTime);
+        if (ms - tag.firstTime > MAX_CHUNK_SPAN_MS) {
+            send(tag, true);
+        }
+    }
+    if (tag.encoder.count() == 0) {
+        tag.firstTime = ms;
+    }
+    if (!tag.unsent) {
+        tag.unsent = true;
+        tag.unsentSince = ms;
+    }
+    tag.encoder.add(tag.words, value, ms);
+    tag.lastTime = ms;
+
+    if (tag.encoder.count() == CHUNK_SAMPLES) {
+        send(tag, true);
+    } else if (ms - tag.unsentSince >= chunkAgeMs) {
+        send(tag, false);
+    }
+}
+
+void Historian::send(TagState& tag, bool complete) {
+    if (tag.encoder.count() == 0 || !(tag.unsent || complete)) {
+        return;
+    }
+
+    Chunk chunk;
+    chunk.tag = &tag;
+    chunk.bits = tag.encoder.bitCount();
+    chunk.count = static_cast<std::uint32_t>(tag.encoder.count());
+    chunk.firstTime = tag.firstTime;
+    chunk.lastTime = tag.lastTime;
+    // Последнее отправленное слово могло получить новые биты
+    chunk.fromWord = tag.sentWords > 0 ? tag.sentWords - 1 : 0;
+    chunk.complete = complete;
+    if (complete) {
+        chunk.words = std::move(tag.words);
+        tag.words.clear();
+        tag.encoder.reset();
+        tag.sentWords = 0;
+    } else {
+        chunk.words = tag.words;
+        tag.sentWords = tag.words.size();
+    }
+    tag.unsent = false;
+
+    bool wasEmpty;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        wasEmpty = queue.empty();
+        queue.push_back(std::move(chunk));
+    }
+    // Непустую очередь фоновый поток заберет сам после текущей группы
+    if (wasEmpty) {
+        wake.notify_one();
+    }
+}
+
+void Historian::poll(HistoryClock::time_point now) {
+    std::int64_t ms = toUnixMs(now);
+    for (auto& it : tags) {
+        TagState& tag = *it.second;
+        if (tag.unsent && ms - tag.unsentSince >= chunkAgeMs) {
+            send(tag, false);
+        }
+    }
+}
+
+void Historian::flush() {
+    for (auto& it : tags) {
+        send(*it.second, false);
+    }
+    std::unique_lock<std::mutex> lock(mutex);
+    idle.wait(lock, [this]() { return queue.empty(); });
+}
+
+std::uint64_t Historian::getChunksWritten() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return chunksWritten;
+}
+
+std::uint64_t Historian::getBytesWritten() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return bytesWritten;
+}
+
+std::uintmax_t Historian::getDiskUsage() const {
+    std::uintmax_t bytes = 0;
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, error)) {
+        if (entry.path().extension() == SEGMENT_EXTENSION) {
+            std::error_code sizeError;
+            std::uintmax_t size = entry.file_size(sizeError);
+            bytes += sizeError ? 0 : size;
+        }
+    }
+    return bytes;
+}
+
+void Historian::writerLoop() {
+    std::vector<const Chunk*> group;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [this]() { return stopping || !queue.empty(); });
+        if (queue.empty()) {
+            break;  // Остановка, очередь пуста
+        }
+
+        // Все, что накопилось, пишем группой: куски одной переменной - за одно открытие файла.
+        // Куски остаются в очереди (закрытые видит чтение), пока не окажутся в файле
+        group.clear();
+        for (const Chunk& chunk : queue) {
+            group.push_back(&chunk);
+        }
+        lock.unlock();
+
+        std::stable_sort(group.begin(), group.end(), [](const Chunk* a, const Chunk* b) {
+            return std::less<TagState*>()(a->tag, b->tag);
+        });
+        bool ok = true;
+        std::uint64_t written = 0;
+        std::uint64_t closed = 0;
+        for (std::size_t begin = 0; begin < group.size();) {
+            std::size_t end = begin;
+            while (end < group.size() && group[end]->tag == group[begin]->tag) {
+                closed += group[end]->complete ? 1 : 0;
+                ++end;
+            }
+            ok = writeChunks(*group[begin]->tag, group.data() + begin, end - begin, written) && ok;
+            begin = end;
+        }
+        if (!ok && !failed) {
+            Logger::error("Failed to write history archive in " + directory);
+        }
+        failed = !ok;
+
+        // Закрытые куски переходят из очереди в записанную часть одним шагом для чтения
+        lock.lock();
+        for (const Chunk* chunk : group) {
+            TagState& tag = *chunk->tag;
+            if (tag.closedSegment != 0) {
+                tag.durableSegment = tag.closedSegment;
+                tag.durableSize = tag.closedSize;
+            }
+        }
+        for (std::size_t i = 0; i < group.size(); ++i) {
+            queue.pop_front();
+        }
+        chunksWritten += closed;
+        bytesWritten += written;
+        if (queue.empty()) {
+            idle.notify_all();
+        }
+    }
+}
+
+bool Historian::writeChunks(TagState& tag, const Chunk* const* chunks, std::size_t count, std::uint64_t& written) {
+    std::FILE* file = nullptr;
+    bool ok = true;
+    for (std::size_t i = 0; i < count && ok; ++i) {
+        const Chunk& chunk = *chunks[i];
+        std::size_t fromWord = chunk.fromWord;
+
+        // Новый кусок на диске; после ошибки открытый кусок тоже пишется заново целиком
+        if (tag.openOffset == 0) {
+            fromWord = 0;
+            if (tag.appendSegment == 0 || tag.appendFailed || tag.appendSize >= segmentBytes) {
+                if (file) {
+                    std::fclose(file);
+                    file = nullptr;
+                }
+                nextSegment(tag);
+            }
+        }
+        if (!file) {
+            bool fresh = tag.appendSize == 0;
+            file = std::fopen(segmentPath(tag, tag.appendSegment).c_str(), fresh ? "wb" : "r+b");
+            if (!file) {
+                ok = false;
+                break;
+            }
+            if (fresh) {
+                SegmentHeader header;
+                std::memcpy(header.magic, SEGMENT_MAGIC, sizeof(SEGMENT_MAGIC));
+                header.version = SEGMENT_VERSION;
+                ok = std::fwrite(&header, sizeof(header), 1, file) == 1;
+                tag.appendSize = sizeof(header);
+                written += sizeof(header);
+            }
+        }
+        if (tag.openOffset == 0) {
+            tag.openOffset = tag.appendSize;
+        }
+
+        ChunkHeader header;
+        header.bits = static_cast<std::uint32_t>(chunk.bits);
+        header.firstTime = chunk.firstTime;
+        header.span = static_cast<std::uint32_t>(chunk.lastTime - chunk.firstTime);
+        header.count = chunk.count;
+        header.crc = chunkCrc(header, chunk.words.data());
+
+        // Сначала биты, потом заголовок: до перезаписи заголовка кусок на диске остается прежним
+        std::size_t words = chunk.words.size() - fromWord;
+        ok = ok && std::fseek(file, static_cast<long>(tag.openOffset + sizeof(header) + fromWord * sizeof(std::uint64_t)),
+                              SEEK_SET) == 0 &&
+             std::fwrite(chunk.words.data() + fromWord, sizeof(std::uint64_t), words, file) == words &&
+             std::fseek(file, static_cast<long>(tag.openOffset), SEEK_SET) == 0 &&
+             std::fwrite(&header, sizeof(header), 1, file) == 1;
+        if (ok) {
+            tag.appendSize = tag.openOffset + sizeof(header) + chunk.words.size() * sizeof(std::uint64_t);
+            written += sizeof(header) + words * sizeof(std::uint64_t);
+            if (chunk.complete) {
+                tag.closedSegment = tag.appendSegment;
+                tag.closedSize = tag.appendSize;
+                tag.openOffset = 0;
+            }
+        }
+    }
+    if (file) {
+        ok = std::fclose(file) == 0 && ok;
+    }
+    // После ошибки в сегменте мог остаться недописанный кусок: следующий кусок - в новый
+    if (!ok) {
+        tag.appendFailed = true;
+        tag.openOffset = 0;
+    }
+    return ok;
+}
+
+void Historian::nextSegment(TagState& tag) {
+    std::uint32_t last = tag.appendSegment;
+    if (last == 0) {
+        // Первый кусок после открытия: последний сегмент прошлого запуска дописывается,
+        // если он цел и не заполнен
+        last = tag.durableSegment;
+        std::uint64_t size = 0;
+        if (last != 0 && tag.durableSize < segmentBytes && segmentIsIntact(segmentPath(tag, last), size)) {
+            tag.appendSegment = last;
+            tag.appendSize = size;
+            tag.appendFailed = false;
+            return;
+        }
+    }
+
+    tag.appendSegment = last + 1;
+    tag.appendSize = 0;
+    tag.appendFailed = false;
+    removeExpired(tag);
+}
+
+void Historian::removeExpired(TagState& tag) {
+    std::uint32_t first;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        first = tag.firstSegment;
+    }
+    if (first == 0) {
+        first = tag.appendSegment;
+    }
+
+    // Сегменты стареют по порядку номеров: удаляем с самого старого до первого свежего
+    auto now = std::filesystem::file_time_type::clock::now();
+    std::uint32_t kept = first;
+    for (; kept < tag.appendSegment; ++kept) {
+        std::string path = segmentPath(tag, kept);
+        std::error_code error;
+        auto modified = std::filesystem::last_write_time(path, error);
+        if (!error && now - modified <= retention) {
+            break;
+        }
+        std::filesystem::remove(path, error);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    tag.firstSegment = kept;
+}
+
+bool Historian::indexSegment(TagState& tag, SegmentView& view, std::uint64_t limit) {
+    // Отображение должно покрывать записанную часть; файл только растет
+    if (!view.file.isOpen() || view.file.getSize() < limit) {
+        if (!view.file.open(segmentPath(tag, view.number))) {
+            return false;
+        }
+    }
+    const char* data = view.file.getData();
+    limit = std::min<std::uint64_t>(limit, view.file.getSize());
+
+    if (view.indexed == 0) {
+        if (!hasSegmentHeader(data, limit)) {
+            view.broken = true;
+            return false;
+        }
+        view.indexed = sizeof(SegmentHeader);
+    }
+    while (!view.broken && view.indexed < limit) {
+        ChunkHeader header;
+        if (!readChunkHeader(data, limit, view.indexed, header)) {
+            // Внутри записанной части - повреждение, дальше сегмент не читается
+            Logger::warning("History archive segment " + segmentPath(tag, view.number) +
+                            " is damaged at offset " + std::to_string(view.indexed));
+            view.broken = true;
+            break;
+        }
+        view.chunks.push_back(ChunkRef{header.firstTime, header.firstTime + header.span, view.indexed, header.count,
+                                       ChunkCheck::Unchecked});
+        view.indexed += chunkSize(header);
+    }
+    return true;
+}
+
+void Historian::collectChunks(TagState& tag, std::uint32_t first, std::uint32_t last, std::uint64_t lastSize,
+                              std::int64_t from, std::int64_t to,
+                              std::vector<std::pair<SegmentView*, std::size_t>>& chunks) {
+    chunks.clear();
+    std::vector<std::unique_ptr<SegmentView>>& views = tag.views;
+    // Сегменты, удаленные по сроку хранения
+    views.erase(views.begin(), std::find_if(views.begin(), views.end(),
+                                            [first](const auto& view) { return view->number >= first; }));
+    if (first == 0 || last == 0) {
+        return;
+    }
+
+    // От новых сегментов к старым, пока сегмент не начнется раньше from
+    std::vector<SegmentView*> selected;
+    for (std::uint32_t number = last; number >= first && number > 0; --number) {
+        auto it = std::lower_bound(views.begin(), views.end(), number,
+                                   [](const auto& view, std::uint32_t n) { return view->number < n; });
+        if (it == views.end() || (*it)->number != number) {
+            auto view = std::make_unique<SegmentView>();
+            view->number = number;
+            it = views.insert(it, std::move(view));
+        }
+        SegmentView& view = **it;
+
+        std::uint64_t limit = view.indexed;
+        if (number == last) {
+            limit = lastSize;
+        } else if (!view.complete) {
+            std::error_code error;
+            std::uintmax_t size = std::filesystem::file_size(segmentPath(tag, number), error);
+            limit = error ? 0 : size;
+        }
+        if (limit > 0 && indexSegment(tag, view, limit)) {
+            view.complete = number != last;
+            selected.push_back(&view);
+        }
+        if (!view.chunks.empty() && view.chunks.front().firstTime < from) {
+            break;
+        }
+    }
+
+    for (auto it = selected.rbegin(); it != selected.rend(); ++it) {
+        const std::vector<ChunkRef>& refs = (*it)->chunks;
+        auto begin = std::partition_point(refs.begin(), refs.end(), [from](const ChunkRef& ref) { return ref.lastTime < from; });
+        auto end = std::partition_point(begin, refs.end(), [to](const ChunkRef& ref) { return ref.firstTime < to; });
+        for (auto ref = begin; ref != end; ++ref) {
+            chunks.emplace_back(*it, static_cast<std::size_t>(ref - refs.begin()));
+        }
+    }
+}
+
+void Historian::releaseViews(TagState& tag) {
+    // Индекс кусков остается, отображение вернется при следующем чтении
+    for (auto& view : tag.views) {
+        view->file.close();
+    }
+}
+
+std::size_t Historian::query(const std::string& name, HistoryClock::time_point from, HistoryClock::time_point to,
+                             std::vector<double>& values, std::vector<HistoryClock::time_point>& times,
+                             std::size_t maxCount) {
+    values.clear();
+    times.clear();
+    TagState* tag = findState(name);
+    if (!tag || !(from < to)) {
+        return 0;
+    }
+    std::int64_t fromMs = toUnixMs(from);
+    std::int64_t toMs = toUnixMs(to);
+
+    std::vector<double> pendingValues;
+    std::vector<std::int64_t> pendingTimes;
+    double chunkValues[CHUNK_SAMPLES];
+    std::int64_t chunkTimes[CHUNK_SAMPLES];
+    auto takePending = [&](const std::vector<std::uint64_t>& words, std::size_t count, std::int64_t firstTime) {
+        decodeTimeSeries(words.data(), count, firstTime, chunkValues, chunkTimes);
+        for (std::size_t i = 0; i < count; ++i) {
+            if (chunkTimes[i] >= fromMs && chunkTimes[i] < toMs) {
+                pendingValues.push_back(chunkValues[i]);
+                pendingTimes.push_back(chunkTimes[i]);
+            }
+        }
+    };
+
+    // Записанная часть архива и закрытые куски в очереди - одним снимком
+    std::uint32_t first, last;
+    std::uint64_t lastSize;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        first = tag->firstSegment;
+        last = tag->durableSegment;
+        lastSize = tag->durableSize;
+        for (const Chunk& chunk : queue) {
+            if (chunk.tag == tag && chunk.complete && chunk.lastTime >= fromMs && chunk.firstTime < toMs) {
+                takePending(chunk.words, chunk.count, chunk.firstTime);
+            }
+        }
+    }
+    if (tag->encoder.count() > 0 && tag->lastTime >= fromMs && tag->firstTime < toMs) {
+        takePending(tag->words, tag->encoder.count(), tag->firstTime);
+    }
+
+    std::vector<std::pair<SegmentView*, std::size_t>> chunks;
+    collectChunks(*tag, first, last, lastSize, fromMs, toMs, chunks);
+
+    // С maxCount разжимаются только последние куски: с конца, пока целиком попавших
+    // в диапазон значений не хватит
+    std::size_t start = 0;
+    if (maxCount > 0) {
+        std::size_t available = pendingValues.size();
+        start = chunks.size();
+        while (start > 0 && available < maxCount) {
+            --start;
+            const ChunkRef& ref = chunks[start].first->chunks[chunks[start].second];
+            if (ref.firstTime >= fromMs && ref.lastTime < toMs) {
+                available += ref.count;
+            }
+        }
+    }
+
+    std::size_t total = pendingValues.size();
+    for (std::size_t i = start; i < chunks.size(); ++i) {
+        total += chunks[i].first->chunks[chunks[i].second].count;
+    }
+    // Куски разжимаются прямо в результат; у кусков на краях диапазона лишнее сдвигается
+    values.resize(total);
+    std::vector<std::int64_t> unixTimes(total);
+    std::size_t size = 0;
+    for (std::size_t i = start; i < chunks.size(); ++i) {
+        SegmentView& view = *chunks[i].first;
+        ChunkRef& ref = view.chunks[chunks[i].second];
+        ChunkHeader header;
+        std::memcpy(&header, view.file.getData() + ref.offset, sizeof(header));
+        const std::uint64_t* words = chunkWords(view.file.getData(), ref.offset);
+        if (ref.check == ChunkCheck::Unchecked) {
+            ref.check = chunkCrc(header, words) == header.crc ? ChunkCheck::Valid : ChunkCheck::Damaged;
+        }
+        if (ref.check == ChunkCheck::Damaged) {
+            continue;  // Поврежденный кусок пропускается
+        }
+        double* outValues = values.data() + size;
+        std::int64_t* outTimes = unixTimes.data() + size;
+        decodeTimeSeries(words, header.count, header.firstTime, outValues, outTimes);
+        if (ref.firstTime >= fromMs && ref.lastTime < toMs) {
+            size += header.count;
+            continue;
+        }
+        for (std::uint32_t j = 0; j < header.count; ++j) {
+            if (outTimes[j] >= fromMs && outTimes[j] < toMs) {
+                values[size] = outValues[j];
+                unixTimes[size] = outTimes[j];
+                ++size;
+            }
+        }
+    }
+    values.resize(size);
+    unixTimes.resize(size);
+    values.insert(values.end(), pendingValues.begin(), pendingValues.end());
+    unixTimes.insert(unixTimes.end(), pendingTimes.begin(), pendingTimes.end());
+
+    std::size_t skip = maxCount > 0 && values.size() > maxCount ? values.size() - maxCount : 0;
+    values.erase(values.begin(), values.begin() + skip);
+    times.reserve(values.size());
+    for (std::size_t i = skip; i < unixTimes.size(); ++i) {
+        times.push_back(fromUnixMs(unixTimes[i]));
+    }
+    return values.size();
+}
+
+std::size_t Historian::backfill(VariableDatabase& db, HistoryClock::duration window) {
+    HistoryClock::time_point now = HistoryClock::now();
+    std::vector<TagId> historyTags = db.getHistoryTags();
+    std::vector<double> values;
+    std::vector<HistoryClock::time_point> times;
+    std::size_t filled = 0;
+
+    for (TagId tag : historyTags) {
+        if (db.getHistoryTotal(tag) > 0) {
+            continue;
+        }
+        const std::string& name = db.getTagName(tag);
+        TagState* archived = findState(name);
+        if (!archived) {
+            continue;
+        }
+        if (query(name, now - window, now, values, times, db.getHistoryCapacity(tag)) > 0) {
+            db.restoreHistory(tag, values, times, false);
+            ++filled;
+        }
+        // При запуске читаются тысячи переменных: отображения не копятся
+        releaseViews(*archived);
+    }
+    return filled;
+}
@@ -0,0 +1,115 @@
+#include "HistoryBuffer.h"
+#include <algorithm>
+
+std::size_t HistoryView::lowerBound(HistoryClock::time_point time) const {
+    std::size_t low = 0, high = size();
+    while (low < high) {
+        std::size_t middle = low + (high - low) / 2;
+        if (this->time(middle) < time) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+HistoryView HistoryView::last(std::size_t n) const {
+    std::size_t total = size();
+    if (n >= total) {
+        return *this;
+    }
+
+    // Пропускаем (total - n) самых старых значений
+    std::size_t skip = total - n;
+    HistoryView result;
+    if (skip < firstSize) {
+        result.first = first + skip;
+        result.firstSize = firstSize - skip;
+        result.second = second;
+        result.secondSize = secondSize;
+        result.firstTimes = firstTimes ? firstTimes + skip : nullptr;
+        result.secondTimes = secondTimes;
+    } else {
+        result.first = second + (skip - firstSize);
+        result.firstSize = n;
+        result.firstTimes = secondTimes ? secondTimes + (skip - firstSize) : nullptr;
+    }
+    return result;
+}
+
+HistoryBuffer::HistoryBuffer(std::size_t capacity)
+    : maxSize(std::max<std::size_t>(capacity, 1)), head(0), pushed(0) {}
+
+void HistoryBuffer::push(double value) {
+    push(value, HistoryClock::now());
+}
+
+void HistoryBuffer::push(double value, HistoryClock::time_point time) {
+    if (!times.empty()) {
+        // Самое новое значение - перед head (после заполнения) или в конце
+        std::size_t newest = data.size() < maxSize ? data.size() - 1 : (head + maxSize - 1) % maxSize;
+        time = std::max(time, times[newest]);
+    }
+
+    ++pushed;
+    if (data.size() < maxSize) {
+        // Буфер еще заполняется - просто дописываем в конец
+        data.push_back(value);
+        times.push_back(time);
+        return;
+    }
+
+    // Буфер заполнен - перезаписываем самое старое значение
+    data[head] = value;
+    times[head] = time;
+    head = (head + 1) % maxSize;
+}
+
+void HistoryBuffer::setCapacity(std::size_t capacity) {
+    capacity = std::max<std::size_t>(capacity, 1);
+    if (capacity == maxSize) {
+        return;
+    }
+
+    // Переупорядочиваем данные от старых к новым, оставляя только самые новые
+    HistoryView current = view().last(capacity);
+    std::vector<double> reordered;
+    reordered.reserve(std::min(capacity, current.size()));
+    reordered.insert(reordered.end(), current.first, current.first + current.firstSize);
+    reordered.insert(reordered.end(), current.second, current.second + current.secondSize);
+    std::vector<HistoryClock::time_point> reorderedTimes;
+    reorderedTimes.reserve(reordered.size());
+    reorderedTimes.insert(reorderedTimes.end(), current.firstTimes, current.firstTimes + current.firstSize);
+    reorderedTimes.insert(reorderedTimes.end(), current.secondTimes, current.secondTimes + current.secondSize);
+
+    data.swap(reordered);
+    times.swap(reorderedTimes);
+    maxSize = capacity;
+    head = 0;
+}
+
+HistoryView HistoryBuffer::view() const {
+    HistoryView result;
+    if (data.size() < maxSize) {
+        result.first = data.data();
+        result.firstSize = data.size();
+        result.firstTimes = times.data();
+        return result;
+    }
+
+    // [head, end) - старые значения, [0, head) - новые
+    result.first = data.data() + head;
+    result.firstSize = maxSize - head;
+    result.second = data.data();
+    result.secondSize = head;
+    result.firstTimes = times.data() + head;
+    result.secondTimes = times.data();
+    return result;
+}
+
+void HistoryBuffer::clear() {
+    data.clear();
+    times.clear();
+    head = 0;
+}
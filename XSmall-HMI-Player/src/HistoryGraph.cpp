@@ -1,33 +1,84 @@
 #include "HistoryGraph.h"
 #include "logger.h"
 #include <algorithm>
+#include <cmath>
 
 HistoryGraph::HistoryGraph(float x, float y, float width, float height,
                            const std::string& name, VariableDatabase* db,
                            const std::string& varName, size_t maxHistory,
                            const sf::Color& lineClr, const sf::Color& gridClr)
     : VisualObject(x, y, name, db), width(width), height(height), 
-      variableName(varName), maxHistorySize(maxHistory),
-      lineColor(lineClr), gridColor(gridClr) {
+      variableName(varName),
+      tag(!varName.empty() && db ? db->resolveTag(varName) : INVALID_TAG),
+      maxHistorySize(std::max<size_t>(maxHistory, 2)),
+      lineColor(lineClr), gridColor(gridClr), timeWindow(0.0), sampleRate(0.0),
+      syncedAt(HistoryClock::time_point()) {
     
     background.setPosition(x, y);
     background.setSize(sf::Vector2f(width, height));
     background.setFillColor(sf::Color::Transparent);
     background.setOutlineColor(sf::Color::Black);
     background.setOutlineThickness(1);
+
+    curve.configure(maxHistorySize, static_cast<std::size_t>(width));
+    curve.setColor(lineColor);
     
     // Подписываемся на изменения переменной для обновления графика
-    if (!variableName.empty() && database) {
-        database->subscribe(variableName, [this](double value) {
+    if (tag != INVALID_TAG) {
+        // История должна вмещать все точки, которые показывает график
+        database->requestHistoryCapacity(tag, maxHistorySize);
+
+        subscribe(tag, [this](double value) {
             this->update();
         });
     }
 }
 
-void HistoryGraph::draw(sf::RenderWindow& window) {
-    window.draw(background);
-    drawGrid(window);
-    drawGraph(window);
+void HistoryGraph::draw(sf::RenderTarget& target) {
+    target.draw(background);
+    drawGrid(target);
+    drawGraph(target);
+}
+
+void HistoryGraph::attachToBatch(RenderBatch& batch) {
+    // Фон прозрачный - в пакет идут только рамка и 6 линий сетки
+    BatchRange range = batch.allocate(RenderBatch::OUTLINE_VERTICES + 6 * RenderBatch::QUAD_VERTICES);
+    sf::Vertex* out = RenderBatch::writeOutline(batch.data(range), sf::FloatRect(x, y, width, height),
+                                                background.getOutlineThickness(), background.getOutlineColor());
+    for (int i = 1; i < 4; ++i) {
+        out = RenderBatch::writeLine(out, sf::Vector2f(x + i * width / 4, y),
+                                     sf::Vector2f(x + i * width / 4, y + height), gridColor);
+    }
+    for (int i = 1; i < 4; ++i) {
+        out = RenderBatch::writeLine(out, sf::Vector2f(x, y + i * height / 4),
+                                     sf::Vector2f(x + width, y + i * height / 4), gridColor);
+    }
+}
+
+void HistoryGraph::drawOverlay(sf::RenderTarget& target) {
+    drawGraph(target);
+}
+
+sf::FloatRect HistoryGraph::getBounds() const {
+    float outline = background.getOutlineThickness();
+    return sf::FloatRect(x - outline, y - outline, width + 2 * outline, height + 2 * outline);
+}
+
+void HistoryGraph::setTimeWindow(double seconds, double rate) {
+    if (seconds <= 0) {
+        return;
+    }
+    timeWindow = seconds;
+    sampleRate = std::max(rate, 0.0);
+    curve.configureTime(std::chrono::duration_cast<HistoryClock::duration>(std::chrono::duration<double>(seconds)),
+                        static_cast<std::size_t>(width));
+
+    if (tag != INVALID_TAG && sampleRate > 0) {
+        database->requestHistoryResampling(tag, std::chrono::duration_cast<HistoryClock::duration>(
+                                                    std::chrono::duration<double>(1.0 / sampleRate)));
+        // Отсчеты всего окна и значение перед ним
+        database->requestHistoryCapacity(tag, static_cast<std::size_t>(std::ceil(seconds * sampleRate)) + 2);
+    }
 }
 
 void HistoryGraph::update() {
@@ -35,14 +86,14 @@ void HistoryGraph::update() {
     // Визуальное обновление выполняется в drawGraph()
 }
 
-void HistoryGraph::drawGrid(sf::RenderWindow& window) {
+void HistoryGraph::drawGrid(sf::RenderTarget& target) {
     // Рисуем вертикальные линии сетки (4 секции)
     for (int i = 1; i < 4; ++i) {
         sf::Vertex verticalLine[] = {
             sf::Vertex(sf::Vector2f(x + i * width / 4, y), gridColor),
             sf::Vertex(sf::Vector2f(x + i * width / 4, y + height), gridColor)
         };
-        window.draw(verticalLine, 2, sf::Lines);
+        target.draw(verticalLine, 2, sf::Lines);
     }
     
     // Рисуем горизонтальные линии сетки
@@ -51,36 +102,54 @@ void HistoryGraph::drawGrid(sf::RenderWindow& window) {
             sf::Vertex(sf::Vector2f(x, y + i * height / 4), gridColor),
             sf::Vertex(sf::Vector2f(x + width, y + i * height / 4), gridColor)
         };
-        window.draw(horizontalLine, 2, sf::Lines);
+        target.draw(horizontalLine, 2, sf::Lines);
+    }
+}
+
+void HistoryGraph::drawGraph(sf::RenderTarget& target) {
+    syncHistory(HistoryClock::now());
+    curve.draw(target, plotArea());
+}
+
+bool HistoryGraph::needsFrame(HistoryClock::time_point now) const {
+    if (timeWindow <= 0 || tag == INVALID_TAG) {
+        return false;
     }
+    double secondsPerPixel = timeWindow / std::max(width, 1.0f);
+    return std::chrono::duration<double>(now - syncedAt).count() >= secondsPerPixel;
 }
 
-void HistoryGraph::drawGraph(sf::RenderWindow& window) {
-    if (!variableName.empty() && database) {
-        const auto& history = database->getHistory(variableName);
-        if (history.size() > 1) {
-            std::vector<sf::Vertex> lineVertices;
-            
-            // Находим минимальное и максимальное значения для масштабирования
-            float maxVal = *std::max_element(history.begin(), history.end());
-            float minVal = *std::min_element(history.begin(), history.end());
-            float range = maxVal - minVal;
-            if (range == 0) range = 1;  // Избегаем деления на ноль
-            
-            // Масштабируем точки графика под размеры виджета
-            float xStep = width / (history.size() - 1);
-            
-            for (size_t i = 0; i < history.size(); ++i) {
-                // Преобразуем значение в координаты Y (инвертируем ось Y - 0 вверху)
-                float xPos = x + i * xStep;
-                float yPos = y + height - ((history[i] - minVal) / range * height);
-                lineVertices.push_back(sf::Vertex(sf::Vector2f(xPos, yPos), lineColor));
-            }
-            
-            // Рисуем линию графика через все точки
-            if (lineVertices.size() > 1) {
-                window.draw(&lineVertices[0], lineVertices.size(), sf::LineStrip);
-            }
-        }
+void HistoryGraph::syncHistory(HistoryClock::time_point now) {
+    if (tag == INVALID_TAG) {
+        return;
+    }
+    syncedAt = now;
+
+    // Значение, удержанное swinging door, еще не в истории, но уже на экране
+    HistoryClock::time_point pendingTime;
+    double pendingValue = 0.0;
+    if (database->getPendingHistory(tag, pendingTime, pendingValue)) {
+        curve.setPending(pendingTime, pendingValue);
+    } else {
+        curve.clearPending();
     }
-}
\ No newline at end of file
+    if (const CompressedHistory* compressed = database->getCompressedHistory(tag)) {
+        curve.sync(*compressed, now);
+    } else {
+        curve.sync(database->getHistory(tag), database->getHistoryTotal(tag), now);
+    }
+}
+
+std::vector<sf::Vector2f> HistoryGraph::getCurvePoints() {
+    return getCurvePoints(HistoryClock::now());
+}
+
+std::vector<sf::Vector2f> HistoryGraph::getCurvePoints(HistoryClock::time_point now) {
+    syncHistory(now);
+    return curve.getScreenPoints(plotArea());
+}
+
+std::size_t HistoryGraph::getCurveVertexCount() {
+    syncHistory(HistoryClock::now());
+    return curve.getVertexCount();
+}
@@ -0,0 +1,173 @@
+#include "HistoryRollup.h"
+#include <algorithm>
+
+namespace {
+
+using std::chrono::seconds;
+using std::chrono::minutes;
+using std::chrono::hours;
+
+// 1 с - последний час, 1 мин - двое суток, 1 ч - 60 суток
+const HistoryClock::duration LEVEL_WIDTHS[HistoryRollup::LEVEL_COUNT] = {seconds(1), minutes(1), hours(1)};
+const std::size_t LEVEL_CAPACITIES[HistoryRollup::LEVEL_COUNT] = {3600, 2 * 24 * 60, 60 * 24};
+
+// Деление с округлением вниз (время до эпохи часов тоже допустимо)
+std::int64_t floorDivide(std::int64_t value, std::int64_t divisor) {
+    return value >= 0 ? value / divisor : -((-value + divisor - 1) / divisor);
+}
+
+std::int64_t bucketNumber(HistoryClock::time_point time, HistoryClock::duration width) {
+    return floorDivide(static_cast<std::int64_t>(time.time_since_epoch().count()),
+                       static_cast<std::int64_t>(width.count()));
+}
+
+std::size_t ringPosition(std::int64_t number, std::int64_t capacity) {
+    return static_cast<std::size_t>(((number % capacity) + capacity) % capacity);
+}
+
+} // namespace
+
+void HistoryAggregate::add(double value) {
+    if (count == 0) {
+        min = max = value;
+    } else {
+        min = std::min(min, value);
+        max = std::max(max, value);
+    }
+    sum += value;
+    ++count;
+}
+
+void HistoryAggregate::merge(const HistoryAggregate& other) {
+    if (other.count == 0) {
+        return;
+    }
+    if (count == 0) {
+        *this = other;
+        return;
+    }
+    min = std::min(min, other.min);
+    max = std::max(max, other.max);
+    sum += other.sum;
+    count += other.count;
+}
+
+HistoryRollup::HistoryRollup() {
+    for (Level& level : levels) {
+        level.newest = 0;
+        level.oldest = 1;  // Пустой уровень: oldest > newest
+    }
+}
+
+HistoryClock::duration HistoryRollup::getLevelWidth(std::size_t level) {
+    return LEVEL_WIDTHS[level];
+}
+
+std::size_t HistoryRollup::getLevelCapacity(std::size_t level) {
+    return LEVEL_CAPACITIES[level];
+}
+
+void HistoryRollup::add(HistoryClock::time_point time, double value) {
+    for (std::size_t i = 0; i < LEVEL_COUNT; ++i) {
+        Level& level = levels[i];
+        std::int64_t capacity = static_cast<std::int64_t>(LEVEL_CAPACITIES[i]);
+        std::int64_t number = bucketNumber(time, LEVEL_WIDTHS[i]);
+
+        if (level.buckets.empty()) {
+            level.buckets.resize(LEVEL_CAPACITIES[i]);
+            level.newest = number;
+            level.oldest = number;
+        } else if (number > level.newest) {
+            // Новые интервалы очищаются; разрыв длиннее кольца очищает его целиком
+            std::int64_t from = std::max(level.newest + 1, number - capacity + 1);
+            for (std::int64_t n = from; n <= number; ++n) {
+                level.buckets[ringPosition(n, capacity)] = HistoryAggregate();
+            }
+            level.newest = number;
+            level.oldest = std::max(level.oldest, number - capacity + 1);
+        } else if (number < level.oldest) {
+            if (number <= level.newest - capacity) {
+                continue;  // Значение старше хранимой истории уровня
+            }
+            for (std::int64_t n = number; n < level.oldest; ++n) {
+                level.buckets[ringPosition(n, capacity)] = HistoryAggregate();
+            }
+            level.oldest = number;
+        }
+        level.buckets[ringPosition(number, capacity)].add(value);
+    }
+}
+
+std::size_t HistoryRollup::selectLevel(HistoryClock::duration interval) {
+    std::size_t selected = 0;
+    for (std::size_t i = 1; i < LEVEL_COUNT; ++i) {
+        if (LEVEL_WIDTHS[i] <= interval) {
+            selected = i;
+        }
+    }
+    return selected;
+}
+
+std::vector<HistoryAggregate> HistoryRollup::query(HistoryClock::time_point from, HistoryClock::time_point to,
+                                                   std::size_t buckets) const {
+    std::vector<HistoryAggregate> result(buckets);
+    if (buckets == 0 || to <= from) {
+        return result;
+    }
+
+    HistoryClock::duration span = to - from;
+    double scale = static_cast<double>(buckets) / static_cast<double>(span.count());
+
+    // Уровень отвечает за [начало своего хранимого участка, end); более старую часть
+    // окна берет следующий, более грубый уровень. Граница выравнивается по его интервалу,
+    // чтобы значения не учитывались дважды
+    HistoryClock::time_point end = to;
+    bool answered = false;  // Более мелкие уровни уже дали значения
+    for (std::size_t i = selectLevel(span / static_cast<HistoryClock::duration::rep>(buckets)); i < LEVEL_COUNT; ++i) {
+        const Level& level = levels[i];
+        if (level.buckets.empty()) {
+            break;
+        }
+
+        HistoryClock::duration width = LEVEL_WIDTHS[i];
+        std::int64_t capacity = static_cast<std::int64_t>(LEVEL_CAPACITIES[i]);
+        std::int64_t first = bucketNumber(from, width);
+        std::int64_t last = std::min(bucketNumber(end - HistoryClock::duration(1), width), level.newest);
+        bool older = first < level.oldest && i + 1 < LEVEL_COUNT;
+        if (older) {
+            std::int64_t ratio = LEVEL_WIDTHS[i + 1] / width;
+            first = -floorDivide(-level.oldest, ratio) * ratio;
+        }
+        first = std::max(first, level.oldest);
+
+        // Интервал уровня попадает в столбец по своему началу (начало до from - в первый столбец).
+        // Если мелкий уровень ничего не дал после выравнивания, граница end не кратна этому
+        // уровню: интервал, заходящий за end, уже частично учтен и пропускается
+        bool levelAnswered = false;
+        for (std::int64_t n = first; n <= last; ++n) {
+            const HistoryAggregate& bucket = level.buckets[ringPosition(n, capacity)];
+            if (bucket.count == 0 || (answered && width * (n + 1) > end.time_since_epoch())) {
+                continue;
+            }
+            levelAnswered = true;
+            HistoryClock::duration offset = std::max(width * n - from.time_since_epoch(), HistoryClock::duration(0));
+            std::size_t column = std::min(static_cast<std::size_t>(offset.count() * scale), buckets - 1);
+            result[column].merge(bucket);
+        }
+
+        answered = answered || levelAnswered;
+        if (!older) {
+            break;
+        }
+        end = std::min(end, HistoryClock::time_point(width * first));
+    }
+    return result;
+}
+
+std::size_t HistoryRollup::memoryUsage() const {
+    std::size_t bytes = 0;
+    for (const Level& level : levels) {
+        bytes += level.buckets.capacity() * sizeof(HistoryAggregate);
+    }
+    return bytes;
+}
@@ -1,106 +1,196 @@
 #include "HmiPlayer.h"
 #include "SceneFactory.h"
 #include "JSONLoader.h"
-#include "StateManager.h"
+#include "BinaryScene.h"
+#include "FrameScheduler.h"
+#include "ResourceManager.h"
 #include "logger.h"
-#include <thread>
 #include <chrono>
 #include <filesystem>
 
 HmiPlayer::HmiPlayer() 
-    : window(sf::VideoMode(1024, 768), "XSmall-HMI SCADA Player") {
-    
-    window.setFramerateLimit(60); // Ограничения 60 FPS для стабильности
+    : window(sf::VideoMode(1024, 768), "XSmall-HMI SCADA Player"),
+      redrawNeeded(true), renderedRevision(0), inputPending(false),
+      temperatureTag(database.resolveTag("temperature_value")),
+      setpointTag(database.resolveTag("setpoint_value")) {
+
+    // Частоту кадров задает FrameScheduler, а не setFramerateLimit
+
+    // Изменения переменных накапливаются и доставляются объектам один раз за кадр
+    database.setNotifyMode(NotifyMode::Deferred);
+
+    sceneRenderer.setBackground(sf::Color(16, 41, 79)); // Темно-синий фон
 }
 
 bool HmiPlayer::initialize() {
-    // Загружаем шрифт
-    std::vector<std::string> fontPaths = {
-        "../assets/fonts/helveticabold.ttf",
-        "assets/fonts/helveticabold.ttf",
-        "assets/fonts/arial.ttf",        
-        "../../assets/fonts/helveticabold.ttf"
-    };
-    
-    bool fontLoaded = false;
-    for (const auto& path : fontPaths) {
-        if (font.loadFromFile(path)) {
-            Logger::info("Font loaded successfully from: " + path);
-            fontLoaded = true;
+    // Загружаем шрифт (корни поиска - в ResourceManager)
+    ResourceManager& resources = ResourceManager::instance();
+    for (const char* path : {"assets/fonts/helveticabold.ttf", "assets/fonts/arial.ttf"}) {
+        font = resources.getFont(path);
+        if (font) {
+            Logger::info("Font loaded successfully from: " + resources.resolvePath(path));
             break;
         }
     }
     
-    if (!fontLoaded) {
+    if (!font) {
         Logger::error("Failed to load font from all possible paths");
         return false;
     }
+
+    // Заглушки изображений подписываются этим же шрифтом
+    resources.setDefaultFont(font);
     
-    // Загружаем сохраненное состояние из файла saved_state.json
-    StateManager stateManager;
+    // Загружаем сохраненное состояние из файла saved_state.json и доигрываем журнал
+    // значений, введенных оператором после последнего снимка
+    stateManager.enableJournal(database);
     stateManager.loadState(database);
     
     // Проверяем наличие файла конфигурации
     std::string configFile = "objects.json";
-    
-    if (!std::filesystem::exists(configFile)) {
+
+    bool configAvailable = std::filesystem::exists(configFile);
+    if (!configAvailable) {
         // Если файла нет, создаем демо-конфигурацию
         Logger::info("Configuration file not found, creating demo configuration...");
-        if (!JSONLoader::createDemoConfig(configFile)) {
+        configAvailable = JSONLoader::createDemoConfig(configFile);
+        if (!configAvailable) {
             Logger::warning("Failed to create demo configuration, using default scene");
-            objects = SceneFactory::createDemoScene(&database, &font);
+        }
+    }
+
+    if (configAvailable) {
+        // Скомпилированная сцена рядом с JSON загружается без разбора текста.
+        // Если ее нет или JSON изменился, компилируем заново; при ошибке читаем JSON напрямую
+        std::string sceneFile = BinaryScene::pathFor(configFile);
+        BinaryScene scene;
+        bool sceneReady = scene.open(sceneFile) && scene.isUpToDate(configFile);
+        if (!sceneReady) {
+            scene.close();
+            sceneReady = JSONLoader::compileScene(configFile, sceneFile) && scene.open(sceneFile);
+        }
+
+        if (sceneReady) {
+            scene.readPlayerSettings(settings);
+            resources.setAtlasCacheDir(settings.atlasCacheDir);
+
+            Logger::info("Loading objects from compiled scene: " + sceneFile);
+            objects = scene.instantiate(&database, font.get());
         } else {
-            // После создания файла загружаем из него
-            objects = JSONLoader::loadFromFile(configFile, &database, &font);
+            // Настройки из секции "player" (если есть) нужны до загрузки объектов
+            JSONLoader::loadPlayerSettings(configFile, settings);
+            resources.setAtlasCacheDir(settings.atlasCacheDir);
+
+            Logger::info("Loading objects from configuration file: " + configFile);
+            objects = JSONLoader::loadFromFile(configFile, &database, font.get());
         }
-    } else {
-        // Загружаем объекты из конфигурационного файла
-        Logger::info("Loading objects from configuration file: " + configFile);
-        objects = JSONLoader::loadFromFile(configFile, &database, &font);
-        
-        // Если не удалось загрузить, создаем демо-сцену
-        if (objects.empty()) {
-            Logger::warning("Failed to load objects from JSON, creating demo scene");
-            objects = SceneFactory::createDemoScene(&database, &font);
+
+        // Дальнейшие правки файла применяются без перезапуска
+        if (!objects.empty()) {
+            sceneReloader = std::make_unique<SceneReloader>(configFile);
+            sceneReloader->start();
         }
     }
+
+    // Список сохраняемых переменных (пустой - все) из секции "player"
+    stateManager.setTags(database, settings.stateTags);
+
+    // Архив истории: пустая история переменных дозаполняется из него,
+    // дальше в него пишется все, что попадает в историю
+    if (!settings.historianDir.empty()) {
+        historian = std::make_unique<Historian>(settings.historianDir,
+                                                std::chrono::hours(24 * settings.historianRetentionDays));
+        historian->setChunkAge(std::chrono::seconds(settings.historianChunkSeconds));
+        std::size_t filled = historian->backfill(database, std::chrono::hours(24 * settings.historianRetentionDays));
+        historian->attach(database);
+        Logger::info("History archive " + settings.historianDir + ": backfilled " + std::to_string(filled) + " tags");
+    }
+
+    // Если не удалось загрузить, создаем демо-сцену
+    if (objects.empty()) {
+        Logger::warning("Failed to load objects from JSON, creating demo scene");
+        objects = SceneFactory::createDemoScene(&database, font.get());
+    }
     
     if (objects.empty()) {
         Logger::error("No objects created during initialization");
         return false;
     }
+
+    // Начальная синхронизация объектов с переменными, дальше обновление только по изменениям
+    database.dispatchPending();
+    for (auto& obj : objects) {
+        obj->update();
+    }
+
+    // Раскладываем геометрию объектов по пакетам: дальше объекты обновляют только свои вершины
+    sceneRenderer.build(objects);
+    Logger::info("Scene batched: " + std::to_string(sceneRenderer.getStepCount()) +
+                 " draw steps, " + std::to_string(sceneRenderer.getBatchCount()) + " batches, " +
+                 std::to_string(sceneRenderer.getStaticObjectCount()) + " static objects");
+
+    // Индекс границ интерактивных объектов для доставки событий мыши
+    eventRouter.build(objects);
     
     Logger::info("HMI Player initialized with " + std::to_string(objects.size()) + " objects");
     return true;
 }
 
 void HmiPlayer::run() {
-    StateManager stateManager;
-    
-     // Главный цикл приложения
-    while (window.isOpen()) {
-        handleEvents();
-        update();
-        render();
-        
-        // Автосохранение каждые 30 секунд
-        static sf::Clock saveClock;
-        if (saveClock.getElapsedTime().asSeconds() > 30.0) {
-            stateManager.saveState(database);
-            saveClock.restart();
+    FrameScheduler scheduler(settings.scheduler);
+    scheduler.setInputHandler([this, &scheduler]() {
+        if (handleEvents()) {
+            // Результат действия пользователя показываем сразу, не дожидаясь такта и кадра
+            database.dispatchPending();
+            scheduler.requestFrame();
         }
-        
-        // Задержка для контроля частоты кадров
-        std::this_thread::sleep_for(std::chrono::milliseconds(16));
+    });
+    scheduler.setTickHandler([this]() { update(); });
+    scheduler.setRenderHandler([this]() { render(); });
+
+    // Периодические задачи
+    scheduler.getTimers().scheduleEvery(std::chrono::milliseconds(settings.autosaveIntervalMs),
+                                        [this]() { stateManager.saveState(database); });
+    scheduler.getTimers().scheduleEvery(std::chrono::milliseconds(settings.demoIntervalMs),
+                                        [this]() { simulateDemo(); });
+    if (historian) {
+        scheduler.getTimers().scheduleEvery(std::chrono::seconds(1),
+                                            [this]() { historian->poll(HistoryClock::now()); });
     }
+
+    Logger::info("Main loop: render " + std::to_string(settings.scheduler.renderRate) +
+                 " Hz, logic " + std::to_string(settings.scheduler.tickRate) +
+                 " Hz, input " + std::to_string(settings.scheduler.inputRate) + " Hz");
+
+    // Главный цикл приложения
+    scheduler.run([this]() { return window.isOpen(); });
     
-    // Сохраняем при закрытии
+    // Сохраняем при закрытии и дожидаемся записи на диск
     stateManager.saveState(database);
+    stateManager.flush();
+    if (historian) {
+        historian->flush();
+    }
 }
 
-void HmiPlayer::handleEvents() {
+bool HmiPlayer::handleEvents() {
+    bool userActed = false;
     sf::Event event;
     while (window.pollEvent(event)) {
+        // Любое событие (ввод, возврат фокуса, изменение размера) может изменить картинку
+        redrawNeeded = true;
+
+        // Запоминаем момент первого действия пользователя до ближайшего кадра
+        bool userAction = event.type == sf::Event::MouseButtonPressed ||
+                          event.type == sf::Event::MouseButtonReleased ||
+                          event.type == sf::Event::KeyPressed ||
+                          event.type == sf::Event::TextEntered;
+        if (userAction && !inputPending) {
+            inputPending = true;
+            inputTime = std::chrono::steady_clock::now();
+        }
+        userActed = userActed || userAction;
+
         if (event.type == sf::Event::Closed) {
             window.close();
         }
@@ -112,57 +202,108 @@ void HmiPlayer::handleEvents() {
             }
         }
         
-        // Передаем события всем объектам для обработки
-        for (auto& obj : objects) {
-            obj->handleEvent(event, window);
+        // Передаем событие только объектам под курсором или в фокусе.
+        // Координаты курсора переводим в координаты сцены (окно могло быть растянуто)
+        sf::Vector2i pixel;
+        sf::Vector2f point;
+        if (EventRouter::getPixelPosition(event, pixel)) {
+            point = window.mapPixelToCoords(pixel);
         }
+        eventRouter.route(event, point, window);
     }
+
+    // Серия MouseMoved за опрос - одна проверка наведения
+    eventRouter.flush();
+    return userActed;
 }
 
 void HmiPlayer::update() {
-    static sf::Clock updateClock;
+    // Логический такт: доставляем накопленные изменения (одно уведомление на переменную,
+    // последнее значение) только подписанным на них объектам
+    database.dispatchPending();
 
-    // Обновляем объекты каждые 100 мс (10 раз в секунду)
-    if (updateClock.getElapsedTime().asMilliseconds() > 100) {
-        for (auto& obj : objects) {
-            obj->update();
-        }
-        updateClock.restart();
+    // Отсчеты истории для графиков с осью времени (выборка с удержанием)
+    database.sampleHistory(HistoryClock::now());
+
+    if (sceneReloader && sceneReloader->hasPending()) {
+        reloadScene();
     }
-    
+}
+
+bool HmiPlayer::reloadScene() {
+    std::vector<ScenePatch> patches = sceneReloader->takePending();
+    if (patches.empty()) {
+        return false;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::unique_ptr<VisualObject>> removed;
+    for (const ScenePatch& patch : patches) {
+        SceneReloader::applyPatch(patch, objects, &database, font.get(), removed);
+    }
+
+    // Пакеты и индекс ввода перестраиваются по новому списку; удаленные объекты
+    // освобождаются последними, когда на них больше никто не ссылается
+    sceneRenderer.build(objects);
+    eventRouter.build(objects);
+    removed.clear();
+    redrawNeeded = true;
+
+    // Тренды новых переменных - из архива
+    if (historian) {
+        historian->backfill(database, std::chrono::hours(24 * settings.historianRetentionDays));
+    }
+
+    double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    Logger::info("Scene reloaded in " + std::to_string(elapsedMs) + " ms, " +
+                 std::to_string(objects.size()) + " objects");
+    return true;
+}
+
+void HmiPlayer::simulateDemo() {
     // Умное обновление температуры - стремится к введенному нами значения setpoint 
-    static sf::Clock demoClock;
-    if (demoClock.getElapsedTime().asSeconds() > 0.2) { // Задается скорость изменения
-        double currentTemp = database.getVariable("temperature_value");
-        double setpoint = database.getVariable("setpoint_value");
-        
-        // Вычисляем разницу и плавно изменяем температуру
-        double difference = setpoint - currentTemp;
-        double change = 0.0;
-        
-        // Адаптивный шаг изменения: больше для больших разниц
-        if (std::abs(difference) > 1.0) {
-            change = (difference > 0) ? 0.2 : -0.2; // Шаг
-        } else if (std::abs(difference) > 0.2) {
-            change = difference * 0.5; // Пропорциональное изменение
-        } else {
-            change = difference * 0.8; // Медленное доведение до точного значения
-        }
-        
-        double newTemp = currentTemp + change;
-        database.setVariable("temperature_value", newTemp);
-        database.addToHistory("temperature_history", newTemp);
-        
-        demoClock.restart();
+    double currentTemp = database.get(temperatureTag);
+    double setpoint = database.get(setpointTag);
+    
+    // Вычисляем разницу и плавно изменяем температуру
+    double difference = setpoint - currentTemp;
+    double change = 0.0;
+    
+    // Адаптивный шаг изменения: больше для больших разниц
+    if (std::abs(difference) > 1.0) {
+        change = (difference > 0) ? 0.2 : -0.2; // Шаг
+    } else if (std::abs(difference) > 0.2) {
+        change = difference * 0.5; // Пропорциональное изменение
+    } else {
+        change = difference * 0.8; // Медленное доведение до точного значения
+    }
+    
+    double newTemp = currentTemp + change;
+    if (newTemp != currentTemp) {  // В установившемся режиме не будим подписчиков
+        database.set(temperatureTag, newTemp);
     }
 }
 
 void HmiPlayer::render() {
-    window.clear(sf::Color(16, 41, 79)); // Темно-синий фон
-    
-    for (auto& obj : objects) {
-        obj->draw(window);
+    // Ничего не изменилось с прошлого кадра - не рисуем и не вызываем display(),
+    // на экране остается предыдущий кадр. Тренды на оси времени сдвигаются и без записей
+    if (!redrawNeeded && database.getRevision() == renderedRevision &&
+        !sceneRenderer.needsFrame(HistoryClock::now())) {
+        return;
     }
+
+    // Фон и статические объекты выводятся одной текстурой, поверх - динамический слой
+    sceneRenderer.draw(window);
     
     window.display();
+
+    redrawNeeded = false;
+    renderedRevision = database.getRevision();
+
+    if (inputPending) {
+        inputPending = false;
+        auto latency = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - inputTime);
+        LOG_DEBUG("Input-to-frame latency: " + std::to_string(latency.count() / 1000.0) + " ms");
+    }
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include "Image.h"
+#include "ResourceManager.h"
+#include "RenderBatch.h"
 #include "logger.h"
-#include <iostream>
 
 Image::Image(float x, float y, float width, float height,
              const std::string& path, const std::string& name,
@@ -8,71 +9,82 @@ Image::Image(float x, float y, float width, float height,
     : VisualObject(x, y, name, db), imgWidth(width), imgHeight(height),
       imagePath(path), textureLoaded(false) {
     
-    std::cout << "Attempting to load image from: " << path << std::endl;
     textureLoaded = loadTexture(path);
     
     sprite.setPosition(x, y);
     if (textureLoaded) {
         // Масштабируем изображение под нужный размер
-        float scaleX = width / sprite.getLocalBounds().width;
-        float scaleY = height / sprite.getLocalBounds().height;
+        float scaleX = width / textureRect.width;
+        float scaleY = height / textureRect.height;
         sprite.setScale(scaleX, scaleY);
-        std::cout << "Image loaded successfully: " << path << std::endl;
     } else {
-        std::cout << "Failed to load image: " << path << std::endl;
+        buildPlaceholder();
     }
 }
 
-void Image::draw(sf::RenderWindow& window) {
+void Image::buildPlaceholder() {
+    placeholder.setSize(sf::Vector2f(imgWidth, imgHeight));
+    placeholder.setPosition(x, y);
+    placeholder.setFillColor(sf::Color(200, 200, 200));
+    placeholder.setOutlineColor(sf::Color::Black);
+    placeholder.setOutlineThickness(2);
+
+    // Текст "Image not found" шрифтом плеера (если он уже загружен)
+    placeholderFont = ResourceManager::instance().getDefaultFont();
+    if (placeholderFont) {
+        placeholderText.setFont(*placeholderFont);
+        placeholderText.setString("Image not found");
+        placeholderText.setCharacterSize(16);
+        placeholderText.setFillColor(sf::Color::Black);
+        placeholderText.setPosition(x + 10, y + imgHeight / 2 - 10);
+    }
+}
+
+void Image::draw(sf::RenderTarget& target) {
     if (textureLoaded) {
-        window.draw(sprite);
+        target.draw(sprite);
     } else {
-
         // Рисуем заглушку, если изображение не удалось загрузить
-        sf::RectangleShape placeholder(sf::Vector2f(imgWidth, imgHeight));
-        placeholder.setPosition(x, y);
-        placeholder.setFillColor(sf::Color(200, 200, 200));
-        placeholder.setOutlineColor(sf::Color::Black);
-        placeholder.setOutlineThickness(2);
-        window.draw(placeholder);
-        
-        // Текст "Image not found" при ошибке
-        sf::Font font;
-        // if (font.loadFromFile("C:/Windows/Fonts/arial.ttf")) {
-        if (font.loadFromFile("C:/projects/XSmall-HMI-Player/assets/fonts/couture.otf")) {
-            sf::Text errorText;
-            errorText.setFont(font);
-            errorText.setString("Image not found");
-            errorText.setCharacterSize(16);
-            errorText.setFillColor(sf::Color::Black);
-            errorText.setPosition(x + 10, y + imgHeight / 2 - 10);
-            window.draw(errorText);
+        target.draw(placeholder);
+        if (placeholderFont) {
+            target.draw(placeholderText);
         }
     }
 }
 
-// Пытается загрузить текстуру из нескольких возможных путей
+void Image::attachToBatch(RenderBatch& batch) {
+    sf::FloatRect rect(x, y, imgWidth, imgHeight);
+    if (textureLoaded) {
+        BatchRange range = batch.allocate(RenderBatch::QUAD_VERTICES);
+        RenderBatch::writeTexturedQuad(batch.data(range), rect, textureRect);
+        return;
+    }
+
+    BatchRange range = batch.allocate(RenderBatch::QUAD_VERTICES + RenderBatch::OUTLINE_VERTICES);
+    sf::Vertex* out = RenderBatch::writeQuad(batch.data(range), rect, placeholder.getFillColor());
+    RenderBatch::writeOutline(out, rect, placeholder.getOutlineThickness(), placeholder.getOutlineColor());
+}
+
+void Image::drawOverlay(sf::RenderTarget& target) {
+    target.draw(placeholderText);
+}
+
+sf::FloatRect Image::getBounds() const {
+    // Контур заглушки выходит на 2px за пределы изображения
+    return sf::FloatRect(x - 2, y - 2, imgWidth + 4, imgHeight + 4);
+}
+
+// Берет текстуру из общего кэша или атласа (поиск по корням - в ResourceManager)
 bool Image::loadTexture(const std::string& path) {
-    // Пробуем несколько возможных путей
-    std::vector<std::string> possiblePaths = {
-        path,  // Оригинальный путь
-        "../" + path,  // На уровень выше
-        "../../" + path,  // На два уровня выше
-        "C:/projects/XSmall-HMI-Player/" + path,  // Абсолютный путь
-        "assets/images/logo.png",  // Просто от корня
-        "../assets/images/logo.png" // От build папки
-    };
-    
-    // Пробуем каждый путь
-    for (const auto& testPath : possiblePaths) {
-        std::cout << "Trying to load: " << testPath << std::endl;
-        if (texture.loadFromFile(testPath)) {
-            sprite.setTexture(texture);
-            std::cout << "Successfully loaded from: " << testPath << std::endl;
-            return true;
-        }
+    TextureRegion region = ResourceManager::instance().getTextureRegion(path);
+    if (!region) {
+        Logger::warning("Could not load image from any path: " + path);
+        return false;
     }
-    
-    Logger::warning("Could not load image from any path: " + path);
-    return false;
-}
\ No newline at end of file
+
+    texture = std::move(region.texture);
+    textureRect = region.rect;
+    sprite.setTexture(*texture);
+    sprite.setTextureRect(textureRect);
+    return true;
+}
@@ -1,12 +1,19 @@
 #include "InputField.h"
 #include "logger.h"
 
+namespace {
+
+// Запас глифов под вводимую строку: при наборе текста участок в пакете не переносится
+const std::size_t INPUT_TEXT_CAPACITY = 32;
+
+} // namespace
 
 InputField::InputField(float x, float y, float width, float height,
                        sf::Font* font, unsigned int fontSize,
                        const std::string& name, VariableDatabase* db,
                        const std::string& varName)
-    : VisualObject(x, y, name, db), font(font), variableName(varName), 
+    : VisualObject(x, y, name, db), font(font), variableName(varName),
+      tag(!varName.empty() && db ? db->resolveTag(varName) : INVALID_TAG),
       isActive(false), inputText("") {
     
     background.setPosition(x, y);
@@ -22,37 +29,77 @@ InputField::InputField(float x, float y, float width, float height,
     text.setString(inputText);
     
     // Подписываемся на изменения переменной для синхронизации
-    if (!variableName.empty() && database) {
-        database->subscribe(variableName, [this](double value) {
+    if (tag != INVALID_TAG) {
+        subscribe(tag, [this](double value) {
             this->update();
         });
     }
 }
 
-void InputField::draw(sf::RenderWindow& window) {
-    window.draw(background);
-    window.draw(text);
+void InputField::draw(sf::RenderTarget& target) {
+    target.draw(background);
+    target.draw(text);
+}
+
+void InputField::attachToBatch(RenderBatch& batch) {
+    batchRange = batch.allocate(RenderBatch::QUAD_VERTICES + RenderBatch::OUTLINE_VERTICES);
+    writeBatchGeometry();
+    textRun.attach(batch, text, INPUT_TEXT_CAPACITY);
+}
+
+void InputField::writeBatchGeometry() {
+    if (!batchRange.attached()) {
+        return;
+    }
+
+    sf::FloatRect rect(x, y, background.getSize().x, background.getSize().y);
+    sf::Vertex* out = RenderBatch::writeQuad(batchRange.batch->data(batchRange), rect, background.getFillColor());
+    RenderBatch::writeOutline(out, rect, background.getOutlineThickness(), background.getOutlineColor());
+    if (batchRange.batch->getTexture()) {
+        // Заливка берется из белого участка атласа шрифта - текст ложится в тот же пакет
+        RenderBatch::setTexCoords(batchRange.batch->data(batchRange), batchRange.count, TextRun::SOLID_TEX_COORDS);
+    }
+    batchRange.batch->markDirty(batchRange);
+}
+
+void InputField::setDisplayedText(const std::string& str) {
+    text.setString(str);
+    textRun.update(text);
+}
+
+void InputField::drawOverlay(sf::RenderTarget& target) {
+    target.draw(text);
+}
+
+sf::FloatRect InputField::getBounds() const {
+    // Берем максимальную толщину рамки (у активного поля), чтобы границы не зависели от фокуса
+    const float outline = 2;
+    return sf::FloatRect(x - outline, y - outline,
+                         background.getSize().x + 2 * outline, background.getSize().y + 2 * outline);
 }
 
 void InputField::update() {
 
     // Обновляем текст из переменной только если поле не активно (пользователь не вводит)
-    if (!variableName.empty() && database && !isActive) {
-        double value = database->getVariable(variableName);
-        inputText = std::to_string(value);
-        text.setString(inputText);
+    if (tag != INVALID_TAG && !isActive) {
+        valueFormat.format(database->get(tag), formatted);
+
+        // В неактивном поле отображается inputText - перестраиваем текст только при изменении
+        if (formatted != inputText) {
+            inputText.assign(formatted);
+            setDisplayedText(inputText);
+        }
     }
 }
 
-void InputField::handleEvent(const sf::Event& event, sf::RenderWindow& window) {
-    if (event.type == sf::Event::MouseButtonPressed) {
-        if (event.mouseButton.button == sf::Mouse::Left) {
-            sf::Vector2i mousePos = sf::Mouse::getPosition(window);
-            // Активируем/деактивируем поле по клику
-            setActive(contains(static_cast<float>(mousePos.x), static_cast<float>(mousePos.y)));
-        }
+void InputField::setFocused(bool focused) {
+    // Клик по полю активирует его, клик в другом месте - деактивирует (см. EventRouter)
+    if (focused != isActive) {
+        setActive(focused);
     }
-    
+}
+
+void InputField::handleEvent(const sf::Event& event, sf::RenderWindow& window) {
     // Обработка ввода текста только для активного поля
     if (isActive && event.type == sf::Event::TextEntered) {
         if (event.text.unicode == '\b') { // backspace
@@ -61,10 +108,10 @@ void InputField::handleEvent(const sf::Event& event, sf::RenderWindow& window) {
             }
         } else if (event.text.unicode == '\r') {  // Enter - завершение ввода
             setActive(false);
-            if (!inputText.empty() && !variableName.empty() && database) {
+            if (!inputText.empty() && tag != INVALID_TAG) {
                 try {
                     double value = std::stod(inputText);
-                    database->setVariable(variableName, value);
+                    database->set(tag, value, WriteSource::Operator);
                     Logger::info("Input field set variable '" + variableName + "' to: " + inputText);
                 } catch (const std::exception& e) {
                     Logger::error("Invalid input: " + inputText);
@@ -75,7 +122,7 @@ void InputField::handleEvent(const sf::Event& event, sf::RenderWindow& window) {
         }
 
         // Показываем курсор (|) в активном поле
-        text.setString(inputText + (isActive ? "|" : ""));
+        setDisplayedText(inputText + (isActive ? "|" : ""));
     }
 }
 
@@ -86,19 +133,21 @@ void InputField::setActive(bool active) {
         // Подсвечиваем активное поле
         background.setOutlineColor(sf::Color::Blue);
         background.setOutlineThickness(2);
-        text.setString(inputText + "|");
+        writeBatchGeometry();
+        setDisplayedText(inputText + "|");
     } else {
 
         // Возвращаем обычный вид
         background.setOutlineColor(sf::Color::Black);
         background.setOutlineThickness(1);
-        text.setString(inputText);
+        writeBatchGeometry();
+        setDisplayedText(inputText);
         
         // Сохраняем значение при деактивации
-        if (!inputText.empty() && !variableName.empty() && database) {
+        if (!inputText.empty() && tag != INVALID_TAG) {
             try {
                 double value = std::stod(inputText);
-                database->setVariable(variableName, value);
+                database->set(tag, value, WriteSource::Operator);
             } catch (const std::exception& e) {
                 Logger::error("Invalid input in input field: " + inputText);
             }
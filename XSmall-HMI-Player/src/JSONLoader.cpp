@@ -1,16 +1,15 @@
 #include "JSONLoader.h"
-#include "Rectangle.h"
-#include "Text.h"
-#include "Line.h"
-#include "Polyline.h"
-#include "InputField.h"
-#include "Button.h"
-#include "HistoryGraph.h"
-#include "Image.h"
+#include "ResourceManager.h"
+#include "BinaryScene.h"
+#include "MappedFile.h"
+#include "JsonScanner.h"
+#include "ThreadPool.h"
 #include "logger.h"
 #include <fstream>
 #include <iostream>
 #include <filesystem>
+#include <algorithm>
+#include <cmath>
 
 using json = nlohmann::json;
 
@@ -34,24 +33,61 @@ std::vector<std::unique_ptr<VisualObject>> JSONLoader::loadFromFile(
     
     std::vector<std::unique_ptr<VisualObject>> objects;
     
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        Logger::error("Cannot open JSON file: " + filename);
-        return objects;
-    }
-    
     try {
         json j;
-        file >> j;
+        std::vector<ParsedObject> parsed;
+        if (!parseFile(filename, j, parsed)) {
+            return objects;
+        }
         
-        if (j.contains("objects") && j["objects"].is_array()) {
-            for (const auto& objJson : j["objects"]) {
-                auto obj = createObject(objJson, db, font);
-                if (obj) {
-                    objects.push_back(std::move(obj));
-                }
+        // Емкость истории по умолчанию (графики могут запросить больше через maxHistory)
+        if (j.contains("historyCapacity") && db) {
+            db->setDefaultHistoryCapacity(j["historyCapacity"].get<size_t>());
+        }
+
+        // История ведется только для переменных с политикой и с потребителями (графики)
+        if (db) {
+            for (const auto& entry : readHistoryPolicies(j)) {
+                db->setHistoryPolicy(db->resolveTag(entry.first), entry.second);
+            }
+            for (const auto& entry : readNotifyDeadbands(j)) {
+                db->setNotifyDeadband(db->resolveTag(entry.first), entry.second);
+            }
+        }
+        
+        const WidgetRegistry& registry = WidgetRegistry::instance();
+
+        // Все изображения сцены упаковываем в атлас до создания объектов:
+        // Image возьмет из него свой участок, и спрайты нарисуются одним пакетом
+        WidgetTypeId imageType = registry.find("Image");
+        std::vector<std::string> imagePaths;
+        for (const auto& object : parsed) {
+            if (object.type == imageType && !object.json.value("path", "").empty()) {
+                imagePaths.push_back(object.json.value("path", ""));
+            }
+        }
+        if (!imagePaths.empty()) {
+            ResourceManager::instance().buildAtlas(imagePaths);
+        }
+
+        // Объекты создаются в UI-потоке в порядке файла: конструкторы подписываются
+        // на переменные и раскладывают текст шрифтом
+        objects.reserve(parsed.size());
+        for (const auto& object : parsed) {
+            if (object.type == INVALID_WIDGET_TYPE) {
+                Logger::warning("Unknown object type: " + object.json.value("type", ""));
+                continue;
+            }
+            auto obj = registry.create(object.type, object.json, db, font);
+            if (obj) {
+                objects.push_back(std::move(obj));
             }
         }
+
+        // Сотня тысяч мелких деревьев освобождается заметное время - тоже в пуле
+        ThreadPool::instance().parallelFor(parsed.size(), [&parsed](std::size_t i) {
+            parsed[i].json = json();
+        });
         Logger::info("Loaded " + std::to_string(objects.size()) + " objects from " + filename);
     } catch (const std::exception& e) {
         Logger::error("Error parsing JSON file: " + std::string(e.what()));
@@ -60,125 +96,401 @@ std::vector<std::unique_ptr<VisualObject>> JSONLoader::loadFromFile(
     return objects;
 }
 
+bool JSONLoader::parseFile(const std::string& filename, json& root, std::vector<ParsedObject>& objects) {
+    MappedFile file;
+    if (!file.open(filename)) {
+        Logger::error("Cannot open JSON file: " + filename);
+        return false;
+    }
+
+    std::vector<JsonScanner::Member> members;
+    if (!JsonScanner::scanObject(JsonSlice{file.getData(), file.getSize()}, members)) {
+        Logger::error("Error parsing JSON file: malformed structure in " + filename);
+        return false;
+    }
+
+    root = json::object();
+    std::vector<JsonSlice> slices;
+    for (const auto& member : members) {
+        const JsonSlice& value = member.value;
+        if (member.key == "objects" && value.size > 0 && value.data[0] == '[') {
+            slices.clear();
+            if (!JsonScanner::scanArray(value, slices)) {
+                Logger::error("Error parsing JSON file: malformed objects array in " + filename);
+                return false;
+            }
+            root.erase("objects");
+        } else {
+            root[member.key] = json::parse(value.data, value.data + value.size);
+        }
+    }
+
+    // Объекты независимы: каждый участок разбирается в своем потоке пула
+    const WidgetRegistry& registry = WidgetRegistry::instance();
+    objects.assign(slices.size(), ParsedObject());
+    std::vector<std::string> errors(slices.size());
+    ThreadPool::instance().parallelFor(slices.size(), [&](std::size_t i) {
+        try {
+            ParsedObject& object = objects[i];
+            object.json = json::parse(slices[i].data, slices[i].data + slices[i].size);
+            object.type = registry.find(object.json.value("type", ""));
+        } catch (const std::exception& e) {
+            errors[i] = e.what();
+        }
+    });
+
+    for (std::size_t i = 0; i < errors.size(); ++i) {
+        if (!errors[i].empty()) {
+            Logger::error("Error parsing JSON file: object " + std::to_string(i) + ": " + errors[i]);
+            objects.clear();
+            return false;
+        }
+    }
+    return true;
+}
+
+bool JSONLoader::loadPlayerSettings(const std::string& filename, PlayerSettings& settings) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    try {
+        json j;
+        file >> j;
+        readPlayerSettings(j, settings);
+        return true;
+    } catch (const std::exception& e) {
+        Logger::error("Error reading player settings: " + std::string(e.what()));
+        return false;
+    }
+}
+
+void JSONLoader::readPlayerSettings(const json& j, PlayerSettings& settings) {
+    if (!j.contains("player") || !j["player"].is_object()) {
+        return;  // Секция необязательна - остаются значения по умолчанию
+    }
+
+    const json& player = j["player"];
+
+    // Частоты и периоды должны быть положительными, иначе оставляем значение по умолчанию
+    auto readPositive = [&player](const char* key, auto& value) {
+        if (player.contains(key)) {
+            auto configured = player[key].get<std::decay_t<decltype(value)>>();
+            if (configured > 0) {
+                value = configured;
+            } else {
+                Logger::warning(std::string("Ignoring non-positive player setting: ") + key);
+            }
+        }
+    };
+
+    readPositive("renderRate", settings.scheduler.renderRate);
+    readPositive("tickRate", settings.scheduler.tickRate);
+    readPositive("inputRate", settings.scheduler.inputRate);
+    readPositive("maxTicksPerFrame", settings.scheduler.maxTicksPerFrame);
+    readPositive("timerResolutionMs", settings.scheduler.timerResolutionMs);
+    readPositive("autosaveIntervalMs", settings.autosaveIntervalMs);
+    readPositive("demoIntervalMs", settings.demoIntervalMs);
+    readPositive("historianRetentionDays", settings.historianRetentionDays);
+    readPositive("historianChunkSeconds", settings.historianChunkSeconds);
+    settings.atlasCacheDir = player.value("atlasCache", settings.atlasCacheDir);
+    settings.historianDir = player.value("historian", settings.historianDir);
+    if (player.contains("stateTags") && player["stateTags"].is_array()) {
+        settings.stateTags = player["stateTags"].get<std::vector<std::string>>();
+    }
+}
+
+std::vector<std::pair<std::string, HistoryPolicy>> JSONLoader::readHistoryPolicies(const json& root) {
+    std::vector<std::pair<std::string, HistoryPolicy>> policies;
+    if (!root.contains("tags") || !root["tags"].is_object()) {
+        return policies;  // Секция необязательна
+    }
+    for (auto it = root["tags"].begin(); it != root["tags"].end(); ++it) {
+        HistoryPolicy policy;
+        if (readHistoryPolicy(it.value(), policy)) {
+            policies.emplace_back(it.key(), policy);
+        }
+    }
+    return policies;
+}
+
+bool JSONLoader::readHistoryPolicy(const json& tagJson, HistoryPolicy& policy) {
+    if (!tagJson.is_object() || !tagJson.contains("history")) {
+        return false;
+    }
+    const json& history = tagJson["history"];
+    if (history.is_boolean()) {
+        return history.get<bool>();
+    }
+    if (!history.is_object()) {
+        Logger::warning("Ignoring malformed history policy: " + history.dump());
+        return false;
+    }
+
+    std::int64_t capacity = history.value("capacity", std::int64_t(0));
+    policy.capacity = capacity > 0 ? static_cast<std::size_t>(capacity) : 0;
+    policy.deadband = std::max(history.value("deadband", 0.0), 0.0);
+    policy.swingingDoor = std::max(history.value("swingingDoor", 0.0), 0.0);
+    policy.compressed = history.value("compression", false);
+    policy.persistent = history.value("persist", false);
+    return true;
+}
+
+std::vector<std::pair<std::string, NotifyDeadband>> JSONLoader::readNotifyDeadbands(const json& root) {
+    std::vector<std::pair<std::string, NotifyDeadband>> deadbands;
+    if (!root.contains("tags") || !root["tags"].is_object()) {
+        return deadbands;
+    }
+    for (auto it = root["tags"].begin(); it != root["tags"].end(); ++it) {
+        NotifyDeadband deadband;
+        if (readNotifyDeadband(it.value(), deadband)) {
+            deadbands.emplace_back(it.key(), deadband);
+        }
+    }
+    return deadbands;
+}
+
+bool JSONLoader::readNotifyDeadband(const json& tagJson, NotifyDeadband& deadband) {
+    if (!tagJson.is_object() || !tagJson.contains("deadband")) {
+        return false;
+    }
+    const json& config = tagJson["deadband"];
+    if (config.is_number()) {
+        deadband.absolute = std::max(config.get<double>(), 0.0);
+    } else if (config.is_object()) {
+        deadband.absolute = std::max(config.value("absolute", 0.0), 0.0);
+        deadband.percent = std::max(config.value("percent", 0.0), 0.0);
+        const json& range = config.contains("range") ? config["range"] : json();
+        if (range.is_array() && range.size() == 2 && range[0].is_number() && range[1].is_number()) {
+            deadband.span = std::abs(range[1].get<double>() - range[0].get<double>());
+        }
+    } else {
+        Logger::warning("Ignoring malformed deadband: " + config.dump());
+        return false;
+    }
+    return deadband.absolute > 0.0 || deadband.percent > 0.0;
+}
+
+bool JSONLoader::compileScene(const std::string& jsonFile, const std::string& sceneFile) {
+    // Отметку исходника снимаем до чтения: если файл поменяют во время компиляции,
+    // сцена окажется устаревшей и при следующем запуске соберется заново
+    std::uint64_t sourceSize = 0;
+    std::int64_t sourceTime = 0;
+    if (!BinaryScene::getSourceStamp(jsonFile, sourceSize, sourceTime)) {
+        return false;
+    }
+
+    try {
+        json j;
+        std::vector<ParsedObject> parsed;
+        if (!parseFile(jsonFile, j, parsed)) {
+            return false;
+        }
+
+        SceneWriter writer;
+        writer.setSource(sourceSize, sourceTime);
+
+        PlayerSettings settings;
+        readPlayerSettings(j, settings);
+        writer.setSettings(settings);
+
+        if (j.contains("historyCapacity")) {
+            writer.setHistoryCapacity(j["historyCapacity"].get<size_t>());
+        }
+        for (const auto& entry : readHistoryPolicies(j)) {
+            writer.addHistoryPolicy(entry.first, entry.second);
+        }
+        for (const auto& entry : readNotifyDeadbands(j)) {
+            writer.addNotifyDeadband(entry.first, entry.second);
+        }
+
+        for (const auto& object : parsed) {
+            if (object.type == INVALID_WIDGET_TYPE) {
+                Logger::warning("Unknown object type: " + object.json.value("type", ""));
+                continue;
+            }
+            // Тип, добавленный через WidgetRegistry, в бинарную сцену не записать -
+            // такая сцена загружается из JSON
+            if (!compileObject(object.json, writer)) {
+                Logger::info("Scene " + jsonFile + " is not compiled: type " +
+                             object.json.value("type", "") + " has no binary record");
+                return false;
+            }
+        }
+
+        if (!writer.write(sceneFile)) {
+            return false;
+        }
+        Logger::info("Compiled " + std::to_string(writer.getObjectCount()) + " objects from " +
+                     jsonFile + " into " + sceneFile);
+        return true;
+    } catch (const std::exception& e) {
+        Logger::error("Error compiling JSON file: " + std::string(e.what()));
+        return false;
+    }
+}
+
 std::unique_ptr<VisualObject> JSONLoader::createObject(
     const nlohmann::json& objJson,
     VariableDatabase* db,
     sf::Font* font) {
     
     std::string type = objJson.value("type", "");
-    std::string name = objJson.value("name", "");
-    float x = objJson.value("x", 0.0f);
-    float y = objJson.value("y", 0.0f);
-    
+    const WidgetRegistry& registry = WidgetRegistry::instance();
+    WidgetTypeId id = registry.find(type);
+    if (id == INVALID_WIDGET_TYPE) {
+        Logger::warning("Unknown object type: " + type);
+        return nullptr;
+    }
+    return registry.create(id, objJson, db, font);
+}
+
+bool JSONLoader::compileObject(const json& objJson, SceneWriter& writer) {
+    std::string type = objJson.value("type", "");
+
+    SceneRecordHeader header = {};
+    header.x = objJson.value("x", 0.0f);
+    header.y = objJson.value("y", 0.0f);
+    header.name = writer.intern(objJson.value("name", ""));
+    header.tag = writer.tag(objJson.value("variable", ""));
+
+    auto color = [&objJson](const char* key, const json& fallback) {
+        return jsonToColor(objJson.value(key, fallback)).toInteger();
+    };
+
     if (type == "Rectangle") {
-        float width = objJson.value("width", 100.0f);
-        float height = objJson.value("height", 50.0f);
-        std::string variable = objJson.value("variable", "");
-        sf::Color color = jsonToColor(objJson.value("color", json::array({255, 255, 255})));
-        
-        auto rect = std::make_unique<Rectangle>(x, y, width, height, color, name, db, variable);
-        
-        // Добавляем условия, если есть
+        SceneRectangleRecord record = {};
+        record.header = header;
+        record.width = objJson.value("width", 100.0f);
+        record.height = objJson.value("height", 50.0f);
+        record.color = color("color", json::array({255, 255, 255}));
+
+        std::vector<SceneConditionRecord> conditions;
         if (objJson.contains("conditions") && objJson["conditions"].is_array()) {
             for (const auto& condJson : objJson["conditions"]) {
-                double value = condJson.value("value", 0.0);
-                sf::Color condColor = jsonToColor(condJson.value("color", json::array({255, 255, 255})));
-                rect->addCondition(value, condColor);
+                SceneConditionRecord condition = {};
+                condition.value = condJson.value("value", 0.0);
+                condition.color = jsonToColor(condJson.value("color", json::array({255, 255, 255}))).toInteger();
+                conditions.push_back(condition);
             }
         }
-        
-        return rect;
+        record.conditionCount = static_cast<std::uint32_t>(conditions.size());
+        writer.add(record, conditions.data(), conditions.size() * sizeof(SceneConditionRecord));
+        return true;
     }
     else if (type == "Text") {
-        std::string content = objJson.value("content", "");
-        unsigned int fontSize = objJson.value("fontSize", 20);
-        std::string variable = objJson.value("variable", "");
-        std::string format = objJson.value("format", "");
-        sf::Color color = jsonToColor(objJson.value("color", json::array({255, 255, 255})));
-        
-        return std::make_unique<Text>(x, y, content, font, fontSize, color, name, db, variable, format);
+        SceneTextRecord record = {};
+        record.header = header;
+        record.content = writer.intern(objJson.value("content", ""));
+        record.format = writer.intern(objJson.value("format", ""));
+        record.fontSize = objJson.value("fontSize", 20);
+        record.color = color("color", json::array({255, 255, 255}));
+        writer.add(record);
+        return true;
     }
     else if (type == "Line") {
-        float x2 = objJson.value("x2", 0.0f);
-        float y2 = objJson.value("y2", 0.0f);
-        sf::Color color = jsonToColor(objJson.value("color", json::array({255, 255, 255})));
-        
-        return std::make_unique<Line>(x, y, x2, y2, color, name, db);
+        // Line не привязывается к переменной
+        SceneLineRecord record = {};
+        record.header = header;
+        record.header.tag = SCENE_NO_INDEX;
+        record.x2 = objJson.value("x2", 0.0f);
+        record.y2 = objJson.value("y2", 0.0f);
+        record.color = color("color", json::array({255, 255, 255}));
+        writer.add(record);
+        return true;
     }
     else if (type == "Polyline") {
-        std::vector<sf::Vector2f> points;
+        std::vector<float> coords;
         if (objJson.contains("points") && objJson["points"].is_array()) {
             for (const auto& pointJson : objJson["points"]) {
                 if (pointJson.is_array() && pointJson.size() >= 2) {
-                    float px = pointJson[0].get<float>();
-                    float py = pointJson[1].get<float>();
-                    points.push_back(sf::Vector2f(px, py));
+                    coords.push_back(pointJson[0].get<float>());
+                    coords.push_back(pointJson[1].get<float>());
                 }
             }
         } else {
             // Если точек нет, используем текущую позицию
-            points.push_back(sf::Vector2f(x, y));
+            coords.push_back(header.x);
+            coords.push_back(header.y);
         }
-        
-        sf::Color color = jsonToColor(objJson.value("color", json::array({255, 255, 255})));
-        std::string variable = objJson.value("variable", "");
-        
-        return std::make_unique<Polyline>(points, color, name, db, variable);
+
+        ScenePolylineRecord record = {};
+        record.header = header;
+        record.color = color("color", json::array({255, 255, 255}));
+        record.pointCount = static_cast<std::uint32_t>(coords.size() / 2);
+        writer.add(record, coords.data(), coords.size() * sizeof(float));
+        return true;
     }
     else if (type == "InputField") {
-        float width = objJson.value("width", 200.0f);
-        float height = objJson.value("height", 30.0f);
-        unsigned int fontSize = objJson.value("fontSize", 16);
-        std::string variable = objJson.value("variable", "");
-        
-        return std::make_unique<InputField>(x, y, width, height, font, fontSize, name, db, variable);
+        SceneInputFieldRecord record = {};
+        record.header = header;
+        record.width = objJson.value("width", 200.0f);
+        record.height = objJson.value("height", 30.0f);
+        record.fontSize = objJson.value("fontSize", 16);
+        writer.add(record);
+        return true;
     }
     else if (type == "Button") {
-        float width = objJson.value("width", 100.0f);
-        float height = objJson.value("height", 40.0f);
-        std::string text = objJson.value("text", "");
-        unsigned int fontSize = objJson.value("fontSize", 16);
-        std::string variable = objJson.value("variable", "");
-        sf::Color color = jsonToColor(objJson.value("color", json::array({200, 200, 200})));
-        sf::Color textColor = jsonToColor(objJson.value("textColor", json::array({0, 0, 0})));
-        
-        // Создаем кнопку без обработчика
-        auto button = std::make_unique<Button>(x, y, width, height, text, font, fontSize, 
-                                               color, name, db, variable, nullptr, textColor);
-        
-        // Устанавливаем действие, если оно есть
-        if (objJson.contains("action")) {
-            std::string action = objJson["action"];
-            button->setAction(action, db);
-        }
-        
-        return button;
+        SceneButtonRecord record = {};
+        record.header = header;
+        record.width = objJson.value("width", 100.0f);
+        record.height = objJson.value("height", 40.0f);
+        record.text = writer.intern(objJson.value("text", ""));
+        record.fontSize = objJson.value("fontSize", 16);
+        record.color = color("color", json::array({200, 200, 200}));
+        record.textColor = color("textColor", json::array({0, 0, 0}));
+        record.action = objJson.contains("action") ? writer.intern(objJson["action"].get<std::string>())
+                                                   : SCENE_NO_INDEX;
+        writer.add(record);
+        return true;
     }
     else if (type == "HistoryGraph") {
-        float width = objJson.value("width", 400.0f);
-        float height = objJson.value("height", 200.0f);
-        std::string variable = objJson.value("variable", "");
-        size_t maxHistory = objJson.value("maxHistory", 50);
-        sf::Color lineColor = jsonToColor(objJson.value("lineColor", json::array({0, 0, 255})));
-        sf::Color gridColor = jsonToColor(objJson.value("gridColor", json::array({200, 200, 200, 100})));
-        
-        return std::make_unique<HistoryGraph>(x, y, width, height, name, db, variable, 
-                                             maxHistory, lineColor, gridColor);
+        SceneHistoryGraphRecord record = {};
+        record.header = header;
+        record.width = objJson.value("width", 400.0f);
+        record.height = objJson.value("height", 200.0f);
+        record.maxHistory = objJson.value("maxHistory", 50);
+        record.lineColor = color("lineColor", json::array({0, 0, 255}));
+        record.gridColor = color("gridColor", json::array({200, 200, 200, 100}));
+        record.timeWindow = objJson.value("timeWindow", 0.0);
+        record.sampleRate = objJson.value("sampleRate", 0.0);
+        writer.add(record);
+        return true;
     }
     else if (type == "Image") {
-        float width = objJson.value("width", 100.0f);
-        float height = objJson.value("height", 100.0f);
-        std::string path = objJson.value("path", "");
-        
-        return std::make_unique<Image>(x, y, width, height, path, name, db);
+        SceneImageRecord record = {};
+        record.header = header;
+        record.header.tag = SCENE_NO_INDEX;
+        record.width = objJson.value("width", 100.0f);
+        record.height = objJson.value("height", 100.0f);
+        record.path = writer.intern(objJson.value("path", ""));
+        writer.add(record);
+        return true;
     }
-    
-    Logger::warning("Unknown object type: " + type);
-    return nullptr;
+
+    return false;
 }
 
 bool JSONLoader::createDemoConfig(const std::string& filename) {
     json j;
+
+    // Частоты главного цикла и периоды фоновых задач
+    PlayerSettings defaults;
+    j["player"] = {
+        {"renderRate", defaults.scheduler.renderRate},
+        {"tickRate", defaults.scheduler.tickRate},
+        {"inputRate", defaults.scheduler.inputRate},
+        {"maxTicksPerFrame", defaults.scheduler.maxTicksPerFrame},
+        {"timerResolutionMs", defaults.scheduler.timerResolutionMs},
+        {"autosaveIntervalMs", defaults.autosaveIntervalMs},
+        {"demoIntervalMs", defaults.demoIntervalMs},
+        {"atlasCache", "cache"}
+    };
+
+    // История температуры переживает перезапуск плеера; колебания у уставки меньше 0.05
+    // не перерисовывают экран
+    j["tags"] = {{"temperature_value", {{"deadband", 0.05}, {"history", {{"persist", true}}}}}};
     
     // Создаем полную демо-конфигурацию на основе вашей демо-сцены
     j["objects"] = json::array();
@@ -323,8 +635,10 @@ bool JSONLoader::createDemoConfig(const std::string& filename) {
     graph["y"] = 350;
     graph["width"] = 400;
     graph["height"] = 200;
-    graph["variable"] = "temperature_history";
+    graph["variable"] = "temperature_value";
     graph["maxHistory"] = 50;
+    graph["timeWindow"] = 120;  // Последние 2 минуты, отсчет температуры дважды в секунду
+    graph["sampleRate"] = 2;
     graph["lineColor"] = {0, 255, 26};
     graph["gridColor"] = {200, 200, 200, 100};
     j["objects"].push_back(graph);
@@ -0,0 +1,162 @@
+#include "JsonScanner.h"
+#include <nlohmann/json.hpp>
+#include <cstring>
+
+namespace {
+    bool isSpace(char c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    }
+
+    bool isDelimiter(char c) {
+        return isSpace(c) || c == ',' || c == ']' || c == '}' || c == ':';
+    }
+
+    // Начало текста без метки порядка байт UTF-8
+    const char* skipBom(const char* p, const char* end) {
+        if (end - p >= 3 && std::memcmp(p, "\xEF\xBB\xBF", 3) == 0) {
+            return p + 3;
+        }
+        return p;
+    }
+}
+
+const char* JsonScanner::skipSpace(const char* p, const char* end) {
+    while (p < end && isSpace(*p)) {
+        ++p;
+    }
+    return p;
+}
+
+const char* JsonScanner::skipString(const char* p, const char* end) {
+    // p указывает на открывающую кавычку
+    for (++p; p < end; ++p) {
+        if (*p == '\\') {
+            ++p;  // Экранированный символ (в том числе кавычка) строку не завершает
+        } else if (*p == '"') {
+            return p + 1;
+        }
+    }
+    return nullptr;
+}
+
+const char* JsonScanner::skipValue(const char* p, const char* end) {
+    if (p >= end) {
+        return nullptr;
+    }
+
+    if (*p == '"') {
+        return skipString(p, end);
+    }
+
+    if (*p == '{' || *p == '[') {
+        // Ожидаемые закрывающие скобки вложенных уровней
+        std::string closers(1, *p == '{' ? '}' : ']');
+        for (++p; p < end; ++p) {
+            char c = *p;
+            if (c == '"') {
+                p = skipString(p, end);
+                if (!p) {
+                    return nullptr;
+                }
+                --p;
+            } else if (c == '{' || c == '[') {
+                closers.push_back(c == '{' ? '}' : ']');
+            } else if (c == '}' || c == ']') {
+                if (c != closers.back()) {
+                    return nullptr;
+                }
+                closers.pop_back();
+                if (closers.empty()) {
+                    return p + 1;
+                }
+            }
+        }
+        return nullptr;
+    }
+
+    // Число или литерал - до ближайшего разделителя
+    const char* start = p;
+    while (p < end && !isDelimiter(*p)) {
+        ++p;
+    }
+    return p > start ? p : nullptr;
+}
+
+bool JsonScanner::scanObject(JsonSlice text, std::vector<Member>& members) {
+    const char* end = text.data + text.size;
+    const char* p = skipSpace(skipBom(text.data, end), end);
+    if (p >= end || *p != '{') {
+        return false;
+    }
+    p = skipSpace(p + 1, end);
+
+    if (p < end && *p == '}') {
+        return skipSpace(p + 1, end) == end;
+    }
+
+    while (p < end && *p == '"') {
+        const char* keyEnd = skipString(p, end);
+        if (!keyEnd) {
+            return false;
+        }
+        Member member;
+        if (std::memchr(p, '\\', keyEnd - p)) {
+            member.key = nlohmann::json::parse(p, keyEnd).get<std::string>();
+        } else {
+            member.key.assign(p + 1, keyEnd - 1);
+        }
+
+        p = skipSpace(keyEnd, end);
+        if (p >= end || *p != ':') {
+            return false;
+        }
+        p = skipSpace(p + 1, end);
+        const char* valueEnd = skipValue(p, end);
+        if (!valueEnd) {
+            return false;
+        }
+        member.value = JsonSlice{p, static_cast<std::size_t>(valueEnd - p)};
+        members.push_back(std::move(member));
+
+        p = skipSpace(valueEnd, end);
+        if (p < end && *p == ',') {
+            p = skipSpace(p + 1, end);
+        } else if (p < end && *p == '}') {
+            return skipSpace(p + 1, end) == end;
+        } else {
+            return false;
+        }
+    }
+    return false;
+}
+
+bool JsonScanner::scanArray(JsonSlice text, std::vector<JsonSlice>& elements) {
+    const char* end = text.data + text.size;
+    const char* p = skipSpace(skipBom(text.data, end), end);
+    if (p >= end || *p != '[') {
+        return false;
+    }
+    p = skipSpace(p + 1, end);
+
+    if (p < end && *p == ']') {
+        return skipSpace(p + 1, end) == end;
+    }
+
+    while (p < end) {
+        const char* valueEnd = skipValue(p, end);
+        if (!valueEnd) {
+            return false;
+        }
+        elements.push_back(JsonSlice{p, static_cast<std::size_t>(valueEnd - p)});
+
+        p = skipSpace(valueEnd, end);
+        if (p < end && *p == ',') {
+            p = skipSpace(p + 1, end);
+        } else if (p < end && *p == ']') {
+            return skipSpace(p + 1, end) == end;
+        } else {
+            return false;
+        }
+    }
+    return false;
+}
@@ -1,4 +1,5 @@
 #include "Line.h"
+#include <algorithm>
 
 Line::Line(float x1, float y1, float x2, float y2, 
            const sf::Color& color, const std::string& name,
@@ -9,6 +10,21 @@ Line::Line(float x1, float y1, float x2, float y2,
     line[1] = sf::Vertex(sf::Vector2f(x2, y2), color);
 }
 
-void Line::draw(sf::RenderWindow& window) {
-    window.draw(line, 2, sf::Lines);
+void Line::draw(sf::RenderTarget& target) {
+    target.draw(line, 2, sf::Lines);
+}
+
+void Line::attachToBatch(RenderBatch& batch) {
+    // Линия статична: записываем один раз
+    BatchRange range = batch.allocate(RenderBatch::QUAD_VERTICES);
+    RenderBatch::writeLine(batch.data(range), line[0].position, line[1].position, color);
+}
+
+sf::FloatRect Line::getBounds() const {
+    // Полпикселя толщины с каждой стороны
+    float left = std::min(line[0].position.x, line[1].position.x) - 0.5f;
+    float top = std::min(line[0].position.y, line[1].position.y) - 0.5f;
+    float right = std::max(line[0].position.x, line[1].position.x) + 0.5f;
+    float bottom = std::max(line[0].position.y, line[1].position.y) + 0.5f;
+    return sf::FloatRect(left, top, right - left, bottom - top);
 }
\ No newline at end of file
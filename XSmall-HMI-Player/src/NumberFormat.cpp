@@ -0,0 +1,108 @@
+#include "NumberFormat.h"
+#include <charconv>
+#include <cctype>
+#include <cmath>
+#include <algorithm>
+
+namespace {
+
+// Вывод printf для значений по умолчанию (std::to_string)
+const int DEFAULT_PRECISION = 6;
+// %f без точности в шаблонах плеера всегда означал один знак после запятой
+const int SHORT_PRECISION = 1;
+// Ширина и точность ограничены размером буфера форматирования
+const int MAX_WIDTH = 64;
+const int MAX_PRECISION = 17;
+
+} // namespace
+
+NumberFormat::NumberFormat()
+    : precision(DEFAULT_PRECISION), width(0), leftAlign(false), zeroPad(false) {}
+
+NumberFormat::NumberFormat(const std::string& pattern) : NumberFormat() {
+    std::string* text = &prefix;
+    bool found = false;
+
+    for (std::size_t i = 0; i < pattern.size(); ++i) {
+        if (pattern[i] != '%' || found) {
+            if (pattern[i] == '%' && i + 1 < pattern.size() && pattern[i + 1] == '%') {
+                ++i;  // %% после спецификатора - тоже знак процента
+            }
+            text->push_back(pattern[i]);
+            continue;
+        }
+        if (i + 1 < pattern.size() && pattern[i + 1] == '%') {
+            text->push_back('%');
+            ++i;
+            continue;
+        }
+
+        // Разбираем %[-][0][ширина][.точность](f|d)
+        std::size_t j = i + 1;
+        bool left = false, zero = false;
+        for (; j < pattern.size() && (pattern[j] == '-' || pattern[j] == '0'); ++j) {
+            (pattern[j] == '-' ? left : zero) = true;
+        }
+        int fieldWidth = 0;
+        for (; j < pattern.size() && std::isdigit(static_cast<unsigned char>(pattern[j])); ++j) {
+            fieldWidth = fieldWidth * 10 + (pattern[j] - '0');
+        }
+        int fieldPrecision = -1;
+        if (j < pattern.size() && pattern[j] == '.') {
+            fieldPrecision = 0;
+            for (++j; j < pattern.size() && std::isdigit(static_cast<unsigned char>(pattern[j])); ++j) {
+                fieldPrecision = fieldPrecision * 10 + (pattern[j] - '0');
+            }
+        }
+        if (j >= pattern.size() || (pattern[j] != 'f' && pattern[j] != 'd')) {
+            text->push_back(pattern[i]);  // Не спецификатор - оставляем как текст
+            continue;
+        }
+
+        if (pattern[j] == 'd') {
+            fieldPrecision = 0;
+        } else if (fieldPrecision < 0) {
+            fieldPrecision = SHORT_PRECISION;
+        }
+        precision = std::min(fieldPrecision, MAX_PRECISION);
+        width = std::min(fieldWidth, MAX_WIDTH);
+        leftAlign = left;
+        zeroPad = zero && !left;
+        found = true;
+        text = &suffix;
+        i = j;
+    }
+}
+
+void NumberFormat::format(double value, std::string& out) const {
+    // Хватает на 309 цифр целой части double, точность и знак
+    char digits[400];
+    char* end = digits + sizeof(digits);
+    std::to_chars_result result = std::to_chars(digits, end, value, std::chars_format::fixed, precision);
+    std::size_t length = result.ec == std::errc() ? static_cast<std::size_t>(result.ptr - digits) : 0;
+
+    std::size_t padding = static_cast<std::size_t>(width) > length ? width - length : 0;
+    out.assign(prefix);
+    if (padding > 0 && !leftAlign) {
+        if (zeroPad && std::isfinite(value)) {
+            // Нули идут после знака: -0012.5
+            std::size_t sign = digits[0] == '-' ? 1 : 0;
+            out.append(digits, sign);
+            out.append(padding, '0');
+            out.append(digits + sign, length - sign);
+        } else {
+            out.append(padding, ' ');
+            out.append(digits, length);
+        }
+    } else {
+        out.append(digits, length);
+        out.append(padding, ' ');
+    }
+    out.append(suffix);
+}
+
+std::string NumberFormat::format(double value) const {
+    std::string out;
+    format(value, out);
+    return out;
+}
@@ -1,12 +1,14 @@
 #include "Polyline.h"
 #include "logger.h"
+#include <algorithm>
 
 Polyline::Polyline(const std::vector<sf::Vector2f>& points, 
                    const sf::Color& color, const std::string& name,
                    VariableDatabase* db, const std::string& varName)
     : VisualObject(points.empty() ? 0 : points[0].x, 
                    points.empty() ? 0 : points[0].y, name, db), 
-      color(color), variableName(varName) {
+      color(color), variableName(varName),
+      tag(!varName.empty() && db ? db->resolveTag(varName) : INVALID_TAG) {
     
     // Инициализируем массив вершин
     for (const auto& point : points) {
@@ -14,42 +16,57 @@ Polyline::Polyline(const std::vector<sf::Vector2f>& points,
     }
     
     // Подписываемся на изменения переменной для динамического обновления
-    if (!variableName.empty() && database) {
-        database->subscribe(variableName, [this](double value) {
+    if (tag != INVALID_TAG) {
+        // Ломаная рисует историю переменной - история должна вестись
+        db->enableHistory(tag);
+        trend.setColor(color);
+        subscribe(tag, [this](double value) {
             this->update();
         });
     }
 }
 
-void Polyline::draw(sf::RenderWindow& window) {
-    if (points.size() > 1) {
+void Polyline::draw(sf::RenderTarget& target) {
+    if (trend.getSampleCount() > 1) {
+        trend.draw(target, trendArea());
+    } else if (points.size() > 1) {
         // Рисуем ломаную линию через все точки
-        window.draw(&points[0], points.size(), sf::LineStrip);
+        target.draw(&points[0], points.size(), sf::LineStrip);
     }
 }
 
+sf::FloatRect Polyline::getBounds() const {
+    if (points.empty()) {
+        return sf::FloatRect(x, y, 0, 0);
+    }
+
+    float left = points[0].position.x, right = left;
+    float top = points[0].position.y, bottom = top;
+    for (const auto& point : points) {
+        left = std::min(left, point.position.x);
+        right = std::max(right, point.position.x);
+        top = std::min(top, point.position.y);
+        bottom = std::max(bottom, point.position.y);
+    }
+    // Ломаная, привязанная к истории, рисуется трендом в trendArea()
+    if (tag != INVALID_TAG) {
+        sf::FloatRect area = trendArea();
+        left = std::min(left, area.left);
+        right = std::max(right, area.left + area.width);
+        top = std::min(top, area.top);
+        bottom = std::max(bottom, area.top + area.height);
+    }
+    return sf::FloatRect(left - 0.5f, top - 0.5f, right - left + 1, bottom - top + 1);
+}
+
 void Polyline::update() {
-    if (!variableName.empty() && database) {
-        const auto& history = database->getHistory(variableName);
-        if (history.size() > 1) {
-            points.clear();
-            
-            // Масштабируем исторические данные для отображения
-            float maxVal = *std::max_element(history.begin(), history.end());
-            float minVal = *std::min_element(history.begin(), history.end());
-            float range = maxVal - minVal;
-            if (range == 0) range = 1; // Избегаем деления на ноль
-            
-            // Фиксированные размеры для графика (можно сделать параметрами)
-            float xStep = 400.0f / (history.size() - 1);
-            float yScale = 200.0f / range;
-            
-            // Преобразуем значения истории в координаты точек
-            for (size_t i = 0; i < history.size(); ++i) {
-                float x = 20 + i * xStep;
-                float y = 420 - (history[i] - minVal) * yScale;  // Инвертируем ось Y
-                points.push_back(sf::Vertex(sf::Vector2f(x, y), color));
-            }
+    if (tag != INVALID_TAG) {
+        // Показываем всю историю; при длинной истории кривая прореживается по ширине области
+        trend.configure(database->getHistoryCapacity(tag), static_cast<std::size_t>(trendArea().width));
+        if (const CompressedHistory* compressed = database->getCompressedHistory(tag)) {
+            trend.sync(*compressed);
+        } else {
+            trend.sync(database->getHistory(tag), database->getHistoryTotal(tag));
         }
     }
 }
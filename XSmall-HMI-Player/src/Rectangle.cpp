@@ -5,27 +5,37 @@ Rectangle::Rectangle(float x, float y, float width, float height,
                      const sf::Color& color, const std::string& name,
                      VariableDatabase* db, const std::string& varName)
     : VisualObject(x, y, name, db), width(width), height(height), 
-      defaultColor(color), variableName(varName) {
+      defaultColor(color), variableName(varName),
+      tag(!varName.empty() && db ? db->resolveTag(varName) : INVALID_TAG) {
     
     shape.setPosition(x, y);
     shape.setSize(sf::Vector2f(width, height));
     shape.setFillColor(color);
     
     // Подписываемся на изменения переменной для автоматического обновления цвета
-    if (!variableName.empty() && database) {
-        database->subscribe(variableName, [this](double value) {
+    if (tag != INVALID_TAG) {
+        subscribe(tag, [this](double value) {
             this->update();
         });
     }
 }
 
-void Rectangle::draw(sf::RenderWindow& window) {
-    window.draw(shape);
+void Rectangle::draw(sf::RenderTarget& target) {
+    target.draw(shape);
+}
+
+void Rectangle::attachToBatch(RenderBatch& batch) {
+    batchRange = batch.allocate(RenderBatch::QUAD_VERTICES);
+    RenderBatch::writeQuad(batch.data(batchRange), getBounds(), shape.getFillColor());
+}
+
+sf::FloatRect Rectangle::getBounds() const {
+    return sf::FloatRect(x, y, width, height);
 }
 
 void Rectangle::update() {
-    if (!variableName.empty() && database) {
-        double value = database->getVariable(variableName);
+    if (tag != INVALID_TAG) {
+        double value = database->get(tag);
         sf::Color newColor = defaultColor;
         
         // Проверяем все условия для изменения цвета
@@ -37,6 +47,12 @@ void Rectangle::update() {
         }
         
         shape.setFillColor(newColor);
+
+        // В пакете перекрашиваем только свои вершины
+        if (batchRange.attached()) {
+            RenderBatch::setColor(batchRange.batch->data(batchRange), batchRange.count, newColor);
+            batchRange.batch->markDirty(batchRange);
+        }
     }
 }
 
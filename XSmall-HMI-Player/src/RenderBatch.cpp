@@ -0,0 +1,136 @@
+#include "RenderBatch.h"
+#include <algorithm>
+#include <cmath>
+
+RenderBatch::RenderBatch(const sf::Texture* texture)
+    : texture(texture),
+      buffer(sf::Triangles, sf::VertexBuffer::Dynamic),
+      useBuffer(sf::VertexBuffer::isAvailable()),
+      dirtyBegin(0), dirtyEnd(0) {}
+
+BatchRange RenderBatch::allocate(std::size_t count) {
+    BatchRange range;
+    range.batch = this;
+    range.offset = vertices.size();
+    range.count = count;
+    vertices.resize(vertices.size() + count);
+    return range;
+}
+
+void RenderBatch::markDirty(const BatchRange& range) {
+    if (dirtyBegin == dirtyEnd) {
+        dirtyBegin = range.offset;
+        dirtyEnd = range.offset + range.count;
+    } else {
+        dirtyBegin = std::min(dirtyBegin, range.offset);
+        dirtyEnd = std::max(dirtyEnd, range.offset + range.count);
+    }
+}
+
+void RenderBatch::draw(sf::RenderTarget& target) {
+    if (vertices.empty()) {
+        return;
+    }
+
+    if (!useBuffer) {
+        target.draw(vertices.data(), vertices.size(), sf::Triangles, sf::RenderStates(texture));
+        return;
+    }
+
+    if (buffer.getVertexCount() != vertices.size()) {
+        // Пакет изменил размер (или рисуется впервые) - загружаем целиком
+        buffer.create(vertices.size());
+        buffer.update(vertices.data());
+    } else if (dirtyBegin != dirtyEnd) {
+        // Догружаем только вершины изменившихся объектов
+        buffer.update(vertices.data() + dirtyBegin, dirtyEnd - dirtyBegin,
+                      static_cast<unsigned int>(dirtyBegin));
+    }
+    dirtyBegin = dirtyEnd = 0;
+
+    target.draw(buffer, sf::RenderStates(texture));
+}
+
+sf::Vertex* RenderBatch::writeQuad(sf::Vertex* out, const sf::FloatRect& rect, const sf::Color& color) {
+    sf::Vector2f topLeft(rect.left, rect.top);
+    sf::Vector2f topRight(rect.left + rect.width, rect.top);
+    sf::Vector2f bottomRight(rect.left + rect.width, rect.top + rect.height);
+    sf::Vector2f bottomLeft(rect.left, rect.top + rect.height);
+
+    *out++ = sf::Vertex(topLeft, color);
+    *out++ = sf::Vertex(topRight, color);
+    *out++ = sf::Vertex(bottomRight, color);
+    *out++ = sf::Vertex(topLeft, color);
+    *out++ = sf::Vertex(bottomRight, color);
+    *out++ = sf::Vertex(bottomLeft, color);
+    return out;
+}
+
+sf::Vertex* RenderBatch::writeTexturedQuad(sf::Vertex* out, const sf::FloatRect& rect,
+                                           const sf::IntRect& textureRect, const sf::Color& color) {
+    sf::Vertex* first = out;
+    out = writeQuad(out, rect, color);
+
+    // Те же шесть вершин в том же порядке: углы прямоугольника -> углы участка текстуры
+    float left = static_cast<float>(textureRect.left);
+    float top = static_cast<float>(textureRect.top);
+    float right = left + textureRect.width;
+    float bottom = top + textureRect.height;
+    sf::Vector2f corners[] = {{left, top}, {right, top}, {right, bottom},
+                              {left, top}, {right, bottom}, {left, bottom}};
+    for (int i = 0; i < 6; ++i) {
+        first[i].texCoords = corners[i];
+    }
+    return out;
+}
+
+sf::Vertex* RenderBatch::writeOutline(sf::Vertex* out, const sf::FloatRect& rect,
+                                      float thickness, const sf::Color& color) {
+    float t = thickness;
+    float right = rect.left + rect.width;
+    float bottom = rect.top + rect.height;
+
+    // Верхняя и нижняя полосы захватывают углы, боковые - только высоту прямоугольника
+    out = writeQuad(out, sf::FloatRect(rect.left - t, rect.top - t, rect.width + 2 * t, t), color);
+    out = writeQuad(out, sf::FloatRect(rect.left - t, bottom, rect.width + 2 * t, t), color);
+    out = writeQuad(out, sf::FloatRect(rect.left - t, rect.top, t, rect.height), color);
+    out = writeQuad(out, sf::FloatRect(right, rect.top, t, rect.height), color);
+    return out;
+}
+
+sf::Vertex* RenderBatch::writeLine(sf::Vertex* out, const sf::Vector2f& from, const sf::Vector2f& to,
+                                   const sf::Color& color) {
+    sf::Vector2f direction = to - from;
+    float length = std::sqrt(direction.x * direction.x + direction.y * direction.y);
+
+    // Смещение на полпикселя по нормали в обе стороны от линии
+    sf::Vector2f normal(0.f, 0.f);
+    if (length > 0) {
+        normal = sf::Vector2f(-direction.y / length * 0.5f, direction.x / length * 0.5f);
+    }
+
+    sf::Vector2f a(from.x + normal.x, from.y + normal.y);
+    sf::Vector2f b(to.x + normal.x, to.y + normal.y);
+    sf::Vector2f c(to.x - normal.x, to.y - normal.y);
+    sf::Vector2f d(from.x - normal.x, from.y - normal.y);
+
+    *out++ = sf::Vertex(a, color);
+    *out++ = sf::Vertex(b, color);
+    *out++ = sf::Vertex(c, color);
+    *out++ = sf::Vertex(a, color);
+    *out++ = sf::Vertex(c, color);
+    *out++ = sf::Vertex(d, color);
+    return out;
+}
+
+void RenderBatch::setColor(sf::Vertex* out, std::size_t count, const sf::Color& color) {
+    for (std::size_t i = 0; i < count; ++i) {
+        out[i].color = color;
+    }
+}
+
+void RenderBatch::setTexCoords(sf::Vertex* out, std::size_t count, const sf::Vector2f& texCoords) {
+    for (std::size_t i = 0; i < count; ++i) {
+        out[i].texCoords = texCoords;
+    }
+}
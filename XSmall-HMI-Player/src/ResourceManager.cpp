@@ -0,0 +1,197 @@
+#include "ResourceManager.h"
+#include "logger.h"
+#include <filesystem>
+#include <algorithm>
+
+namespace {
+
+// Ищет живой ресурс в кэше или загружает его. Вызывается под мьютексом менеджера
+template <typename Resource, typename Stored>
+std::shared_ptr<Stored> acquire(std::unordered_map<std::string, std::weak_ptr<Stored>>& cache,
+                                const std::string& file, std::size_t& loadCount) {
+    auto it = cache.find(file);
+    if (it != cache.end()) {
+        if (auto existing = it->second.lock()) {
+            return existing;
+        }
+    }
+
+    auto resource = std::make_shared<Resource>();
+    ++loadCount;
+    if (!resource->loadFromFile(file)) {
+        return nullptr;
+    }
+    cache[file] = resource;
+    LOG_DEBUG("Resource loaded: " + file);
+    return resource;
+}
+
+// Сколько ресурсов из кэша еще используется
+template <typename Stored>
+std::size_t countAlive(const std::unordered_map<std::string, std::weak_ptr<Stored>>& cache) {
+    std::size_t alive = 0;
+    for (const auto& entry : cache) {
+        if (!entry.second.expired()) {
+            ++alive;
+        }
+    }
+    return alive;
+}
+
+} // namespace
+
+ResourceManager::ResourceManager()
+    : searchPaths{"", "../", "../../"}, loadCount(0) {}
+
+ResourceManager& ResourceManager::instance() {
+    static ResourceManager manager;
+    return manager;
+}
+
+void ResourceManager::addSearchPath(const std::string& root) {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::string normalized = root;
+    if (!normalized.empty() && normalized.back() != '/' && normalized.back() != '\\') {
+        normalized += '/';
+    }
+    searchPaths.push_back(normalized);
+    resolved.clear();  // Ненайденные раньше файлы могут найтись в новом корне
+}
+
+std::string ResourceManager::resolvePath(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return resolveLocked(path);
+}
+
+std::string ResourceManager::resolveLocked(const std::string& path) {
+    auto it = resolved.find(path);
+    if (it != resolved.end()) {
+        return it->second;
+    }
+
+    std::string result;
+    std::filesystem::path requested(path);
+    std::error_code error;
+    if (requested.is_absolute()) {
+        if (std::filesystem::is_regular_file(requested, error)) {
+            result = requested.lexically_normal().string();
+        }
+    } else {
+        for (const auto& root : searchPaths) {
+            std::filesystem::path candidate(root + path);
+            if (std::filesystem::is_regular_file(candidate, error)) {
+                // Ключ кэша - абсолютный путь: один файл под разными относительными путями загружается один раз
+                result = std::filesystem::absolute(candidate, error).lexically_normal().string();
+                break;
+            }
+        }
+    }
+
+    // Промах тоже запоминаем: повторные запросы не ходят в файловую систему
+    resolved.emplace(path, result);
+    return result;
+}
+
+std::shared_ptr<const sf::Texture> ResourceManager::getTexture(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return getTextureLocked(resolveLocked(path));
+}
+
+std::shared_ptr<const sf::Texture> ResourceManager::getTextureLocked(const std::string& file) {
+    if (file.empty()) {
+        return nullptr;
+    }
+    return acquire<sf::Texture>(textures, file, loadCount);
+}
+
+TextureRegion ResourceManager::getTextureRegion(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::string file = resolveLocked(path);
+    TextureRegion region;
+
+    const TextureAtlas::Entry* entry = atlas && !file.empty() ? atlas->find(file) : nullptr;
+    if (entry) {
+        // Участок держит весь атлас: страница живет, пока её кто-то рисует
+        region.texture = std::shared_ptr<const sf::Texture>(atlas, &atlas->getPage(entry->page));
+        region.rect = entry->rect;
+        return region;
+    }
+
+    region.texture = getTextureLocked(file);
+    if (region.texture) {
+        sf::Vector2u size = region.texture->getSize();
+        region.rect = sf::IntRect(0, 0, static_cast<int>(size.x), static_cast<int>(size.y));
+    }
+    return region;
+}
+
+std::size_t ResourceManager::buildAtlas(const std::vector<std::string>& paths) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    // Каждый файл - один раз, в постоянном порядке (от порядка зависит ключ кэша)
+    std::vector<std::string> files;
+    for (const auto& path : paths) {
+        std::string file = resolveLocked(path);
+        if (!file.empty()) {
+            files.push_back(file);
+        }
+    }
+    std::sort(files.begin(), files.end());
+    files.erase(std::unique(files.begin(), files.end()), files.end());
+    if (files.empty()) {
+        atlas.reset();
+        return 0;
+    }
+
+    auto built = std::make_shared<TextureAtlas>(std::min(2048u, sf::Texture::getMaximumSize()));
+    built->loadFiles(files, atlasCacheDir);
+    if (!built->isLoadedFromCache()) {
+        loadCount += files.size();
+    }
+    atlas = built;
+    return atlas->getEntryCount();
+}
+
+void ResourceManager::setAtlasCacheDir(const std::string& dir) {
+    std::lock_guard<std::mutex> lock(mutex);
+    atlasCacheDir = dir;
+}
+
+std::shared_ptr<sf::Font> ResourceManager::getFont(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::string file = resolveLocked(path);
+    if (file.empty()) {
+        return nullptr;
+    }
+    return acquire<sf::Font>(fonts, file, loadCount);
+}
+
+void ResourceManager::setDefaultFont(std::shared_ptr<sf::Font> font) {
+    std::lock_guard<std::mutex> lock(mutex);
+    defaultFont = std::move(font);
+}
+
+std::shared_ptr<sf::Font> ResourceManager::getDefaultFont() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return defaultFont;
+}
+
+std::size_t ResourceManager::getLoadCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return loadCount;
+}
+
+std::size_t ResourceManager::getTextureCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return countAlive(textures);
+}
+
+std::size_t ResourceManager::getFontCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return countAlive(fonts);
+}
+
+std::size_t ResourceManager::getAtlasPageCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return atlas ? atlas->getPageCount() : 0;
+}
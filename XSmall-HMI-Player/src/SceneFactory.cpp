@@ -21,6 +21,11 @@ std::vector<std::unique_ptr<VisualObject>> SceneFactory::createDemoScene(
     std::vector<std::unique_ptr<VisualObject>> objects;
     
     Logger::info("Creating demo SCADA scene");
+
+    // Дескрипторы переменных, которыми управляют кнопки демо-сцены
+    TagId panelTag = db->resolveTag("panel_status");
+    TagId temperatureTag = db->resolveTag("temperature_value");
+    TagId pressureTag = db->resolveTag("pressure_value");
     
     // 1. Панель статуса (прямоугольник) с условным форматированием по значению panel_status
     auto panel = std::make_unique<Rectangle>(20, 50, 500, 200, 
@@ -88,7 +93,8 @@ std::vector<std::unique_ptr<VisualObject>> SceneFactory::createDemoScene(
     
     // 8. График истории температуры
     auto graph = std::make_unique<HistoryGraph>(20, 250+100, 400, 200,
-        "Temperature Graph", db, "temperature_history", 50, sf::Color{0, 255, 26});
+        "Temperature Graph", db, "temperature_value", 50, sf::Color{0, 255, 26});
+    graph->setTimeWindow(120, 2);
     objects.push_back(std::move(graph));
     // 9. Изображение
     auto image = std::make_unique<Image>(720, 330, 350*0.5, 437*0.5,
@@ -98,10 +104,10 @@ std::vector<std::unique_ptr<VisualObject>> SceneFactory::createDemoScene(
     // 10. Кнопка изменения статуса панели
     auto statusButton = std::make_unique<Button>(450, 340+20, 180, 50,
         "Change Color", font, 28, sf::Color(231, 214, 191), "Change Color", db,
-        "", [db]() {
+        "", [db, panelTag]() {
             static int status = 0;
             status = (status + 1) % 10;  // Циклическое переключение 0-9
-            db->setVariable("panel_status", static_cast<double>(status));
+            db->set(panelTag, static_cast<double>(status), WriteSource::Operator);
             Logger::info("Panel status toggled to: " + std::to_string(status));
         },
         sf::Color{10, 35, 79});  
@@ -110,9 +116,9 @@ std::vector<std::unique_ptr<VisualObject>> SceneFactory::createDemoScene(
     // 11. Кнопка увеличения температуры 
     auto tempUpButton = std::make_unique<Button>(450, 400+20, 80, 30,
         "Temp +", font, 22, sf::Color(217, 72, 28), "Temp Increase", db,
-        "", [db]() {
-            double current = db->getVariable("temperature_value");
-            db->setVariable("temperature_value", current + 1.0);
+        "", [db, temperatureTag]() {
+            double current = db->get(temperatureTag);
+            db->set(temperatureTag, current + 1.0, WriteSource::Operator);
             Logger::info("Temperature increased to: " + std::to_string(current + 1.0));
         },
         sf::Color::White);
@@ -121,9 +127,9 @@ std::vector<std::unique_ptr<VisualObject>> SceneFactory::createDemoScene(
     // 12. Кнопка уменьшения температуры
     auto tempDownButton = std::make_unique<Button>(540, 400+20, 80, 30,
         "Temp -", font, 22, sf::Color(0, 178, 232), "Temp Decrease", db,
-        "", [db]() {
-            double current = db->getVariable("temperature_value");
-            db->setVariable("temperature_value", current - 1.0);
+        "", [db, temperatureTag]() {
+            double current = db->get(temperatureTag);
+            db->set(temperatureTag, current - 1.0, WriteSource::Operator);
             Logger::info("Temperature decreased to: " + std::to_string(current - 1.0));
         },
         sf::Color::White);  
@@ -132,9 +138,9 @@ std::vector<std::unique_ptr<VisualObject>> SceneFactory::createDemoScene(
     // 13. Кнопка увеличения давления 
     auto pressureUpButton = std::make_unique<Button>(450, 450+20, 80, 30,
         "Press +", font, 14, sf::Color(143, 0, 232), "Pressure Increase", db,
-        "", [db]() {
-            double current = db->getVariable("pressure_value");
-            db->setVariable("pressure_value", current + 0.5);
+        "", [db, pressureTag]() {
+            double current = db->get(pressureTag);
+            db->set(pressureTag, current + 0.5, WriteSource::Operator);
             Logger::info("Pressure increased to: " + std::to_string(current + 0.1));
         },
         sf::Color::White);
@@ -143,9 +149,9 @@ std::vector<std::unique_ptr<VisualObject>> SceneFactory::createDemoScene(
     // 14. Кнопка уменьшения давления 
     auto pressureDownButton = std::make_unique<Button>(540, 450+20, 80, 30,
         "Press -", font, 14, sf::Color(179, 73, 245), "Pressure Decrease", db,
-        "", [db]() {
-            double current = db->getVariable("pressure_value");
-            db->setVariable("pressure_value", current - 0.5);
+        "", [db, pressureTag]() {
+            double current = db->get(pressureTag);
+            db->set(pressureTag, current - 0.5, WriteSource::Operator);
             Logger::info("Pressure decreased to: " + std::to_string(current - 0.1));
         },
         sf::Color::White);
@@ -0,0 +1,189 @@
+#include "SceneReloader.h"
+#include "JSONLoader.h"
+#include "logger.h"
+#include <fstream>
+
+using json = nlohmann::json;
+
+SceneReloader::SceneReloader(const std::string& configFile)
+    : configFile(configFile), watcher(configFile), hasBaseline(false), pendingFlag(false) {}
+
+void SceneReloader::start() {
+    watcher.start([this]() { onFileChanged(); });
+}
+
+void SceneReloader::stop() {
+    watcher.stop();
+}
+
+void SceneReloader::onFileChanged() {
+    json scene;
+    try {
+        std::ifstream file(configFile);
+        if (!file.is_open()) {
+            return;
+        }
+        file >> scene;
+    } catch (const std::exception& e) {
+        // Файл сохранен с ошибкой - ждем следующего сохранения, сцена не меняется
+        Logger::warning("Cannot reload " + configFile + ": " + std::string(e.what()));
+        return;
+    }
+
+    if (!hasBaseline) {
+        diff(baseline, scene);
+        hasBaseline = true;
+        return;
+    }
+
+    ScenePatch patch = diff(baseline, scene);
+    if (patch.empty()) {
+        return;
+    }
+
+    Logger::info("Scene changed: " + std::to_string(patch.added) + " added, " +
+                 std::to_string(patch.changed) + " changed, " + std::to_string(patch.removed) + " removed");
+    std::lock_guard<std::mutex> lock(mutex);
+    pending.push_back(std::move(patch));
+    pendingFlag.store(true, std::memory_order_release);
+}
+
+std::vector<ScenePatch> SceneReloader::takePending() {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<ScenePatch> patches;
+    patches.swap(pending);
+    pendingFlag.store(false, std::memory_order_release);
+    return patches;
+}
+
+std::string SceneReloader::makeKey(const std::string& name, std::size_t occurrence) {
+    // Разделитель, которого не бывает в именах из редактора
+    return occurrence == 0 ? name : name + '\x1f' + std::to_string(occurrence);
+}
+
+std::vector<std::string> SceneReloader::objectKeys(const json& objects) {
+    std::vector<std::string> keys;
+    std::unordered_map<std::string, std::size_t> occurrences;
+    keys.reserve(objects.size());
+    for (const auto& objJson : objects) {
+        std::string name = objJson.is_object() ? objJson.value("name", "") : std::string();
+        keys.push_back(makeKey(name, occurrences[name]++));
+    }
+    return keys;
+}
+
+ScenePatch SceneReloader::diff(SceneSnapshot& previous, const json& scene) {
+    static const json noObjects = json::array();
+    const json& objects = scene.contains("objects") && scene["objects"].is_array() ? scene["objects"] : noObjects;
+
+    ScenePatch patch;
+    SceneSnapshot next;
+    std::vector<std::string> keys = objectKeys(objects);
+    patch.order = keys;
+    next.objects.reserve(keys.size());
+
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        const json& objJson = objects[i];
+        auto it = previous.objects.find(keys[i]);
+        if (it == previous.objects.end()) {
+            ++patch.added;
+            patch.created.emplace(keys[i], objJson);
+        } else if (it->second != objJson) {
+            ++patch.changed;
+            patch.created.emplace(keys[i], objJson);
+        }
+        next.objects.emplace(keys[i], objJson);
+    }
+    for (const auto& entry : previous.objects) {
+        if (next.objects.find(entry.first) == next.objects.end()) {
+            ++patch.removed;
+        }
+    }
+
+    next.historyCapacity = scene.contains("historyCapacity") ? scene["historyCapacity"] : json();
+    if (next.historyCapacity != previous.historyCapacity &&
+        next.historyCapacity.is_number_integer() && next.historyCapacity.get<std::int64_t>() > 0) {
+        patch.hasHistoryCapacity = true;
+        patch.historyCapacity = next.historyCapacity.get<std::size_t>();
+    }
+
+    // Политика, снятая с переменной, не отзывается: уже записанная история остается
+    next.tags = scene.contains("tags") && scene["tags"].is_object() ? scene["tags"] : json::object();
+    for (const auto& entry : JSONLoader::readHistoryPolicies(scene)) {
+        bool known = previous.tags.is_object() && previous.tags.contains(entry.first) &&
+                     previous.tags[entry.first] == next.tags[entry.first];
+        if (!known) {
+            patch.historyPolicies.push_back(entry);
+        }
+    }
+
+    // Зона нечувствительности, в отличие от политики, снимается: уведомления снова идут на каждую запись
+    for (auto it = next.tags.begin(); it != next.tags.end(); ++it) {
+        bool known = previous.tags.is_object() && previous.tags.contains(it.key()) &&
+                     previous.tags[it.key()] == it.value();
+        NotifyDeadband deadband;
+        bool configured = JSONLoader::readNotifyDeadband(it.value(), deadband);
+        bool hadDeadband = previous.tags.is_object() && previous.tags.contains(it.key()) &&
+                           previous.tags[it.key()].is_object() && previous.tags[it.key()].contains("deadband");
+        if (!known && (configured || hadDeadband)) {
+            patch.notifyDeadbands.emplace_back(it.key(), deadband);
+        }
+    }
+
+    previous = std::move(next);
+    return patch;
+}
+
+void SceneReloader::applyPatch(const ScenePatch& patch,
+                               std::vector<std::unique_ptr<VisualObject>>& objects,
+                               VariableDatabase* db, sf::Font* font,
+                               std::vector<std::unique_ptr<VisualObject>>& removed) {
+    // Текущие объекты по тем же ключам, что и в файле
+    std::unordered_map<std::string, std::unique_ptr<VisualObject>> current;
+    std::unordered_map<std::string, std::size_t> occurrences;
+    current.reserve(objects.size());
+    for (auto& obj : objects) {
+        std::string name = obj->getName();
+        std::string key = makeKey(name, occurrences[name]++);
+        current.emplace(std::move(key), std::move(obj));
+    }
+    objects.clear();
+    objects.reserve(patch.order.size());
+
+    if (patch.hasHistoryCapacity && db) {
+        db->setDefaultHistoryCapacity(patch.historyCapacity);
+    }
+    if (db) {
+        for (const auto& entry : patch.historyPolicies) {
+            db->setHistoryPolicy(db->resolveTag(entry.first), entry.second);
+        }
+        for (const auto& entry : patch.notifyDeadbands) {
+            db->setNotifyDeadband(db->resolveTag(entry.first), entry.second);
+        }
+    }
+
+    for (const std::string& key : patch.order) {
+        auto created = patch.created.find(key);
+        if (created != patch.created.end()) {
+            // Новый или измененный объект: создаем по описанию и сразу синхронизируем
+            auto obj = JSONLoader::createObject(created->second, db, font);
+            if (obj) {
+                obj->update();
+                objects.push_back(std::move(obj));
+            }
+            continue;
+        }
+
+        auto kept = current.find(key);
+        if (kept != current.end() && kept->second) {
+            objects.push_back(std::move(kept->second));
+        }
+    }
+
+    // Удаленные и замененные объекты
+    for (auto& entry : current) {
+        if (entry.second) {
+            removed.push_back(std::move(entry.second));
+        }
+    }
+}
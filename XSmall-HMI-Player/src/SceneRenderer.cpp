@@ -0,0 +1,294 @@
+#include "SceneRenderer.h"
+#include "logger.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+sf::FloatRect unite(const sf::FloatRect& a, const sf::FloatRect& b) {
+    float left = std::min(a.left, b.left);
+    float top = std::min(a.top, b.top);
+    float right = std::max(a.left + a.width, b.left + b.width);
+    float bottom = std::max(a.top + a.height, b.top + b.height);
+    return sf::FloatRect(left, top, right - left, bottom - top);
+}
+
+// Области крупнее (например, границы по умолчанию - весь экран) в сетку не кладутся
+const float MAX_GRID_SIZE = 100000.f;
+
+// Поиск пересечения с уже добавленными областями через равномерную сетку,
+// чтобы при перестроении большой сцены не сравнивать каждый объект с каждым
+class BoundsGrid {
+public:
+    explicit BoundsGrid(const std::vector<sf::FloatRect>& all) : columns(0), rows(0), cellSize(64.f) {
+        bool first = true;
+        float left = 0, top = 0, right = 0, bottom = 0;
+        for (const sf::FloatRect& rect : all) {
+            if (isHuge(rect)) {
+                continue;
+            }
+            left = first ? rect.left : std::min(left, rect.left);
+            top = first ? rect.top : std::min(top, rect.top);
+            right = first ? rect.left + rect.width : std::max(right, rect.left + rect.width);
+            bottom = first ? rect.top + rect.height : std::max(bottom, rect.top + rect.height);
+            first = false;
+        }
+        if (first) {
+            return;
+        }
+
+        // Не больше 512 ячеек по стороне, даже если объекты разбросаны далеко
+        origin = sf::Vector2f(left, top);
+        cellSize = std::max(cellSize, std::max(right - left, bottom - top) / 512.f);
+        columns = static_cast<std::size_t>((right - left) / cellSize) + 1;
+        rows = static_cast<std::size_t>((bottom - top) / cellSize) + 1;
+        cells.resize(columns * rows);
+    }
+
+    bool intersectsAny(const sf::FloatRect& rect) const {
+        for (std::size_t index : unbounded) {
+            if (rect.intersects(rects[index])) {
+                return true;
+            }
+        }
+        if (isHuge(rect)) {
+            return std::any_of(rects.begin(), rects.end(),
+                               [&rect](const sf::FloatRect& other) { return rect.intersects(other); });
+        }
+
+        std::size_t firstColumn, lastColumn, firstRow, lastRow;
+        if (!cellRange(rect, firstColumn, lastColumn, firstRow, lastRow)) {
+            return false;
+        }
+        for (std::size_t row = firstRow; row <= lastRow; ++row) {
+            for (std::size_t column = firstColumn; column <= lastColumn; ++column) {
+                for (std::size_t index : cells[row * columns + column]) {
+                    if (rect.intersects(rects[index])) {
+                        return true;
+                    }
+                }
+            }
+        }
+        return false;
+    }
+
+    void add(const sf::FloatRect& rect) {
+        std::size_t index = rects.size();
+        rects.push_back(rect);
+
+        std::size_t firstColumn, lastColumn, firstRow, lastRow;
+        if (isHuge(rect) || !cellRange(rect, firstColumn, lastColumn, firstRow, lastRow)) {
+            unbounded.push_back(index);
+            return;
+        }
+        for (std::size_t row = firstRow; row <= lastRow; ++row) {
+            for (std::size_t column = firstColumn; column <= lastColumn; ++column) {
+                cells[row * columns + column].push_back(index);
+            }
+        }
+    }
+
+private:
+    std::vector<sf::FloatRect> rects;
+    std::vector<std::vector<std::size_t>> cells;
+    std::vector<std::size_t> unbounded;
+    sf::Vector2f origin;
+    std::size_t columns, rows;
+    float cellSize;
+
+    static bool isHuge(const sf::FloatRect& rect) {
+        return rect.width > MAX_GRID_SIZE || rect.height > MAX_GRID_SIZE;
+    }
+
+    // Ячейки, которые пересекает rect (с обрезкой по краям сетки)
+    bool cellRange(const sf::FloatRect& rect, std::size_t& firstColumn, std::size_t& lastColumn,
+                   std::size_t& firstRow, std::size_t& lastRow) const {
+        if (cells.empty()) {
+            return false;
+        }
+        auto toCell = [this](float offset, std::size_t count) {
+            float cell = std::floor(offset / cellSize);
+            return static_cast<std::size_t>(std::clamp(cell, 0.f, static_cast<float>(count - 1)));
+        };
+        firstColumn = toCell(rect.left - origin.x, columns);
+        lastColumn = toCell(rect.left + rect.width - origin.x, columns);
+        firstRow = toCell(rect.top - origin.y, rows);
+        lastRow = toCell(rect.top + rect.height - origin.y, rows);
+        return true;
+    }
+};
+
+} // namespace
+
+SceneRenderer::SceneRenderer()
+    : background(sf::Color::Black), staticTextureValid(false), staticCacheAvailable(true) {}
+
+void SceneRenderer::build(const std::vector<std::unique_ptr<VisualObject>>& objects) {
+    // Делим объекты на слои. Статический слой выводится под динамическим, поэтому
+    // статический объект поверх динамического оставляем в динамическом слое
+    std::vector<VisualObject*> staticObjects;
+    std::vector<VisualObject*> dynamicObjects;
+    std::vector<sf::FloatRect> bounds;
+    bounds.reserve(objects.size());
+    for (const auto& object : objects) {
+        bounds.push_back(object->getBounds());
+    }
+
+    BoundsGrid dynamicBounds(bounds);
+    for (std::size_t i = 0; i < objects.size(); ++i) {
+        VisualObject* object = objects[i].get();
+        if (object->isStatic() && !dynamicBounds.intersectsAny(bounds[i])) {
+            staticObjects.push_back(object);
+        } else {
+            dynamicObjects.push_back(object);
+            dynamicBounds.add(bounds[i]);
+        }
+    }
+
+    buildLayer(staticLayer, staticObjects);
+    buildLayer(dynamicLayer, dynamicObjects);
+    staticTextureValid = false;
+}
+
+bool SceneRenderer::needsFrame(HistoryClock::time_point now) const {
+    // Отдельно рисуемых объектов немного, проверка каждый кадр дешева
+    for (const Step& step : dynamicLayer.steps) {
+        if (step.object && step.object->needsFrame(now)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void SceneRenderer::buildLayer(Layer& layer, const std::vector<VisualObject*>& objects) {
+    layer.steps.clear();
+    layer.batches.clear();
+    layer.objectCount = objects.size();
+
+    // Пакеты текущей группы в порядке отрисовки и занятые их геометрией области
+    struct OpenBatch {
+        RenderBatch* batch;
+        sf::FloatRect bounds;
+        bool hasGeometry;
+    };
+    std::vector<OpenBatch> open;
+    std::vector<VisualObject*> deferred;     // Объекты, рисуемые поверх текущих пакетов
+    std::vector<sf::FloatRect> deferredBounds;
+
+    // Завершает текущую группу: сначала пакеты, затем отложенные объекты
+    auto flush = [&]() {
+        for (const OpenBatch& item : open) {
+            if (!item.batch->empty()) {
+                layer.steps.push_back({item.batch, nullptr});
+            }
+        }
+        for (VisualObject* object : deferred) {
+            layer.steps.push_back({nullptr, object});
+        }
+        open.clear();
+        deferred.clear();
+        deferredBounds.clear();
+    };
+
+    for (VisualObject* object : objects) {
+        sf::FloatRect bounds = object->getBounds();
+
+        // Геометрия объекта легла бы под уже отложенный объект, а должна быть над ним
+        for (const auto& other : deferredBounds) {
+            if (bounds.intersects(other)) {
+                flush();
+                break;
+            }
+        }
+
+        // Последний пакет с нужной текстурой, если объект не перекрывает пакеты, рисуемые после него
+        const sf::Texture* texture = object->getBatchTexture();
+        OpenBatch* target = nullptr;
+        for (std::size_t i = open.size(); i-- > 0;) {
+            if (open[i].batch->getTexture() == texture) {
+                target = &open[i];
+                break;
+            }
+            if (open[i].hasGeometry && bounds.intersects(open[i].bounds)) {
+                break;
+            }
+        }
+        if (!target) {
+            layer.batches.push_back(std::make_unique<RenderBatch>(texture));
+            open.push_back({layer.batches.back().get(), sf::FloatRect(), false});
+            target = &open.back();
+        }
+
+        std::size_t before = target->batch->getVertexCount();
+        object->attachToBatch(*target->batch);
+        if (target->batch->getVertexCount() != before) {
+            target->bounds = target->hasGeometry ? unite(target->bounds, bounds) : bounds;
+            target->hasGeometry = true;
+        }
+
+        if (object->hasOverlay()) {
+            deferred.push_back(object);
+            deferredBounds.push_back(bounds);
+        }
+    }
+    flush();
+
+    // Пакеты без геометрии (например, между подряд идущими текстами) не нужны
+    layer.batches.erase(std::remove_if(layer.batches.begin(), layer.batches.end(),
+                                       [](const std::unique_ptr<RenderBatch>& batch) { return batch->empty(); }),
+                        layer.batches.end());
+}
+
+void SceneRenderer::drawLayer(const Layer& layer, sf::RenderTarget& target) {
+    for (const Step& step : layer.steps) {
+        if (step.batch) {
+            step.batch->draw(target);
+        } else {
+            step.object->drawOverlay(target);
+        }
+    }
+}
+
+bool SceneRenderer::renderStaticLayer(const sf::RenderTarget& target) {
+    // Размер текстуры - логический размер сцены: при растяжении окна она масштабируется
+    // вместе с остальными объектами
+    sf::Vector2f viewSize = target.getView().getSize();
+    sf::Vector2u size(static_cast<unsigned int>(viewSize.x), static_cast<unsigned int>(viewSize.y));
+    if (staticTexture.getSize() != size) {
+        if (!staticTexture.create(size.x, size.y)) {
+            Logger::warning("Cannot create static layer texture, static objects will be redrawn every frame");
+            staticCacheAvailable = false;
+            return false;
+        }
+    }
+
+    staticTexture.clear(background);
+    drawLayer(staticLayer, staticTexture);
+    staticTexture.display();
+    staticTextureValid = true;
+    return true;
+}
+
+void SceneRenderer::draw(sf::RenderTarget& target) {
+    if (staticCacheAvailable && (staticTextureValid || renderStaticLayer(target))) {
+        // Непрозрачная текстура закрывает весь кадр - смешивание не нужно
+        target.draw(sf::Sprite(staticTexture.getTexture()), sf::RenderStates(sf::BlendNone));
+    } else {
+        target.clear(background);
+        drawLayer(staticLayer, target);
+    }
+
+    drawLayer(dynamicLayer, target);
+}
+
+void SceneRenderer::setBackground(const sf::Color& color) {
+    background = color;
+    staticTextureValid = false;
+}
+
+const RenderBatch& SceneRenderer::getBatch(std::size_t index) const {
+    if (index < staticLayer.batches.size()) {
+        return *staticLayer.batches[index];
+    }
+    return *dynamicLayer.batches[index - staticLayer.batches.size()];
+}
@@ -0,0 +1,372 @@
+#include "StateManager.h"
+#include "logger.h"
+#include <nlohmann/json.hpp>
+#include <filesystem>
+#include <fstream>
+#include <cstdio>
+#include <chrono>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using json = nlohmann::json;
+
+namespace {
+
+// История идет по монотонным часам; в файл отметки пишутся Unix-временем,
+// чтобы после перезапуска (и перезагрузки машины) они остались на своих местах
+std::int64_t toUnixMs(HistoryClock::time_point time, HistoryClock::time_point steadyNow,
+                      std::chrono::system_clock::time_point systemNow) {
+    auto system = systemNow + std::chrono::duration_cast<std::chrono::system_clock::duration>(time - steadyNow);
+    return std::chrono::duration_cast<std::chrono::milliseconds>(system.time_since_epoch()).count();
+}
+
+HistoryClock::time_point fromUnixMs(std::int64_t ms, HistoryClock::time_point steadyNow,
+                                    std::chrono::system_clock::time_point systemNow) {
+    std::chrono::system_clock::time_point system{std::chrono::milliseconds(ms)};
+    return steadyNow + std::chrono::duration_cast<HistoryClock::duration>(system - systemNow);
+}
+
+// Восстанавливает сохраненные истории; возвращает их число
+std::size_t loadHistory(VariableDatabase& db, const json& histories) {
+    HistoryClock::time_point steadyNow = HistoryClock::now();
+    std::chrono::system_clock::time_point systemNow = std::chrono::system_clock::now();
+
+    std::size_t loaded = 0;
+    std::vector<double> values;
+    std::vector<HistoryClock::time_point> times;
+    for (auto it = histories.begin(); it != histories.end(); ++it) {
+        const json& history = it.value();
+        if (!history.is_object() || !history.contains("times") || !history.contains("values") ||
+            !history["times"].is_array() || !history["values"].is_array() ||
+            history["times"].size() != history["values"].size()) {
+            Logger::warning("Ignoring malformed saved history of " + it.key());
+            continue;
+        }
+
+        values.clear();
+        times.clear();
+        for (std::size_t i = 0; i < history["values"].size(); ++i) {
+            const json& time = history["times"][i];
+            const json& value = history["values"][i];
+            if (time.is_number_integer() && value.is_number()) {
+                times.push_back(fromUnixMs(time.get<std::int64_t>(), steadyNow, systemNow));
+                values.push_back(value.get<double>());
+            }
+        }
+        db.restoreHistory(db.resolveTag(it.key()), values, times);
+        ++loaded;
+    }
+    return loaded;
+}
+
+#ifdef _WIN32
+
+bool writeAndSync(const std::string& path, const std::string& content) {
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    DWORD written = 0;
+    bool ok = WriteFile(file, content.data(), static_cast<DWORD>(content.size()), &written, nullptr) &&
+              written == content.size() && FlushFileBuffers(file);
+    CloseHandle(file);
+    return ok;
+}
+
+bool replaceFile(const std::string& from, const std::string& to) {
+    return MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH);
+}
+
+#else
+
+bool writeAndSync(const std::string& path, const std::string& content) {
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    const char* data = content.data();
+    std::size_t left = content.size();
+    while (left > 0) {
+        ssize_t written = ::write(fd, data, left);
+        if (written <= 0) {
+            ::close(fd);
+            return false;
+        }
+        data += written;
+        left -= static_cast<std::size_t>(written);
+    }
+    bool ok = ::fsync(fd) == 0;
+    return ::close(fd) == 0 && ok;
+}
+
+bool replaceFile(const std::string& from, const std::string& to) {
+    if (std::rename(from.c_str(), to.c_str()) != 0) {
+        return false;
+    }
+    // Переименование тоже должно дойти до диска: сбрасываем каталог
+    std::string dir = std::filesystem::path(to).parent_path().string();
+    int fd = ::open(dir.empty() ? "." : dir.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        ::fsync(fd);
+        ::close(fd);
+    }
+    return true;
+}
+
+#endif
+
+} // namespace
+
+StateManager::StateManager(const std::string& file)
+    : filename(file), journalDb(nullptr), writing(false), stopping(false) {
+    writer = std::thread(&StateManager::writerLoop, this);
+}
+
+StateManager::~StateManager() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    writer.join();
+
+    if (journalDb) {
+        journalDb->setOperatorWriteHandler(nullptr);
+    }
+}
+
+void StateManager::enableJournal(VariableDatabase& db) {
+    std::string base = std::filesystem::path(filename).replace_extension(".wal").string();
+    journal = std::make_unique<WriteAheadLog>(base);
+    journalDb = &db;
+
+    WriteAheadLog* log = journal.get();
+    db.setOperatorWriteHandler([log, &db](TagId tag, double value) {
+        log->append(db.getTagName(tag), value);
+    });
+}
+
+void StateManager::setTags(VariableDatabase& db, const std::vector<std::string>& names) {
+    configuredTags.clear();
+    for (const auto& name : names) {
+        configuredTags.push_back(db.resolveTag(name));
+    }
+}
+
+void StateManager::saveState(const VariableDatabase& db) {
+    auto snapshot = std::make_unique<Snapshot>();
+    snapshot->db = &db;
+    snapshot->time = std::time(nullptr);
+    snapshot->walSequence = 0;
+    snapshot->walSegment = 0;
+    if (journal) {
+        // Все записи до этого момента вошли в снимок, следующие пойдут в новый сегмент
+        snapshot->walSequence = journal->rotate(snapshot->walSegment);
+    }
+
+    // Копируются только дескрипторы и числа; имена и JSON - в фоновом потоке
+    auto capture = [&db, &snapshot](TagId tag) {
+        if (db.hasValue(tag)) {
+            snapshot->tags.push_back(tag);
+            snapshot->values.push_back(db.get(tag));
+        }
+    };
+    // История копируется целиком: к записи фоновым потоком она уже изменится
+    HistoryClock::time_point steadyNow = HistoryClock::now();
+    std::chrono::system_clock::time_point systemNow = std::chrono::system_clock::now();
+    std::vector<HistoryClock::time_point> times;
+    for (TagId tag : db.getPersistentHistoryTags()) {
+        snapshot->historyValues.emplace_back();
+        db.copyHistory(tag, snapshot->historyValues.back(), times);
+        std::vector<std::int64_t> unixTimes;
+        unixTimes.reserve(times.size());
+        for (HistoryClock::time_point time : times) {
+            unixTimes.push_back(toUnixMs(time, steadyNow, systemNow));
+        }
+        snapshot->historyTags.push_back(tag);
+        snapshot->historyTimes.push_back(std::move(unixTimes));
+    }
+
+    if (configuredTags.empty()) {
+        std::size_t count = db.tagCount();
+        snapshot->tags.reserve(count);
+        snapshot->values.reserve(count);
+        for (TagId tag = 0; tag < count; ++tag) {
+            capture(tag);
+        }
+    } else {
+        for (TagId tag : configuredTags) {
+            capture(tag);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending = std::move(snapshot);  // Еще не записанный снимок устарел
+    }
+    wake.notify_one();
+}
+
+void StateManager::flush() {
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        idle.wait(lock, [this]() { return !pending && !writing; });
+    }
+    if (journal) {
+        journal->flush();
+    }
+}
+
+void StateManager::writerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [this]() { return stopping || pending; });
+        if (!pending) {
+            return;  // Остановка, все снимки записаны
+        }
+
+        std::unique_ptr<Snapshot> snapshot = std::move(pending);
+        writing = true;
+        lock.unlock();
+
+        writeSnapshot(*snapshot);
+
+        lock.lock();
+        writing = false;
+        idle.notify_all();
+    }
+}
+
+bool StateManager::writeSnapshot(const Snapshot& snapshot) {
+    json variables = json::object();
+    for (std::size_t i = 0; i < snapshot.tags.size(); ++i) {
+        variables[snapshot.db->getTagName(snapshot.tags[i])] = snapshot.values[i];
+    }
+
+    // std::localtime не потокобезопасен
+    std::tm localTime = {};
+#ifdef _WIN32
+    localtime_s(&localTime, &snapshot.time);
+#else
+    localtime_r(&snapshot.time, &localTime);
+#endif
+    char timeStr[100];
+    std::strftime(timeStr, sizeof(timeStr), "%Y-%m-%d %H:%M:%S", &localTime);
+
+    json j;
+    j["saved_at"] = timeStr;
+    j["timestamp"] = static_cast<std::int64_t>(snapshot.time);
+    j["variables"] = std::move(variables);
+    if (!snapshot.historyTags.empty()) {
+        json histories = json::object();
+        for (std::size_t i = 0; i < snapshot.historyTags.size(); ++i) {
+            histories[snapshot.db->getTagName(snapshot.historyTags[i])] = {
+                {"times", snapshot.historyTimes[i]}, {"values", snapshot.historyValues[i]}};
+        }
+        j["history"] = std::move(histories);
+    }
+    if (journal) {
+        j["walSequence"] = snapshot.walSequence;
+    }
+
+    if (!writeFileAtomically(filename, j.dump(2))) {
+        Logger::error("Failed to save state to " + filename);
+        return false;
+    }
+    Logger::info("State saved to " + filename + " (" + std::to_string(snapshot.tags.size()) + " variables)");
+
+    if (journal) {
+        // Сегменты удаляются только после того, как вошедшие в снимок записи
+        // дописаны в журнал: иначе при сбое их можно было бы записать в удаленный сегмент
+        journal->flush();
+        journal->removeSegmentsBefore(snapshot.walSegment);
+    }
+    return true;
+}
+
+bool StateManager::writeFileAtomically(const std::string& path, const std::string& content) {
+    std::string tempPath = path + ".tmp";
+    if (!writeAndSync(tempPath, content)) {
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    if (!replaceFile(tempPath, path)) {
+        std::remove(tempPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool StateManager::loadState(VariableDatabase& db) {
+    std::uint64_t walSequence = 0;
+    bool loaded = loadSnapshot(db, walSequence);
+
+    if (journal) {
+        std::size_t replayed = journal->recover(walSequence, [&db](const std::string& name, double value) {
+            db.setVariable(name, value);
+        });
+        if (replayed > 0) {
+            Logger::info("Replayed " + std::to_string(replayed) + " journal records from " +
+                         journal->getBasePath());
+        }
+    }
+    return loaded;
+}
+
+bool StateManager::loadSnapshot(VariableDatabase& db, std::uint64_t& walSequence) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        Logger::warning("State file not found: " + filename);
+        return false;
+    }
+
+    json j;
+    try {
+        file >> j;
+    } catch (const std::exception& e) {
+        Logger::error("Cannot parse state file " + filename + ": " + e.what());
+        return false;
+    }
+    if (!j.is_object()) {
+        Logger::error("Cannot parse state file " + filename + ": not an object");
+        return false;
+    }
+
+    // Прежний формат хранил переменные прямо в корне рядом с отметками времени
+    const json* variables = &j;
+    if (j.contains("variables") && j["variables"].is_object()) {
+        variables = &j["variables"];
+    }
+
+    std::size_t loaded = 0;
+    for (auto it = variables->begin(); it != variables->end(); ++it) {
+        if (!it.value().is_number() || (variables == &j && it.key() == "timestamp")) {
+            continue;
+        }
+        db.setVariable(it.key(), it.value().get<double>());
+        ++loaded;
+    }
+
+    std::size_t histories = 0;
+    if (j.contains("history") && j["history"].is_object()) {
+        histories = loadHistory(db, j["history"]);
+    }
+
+    if (j.contains("walSequence") && j["walSequence"].is_number_unsigned()) {
+        walSequence = j["walSequence"].get<std::uint64_t>();
+    }
+    if (j.contains("saved_at") && j["saved_at"].is_string()) {
+        Logger::info("File was saved at: " + j["saved_at"].get<std::string>());
+    }
+    Logger::info("State loaded from " + filename + " (" + std::to_string(loaded) + " variables, " +
+                 std::to_string(histories) + " histories)");
+    return true;
+}
@@ -0,0 +1,91 @@
+#include "SwingingDoor.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+SwingingDoor::SwingingDoor(double deviation)
+    : deviation(deviation), started(false), holding(false), pivotValue(0.0), heldValue(0.0),
+      slopeLow(0.0), slopeHigh(0.0) {}
+
+void SwingingDoor::reset() {
+    started = false;
+    holding = false;
+}
+
+void SwingingDoor::openDoors(HistoryClock::time_point time, double value) {
+    double seconds = std::chrono::duration<double>(time - pivotTime).count();
+    slopeLow = (value - deviation - pivotValue) / seconds;
+    slopeHigh = (value + deviation - pivotValue) / seconds;
+}
+
+bool SwingingDoor::add(HistoryClock::time_point time, double value,
+                       HistoryClock::time_point& archivedTime, double& archivedValue) {
+    if (!started) {
+        started = true;
+        holding = false;
+        pivotTime = time;
+        pivotValue = value;
+        archivedTime = time;
+        archivedValue = value;
+        return true;
+    }
+
+    // Значение с отметкой точки A (отметки истории не убывают): наклон не определен,
+    // значение заменяет принятое. Выход за допуск сохраняет его как новую точку A
+    if (time <= pivotTime) {
+        if (holding) {
+            heldValue = value;  // Принятое значение с той же отметкой: остается последнее
+            return false;
+        }
+        if (std::abs(value - pivotValue) > deviation) {
+            pivotValue = value;
+            holding = false;
+            archivedTime = pivotTime;
+            archivedValue = value;
+            return true;
+        }
+        return false;
+    }
+
+    if (!holding) {
+        openDoors(time, value);
+        holding = true;
+        heldTime = time;
+        heldValue = value;
+        return false;
+    }
+
+    double seconds = std::chrono::duration<double>(time - pivotTime).count();
+    double low = std::max(slopeLow, (value - deviation - pivotValue) / seconds);
+    double high = std::min(slopeHigh, (value + deviation - pivotValue) / seconds);
+    if (low <= high) {
+        slopeLow = low;
+        slopeHigh = high;
+        heldTime = time;
+        heldValue = value;
+        return false;
+    }
+
+    // Двери разошлись: точка излома - в момент последнего принятого значения на прямой
+    // между дверями, ближайшей к нему. Через такую точку линия проходит не дальше
+    // deviation от всех принятых значений (само значение сохраняется, если оно на прямой)
+    archivedTime = heldTime;
+    archivedValue = heldValue;
+    if (heldTime > pivotTime) {
+        double heldSeconds = std::chrono::duration<double>(heldTime - pivotTime).count();
+        double slope = std::clamp((heldValue - pivotValue) / heldSeconds, slopeLow, slopeHigh);
+        archivedValue = pivotValue + slope * heldSeconds;
+    }
+    pivotTime = heldTime;
+    pivotValue = archivedValue;
+    heldTime = time;
+    heldValue = value;
+    if (time > pivotTime) {
+        openDoors(time, value);
+    } else {
+        // Та же отметка, что у новой точки A: дверей нет, следующее значение сохранит это
+        slopeLow = std::numeric_limits<double>::infinity();
+        slopeHigh = -std::numeric_limits<double>::infinity();
+    }
+    return true;
+}
@@ -1,14 +1,21 @@
 #include "Text.h"
 #include "logger.h"
-#include <sstream>
-#include <iomanip>
+
+namespace {
+
+// Запас глифов для надписей со значением переменной: строка меняется без переноса участка
+const std::size_t VALUE_TEXT_CAPACITY = 32;
+
+} // namespace
 
 Text::Text(float x, float y, const std::string& content, 
            sf::Font* font, unsigned int size, const sf::Color& color,
            const std::string& name, VariableDatabase* db, 
            const std::string& varName, const std::string& format)
     : VisualObject(x, y, name, db), formatString(format), 
-      variableName(varName), font(font) {
+      variableName(varName),
+      tag(!varName.empty() && db ? db->resolveTag(varName) : INVALID_TAG), font(font),
+      numberFormat(format) {
     
     text.setPosition(x, y);
     text.setFont(*font);
@@ -26,8 +33,8 @@ Text::Text(float x, float y, const std::string& content,
             formatString = format; // Сохраняем формат для динамического обновления
         }
         
-        if (database) {
-            database->subscribe(variableName, [this](double value) {
+        if (tag != INVALID_TAG) {
+            subscribe(tag, [this](double value) {
                 this->update();
             });
         }
@@ -35,35 +42,34 @@ Text::Text(float x, float y, const std::string& content,
     }
 }
 
-void Text::draw(sf::RenderWindow& window) {
-    window.draw(text);
+void Text::draw(sf::RenderTarget& target) {
+    target.draw(text);
+}
+
+void Text::attachToBatch(RenderBatch& batch) {
+    textRun.attach(batch, text, tag != INVALID_TAG ? VALUE_TEXT_CAPACITY : 0);
+}
+
+sf::FloatRect Text::getBounds() const {
+    return text.getGlobalBounds();
 }
 
 void Text::update() {
-    if (!variableName.empty() && database) {
-        double value = database->getVariable(variableName);
-        
-        if (!formatString.empty()) {
-            // Форматируем строку с использованием шаблона
-            std::stringstream ss;
-            size_t pos = formatString.find("%f");
-            if (pos != std::string::npos) {
-                // Заменяем %f на значение с одним знаком после запятой
-                std::string before = formatString.substr(0, pos);
-                std::string after = formatString.substr(pos + 2);
-                ss << before << std::fixed << std::setprecision(1) << value << after;
-                text.setString(ss.str());
-            } else {
-                // Если нет спецификатора формата, просто добавляем значение
-                text.setString(formatString + std::to_string(value));
-            }
-        } else {
-            // Без форматирования - просто преобразуем число в строку
-            text.setString(std::to_string(value));
+    if (tag != INVALID_TAG) {
+        // Шаблон уже разобран (префикс, спецификатор, единицы) - только вывод числа
+        numberFormat.format(database->get(tag), formatted);
+
+        // sf::Text перестраивает геометрию при каждом setString - пропускаем, если текст тот же
+        if (formatted != displayed) {
+            displayed.assign(formatted);
+            text.setString(displayed);
+            textRun.update(text);
         }
     }
 }
 
 void Text::setString(const std::string& str) {
+    displayed = str;
     text.setString(str);
+    textRun.update(text);
 }
\ No newline at end of file
@@ -0,0 +1,104 @@
+#include "TextRun.h"
+#include <algorithm>
+
+// sf::Font заполняет пиксели [0, 2) x [0, 2) белым для подчеркивания; берем центр квадрата
+const sf::Vector2f TextRun::SOLID_TEX_COORDS(1.f, 1.f);
+
+TextRun::TextRun() : capacity(0) {}
+
+const sf::Texture* TextRun::getTexture(const sf::Text& text) {
+    const sf::Font* font = text.getFont();
+    return font ? &font->getTexture(text.getCharacterSize()) : nullptr;
+}
+
+std::size_t TextRun::countGlyphs(const sf::String& string) {
+    std::size_t count = 0;
+    for (sf::Uint32 c : string) {
+        if (c != ' ' && c != '\t' && c != '\n' && c != '\r') {
+            ++count;
+        }
+    }
+    return count;
+}
+
+void TextRun::attach(RenderBatch& batch, const sf::Text& text, std::size_t minCapacity) {
+    capacity = std::max(countGlyphs(text.getString()), minCapacity);
+    range = batch.allocate(capacity * RenderBatch::QUAD_VERTICES);
+    write(text);
+}
+
+void TextRun::update(const sf::Text& text) {
+    if (!range.attached()) {
+        return;
+    }
+
+    std::size_t glyphs = countGlyphs(text.getString());
+    if (glyphs > capacity) {
+        // Строка не помещается: гасим старый участок и берем новый, вдвое больше, в конце пакета.
+        // Вершины других объектов не сдвигаются, меняется только порядок внутри пакета
+        RenderBatch& batch = *range.batch;
+        sf::Vertex* old = batch.data(range);
+        std::fill(old, old + range.count, sf::Vertex());
+        batch.markDirty(range);
+
+        capacity = std::max(glyphs, capacity * 2);
+        range = batch.allocate(capacity * RenderBatch::QUAD_VERTICES);
+    }
+    write(text);
+}
+
+void TextRun::write(const sf::Text& text) {
+    sf::Vertex* out = range.batch->data(range);
+    sf::Vertex* end = out + range.count;
+
+    const sf::Font* font = text.getFont();
+    if (font) {
+        unsigned int size = text.getCharacterSize();
+        sf::Color color = text.getFillColor();
+        sf::Vector2f origin = text.getPosition() - text.getOrigin();
+
+        float whitespace = font->getGlyph(' ', size, false).advance;
+        float lineSpacing = font->getLineSpacing(size);
+
+        // Как в sf::Text: первая строка - на базовой линии y = размер символов
+        float x = 0.f;
+        float y = static_cast<float>(size);
+        sf::Uint32 previous = 0;
+
+        for (sf::Uint32 current : text.getString()) {
+            if (current == '\r') {
+                continue;
+            }
+            x += font->getKerning(previous, current, size);
+            previous = current;
+
+            if (current == ' ') {
+                x += whitespace;
+                continue;
+            }
+            if (current == '\t') {
+                x += whitespace * 4;
+                continue;
+            }
+            if (current == '\n') {
+                y += lineSpacing;
+                x = 0.f;
+                continue;
+            }
+
+            const sf::Glyph& glyph = font->getGlyph(current, size, false);
+
+            // Отступ в 1px вокруг глифа, как у sf::Text: сглаживание не обрезается по краю
+            sf::FloatRect rect(origin.x + x + glyph.bounds.left - 1.f, origin.y + y + glyph.bounds.top - 1.f,
+                               glyph.bounds.width + 2.f, glyph.bounds.height + 2.f);
+            sf::IntRect textureRect(glyph.textureRect.left - 1, glyph.textureRect.top - 1,
+                                    glyph.textureRect.width + 2, glyph.textureRect.height + 2);
+            out = RenderBatch::writeTexturedQuad(out, rect, textureRect, color);
+            x += glyph.advance;
+        }
+    }
+
+    // Неиспользованные глифы - вырожденные треугольники, растеризатор их отбрасывает
+    std::fill(out, end, sf::Vertex());
+    range.batch->markDirty(range);
+}
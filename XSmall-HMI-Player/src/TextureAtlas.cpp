@@ -0,0 +1,233 @@
+#include "TextureAtlas.h"
+#include "logger.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+
+namespace {
+
+const std::uint64_t FNV_OFFSET = 14695981039346656037ull;
+const std::uint64_t FNV_PRIME = 1099511628211ull;
+
+void hashBytes(std::uint64_t& hash, const char* data, std::size_t size) {
+    for (std::size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= FNV_PRIME;
+    }
+}
+
+std::string hashName(std::uint64_t hash) {
+    std::ostringstream name;
+    name << "atlas_" << std::hex << std::setw(16) << std::setfill('0') << hash;
+    return name.str();
+}
+
+std::string pageFile(const std::string& cacheDir, std::uint64_t hash, std::size_t page) {
+    return (std::filesystem::path(cacheDir) / (hashName(hash) + "_" + std::to_string(page) + ".png")).string();
+}
+
+} // namespace
+
+TextureAtlas::TextureAtlas(unsigned int pageSize, unsigned int padding)
+    : pageSize(pageSize), padding(padding), loadedFromCache(false) {}
+
+void TextureAtlas::add(const std::string& key, const sf::Image& image) {
+    pending.emplace_back(key, image);
+}
+
+bool TextureAtlas::pack() {
+    // Полки: сначала высокие изображения, чтобы полки заполнялись плотнее
+    std::vector<std::size_t> order(pending.size());
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+        return pending[a].second.getSize().y > pending[b].second.getSize().y;
+    });
+
+    struct Placement {
+        std::size_t image;
+        std::size_t page;
+        sf::Vector2u position;
+    };
+    std::vector<Placement> placements;
+    std::vector<unsigned int> pageHeights;
+
+    bool packedAll = true;
+    std::size_t firstPage = pages.size();
+    unsigned int shelfX = 0, shelfY = 0, shelfHeight = 0;
+    for (std::size_t index : order) {
+        sf::Vector2u size = pending[index].second.getSize();
+        if (size.x == 0 || size.y == 0 || size.x > pageSize || size.y > pageSize) {
+            Logger::warning("Image does not fit into texture atlas: " + pending[index].first);
+            packedAll = false;
+            continue;
+        }
+
+        if (pageHeights.empty()) {
+            pageHeights.push_back(0);
+        }
+        if (shelfX + size.x > pageSize) {
+            // Полка заполнена - начинаем следующую
+            shelfY += shelfHeight + padding;
+            shelfX = 0;
+            shelfHeight = 0;
+        }
+        if (shelfY + size.y > pageSize) {
+            // Страница заполнена
+            pageHeights.push_back(0);
+            shelfX = shelfY = shelfHeight = 0;
+        }
+
+        placements.push_back({index, firstPage + pageHeights.size() - 1, sf::Vector2u(shelfX, shelfY)});
+        shelfX += size.x + padding;
+        shelfHeight = std::max(shelfHeight, size.y);
+        pageHeights.back() = std::max(pageHeights.back(), shelfY + size.y);
+    }
+
+    // Страница по высоте занятой области - меньше видеопамяти под пустое место
+    for (unsigned int height : pageHeights) {
+        sf::Image page;
+        page.create(pageSize, height, sf::Color::Transparent);
+        pageImages.push_back(page);
+    }
+    for (const Placement& placement : placements) {
+        const auto& source = pending[placement.image];
+        sf::Vector2u size = source.second.getSize();
+        pageImages[placement.page].copy(source.second, placement.position.x, placement.position.y);
+        entries[source.first] = Entry{placement.page,
+                                      sf::IntRect(static_cast<int>(placement.position.x),
+                                                  static_cast<int>(placement.position.y),
+                                                  static_cast<int>(size.x), static_cast<int>(size.y))};
+    }
+    for (std::size_t page = firstPage; page < pageImages.size(); ++page) {
+        auto texture = std::make_unique<sf::Texture>();
+        if (!texture->loadFromImage(pageImages[page])) {
+            Logger::error("Cannot create texture atlas page " + std::to_string(page));
+            packedAll = false;
+        }
+        pages.push_back(std::move(texture));
+    }
+
+    pending.clear();
+    return packedAll;
+}
+
+bool TextureAtlas::loadFiles(const std::vector<std::string>& files, const std::string& cacheDir) {
+    std::uint64_t hash = 0;
+    std::string indexFile;
+    if (!cacheDir.empty()) {
+        // Другая раскладка - другой атлас
+        hash = hashFiles(files);
+        hashBytes(hash, reinterpret_cast<const char*>(&pageSize), sizeof(pageSize));
+        hashBytes(hash, reinterpret_cast<const char*>(&padding), sizeof(padding));
+        indexFile = (std::filesystem::path(cacheDir) / (hashName(hash) + ".txt")).string();
+        if (loadCache(indexFile, hash)) {
+            loadedFromCache = true;
+            Logger::info("Texture atlas loaded from cache: " + indexFile);
+            return true;
+        }
+    }
+
+    bool loadedAll = true;
+    for (const auto& file : files) {
+        sf::Image image;
+        if (image.loadFromFile(file)) {
+            add(file, image);
+        } else {
+            Logger::warning("Cannot load image for texture atlas: " + file);
+            loadedAll = false;
+        }
+    }
+    bool packedAll = pack();
+    Logger::info("Texture atlas: " + std::to_string(entries.size()) + " images in " +
+                 std::to_string(pages.size()) + " page(s)");
+
+    // Неполный атлас не кэшируем: в следующий раз недостающие файлы могут появиться
+    if (!cacheDir.empty() && loadedAll && packedAll && !saveCache(cacheDir, indexFile, hash)) {
+        Logger::warning("Cannot save texture atlas cache to: " + cacheDir);
+    }
+    return loadedAll && packedAll;
+}
+
+bool TextureAtlas::loadCache(const std::string& indexFile, std::uint64_t hash) {
+    std::ifstream index(indexFile);
+    if (!index) {
+        return false;
+    }
+
+    std::string keyword;
+    std::size_t pageCount = 0;
+    if (!(index >> keyword >> pageCount) || keyword != "pages") {
+        return false;
+    }
+
+    std::string cacheDir = std::filesystem::path(indexFile).parent_path().string();
+    std::vector<std::unique_ptr<sf::Texture>> cachedPages;
+    for (std::size_t page = 0; page < pageCount; ++page) {
+        auto texture = std::make_unique<sf::Texture>();
+        if (!texture->loadFromFile(pageFile(cacheDir, hash, page))) {
+            return false;
+        }
+        cachedPages.push_back(std::move(texture));
+    }
+
+    // Строки: entry <страница> <x> <y> <ширина> <высота> <файл до конца строки>
+    std::unordered_map<std::string, Entry> cachedEntries;
+    Entry entry;
+    while (index >> keyword >> entry.page >> entry.rect.left >> entry.rect.top
+                 >> entry.rect.width >> entry.rect.height) {
+        std::string file;
+        std::getline(index >> std::ws, file);
+        if (keyword != "entry" || entry.page >= pageCount || file.empty()) {
+            return false;
+        }
+        cachedEntries[file] = entry;
+    }
+
+    pages = std::move(cachedPages);
+    entries = std::move(cachedEntries);
+    return true;
+}
+
+bool TextureAtlas::saveCache(const std::string& cacheDir, const std::string& indexFile, std::uint64_t hash) const {
+    std::error_code error;
+    std::filesystem::create_directories(cacheDir, error);
+    for (std::size_t page = 0; page < pageImages.size(); ++page) {
+        if (!pageImages[page].saveToFile(pageFile(cacheDir, hash, page))) {
+            return false;
+        }
+    }
+
+    // Индекс пишется последним: без него неполный кэш не будет прочитан
+    std::ofstream index(indexFile);
+    index << "pages " << pageImages.size() << "\n";
+    for (const auto& item : entries) {
+        const Entry& entry = item.second;
+        index << "entry " << entry.page << " " << entry.rect.left << " " << entry.rect.top << " "
+              << entry.rect.width << " " << entry.rect.height << " " << item.first << "\n";
+    }
+    return static_cast<bool>(index);
+}
+
+const TextureAtlas::Entry* TextureAtlas::find(const std::string& key) const {
+    auto it = entries.find(key);
+    return it != entries.end() ? &it->second : nullptr;
+}
+
+std::uint64_t TextureAtlas::hashFiles(const std::vector<std::string>& files) {
+    std::uint64_t hash = FNV_OFFSET;
+    std::vector<char> buffer(64 * 1024);
+    for (const auto& file : files) {
+        hashBytes(hash, file.c_str(), file.size() + 1);  // Вместе с завершающим нулем - граница между файлами
+
+        std::ifstream in(file, std::ios::binary);
+        while (in) {
+            in.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            hashBytes(hash, buffer.data(), static_cast<std::size_t>(in.gcount()));
+        }
+    }
+    return hash;
+}
@@ -0,0 +1,94 @@
+#include "ThreadPool.h"
+#include <algorithm>
+
+namespace {
+    // Порций на поток: мелкие порции выравнивают нагрузку, если элементы неравной сложности
+    const std::size_t CHUNKS_PER_THREAD = 8;
+}
+
+ThreadPool::ThreadPool(std::size_t threads)
+    : task(nullptr), count(0), chunk(1), next(0), generation(0), activeWorkers(0), stopping(false) {
+    if (threads == 0) {
+        unsigned int cores = std::thread::hardware_concurrency();
+        threads = cores > 1 ? cores - 1 : 0;
+    }
+    workers.reserve(threads);
+    for (std::size_t i = 0; i < threads; ++i) {
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+ThreadPool& ThreadPool::instance() {
+    static ThreadPool pool;
+    return pool;
+}
+
+void ThreadPool::runChunks() {
+    std::size_t begin;
+    while ((begin = next.fetch_add(chunk)) < count) {
+        std::size_t end = std::min(begin + chunk, count);
+        for (std::size_t i = begin; i < end; ++i) {
+            (*task)(i);
+        }
+    }
+}
+
+void ThreadPool::workerLoop() {
+    std::size_t seen = 0;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [this, seen]() { return stopping || generation != seen; });
+        if (stopping) {
+            return;
+        }
+        seen = generation;
+
+        lock.unlock();
+        runChunks();
+        lock.lock();
+
+        if (--activeWorkers == 0) {
+            done.notify_one();
+        }
+    }
+}
+
+void ThreadPool::parallelFor(std::size_t count, const std::function<void(std::size_t)>& task) {
+    std::lock_guard<std::mutex> run(runMutex);
+
+    // Несколько элементов быстрее обработать самим, чем будить потоки
+    if (workers.empty() || count < 2) {
+        for (std::size_t i = 0; i < count; ++i) {
+            task(i);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        this->task = &task;
+        this->count = count;
+        chunk = std::max<std::size_t>(1, count / (getThreadCount() * CHUNKS_PER_THREAD));
+        next = 0;
+        activeWorkers = workers.size();
+        ++generation;
+    }
+    wake.notify_all();
+
+    runChunks();
+
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [this]() { return activeWorkers == 0; });
+    this->task = nullptr;
+}
@@ -0,0 +1,206 @@
+#include "TimeSeriesCodec.h"
+#include <algorithm>
+#include <cstring>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace {
+
+std::uint64_t toBits(double value) {
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+double fromBits(std::uint64_t bits) {
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// x != 0
+unsigned leadingZeros(std::uint64_t x) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanReverse64(&index, x);
+    return 63 - index;
+#else
+    return static_cast<unsigned>(__builtin_clzll(x));
+#endif
+}
+
+unsigned trailingZeros(std::uint64_t x) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, x);
+    return index;
+#else
+    return static_cast<unsigned>(__builtin_ctzll(x));
+#endif
+}
+
+// Знаковая разность в беззнаковую: малые по модулю значения - малые числа
+std::uint64_t zigzag(std::int64_t value) {
+    return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+}
+
+std::int64_t unzigzag(std::uint64_t value) {
+    return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+}
+
+class BitReader {
+public:
+    explicit BitReader(const std::uint64_t* words) : words(words), position(0) {}
+
+    // 1 <= count <= 64; за последним записанным битом слово не читается
+    std::uint64_t read(unsigned count) {
+        std::size_t word = position >> 6;
+        unsigned offset = static_cast<unsigned>(position & 63);
+        position += count;
+
+        std::uint64_t head = words[word] << offset;
+        unsigned available = 64 - offset;
+        if (count <= available) {
+            return count == 64 ? head : head >> (64 - count);
+        }
+        unsigned rest = count - available;
+        return (head >> (64 - count)) | (words[word + 1] >> (64 - rest));
+    }
+
+private:
+    const std::uint64_t* words;
+    std::size_t position;
+};
+
+std::int64_t readTimeDelta(BitReader& reader) {
+    static const unsigned WIDTHS[] = {8, 24, 40, 64};
+    unsigned prefix = 0;
+    while (prefix < 4 && reader.read(1) != 0) {
+        ++prefix;
+    }
+    if (prefix == 0) {
+        return 0;
+    }
+    return unzigzag(reader.read(WIDTHS[prefix - 1]));
+}
+
+} // namespace
+
+TimeSeriesEncoder::TimeSeriesEncoder() {
+    reset();
+}
+
+void TimeSeriesEncoder::reset() {
+    bits = 0;
+    samples = 0;
+    previousTime = 0;
+    previousDelta = 0;
+    previousValue = 0;
+    windowLeading = 0;
+    windowTrailing = 0;
+    hasWindow = false;
+}
+
+void TimeSeriesEncoder::write(std::vector<std::uint64_t>& words, std::uint64_t value, unsigned count) {
+    // value содержит только младшие count битов, 1 <= count <= 64
+    unsigned used = static_cast<unsigned>(bits & 63);
+    if (used == 0) {
+        words.push_back(0);
+    }
+    unsigned free = 64 - used;
+    if (count <= free) {
+        words.back() |= value << (free - count);
+    } else {
+        unsigned rest = count - free;
+        words.back() |= value >> rest;
+        words.push_back(value << (64 - rest));
+    }
+    bits += count;
+}
+
+void TimeSeriesEncoder::add(std::vector<std::uint64_t>& words, double value, std::int64_t time) {
+    std::uint64_t current = toBits(value);
+    if (samples++ == 0) {
+        // Первое значение целиком, его отметка хранится у вызывающего
+        write(words, current, 64);
+        previousTime = time;
+        previousValue = current;
+        return;
+    }
+
+    // Разность разностей отметок: 0, 10 + 8 бит, 110 + 24 бита, 1110 + 40 бит, 1111 + 64 бита
+    std::int64_t delta = time - previousTime;
+    std::uint64_t z = zigzag(delta - previousDelta);
+    previousTime = time;
+    previousDelta = delta;
+    if (z == 0) {
+        write(words, 0, 1);
+    } else if (z < (1ull << 8)) {
+        write(words, 0b10, 2);
+        write(words, z, 8);
+    } else if (z < (1ull << 24)) {
+        write(words, 0b110, 3);
+        write(words, z, 24);
+    } else if (z < (1ull << 40)) {
+        write(words, 0b1110, 4);
+        write(words, z, 40);
+    } else {
+        write(words, 0b1111, 4);
+        write(words, z, 64);
+    }
+
+    // XOR с предыдущим значением:
+    // 0 - значение не изменилось,
+    // 10 - отличающиеся биты укладываются в окно предыдущего значения,
+    // 11 - новое окно: 5 бит ведущих нулей, 6 бит длины, значимые биты
+    std::uint64_t x = current ^ previousValue;
+    previousValue = current;
+    if (x == 0) {
+        write(words, 0, 1);
+        return;
+    }
+    unsigned leading = std::min(leadingZeros(x), 31u);
+    unsigned trailing = trailingZeros(x);
+    if (hasWindow && leading >= windowLeading && trailing >= windowTrailing) {
+        write(words, 0b10, 2);
+        write(words, x >> windowTrailing, 64 - windowLeading - windowTrailing);
+    } else {
+        unsigned significant = 64 - leading - trailing;
+        write(words, 0b11, 2);
+        write(words, leading, 5);
+        write(words, significant - 1, 6);
+        write(words, x >> trailing, significant);
+        windowLeading = leading;
+        windowTrailing = trailing;
+        hasWindow = true;
+    }
+}
+
+void decodeTimeSeries(const std::uint64_t* words, std::size_t count, std::int64_t firstTime,
+                      double* values, std::int64_t* times) {
+    if (count == 0) {
+        return;
+    }
+    BitReader reader(words);
+    std::uint64_t previous = reader.read(64);
+    values[0] = fromBits(previous);
+    times[0] = firstTime;
+    std::int64_t delta = 0;
+    unsigned windowLeading = 0, windowTrailing = 0;
+
+    for (std::size_t i = 1; i < count; ++i) {
+        delta += readTimeDelta(reader);
+        times[i] = times[i - 1] + delta;
+        if (reader.read(1) != 0) {
+            if (reader.read(1) != 0) {
+                windowLeading = static_cast<unsigned>(reader.read(5));
+                unsigned significant = static_cast<unsigned>(reader.read(6)) + 1;
+                windowTrailing = 64 - windowLeading - significant;
+            }
+            previous ^= reader.read(64 - windowLeading - windowTrailing) << windowTrailing;
+        }
+        values[i] = fromBits(previous);
+    }
+}
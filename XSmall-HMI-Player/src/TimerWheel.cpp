@@ -0,0 +1,112 @@
+#include "TimerWheel.h"
+#include <algorithm>
+
+TimerWheel::TimerWheel(std::chrono::milliseconds resolution, std::size_t slotCount)
+    : resolution(std::max(resolution, std::chrono::milliseconds(1))),
+      slots(std::max<std::size_t>(slotCount, 1)),
+      currentTick(0), remainder(Duration::zero()),
+      nextId(1), timerCount(0),
+      firingId(INVALID_TIMER), firingCancelled(false) {}
+
+std::uint64_t TimerWheel::toTicks(Duration duration) const {
+    // Округляем вверх: таймер не должен сработать раньше срока
+    auto res = std::chrono::duration_cast<Duration>(resolution);
+    std::uint64_t ticks = static_cast<std::uint64_t>((duration + res - Duration(1)) / res);
+    return std::max<std::uint64_t>(ticks, 1);
+}
+
+TimerWheel::TimerId TimerWheel::scheduleEvery(Duration interval, Callback callback) {
+    return schedule(interval, toTicks(interval), std::move(callback));
+}
+
+TimerWheel::TimerId TimerWheel::scheduleOnce(Duration delay, Callback callback) {
+    return schedule(delay, 0, std::move(callback));
+}
+
+TimerWheel::TimerId TimerWheel::schedule(Duration delay, std::uint64_t intervalTicks, Callback callback) {
+    Timer timer;
+    timer.id = nextId++;
+    timer.expiry = currentTick + toTicks(delay);
+    timer.interval = intervalTicks;
+    timer.callback = std::move(callback);
+
+    TimerId id = timer.id;
+    insert(std::move(timer));
+    ++timerCount;
+    return id;
+}
+
+void TimerWheel::insert(Timer timer) {
+    slots[timer.expiry % slots.size()].push_back(std::move(timer));
+}
+
+void TimerWheel::cancel(TimerId id) {
+    if (id == INVALID_TIMER) {
+        return;
+    }
+
+    if (id == firingId) {
+        firingCancelled = true;
+        return;
+    }
+
+    for (auto& slot : slots) {
+        auto it = std::find_if(slot.begin(), slot.end(), [id](const Timer& t) { return t.id == id; });
+        if (it != slot.end()) {
+            slot.erase(it);
+            --timerCount;
+            return;
+        }
+    }
+}
+
+std::size_t TimerWheel::advance(Duration elapsed) {
+    remainder += elapsed;
+    auto res = std::chrono::duration_cast<Duration>(resolution);
+    std::uint64_t ticks = static_cast<std::uint64_t>(remainder / res);
+    remainder -= res * static_cast<Duration::rep>(ticks);
+
+    std::uint64_t targetTick = currentTick + ticks;
+    std::size_t fired = 0;
+
+    // После долгой паузы достаточно одного оборота колеса: остальные такты
+    // не содержат ничего, что не попало бы в эти слоты
+    if (ticks > slots.size()) {
+        currentTick = targetTick - slots.size();
+    }
+
+    while (currentTick < targetTick) {
+        ++currentTick;
+
+        // Забираем слот целиком: обработчики могут добавлять таймеры в этот же слот
+        std::vector<Timer> pending;
+        pending.swap(slots[currentTick % slots.size()]);
+
+        for (auto& timer : pending) {
+            if (timer.expiry > targetTick) {
+                // Срок на следующих оборотах колеса
+                insert(std::move(timer));
+                continue;
+            }
+
+            firingId = timer.id;
+            firingCancelled = false;
+            timer.callback();
+            ++fired;
+            firingId = INVALID_TIMER;
+
+            if (timer.interval == 0 || firingCancelled) {
+                --timerCount;
+                continue;
+            }
+
+            // Следующий срок - не раньше следующего такта после текущего продвижения
+            timer.expiry += timer.interval;
+            if (timer.expiry <= targetTick) {
+                timer.expiry = targetTick + 1;
+            }
+            insert(std::move(timer));
+        }
+    }
+    return fired;
+}
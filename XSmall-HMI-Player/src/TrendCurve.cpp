@@ -0,0 +1,496 @@
+#include "TrendCurve.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Отметка истории в секундах часов (double: точность до наносекунд на месяцы работы)
+double toSeconds(HistoryClock::time_point time) {
+    return std::chrono::duration<double>(time.time_since_epoch()).count();
+}
+
+} // namespace
+
+TrendCurve::TrendCurve()
+    : window(2), columns(1), blockSize(0), span(0), originTime(0), held(0),
+      pending(false), pendingValue(0),
+      start(0), originIndex(0), valueBase(0),
+      firstIndex(0), count(0), minValue(0), maxValue(0), syncedTotal(0), stale(true),
+      color(sf::Color::Blue), blockBase(0), mirror(2), mirroredTotal(0) {}
+
+void TrendCurve::configure(std::size_t newWindow, std::size_t newColumns) {
+    newWindow = std::max<std::size_t>(newWindow, 2);
+    newColumns = std::max<std::size_t>(newColumns, 1);
+    if (newWindow == window && newColumns == columns && !isTimeAxis()) {
+        return;
+    }
+    window = newWindow;
+    columns = newColumns;
+    span = HistoryClock::duration::zero();
+
+    // До 4 значений на пиксель прореживание ничего не дает: M4 оставляет те же 4 точки.
+    // Блок ~sqrt(значений на столбец) уравнивает просмотр блоков и неполных краев столбца
+    if (window > 4 * columns) {
+        double perColumn = static_cast<double>(window) / columns;
+        blockSize = std::max<std::size_t>(static_cast<std::size_t>(std::sqrt(perColumn / 2)), 1);
+    } else {
+        blockSize = 0;
+    }
+    stale = true;
+}
+
+void TrendCurve::configureTime(HistoryClock::duration newSpan, std::size_t newColumns) {
+    newColumns = std::max<std::size_t>(newColumns, 1);
+    if (newSpan <= HistoryClock::duration::zero() || (newSpan == span && newColumns == columns)) {
+        return;
+    }
+    span = newSpan;
+    columns = newColumns;
+    blockSize = 0;  // Выбирается по числу значений в окне при синхронизации
+    stale = true;
+}
+
+void TrendCurve::setColor(const sf::Color& newColor) {
+    color = newColor;
+    for (auto& vertex : vertices) {
+        vertex.color = color;
+    }
+}
+
+void TrendCurve::setPending(HistoryClock::time_point time, double value) {
+    pending = true;
+    pendingTime = time;
+    pendingValue = value;
+}
+
+void TrendCurve::clearPending() {
+    pending = false;
+}
+
+void TrendCurve::sync(const HistoryView& fullHistory, std::uint64_t total) {
+    if (!stale && total == syncedTotal) {
+        return;  // Новых значений нет - кривая не меняется
+    }
+
+    HistoryView history = fullHistory.last(window);
+    std::uint64_t fresh = total - syncedTotal;
+    if (stale || total < syncedTotal || fresh >= history.size()) {
+        // Все окно новое - строим заново
+        rebuild(history, total);
+    } else {
+        // Дописываем только новые значения (они в конце истории)
+        std::size_t offset = history.size() - static_cast<std::size_t>(fresh);
+        for (std::size_t i = offset; i < history.size(); ++i) {
+            append(total - history.size() + i, history[i], history.time(i));
+        }
+        syncedTotal = total;
+        slide(total, history.size());
+    }
+
+    if (isDecimated()) {
+        decimate(history);
+    }
+}
+
+void TrendCurve::sync(const HistoryView& fullHistory, std::uint64_t total, HistoryClock::time_point now) {
+    if (!isTimeAxis()) {
+        sync(fullHistory, total);
+        return;
+    }
+    vertices.resize(vertices.size() - held);
+    held = 0;
+
+    // Значения окна и одно значение перед ним - двоичным поиском по отметкам
+    std::size_t from = fullHistory.lowerBound(now - span);
+    HistoryView history = fullHistory.last(fullHistory.size() - (from > 0 ? from - 1 : 0));
+    std::uint64_t first = total - history.size();
+    windowEnd = now;
+
+    selectDecimation(history.size());
+    std::uint64_t fresh = total - syncedTotal;
+    bool changed = stale || fresh > 0 || first != firstIndex;
+    if (stale || total < syncedTotal || first < firstIndex || fresh >= history.size()) {
+        rebuild(history, total);
+    } else if (changed) {
+        // Новые значения дописываются, вышедшие за левый край отбрасываются
+        std::size_t offset = history.size() - static_cast<std::size_t>(fresh);
+        for (std::size_t i = offset; i < history.size(); ++i) {
+            append(total - history.size() + i, history[i], history.time(i));
+        }
+        syncedTotal = total;
+        slide(total, history.size());
+    }
+
+    // Без новых значений столбцы прореживания сдвигаются вместе с окном - пересобираем,
+    // когда окно сдвинулось на ширину столбца
+    if (isDecimated() && (changed || now - decimatedEnd >= span / static_cast<HistoryClock::duration::rep>(columns))) {
+        decimate(history);
+        decimatedEnd = now;
+    }
+    clipEntry(history);
+    holdLast(history);
+}
+
+void TrendCurve::sync(const CompressedHistory& history) {
+    std::uint64_t total = history.total();
+    if (!stale && total == syncedTotal) {
+        return;
+    }
+
+    // Окно изменилось или история начата заново - копию окна собираем с нуля
+    std::uint64_t windowStart = total - std::min<std::uint64_t>(total, window);
+    std::uint64_t from = std::max(windowStart, history.firstIndex());
+    if (mirror.capacity() != window || total < mirroredTotal || from > mirroredTotal) {
+        mirror = HistoryBuffer(window);
+    } else {
+        from = mirroredTotal;
+    }
+    mirrorFrom(history, from);
+    sync(mirror.view(), total);
+}
+
+void TrendCurve::sync(const CompressedHistory& history, HistoryClock::time_point now) {
+    if (!isTimeAxis()) {
+        sync(history);
+        return;
+    }
+
+    // Копия держит окно по времени и значение перед ним; емкость - с запасом вдвое,
+    // чтобы копия не собиралась заново при каждом росте числа значений в окне
+    std::uint64_t total = history.total();
+    std::uint64_t from = history.lowerBound(now - span);
+    if (from > history.firstIndex()) {
+        --from;
+    }
+    std::size_t visible = static_cast<std::size_t>(total - from);
+    std::uint64_t mirrorStart = mirroredTotal - mirror.size();
+    if (mirror.capacity() < visible || total < mirroredTotal || from > mirroredTotal || from < mirrorStart) {
+        mirror = HistoryBuffer(std::max<std::size_t>(2 * visible, 2));
+    } else {
+        from = mirroredTotal;
+    }
+    mirrorFrom(history, from);
+    sync(mirror.view(), total, now);
+}
+
+void TrendCurve::mirrorFrom(const CompressedHistory& history, std::uint64_t from) {
+    for (CompressedHistory::Cursor cursor(history, from); cursor.next();) {
+        for (std::size_t i = 0; i < cursor.size(); ++i) {
+            mirror.push(cursor.data()[i], cursor.times()[i]);
+        }
+    }
+    mirroredTotal = history.total();
+}
+
+void TrendCurve::rebuild(const HistoryView& history, std::uint64_t total) {
+    vertices.clear();
+    start = 0;
+    held = 0;
+    minQueue.clear();
+    maxQueue.clear();
+    blocks.clear();
+
+    firstIndex = total - history.size();
+    count = history.size();
+    originIndex = firstIndex;
+    originTime = history.empty() ? 0.0 : toSeconds(history.time(0));
+    blockBase = isDecimated() ? firstIndex / blockSize : 0;
+    valueBase = history.empty() ? 0.0 : history.front();
+    for (std::size_t i = 0; i < history.size(); ++i) {
+        append(firstIndex + i, history[i], history.time(i));
+    }
+    if (!minQueue.empty()) {
+        minValue = minQueue.front().value;
+        maxValue = maxQueue.front().value;
+    }
+    syncedTotal = total;
+    stale = false;
+}
+
+float TrendCurve::positionX(std::uint64_t index, HistoryClock::time_point time) const {
+    if (isTimeAxis()) {
+        return static_cast<float>(toSeconds(time) - originTime);
+    }
+    return static_cast<float>(index - originIndex);
+}
+
+void TrendCurve::append(std::uint64_t index, double value, HistoryClock::time_point time) {
+    if (isDecimated()) {
+        appendToBlock(index, value);
+        return;
+    }
+
+    vertices.push_back(sf::Vertex(sf::Vector2f(positionX(index, time), static_cast<float>(value - valueBase)), color));
+
+    // Значения, которые уже никогда не станут максимумом (минимумом) окна, выбрасываем
+    while (!maxQueue.empty() && maxQueue.back().value <= value) {
+        maxQueue.pop_back();
+    }
+    maxQueue.push_back({index, value});
+    while (!minQueue.empty() && minQueue.back().value >= value) {
+        minQueue.pop_back();
+    }
+    minQueue.push_back({index, value});
+}
+
+void TrendCurve::slide(std::uint64_t total, std::size_t size) {
+    firstIndex = total - size;
+    count = size;
+
+    if (isDecimated()) {
+        // Блоки, целиком вышедшие из окна, больше не нужны
+        while (!blocks.empty() && blockBase < firstIndex / blockSize) {
+            blocks.pop_front();
+            ++blockBase;
+        }
+        return;
+    }
+
+    start = static_cast<std::size_t>(firstIndex - originIndex);
+    while (maxQueue.front().index < firstIndex) {
+        maxQueue.pop_front();
+    }
+    while (minQueue.front().index < firstIndex) {
+        minQueue.pop_front();
+    }
+    minValue = minQueue.front().value;
+    maxValue = maxQueue.front().value;
+
+    // Перед окном накопилось столько же вытесненных вершин, сколько в окне -
+    // сдвигаем, чтобы память не росла (в среднем O(1) на значение)
+    if (start >= vertices.size() - start) {
+        compact();
+    }
+}
+
+void TrendCurve::compact() {
+    // На оси времени x = 0 переносится на первую вершину окна
+    float shift = isTimeAxis() ? vertices[start].position.x : static_cast<float>(start);
+    vertices.erase(vertices.begin(), vertices.begin() + start);
+    for (auto& vertex : vertices) {
+        vertex.position.x -= shift;
+    }
+    originIndex += start;
+    originTime += shift;
+    start = 0;
+}
+
+void TrendCurve::appendToBlock(std::uint64_t index, double value) {
+    Point point{index, value};
+    if (blocks.empty() || index / blockSize >= blockBase + blocks.size()) {
+        blocks.push_back(Block{point, point});
+        return;
+    }
+
+    Block& block = blocks.back();
+    if (value < block.min.value) block.min = point;
+    if (value > block.max.value) block.max = point;
+}
+
+void TrendCurve::decimate(const HistoryView& history) {
+    vertices.clear();
+    start = 0;
+    held = 0;
+    originIndex = firstIndex;
+    if (count < 2) {
+        return;
+    }
+
+    bool first = true;
+    if (isTimeAxis()) {
+        // Столбец c - значения с отметками [начало окна + c * span / columns, начало следующего);
+        // значение перед окном попадает в первый столбец, границы - двоичным поиском
+        originTime = toSeconds(history.time(0));
+        HistoryClock::time_point windowStart = windowEnd - span;
+        std::uint64_t from = firstIndex;
+        for (std::size_t column = 0; column < columns; ++column) {
+            std::uint64_t to = firstIndex + count;
+            if (column + 1 < columns) {
+                auto offset = static_cast<HistoryClock::duration::rep>(
+                    static_cast<double>(span.count()) * (column + 1) / columns);
+                to = firstIndex + history.lowerBound(windowStart + HistoryClock::duration(offset));
+            }
+            if (from < to) {
+                decimateColumn(history, from, to, first);
+                from = to;
+            }
+        }
+        return;
+    }
+
+    // Значение r рисуется в x = r * columns / (count - 1): столбец c - значения
+    // с ceil(c * (count - 1) / columns) по начало следующего столбца (последний столбец - x = columns)
+    std::uint64_t steps = count - 1;
+    for (std::uint64_t column = 0; column <= columns; ++column) {
+        std::uint64_t from = (column * steps + columns - 1) / columns;
+        std::uint64_t to = std::min<std::uint64_t>(((column + 1) * steps + columns - 1) / columns, count);
+        if (from >= to) {
+            continue;  // Значений уже меньше, чем пикселей
+        }
+        decimateColumn(history, firstIndex + from, firstIndex + to, first);
+    }
+}
+
+void TrendCurve::decimateColumn(const HistoryView& history, std::uint64_t from, std::uint64_t to, bool& first) {
+    // Минимум и максимум отрезка [from, to) поэлементно и по готовым блокам
+    Point lo{}, hi{};
+    auto scan = [&](std::uint64_t begin, std::uint64_t end) {
+        for (std::uint64_t i = begin; i < end; ++i) {
+            double value = history[static_cast<std::size_t>(i - firstIndex)];
+            if (value < lo.value) lo = Point{i, value};
+            if (value > hi.value) hi = Point{i, value};
+        }
+    };
+    auto vertex = [&](const Point& point) {
+        HistoryClock::time_point time = history.time(static_cast<std::size_t>(point.index - firstIndex));
+        return sf::Vertex(sf::Vector2f(positionX(point.index, time),
+                                       static_cast<float>(point.value - valueBase)), color);
+    };
+
+    Point head{from, history[static_cast<std::size_t>(from - firstIndex)]};
+    Point tail{to - 1, history[static_cast<std::size_t>(to - 1 - firstIndex)]};
+    lo = head;
+    hi = head;
+    std::uint64_t fullBegin = (from + blockSize - 1) / blockSize;
+    std::uint64_t fullEnd = to / blockSize;
+    if (fullBegin >= fullEnd) {
+        scan(from, to);
+    } else {
+        scan(from, fullBegin * blockSize);
+        for (std::uint64_t b = fullBegin; b < fullEnd; ++b) {
+            const Block& block = blocks[static_cast<std::size_t>(b - blockBase)];
+            if (block.min.value < lo.value) lo = block.min;
+            if (block.max.value > hi.value) hi = block.max;
+        }
+        scan(fullEnd * blockSize, to);
+    }
+
+    if (first) {
+        minValue = lo.value;
+        maxValue = hi.value;
+        first = false;
+    } else {
+        minValue = std::min(minValue, lo.value);
+        maxValue = std::max(maxValue, hi.value);
+    }
+
+    // Первое, экстремумы в порядке появления, последнее - без повторов
+    const Point* ordered[4] = {&head, lo.index <= hi.index ? &lo : &hi,
+                               lo.index <= hi.index ? &hi : &lo, &tail};
+    std::uint64_t lastIndex = 0;
+    for (const Point* point : ordered) {
+        if (point == &head || point->index != lastIndex) {
+            vertices.push_back(vertex(*point));
+            lastIndex = point->index;
+        }
+    }
+}
+
+void TrendCurve::selectDecimation(std::size_t samples) {
+    // Порог с запасом вдвое: окно на границе порога не перестраивается каждый кадр.
+    // Размер блока меняется, только когда отличается от нужного больше чем вдвое
+    bool decimated = samples > 4 * columns || (isDecimated() && samples > 2 * columns);
+    std::size_t wanted = 0;
+    if (decimated) {
+        double perColumn = static_cast<double>(samples) / columns;
+        wanted = std::max<std::size_t>(static_cast<std::size_t>(std::sqrt(perColumn / 2)), 1);
+    }
+    if (decimated != isDecimated() || (decimated && (wanted > 2 * blockSize || 2 * wanted < blockSize))) {
+        blockSize = wanted;
+        stale = true;
+    }
+}
+
+void TrendCurve::clipEntry(const HistoryView& history) {
+    HistoryClock::time_point windowStart = windowEnd - span;
+    if (history.empty() || getVertexCount() == 0 || !(history.time(0) < windowStart)) {
+        return;
+    }
+
+    // Вершина значения перед окном - точка линии на левом краю
+    double value = history[0];
+    if (history.size() > 1) {
+        double t0 = toSeconds(history.time(0));
+        double t1 = toSeconds(history.time(1));
+        if (t1 > t0) {
+            value += (history[1] - history[0]) * (toSeconds(windowStart) - t0) / (t1 - t0);
+        }
+    }
+    vertices[start].position = sf::Vector2f(static_cast<float>(toSeconds(windowStart) - originTime),
+                                            static_cast<float>(value - valueBase));
+}
+
+void TrendCurve::holdLast(const HistoryView& history) {
+    if (history.empty() || getVertexCount() == 0) {
+        return;
+    }
+    HistoryClock::time_point lastTime = history.time(history.size() - 1);
+    double lastValue = history.back();
+    if (pending && !(pendingTime < lastTime)) {
+        // Несохраненное значение продолжает линию и удерживается вместо последнего сохраненного
+        lastTime = std::min(pendingTime, windowEnd);
+        lastValue = pendingValue;
+        vertices.push_back(sf::Vertex(sf::Vector2f(static_cast<float>(toSeconds(lastTime) - originTime),
+                                                   static_cast<float>(lastValue - valueBase)), color));
+        ++held;
+    }
+    if (lastTime < windowEnd) {
+        vertices.push_back(sf::Vertex(sf::Vector2f(static_cast<float>(toSeconds(windowEnd) - originTime),
+                                                   static_cast<float>(lastValue - valueBase)), color));
+        ++held;
+    }
+}
+
+sf::Transform TrendCurve::getTransform(const sf::FloatRect& area) const {
+    sf::Transform transform;
+    if (count < (isTimeAxis() ? 1u : 2u)) {
+        return transform;
+    }
+
+    // Несохраненное значение на кривой входит в диапазон
+    double low = minValue;
+    double high = maxValue;
+    if (pending && held > 0) {
+        low = std::min(low, pendingValue);
+        high = std::max(high, pendingValue);
+    }
+    float range = static_cast<float>(high - low);
+    if (range == 0) range = 1;  // Избегаем деления на ноль
+
+    if (isTimeAxis()) {
+        // Экран: left + (секунды - начало окна) / span * width
+        double seconds = std::chrono::duration<double>(span).count();
+        transform.translate(area.left, area.top + area.height);
+        transform.scale(static_cast<float>(area.width / seconds), -area.height / range);
+        transform.translate(-static_cast<float>(toSeconds(windowEnd) - seconds - originTime),
+                            -static_cast<float>(low - valueBase));
+        return transform;
+    }
+
+    // Экран: left + (номер - первый) * шаг, bottom - (значение - минимум) / range * height
+    float xStep = area.width / (count - 1);
+    transform.translate(area.left, area.top + area.height);
+    transform.scale(xStep, -area.height / range);
+    transform.translate(-static_cast<float>(firstIndex - originIndex),
+                        -static_cast<float>(low - valueBase));
+    return transform;
+}
+
+void TrendCurve::draw(sf::RenderTarget& target, const sf::FloatRect& area) const {
+    if (isDrawable()) {
+        // Вершины не пересчитываются: масштаб и сдвиг окна задает преобразование
+        target.draw(getVertices(), getVertexCount(), sf::LineStrip, sf::RenderStates(getTransform(area)));
+    }
+}
+
+std::vector<sf::Vector2f> TrendCurve::getScreenPoints(const sf::FloatRect& area) const {
+    std::vector<sf::Vector2f> points;
+    if (isDrawable()) {
+        sf::Transform transform = getTransform(area);
+        points.reserve(getVertexCount());
+        for (std::size_t i = start; i < vertices.size(); ++i) {
+            points.push_back(transform.transformPoint(vertices[i].position));
+        }
+    }
+    return points;
+}
@@ -1,65 +1,653 @@
 #include "VariableDatabase.h"
 #include "logger.h"
-#include <iostream>
+#include <mutex>
+#include <algorithm>
+#include <cmath>
 
-VariableDatabase::VariableDatabase() {
+VariableDatabase::VariableDatabase()
+    : slotChunks(std::make_unique<std::unique_ptr<TagSlot[]>[]>(MAX_SLOT_CHUNKS)),
+      slotCount(0),
+      queueHead(&queueStub), queueTail(&queueStub),
+      defaultHistoryCapacity(DEFAULT_HISTORY_CAPACITY),
+      notifyMode(NotifyMode::Immediate), revision(0) {
     initializeDemoVariables();
 }
 
-void VariableDatabase::setVariable(const std::string& name, double value) {
-    double oldValue = variables[name]; // Сохраняем старое значение для возможного отката
-    
-    // Обновляем текущее значение
-    variables[name] = value;
-    
-    // Добавляем в историю изменений (для графиков)
-    addToHistory(name, value);
-    
-    // Уведомляем всех подписчиков об изменениях
-    if (subscribers.find(name) != subscribers.end()) {
-        for (auto& callback : subscribers[name]) {
-            callback(value);
+TagId VariableDatabase::resolveTag(const std::string& name) {
+    {
+        std::shared_lock<std::shared_mutex> lock(namesMutex);
+        auto it = tagIds.find(name);
+        if (it != tagIds.end()) {
+            return it->second;
         }
     }
-    
-    // Логируем изменения для отладки
-    Logger::info("Variable '" + name + "' set to: " + std::to_string(value));
+
+    std::unique_lock<std::shared_mutex> lock(namesMutex);
+    auto it = tagIds.find(name);
+    if (it != tagIds.end()) {
+        return it->second; // Другой поток успел зарегистрировать переменную
+    }
+
+    TagId tag = slotCount.load(std::memory_order_relaxed);
+    std::size_t chunk = tag / SLOT_CHUNK_SIZE;
+    if (chunk >= MAX_SLOT_CHUNKS) {
+        LOG_ERROR_RATE_LIMITED(1.0, "Too many variables, cannot register: " + name);
+        return INVALID_TAG;
+    }
+    if (!slotChunks[chunk]) {
+        slotChunks[chunk] = std::make_unique<TagSlot[]>(SLOT_CHUNK_SIZE);
+    }
+
+    // Заполняем слот до публикации: читатели увидят его только после увеличения slotCount
+    TagSlot& newSlot = slot(tag);
+    newSlot.name = name;
+    newSlot.node.tag = tag;
+    tagIds.emplace(name, tag);
+    slotCount.store(tag + 1, std::memory_order_release);
+    return tag;
 }
 
-double VariableDatabase::getVariable(const std::string& name) const {
-    auto it = variables.find(name);
-    if (it != variables.end()) {
-        return it->second;
+TagId VariableDatabase::findTag(const std::string& name) const {
+    std::shared_lock<std::shared_mutex> lock(namesMutex);
+    auto it = tagIds.find(name);
+    return it != tagIds.end() ? it->second : INVALID_TAG;
+}
+
+const std::string& VariableDatabase::getTagName(TagId tag) const {
+    static const std::string emptyName;
+    return isValid(tag) ? slot(tag).name : emptyName;
+}
+
+void VariableDatabase::set(TagId tag, double value, WriteSource source) {
+    if (!isValid(tag)) {
+        return;
+    }
+
+    TagSlot& s = slot(tag);
+    if (source == WriteSource::Operator) {
+        if (operatorWriteHandler) {
+            operatorWriteHandler(tag, value);
+        }
+        // Ввод оператора всегда доходит до экрана, даже в пределах зоны нечувствительности
+        if (s.filter) {
+            s.filter->force = true;
+        }
+    }
+
+    if (notifyMode == NotifyMode::Deferred) {
+        // Только помечаем переменную измененной - уведомление уйдет раз в кадр
+        post(tag, value);
+    } else {
+        // Обновляем текущее значение и сразу уведомляем подписчиков
+        s.value.store(value, std::memory_order_release);
+        s.assigned.store(true, std::memory_order_release);
+        notify(tag, value);
+    }
+
+    // Логируем изменения для отладки (строка формируется только при включенном DEBUG)
+    LOG_DEBUG("Variable '" + s.name + "' set to: " + std::to_string(value));
+}
+
+double VariableDatabase::get(TagId tag) const {
+    // 0 для несуществующих переменных
+    return isValid(tag) ? slot(tag).value.load(std::memory_order_acquire) : 0.0;
+}
+
+void VariableDatabase::notify(TagId tag, double value) {
+    TagSlot& s = slot(tag);
+
+    // Изменение в пределах зоны нечувствительности: значение уже обновлено, но ни подписчики,
+    // ни история его не получают
+    if (s.filter && !s.filter->accept(value)) {
+        return;
+    }
+    ++revision;
+
+    // Добавляем в историю изменений, если она ведется. Передискретизируемая переменная
+    // попадает в историю по расписанию из sampleHistory(), а не при каждой записи
+    if (s.history && s.history->samplePeriod == HistoryClock::duration::zero()) {
+        recordHistory(*s.history, value, HistoryClock::now());
+    }
+
+    // Уведомляем всех подписчиков об изменениях.
+    // Индексируем заново на каждой итерации: callback может подписать новый обработчик
+    for (size_t i = 0; i < s.subscribers.size(); ++i) {
+        s.subscribers[i].callback(value);
+    }
+}
+
+bool VariableDatabase::NotifyFilter::accept(double value) {
+    if (notified && !force) {
+        double scale = deadband.span > 0.0 ? deadband.span : std::abs(lastNotified);
+        double threshold = std::max(deadband.absolute, deadband.percent / 100.0 * scale);
+        if (std::abs(value - lastNotified) < threshold) {
+            return false;
+        }
     }
-    return 0.0; // Возвращаем 0 для несуществующих переменных
+    lastNotified = value;
+    notified = true;
+    force = false;
+    return true;
+}
+
+void VariableDatabase::setNotifyDeadband(TagId tag, const NotifyDeadband& deadband) {
+    if (!isValid(tag)) {
+        return;
+    }
+    TagSlot& s = slot(tag);
+    if (deadband.absolute <= 0.0 && deadband.percent <= 0.0) {
+        s.filter.reset();
+        return;
+    }
+    if (!s.filter) {
+        s.filter = std::make_unique<NotifyFilter>();
+    }
+    s.filter->deadband = deadband;
+}
+
+NotifyDeadband VariableDatabase::getNotifyDeadband(TagId tag) const {
+    return isValid(tag) && slot(tag).filter ? slot(tag).filter->deadband : NotifyDeadband();
+}
+
+void VariableDatabase::setVariable(const std::string& name, double value) {
+    set(resolveTag(name), value);
+}
+
+double VariableDatabase::getVariable(const std::string& name) const {
+    return get(findTag(name));
 }
 
 bool VariableDatabase::variableExists(const std::string& name) const {
-    return variables.find(name) != variables.end();
+    return hasValue(findTag(name));
+}
+
+bool VariableDatabase::hasValue(TagId tag) const {
+    return isValid(tag) && slot(tag).assigned.load(std::memory_order_acquire);
+}
+
+void VariableDatabase::post(TagId tag, double value) {
+    if (!isValid(tag)) {
+        return;
+    }
+
+    // Запись значения и проверка флага - seq_cst в паре с dispatchPending():
+    // если флаг уже стоит, доставка гарантированно прочитает это значение
+    TagSlot& s = slot(tag);
+    s.value.store(value, std::memory_order_seq_cst);
+    s.assigned.store(true, std::memory_order_release);
+
+    // Ставим переменную в очередь только один раз до ближайшей доставки
+    if (!s.queued.exchange(true, std::memory_order_seq_cst)) {
+        enqueueChange(&s.node);
+    }
+}
+
+void VariableDatabase::postVariable(const std::string& name, double value) {
+    post(resolveTag(name), value);
+}
+
+std::size_t VariableDatabase::dispatchPending() {
+    std::size_t dispatched = 0;
+    while (ChangeNode* node = dequeueChange()) {
+        TagSlot& s = slot(node->tag);
+
+        // Снимаем флаг до чтения значения: запись, пришедшая после чтения, снова попадет в очередь
+        s.queued.store(false, std::memory_order_seq_cst);
+        notify(node->tag, s.value.load(std::memory_order_seq_cst));
+        ++dispatched;
+    }
+    return dispatched;
+}
+
+void VariableDatabase::enqueueChange(ChangeNode* node) {
+    node->next.store(nullptr, std::memory_order_relaxed);
+    ChangeNode* prev = queueHead.exchange(node, std::memory_order_acq_rel);
+    prev->next.store(node, std::memory_order_release);
+}
+
+VariableDatabase::ChangeNode* VariableDatabase::dequeueChange() {
+    ChangeNode* tail = queueTail;
+    ChangeNode* next = tail->next.load(std::memory_order_acquire);
+
+    // Пропускаем служебный узел
+    if (tail == &queueStub) {
+        if (next == nullptr) {
+            return nullptr;
+        }
+        queueTail = next;
+        tail = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+
+    if (next != nullptr) {
+        queueTail = next;
+        return tail;
+    }
+
+    // tail - последний узел; если производитель еще не дописал ссылку, заберем его в следующий раз
+    if (tail != queueHead.load(std::memory_order_acquire)) {
+        return nullptr;
+    }
+
+    // Возвращаем служебный узел в очередь, чтобы отдать tail
+    enqueueChange(&queueStub);
+    next = tail->next.load(std::memory_order_acquire);
+    if (next != nullptr) {
+        queueTail = next;
+        return tail;
+    }
+    return nullptr;
+}
+
+VariableDatabase::TagHistory& VariableDatabase::history(TagId tag) {
+    TagSlot& s = slot(tag);
+    if (!s.history) {
+        s.history = std::make_unique<TagHistory>(tag, defaultHistoryCapacity.load(std::memory_order_relaxed));
+        historyTags.push_back(tag);
+    }
+    return *s.history;
+}
+
+const VariableDatabase::TagHistory* VariableDatabase::findHistory(TagId tag) const {
+    return isValid(tag) ? slot(tag).history.get() : nullptr;
+}
+
+void VariableDatabase::enableHistory(TagId tag) {
+    if (isValid(tag)) {
+        history(tag);
+    }
+}
+
+bool VariableDatabase::isHistoryEnabled(TagId tag) const {
+    return findHistory(tag) != nullptr;
+}
+
+void VariableDatabase::setHistoryPolicy(TagId tag, const HistoryPolicy& policy) {
+    if (!isValid(tag)) {
+        return;
+    }
+    TagHistory& h = history(tag);
+    h.policy.deadband = policy.deadband;
+    h.policy.persistent = policy.persistent;
+    h.policy.swingingDoor = policy.swingingDoor;
+    if (policy.swingingDoor > 0.0) {
+        if (!h.door) {
+            h.door = std::make_unique<SwingingDoor>();
+        }
+        h.door->setDeviation(policy.swingingDoor);
+    } else if (h.door) {
+        // Принятое, но не сохраненное значение не теряется
+        if (h.door->hasHeld()) {
+            commitHistory(h, h.door->getHeldValue(), h.door->getHeldTime());
+        }
+        h.door.reset();
+    }
+    if (policy.capacity > 0) {
+        requestHistoryCapacity(tag, policy.capacity);
+        h.policy.capacity = std::max(h.policy.capacity, policy.capacity);
+    }
+    setHistoryCompression(tag, policy.compressed);
+}
+
+HistoryPolicy VariableDatabase::getHistoryPolicy(TagId tag) const {
+    HistoryPolicy policy;
+    if (const TagHistory* h = findHistory(tag)) {
+        policy = h->policy;
+        policy.compressed = static_cast<bool>(h->compressed);
+    }
+    policy.capacity = getHistoryCapacity(tag);
+    return policy;
+}
+
+bool VariableDatabase::getPendingHistory(TagId tag, HistoryClock::time_point& time, double& value) const {
+    const TagHistory* h = findHistory(tag);
+    if (!h || !h->door || !h->door->hasHeld()) {
+        return false;
+    }
+    time = h->door->getHeldTime();
+    value = h->door->getHeldValue();
+    return true;
+}
+
+std::vector<TagId> VariableDatabase::getPersistentHistoryTags() const {
+    std::vector<TagId> tags;
+    for (TagId tag : historyTags) {
+        if (slot(tag).history->policy.persistent) {
+            tags.push_back(tag);
+        }
+    }
+    return tags;
+}
+
+void VariableDatabase::copyHistory(TagId tag, std::vector<double>& values,
+                                   std::vector<HistoryClock::time_point>& times) const {
+    values.clear();
+    times.clear();
+    const TagHistory* h = findHistory(tag);
+    if (!h) {
+        return;
+    }
+
+    if (h->compressed) {
+        values.reserve(h->compressed->size());
+        times.reserve(h->compressed->size());
+        for (CompressedHistory::Cursor cursor(*h->compressed, 0); cursor.next();) {
+            values.insert(values.end(), cursor.data(), cursor.data() + cursor.size());
+            times.insert(times.end(), cursor.times(), cursor.times() + cursor.size());
+        }
+    } else {
+        HistoryView view = h->buffer.view();
+        values.reserve(view.size() + 1);
+        times.reserve(view.size() + 1);
+        for (std::size_t i = 0; i < view.size(); ++i) {
+            values.push_back(view[i]);
+            times.push_back(view.time(i));
+        }
+    }
+
+    if (h->door && h->door->hasHeld()) {
+        values.push_back(h->door->getHeldValue());
+        times.push_back(h->door->getHeldTime());
+    }
+}
+
+void VariableDatabase::restoreHistory(TagId tag, const std::vector<double>& values,
+                                      const std::vector<HistoryClock::time_point>& times, bool persistent) {
+    if (!isValid(tag)) {
+        return;
+    }
+    TagHistory& h = history(tag);
+    h.policy.persistent = h.policy.persistent || persistent;
+    requestHistoryCapacity(tag, values.size());
+
+    // Нумерация продолжается с нуля: тренды построят кривую заново
+    if (h.door) {
+        h.door->reset();
+    }
+    if (h.compressed) {
+        h.compressed->clear();
+    } else {
+        h.buffer.clear();
+    }
+    std::size_t count = std::min(values.size(), times.size());
+    for (std::size_t i = 0; i < count; ++i) {
+        pushHistory(h, values[i], times[i]);
+    }
+    if (count > 0) {
+        h.lastRecorded = values[count - 1];
+        h.recorded = true;
+    }
+    ++revision;
+}
+
+std::size_t VariableDatabase::getHistoryMemoryUsage() const {
+    std::size_t bytes = historyTags.capacity() * sizeof(TagId);
+    for (TagId tag : historyTags) {
+        const TagHistory& h = *slot(tag).history;
+        bytes += sizeof(TagHistory) + h.buffer.memoryUsage();
+        if (h.compressed) {
+            bytes += sizeof(CompressedHistory) + h.compressed->memoryUsage();
+        }
+        if (h.rollup) {
+            bytes += sizeof(HistoryRollup) + h.rollup->memoryUsage();
+        }
+        if (h.door) {
+            bytes += sizeof(SwingingDoor);
+        }
+    }
+    return bytes;
+}
+
+void VariableDatabase::addToHistory(TagId tag, double value) {
+    if (isValid(tag)) {
+        addToHistory(tag, value, HistoryClock::now());
+    }
+}
+
+void VariableDatabase::addToHistory(TagId tag, double value, HistoryClock::time_point time) {
+    if (isValid(tag)) {
+        recordHistory(history(tag), value, time);
+        ++revision;
+    }
 }
 
 void VariableDatabase::addToHistory(const std::string& name, double value) {
-    // Ограничиваем историю 100 последними значениями 
-    historyVariables[name].push_back(value);
-    
-    if (historyVariables[name].size() > 100) {
-        historyVariables[name].erase(historyVariables[name].begin());
+    addToHistory(resolveTag(name), value);
+}
+
+HistoryView VariableDatabase::getHistory(TagId tag) const {
+    // Возвращаем пустое представление для несуществующей истории
+    const TagHistory* h = findHistory(tag);
+    return h ? h->buffer.view() : HistoryView();
+}
+
+HistoryView VariableDatabase::getHistory(const std::string& name) const {
+    return getHistory(findTag(name));
+}
+
+std::uint64_t VariableDatabase::getHistoryTotal(TagId tag) const {
+    const TagHistory* h = findHistory(tag);
+    if (!h) {
+        return 0;
     }
+    return h->compressed ? h->compressed->total() : h->buffer.total();
 }
 
-const std::vector<double>& VariableDatabase::getHistory(const std::string& name) const {
-    // Возвращаем пустой вектор для несуществующей истории
-    static std::vector<double> emptyHistory;
-    auto it = historyVariables.find(name);
-    if (it != historyVariables.end()) {
-        return it->second;
+void VariableDatabase::requestHistoryCapacity(TagId tag, std::size_t capacity) {
+    if (!isValid(tag)) {
+        return;
+    }
+    TagHistory& h = history(tag);
+    if (capacity > getHistoryCapacity(tag)) {
+        setHistoryCapacity(h, capacity);
     }
-    return emptyHistory;
 }
 
-void VariableDatabase::subscribe(const std::string& variable, std::function<void(double)> callback) {
+std::size_t VariableDatabase::getHistoryCapacity(TagId tag) const {
+    if (!isValid(tag)) {
+        return 0;
+    }
+    // Без истории - емкость, которую она получит при включении
+    const TagHistory* h = findHistory(tag);
+    if (!h) {
+        return defaultHistoryCapacity.load(std::memory_order_relaxed);
+    }
+    return h->compressed ? h->compressed->capacity() : h->buffer.capacity();
+}
+
+void VariableDatabase::setDefaultHistoryCapacity(std::size_t capacity) {
+    // Увеличиваем емкость уже включенных историй, новые получат ее при создании
+    for (TagId tag : historyTags) {
+        if (getHistoryCapacity(tag) < capacity) {
+            setHistoryCapacity(*slot(tag).history, capacity);
+        }
+    }
+    defaultHistoryCapacity.store(capacity, std::memory_order_relaxed);
+}
+
+void VariableDatabase::setHistoryCompression(TagId tag, bool enabled) {
+    if (!isValid(tag)) {
+        return;
+    }
+    TagHistory& h = history(tag);
+    if (enabled == static_cast<bool>(h.compressed)) {
+        return;
+    }
+
+    if (enabled) {
+        // Нумерация значений продолжается: тренды дописывают кривую, а не строят заново
+        HistoryView current = h.buffer.view();
+        auto compressed = std::make_unique<CompressedHistory>(h.buffer.capacity(),
+                                                              h.buffer.total() - current.size());
+        for (std::size_t i = 0; i < current.size(); ++i) {
+            compressed->push(current[i], current.time(i));
+        }
+        h.compressed = std::move(compressed);
+        h.buffer = HistoryBuffer(1);
+    } else {
+        HistoryBuffer restored(h.compressed->capacity());
+        std::uint64_t from = h.compressed->total() - std::min<std::uint64_t>(
+            h.compressed->size(), h.compressed->capacity());
+        for (CompressedHistory::Cursor cursor(*h.compressed, from); cursor.next();) {
+            for (std::size_t i = 0; i < cursor.size(); ++i) {
+                restored.push(cursor.data()[i], cursor.times()[i]);
+            }
+        }
+        h.buffer = std::move(restored);
+        h.compressed.reset();
+    }
+    ++revision;
+}
+
+const CompressedHistory* VariableDatabase::getCompressedHistory(TagId tag) const {
+    const TagHistory* h = findHistory(tag);
+    return h ? h->compressed.get() : nullptr;
+}
+
+void VariableDatabase::recordHistory(TagHistory& h, double value, HistoryClock::time_point time) {
+    // Зона нечувствительности: мелкие колебания около последнего записанного значения не пишутся
+    if (h.recorded && h.policy.deadband > 0.0 && std::abs(value - h.lastRecorded) < h.policy.deadband) {
+        return;
+    }
+    h.lastRecorded = value;
+    h.recorded = true;
+
+    // Swinging door сохраняет только точки излома; агрегаты получают каждое значение
+    if (h.rollup) {
+        h.rollup->add(time, value);
+    }
+    if (h.door) {
+        HistoryClock::time_point archivedTime;
+        double archivedValue = 0.0;
+        if (h.door->add(time, value, archivedTime, archivedValue)) {
+            commitHistory(h, archivedValue, archivedTime);
+        }
+        return;
+    }
+    commitHistory(h, value, time);
+}
+
+void VariableDatabase::pushHistory(TagHistory& h, double value, HistoryClock::time_point time) {
+    storeHistory(h, value, time);
+    if (h.rollup) {
+        h.rollup->add(time, value);
+    }
+}
+
+void VariableDatabase::storeHistory(TagHistory& h, double value, HistoryClock::time_point time) {
+    if (h.compressed) {
+        h.compressed->push(value, time);
+    } else {
+        h.buffer.push(value, time);
+    }
+}
+
+void VariableDatabase::commitHistory(TagHistory& h, double value, HistoryClock::time_point time) {
+    storeHistory(h, value, time);
+    if (historyArchiveHandler) {
+        historyArchiveHandler(h.tag, value, time);
+    }
+}
+
+void VariableDatabase::enableRollups(TagId tag) {
+    if (isValid(tag)) {
+        TagHistory& h = history(tag);
+        if (!h.rollup) {
+            h.rollup = std::make_unique<HistoryRollup>();
+        }
+    }
+}
+
+std::vector<HistoryAggregate> VariableDatabase::getAggregated(TagId tag, HistoryClock::time_point from,
+                                                              HistoryClock::time_point to, std::size_t buckets) const {
+    const TagHistory* h = findHistory(tag);
+    if (!h || !h->rollup) {
+        return std::vector<HistoryAggregate>(buckets);
+    }
+    return h->rollup->query(from, to, buckets);
+}
+
+void VariableDatabase::requestHistoryResampling(TagId tag, HistoryClock::duration period) {
+    if (!isValid(tag) || period <= HistoryClock::duration::zero()) {
+        return;
+    }
+    TagHistory& h = history(tag);
+    if (h.samplePeriod == HistoryClock::duration::zero()) {
+        resampledTags.push_back(tag);
+        h.nextSample = HistoryClock::now();
+        h.samplePeriod = period;
+    } else {
+        h.samplePeriod = std::min(h.samplePeriod, period);
+    }
+}
+
+HistoryClock::duration VariableDatabase::getHistoryResampling(TagId tag) const {
+    const TagHistory* h = findHistory(tag);
+    return h ? h->samplePeriod : HistoryClock::duration::zero();
+}
+
+std::size_t VariableDatabase::sampleHistory(HistoryClock::time_point now) {
+    std::size_t samples = 0;
+    for (TagId tag : resampledTags) {
+        TagSlot& s = slot(tag);
+        TagHistory& h = *s.history;
+        if (!s.assigned.load(std::memory_order_acquire)) {
+            // Значения еще нет - удерживать нечего
+            h.nextSample = now;
+            continue;
+        }
+
+        // После долгой паузы пропущенные отсчеты старше емкости истории все равно вытеснятся
+        std::size_t capacity = h.compressed ? h.compressed->capacity() : h.buffer.capacity();
+        auto behind = (now - h.nextSample) / h.samplePeriod;
+        if (behind > static_cast<decltype(behind)>(capacity)) {
+            h.nextSample += h.samplePeriod * (behind - static_cast<decltype(behind)>(capacity));
+        }
+
+        // Отсчет проходит те же фильтры, что и запись: зону нечувствительности уведомлений
+        // (удерживается последнее доставленное значение), зону политики и swinging door
+        double value = s.filter && s.filter->notified ? s.filter->lastNotified
+                                                      : s.value.load(std::memory_order_acquire);
+        for (; h.nextSample <= now; h.nextSample += h.samplePeriod) {
+            recordHistory(h, value, h.nextSample);
+            ++samples;
+        }
+    }
+    if (samples > 0) {
+        ++revision;
+    }
+    return samples;
+}
+
+void VariableDatabase::setHistoryCapacity(TagHistory& h, std::size_t capacity) {
+    if (h.compressed) {
+        h.compressed->setCapacity(capacity);
+    } else {
+        h.buffer.setCapacity(capacity);
+    }
+}
+
+void VariableDatabase::subscribe(TagId tag, std::function<void(double)> callback, const void* owner) {
     // Добавляем callback в список подписчиков для указанной переменной
-    subscribers[variable].push_back(callback);
+    if (isValid(tag)) {
+        slot(tag).subscribers.push_back({std::move(callback), owner});
+    }
+}
+
+void VariableDatabase::unsubscribe(TagId tag, const void* owner) {
+    if (!isValid(tag) || owner == nullptr) {
+        return;
+    }
+
+    // Порядок остальных подписчиков сохраняется
+    auto& subscribers = slot(tag).subscribers;
+    subscribers.erase(std::remove_if(subscribers.begin(), subscribers.end(),
+                                     [owner](const Subscriber& s) { return s.owner == owner; }),
+                      subscribers.end());
+}
+
+void VariableDatabase::subscribe(const std::string& variable, std::function<void(double)> callback) {
+    subscribe(resolveTag(variable), std::move(callback));
 }
 
 void VariableDatabase::initializeDemoVariables() {
@@ -68,14 +656,18 @@ void VariableDatabase::initializeDemoVariables() {
     setVariable("temperature_value", 72.5);
     setVariable("setpoint_value", 65.0);
     setVariable("pressure_value", 1.2);
-    
+
     // Создаем тестовую историю температуры для графиков
+    TagId temperatureHistory = resolveTag("temperature_history");
+    enableHistory(temperatureHistory);
     for (int i = 0; i < 10; ++i) {
-        setVariable("temperature_history", 70.0 + i * 0.5);
+        set(temperatureHistory, 70.0 + i * 0.5);
     }
-    
+
     // Инициализируем историю давления
+    TagId pressureHistory = resolveTag("pressure_history");
+    enableHistory(pressureHistory);
     for (int i = 0; i < 10; ++i) {
-        setVariable("pressure_history", 1.0 + i * 0.05);
+        set(pressureHistory, 1.0 + i * 0.05);
     }
-}
\ No newline at end of file
+}
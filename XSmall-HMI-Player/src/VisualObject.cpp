@@ -1,8 +1,22 @@
 #include "VisualObject.h"
+#include <limits>
 
 VisualObject::VisualObject(float x, float y, const std::string& name, VariableDatabase* db)
     : x(x), y(y), name(name), database(db) {}
 
+VisualObject::~VisualObject() {
+    for (TagId tag : subscriptions) {
+        database->unsubscribe(tag, this);
+    }
+}
+
+void VisualObject::subscribe(TagId tag, std::function<void(double)> callback) {
+    if (database && tag != INVALID_TAG) {
+        database->subscribe(tag, std::move(callback), this);
+        subscriptions.push_back(tag);
+    }
+}
+
 void VisualObject::setPosition(float newX, float newY) {
     x = newX;
     y = newY;
@@ -10,4 +24,13 @@ void VisualObject::setPosition(float newX, float newY) {
 
 std::string VisualObject::getName() const {
     return name;
-}
\ No newline at end of file
+}
+
+sf::FloatRect VisualObject::getBounds() const {
+    const float infinity = std::numeric_limits<float>::max() / 4;
+    return sf::FloatRect(-infinity, -infinity, 2 * infinity, 2 * infinity);
+}
+
+bool VisualObject::contains(float pointX, float pointY) const {
+    return getBounds().contains(pointX, pointY);
+}
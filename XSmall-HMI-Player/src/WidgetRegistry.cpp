@@ -0,0 +1,191 @@
+#include "WidgetRegistry.h"
+#include "JSONLoader.h"
+#include "Rectangle.h"
+#include "Text.h"
+#include "Line.h"
+#include "Polyline.h"
+#include "InputField.h"
+#include "Button.h"
+#include "HistoryGraph.h"
+#include "Image.h"
+
+using json = nlohmann::json;
+
+namespace {
+
+sf::Color colorValue(const json& objJson, const char* key, const json& fallback) {
+    return JSONLoader::jsonToColor(objJson.value(key, fallback));
+}
+
+std::unique_ptr<VisualObject> createRectangle(const json& objJson, VariableDatabase* db, sf::Font*) {
+    float width = objJson.value("width", 100.0f);
+    float height = objJson.value("height", 50.0f);
+    std::string variable = objJson.value("variable", "");
+    sf::Color color = colorValue(objJson, "color", json::array({255, 255, 255}));
+
+    auto rect = std::make_unique<Rectangle>(objJson.value("x", 0.0f), objJson.value("y", 0.0f),
+                                            width, height, color, objJson.value("name", ""), db, variable);
+
+    // Добавляем условия, если есть
+    if (objJson.contains("conditions") && objJson["conditions"].is_array()) {
+        for (const auto& condJson : objJson["conditions"]) {
+            double value = condJson.value("value", 0.0);
+            sf::Color condColor = colorValue(condJson, "color", json::array({255, 255, 255}));
+            rect->addCondition(value, condColor);
+        }
+    }
+
+    return rect;
+}
+
+std::unique_ptr<VisualObject> createText(const json& objJson, VariableDatabase* db, sf::Font* font) {
+    std::string content = objJson.value("content", "");
+    unsigned int fontSize = objJson.value("fontSize", 20);
+    std::string variable = objJson.value("variable", "");
+    std::string format = objJson.value("format", "");
+    sf::Color color = colorValue(objJson, "color", json::array({255, 255, 255}));
+
+    return std::make_unique<Text>(objJson.value("x", 0.0f), objJson.value("y", 0.0f), content, font,
+                                  fontSize, color, objJson.value("name", ""), db, variable, format);
+}
+
+std::unique_ptr<VisualObject> createLine(const json& objJson, VariableDatabase* db, sf::Font*) {
+    float x2 = objJson.value("x2", 0.0f);
+    float y2 = objJson.value("y2", 0.0f);
+    sf::Color color = colorValue(objJson, "color", json::array({255, 255, 255}));
+
+    return std::make_unique<Line>(objJson.value("x", 0.0f), objJson.value("y", 0.0f), x2, y2, color,
+                                  objJson.value("name", ""), db);
+}
+
+std::unique_ptr<VisualObject> createPolyline(const json& objJson, VariableDatabase* db, sf::Font*) {
+    std::vector<sf::Vector2f> points;
+    if (objJson.contains("points") && objJson["points"].is_array()) {
+        for (const auto& pointJson : objJson["points"]) {
+            if (pointJson.is_array() && pointJson.size() >= 2) {
+                float px = pointJson[0].get<float>();
+                float py = pointJson[1].get<float>();
+                points.push_back(sf::Vector2f(px, py));
+            }
+        }
+    } else {
+        // Если точек нет, используем текущую позицию
+        points.push_back(sf::Vector2f(objJson.value("x", 0.0f), objJson.value("y", 0.0f)));
+    }
+
+    sf::Color color = colorValue(objJson, "color", json::array({255, 255, 255}));
+    std::string variable = objJson.value("variable", "");
+
+    return std::make_unique<Polyline>(points, color, objJson.value("name", ""), db, variable);
+}
+
+std::unique_ptr<VisualObject> createInputField(const json& objJson, VariableDatabase* db, sf::Font* font) {
+    float width = objJson.value("width", 200.0f);
+    float height = objJson.value("height", 30.0f);
+    unsigned int fontSize = objJson.value("fontSize", 16);
+    std::string variable = objJson.value("variable", "");
+
+    return std::make_unique<InputField>(objJson.value("x", 0.0f), objJson.value("y", 0.0f), width, height,
+                                        font, fontSize, objJson.value("name", ""), db, variable);
+}
+
+std::unique_ptr<VisualObject> createButton(const json& objJson, VariableDatabase* db, sf::Font* font) {
+    float width = objJson.value("width", 100.0f);
+    float height = objJson.value("height", 40.0f);
+    std::string text = objJson.value("text", "");
+    unsigned int fontSize = objJson.value("fontSize", 16);
+    std::string variable = objJson.value("variable", "");
+    sf::Color color = colorValue(objJson, "color", json::array({200, 200, 200}));
+    sf::Color textColor = colorValue(objJson, "textColor", json::array({0, 0, 0}));
+
+    // Создаем кнопку без обработчика
+    auto button = std::make_unique<Button>(objJson.value("x", 0.0f), objJson.value("y", 0.0f), width, height,
+                                           text, font, fontSize, color, objJson.value("name", ""), db,
+                                           variable, nullptr, textColor);
+
+    // Устанавливаем действие, если оно есть
+    if (objJson.contains("action")) {
+        std::string action = objJson["action"];
+        button->setAction(action, db);
+    }
+
+    return button;
+}
+
+std::unique_ptr<VisualObject> createHistoryGraph(const json& objJson, VariableDatabase* db, sf::Font*) {
+    float width = objJson.value("width", 400.0f);
+    float height = objJson.value("height", 200.0f);
+    std::string variable = objJson.value("variable", "");
+    size_t maxHistory = objJson.value("maxHistory", 50);
+    sf::Color lineColor = colorValue(objJson, "lineColor", json::array({0, 0, 255}));
+    sf::Color gridColor = colorValue(objJson, "gridColor", json::array({200, 200, 200, 100}));
+
+    auto graph = std::make_unique<HistoryGraph>(objJson.value("x", 0.0f), objJson.value("y", 0.0f), width, height,
+                                                objJson.value("name", ""), db, variable,
+                                                maxHistory, lineColor, gridColor);
+
+    // Ось времени: окно в секундах и необязательная частота отсчетов истории
+    double timeWindow = objJson.value("timeWindow", 0.0);
+    if (timeWindow > 0) {
+        graph->setTimeWindow(timeWindow, objJson.value("sampleRate", 0.0));
+    }
+    return graph;
+}
+
+std::unique_ptr<VisualObject> createImage(const json& objJson, VariableDatabase* db, sf::Font*) {
+    float width = objJson.value("width", 100.0f);
+    float height = objJson.value("height", 100.0f);
+    std::string path = objJson.value("path", "");
+
+    return std::make_unique<Image>(objJson.value("x", 0.0f), objJson.value("y", 0.0f), width, height, path,
+                                   objJson.value("name", ""), db);
+}
+
+} // namespace
+
+WidgetRegistry::WidgetRegistry() {
+    registerBuiltinTypes();
+}
+
+WidgetRegistry& WidgetRegistry::instance() {
+    static WidgetRegistry registry;
+    return registry;
+}
+
+void WidgetRegistry::registerBuiltinTypes() {
+    add("Rectangle", createRectangle);
+    add("Text", createText);
+    add("Line", createLine);
+    add("Polyline", createPolyline);
+    add("InputField", createInputField);
+    add("Button", createButton);
+    add("HistoryGraph", createHistoryGraph);
+    add("Image", createImage);
+}
+
+WidgetTypeId WidgetRegistry::add(const std::string& type, Factory factory) {
+    auto it = typeIds.find(type);
+    if (it != typeIds.end()) {
+        factories[it->second] = std::move(factory);
+        return it->second;
+    }
+
+    WidgetTypeId id = static_cast<WidgetTypeId>(factories.size());
+    typeIds.emplace(type, id);
+    typeNames.push_back(type);
+    factories.push_back(std::move(factory));
+    return id;
+}
+
+WidgetTypeId WidgetRegistry::find(const std::string& type) const {
+    auto it = typeIds.find(type);
+    return it != typeIds.end() ? it->second : INVALID_WIDGET_TYPE;
+}
+
+std::unique_ptr<VisualObject> WidgetRegistry::create(WidgetTypeId id, const json& objJson,
+                                                     VariableDatabase* db, sf::Font* font) const {
+    if (id >= factories.size() || !factories[id]) {
+        return nullptr;
+    }
+    return factories[id](objJson, db, font);
+}
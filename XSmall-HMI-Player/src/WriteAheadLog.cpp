@@ -0,0 +1,307 @@
+#include "WriteAheadLog.h"
+#include "MappedFile.h"
+#include "Crc32.h"
+#include "logger.h"
+#include <filesystem>
+#include <algorithm>
+#include <cstring>
+#include <cctype>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+struct WalSegmentHeader {
+    char magic[4];
+    std::uint32_t version;
+};
+
+const char WAL_MAGIC[4] = {'H', 'M', 'I', 'W'};
+const std::uint32_t WAL_VERSION = 1;
+
+// Заголовок записи; crc считается по всему, что следует за ним (включая имя)
+struct WalRecordHeader {
+    std::uint32_t crc;
+    std::uint32_t nameLength;
+    std::uint64_t sequence;
+    double value;
+};
+
+const std::uint32_t MAX_NAME_LENGTH = 64 * 1024;
+
+std::uint32_t recordCrc(const WalRecordHeader& header, const char* name) {
+    const char* fields = reinterpret_cast<const char*>(&header) + sizeof(header.crc);
+    std::uint32_t crc = crc32(fields, sizeof(header) - sizeof(header.crc));
+    return crc32(name, header.nameLength, crc);
+}
+
+bool syncFile(std::FILE* file) {
+    if (std::fflush(file) != 0) {
+        return false;
+    }
+#ifdef _WIN32
+    return _commit(_fileno(file)) == 0;
+#else
+    return ::fsync(fileno(file)) == 0;
+#endif
+}
+
+// Новый файл появляется в каталоге только после сброса самого каталога
+void syncDirectory(const std::string& path) {
+#ifndef _WIN32
+    std::string dir = std::filesystem::path(path).parent_path().string();
+    int fd = ::open(dir.empty() ? "." : dir.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        ::fsync(fd);
+        ::close(fd);
+    }
+#else
+    (void)path;
+#endif
+}
+
+} // namespace
+
+WriteAheadLog::WriteAheadLog(const std::string& basePath)
+    : basePath(basePath), nextSequence(1), durableSequence(0), activeSegment(1),
+      recovered(false), writing(false), stopping(false), commitCount(0),
+      file(nullptr), openSegment(0), failed(false) {}
+
+WriteAheadLog::~WriteAheadLog() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    if (writer.joinable()) {
+        writer.join();
+    }
+}
+
+std::string WriteAheadLog::segmentPath(std::uint32_t segment) const {
+    return basePath + "." + std::to_string(segment);
+}
+
+std::vector<std::uint32_t> WriteAheadLog::listSegments() const {
+    std::vector<std::uint32_t> segments;
+    std::filesystem::path base(basePath);
+    std::filesystem::path dir = base.parent_path().empty() ? std::filesystem::path(".") : base.parent_path();
+    std::string prefix = base.filename().string() + ".";
+
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(dir, error)) {
+        std::string name = entry.path().filename().string();
+        if (name.size() <= prefix.size() || name.compare(0, prefix.size(), prefix) != 0) {
+            continue;
+        }
+        std::string number = name.substr(prefix.size());
+        if (number.size() <= 9 && std::all_of(number.begin(), number.end(), ::isdigit)) {
+            segments.push_back(static_cast<std::uint32_t>(std::stoul(number)));
+        }
+    }
+    std::sort(segments.begin(), segments.end());
+    return segments;
+}
+
+std::size_t WriteAheadLog::recover(std::uint64_t afterSequence, const ApplyRecord& apply) {
+    if (recovered) {
+        return 0;
+    }
+
+    std::size_t applied = 0;
+    std::uint64_t lastSequence = afterSequence;
+    std::vector<std::uint32_t> segments = listSegments();
+
+    for (std::uint32_t segment : segments) {
+        MappedFile mapped;
+        if (!mapped.open(segmentPath(segment))) {
+            continue;  // Пустой сегмент: сбой сразу после создания
+        }
+        const char* data = mapped.getData();
+        std::size_t size = mapped.getSize();
+
+        WalSegmentHeader segmentHeader;
+        if (size < sizeof(segmentHeader)) {
+            continue;
+        }
+        std::memcpy(&segmentHeader, data, sizeof(segmentHeader));
+        if (std::memcmp(segmentHeader.magic, WAL_MAGIC, sizeof(WAL_MAGIC)) != 0 ||
+            segmentHeader.version != WAL_VERSION) {
+            Logger::warning("Ignoring unknown journal segment: " + segmentPath(segment));
+            continue;
+        }
+
+        std::size_t offset = sizeof(segmentHeader);
+        while (offset + sizeof(WalRecordHeader) <= size) {
+            WalRecordHeader header;
+            std::memcpy(&header, data + offset, sizeof(header));
+            const char* name = data + offset + sizeof(header);
+            if (header.nameLength > MAX_NAME_LENGTH ||
+                header.nameLength > size - offset - sizeof(header) ||
+                recordCrc(header, name) != header.crc) {
+                break;
+            }
+
+            if (header.sequence > afterSequence && apply) {
+                apply(std::string(name, header.nameLength), header.value);
+                ++applied;
+            }
+            lastSequence = std::max(lastSequence, header.sequence);
+            offset += sizeof(header) + header.nameLength;
+        }
+        if (offset != size) {
+            Logger::warning("Journal segment " + segmentPath(segment) + " ends with a damaged record, " +
+                            std::to_string(size - offset) + " bytes dropped");
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        nextSequence = lastSequence + 1;
+        durableSequence = lastSequence;
+        // Сегмент, оборванный сбоем, не дописываем: новые записи - в новый
+        activeSegment = segments.empty() ? 1 : segments.back() + 1;
+        recovered = true;
+    }
+    writer = std::thread(&WriteAheadLog::writerLoop, this);
+    return applied;
+}
+
+std::uint64_t WriteAheadLog::append(const std::string& name, double value) {
+    if (!recovered) {
+        recover(0, nullptr);
+    }
+
+    WalRecordHeader header;
+    header.nameLength = static_cast<std::uint32_t>(std::min<std::size_t>(name.size(), MAX_NAME_LENGTH));
+    header.value = value;
+
+    std::uint64_t sequence;
+    bool wasEmpty;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        sequence = nextSequence++;
+        wasEmpty = batches.empty();
+        header.sequence = sequence;
+        header.crc = recordCrc(header, name.data());
+
+        if (batches.empty() || batches.back().segment != activeSegment) {
+            batches.push_back(Batch{activeSegment, std::string(), 0});
+        }
+        Batch& batch = batches.back();
+        batch.data.append(reinterpret_cast<const char*>(&header), sizeof(header));
+        batch.data.append(name.data(), header.nameLength);
+        batch.lastSequence = sequence;
+    }
+    // Непустую очередь фоновый поток заберет сам после текущей фиксации
+    if (wasEmpty) {
+        wake.notify_one();
+    }
+    return sequence;
+}
+
+std::uint64_t WriteAheadLog::rotate(std::uint32_t& newSegment) {
+    if (!recovered) {
+        recover(0, nullptr);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    newSegment = ++activeSegment;
+    return nextSequence - 1;
+}
+
+void WriteAheadLog::removeSegmentsBefore(std::uint32_t segment) {
+    for (std::uint32_t existing : listSegments()) {
+        if (existing < segment) {
+            std::error_code error;
+            std::filesystem::remove(segmentPath(existing), error);
+        }
+    }
+}
+
+void WriteAheadLog::flush() {
+    std::unique_lock<std::mutex> lock(mutex);
+    durable.wait(lock, [this]() { return batches.empty() && !writing; });
+}
+
+std::uint64_t WriteAheadLog::getCommitCount() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return commitCount;
+}
+
+std::uint64_t WriteAheadLog::getLastSequence() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return nextSequence - 1;
+}
+
+bool WriteAheadLog::openSegmentFile(std::uint32_t segment) {
+    std::string path = segmentPath(segment);
+    file = std::fopen(path.c_str(), "wb");
+    openSegment = segment;
+    if (!file) {
+        return false;
+    }
+
+    WalSegmentHeader header;
+    std::memcpy(header.magic, WAL_MAGIC, sizeof(WAL_MAGIC));
+    header.version = WAL_VERSION;
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1;
+    syncDirectory(path);
+    return ok;
+}
+
+void WriteAheadLog::closeSegmentFile() {
+    if (file) {
+        syncFile(file);
+        std::fclose(file);
+        file = nullptr;
+    }
+}
+
+void WriteAheadLog::writerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [this]() { return stopping || !batches.empty(); });
+        if (batches.empty()) {
+            break;  // Остановка, очередь пуста
+        }
+
+        // Все, что накопилось, пока шла предыдущая фиксация, пишем одной группой
+        std::deque<Batch> group;
+        group.swap(batches);
+        writing = true;
+        lock.unlock();
+
+        bool ok = true;
+        std::uint64_t lastSequence = 0;
+        for (const Batch& batch : group) {
+            if (!file || batch.segment != openSegment) {
+                closeSegmentFile();
+                ok = openSegmentFile(batch.segment) && ok;
+            }
+            if (file) {
+                ok = std::fwrite(batch.data.data(), 1, batch.data.size(), file) == batch.data.size() && ok;
+            }
+            lastSequence = batch.lastSequence;
+        }
+        ok = file && syncFile(file) && ok;
+
+        if (!ok && !failed) {
+            Logger::error("Failed to write journal segment " + segmentPath(openSegment));
+        }
+        failed = !ok;
+
+        lock.lock();
+        durableSequence = lastSequence;
+        ++commitCount;
+        writing = false;
+        durable.notify_all();
+    }
+    lock.unlock();
+    closeSegmentFile();
+}
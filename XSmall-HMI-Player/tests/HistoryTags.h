@@ -0,0 +1,16 @@
+#ifndef HISTORYTAGS_H
+#define HISTORYTAGS_H
+
+#include <string>
+
+#include "VariableDatabase.h"
+
+// Переменная с включенной историей. Без потребителя (графика, политики, агрегатов) база
+// историю не ведет, а тестам базы и архива она нужна сразу после регистрации
+inline TagId historyTag(VariableDatabase& db, const std::string& name) {
+    TagId tag = db.resolveTag(name);
+    db.enableHistory(tag);
+    return tag;
+}
+
+#endif
@@ -0,0 +1,76 @@
+#ifndef SCENECONFIGTEST_H
+#define SCENECONFIGTEST_H
+
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "VariableDatabase.h"
+#include "JSONLoader.h"
+#include "BinaryScene.h"
+#include "SceneReloader.h"
+
+/**
+ * Общая основа тестов настроек сцены, которые должны одинаково действовать на всех путях
+ * загрузки: из objects.json, из скомпилированной сцены и при горячей перезагрузке.
+ *
+ * Базы объявлены раньше объектов: объекты отписываются от своей базы в деструкторе,
+ * поэтому уничтожаются первыми.
+ */
+class SceneConfigTest : public ::testing::Test {
+protected:
+    const std::string jsonFile;
+    const std::string sceneFile;
+
+    VariableDatabase jsonDb;   // Сцена, загруженная из JSON
+    VariableDatabase sceneDb;  // Сцена из скомпилированного файла, в нее же применяется перезагрузка
+    std::vector<std::unique_ptr<VisualObject>> objects;  // Объекты sceneDb
+    std::vector<std::unique_ptr<VisualObject>> removed;
+    SceneSnapshot snapshot;
+
+    explicit SceneConfigTest(const std::string& baseName)
+        : jsonFile(baseName + ".json"), sceneFile(baseName + ".hmiscene") {}
+
+    void TearDown() override {
+        objects.clear();
+        removed.clear();
+        std::filesystem::remove(jsonFile);
+        std::filesystem::remove(sceneFile);
+    }
+
+    // Записывает сцену и загружает ее в jsonDb из JSON и в sceneDb из скомпилированного файла.
+    // Первая версия сцены запоминается для перезагрузки (reload)
+    void load(const nlohmann::json& scene, std::size_t objectCount) {
+        std::ofstream(jsonFile) << scene.dump();
+
+        auto jsonObjects = JSONLoader::loadFromFile(jsonFile, &jsonDb, nullptr);
+        ASSERT_EQ(jsonObjects.size(), objectCount);
+        jsonObjects.clear();
+
+        ASSERT_TRUE(JSONLoader::compileScene(jsonFile, sceneFile));
+        BinaryScene compiled;
+        ASSERT_TRUE(compiled.open(sceneFile));
+        objects = compiled.instantiate(&sceneDb, nullptr);
+        ASSERT_EQ(objects.size(), objectCount);
+
+        SceneReloader::diff(snapshot, scene);
+    }
+
+    // Изменения относительно предыдущей версии сцены
+    ScenePatch diff(const nlohmann::json& scene) {
+        SceneSnapshot copy = snapshot;
+        return SceneReloader::diff(copy, scene);
+    }
+
+    // Перезагрузка новой версии сцены в sceneDb; возвращает примененные изменения
+    ScenePatch reload(const nlohmann::json& scene) {
+        ScenePatch patch = SceneReloader::diff(snapshot, scene);
+        SceneReloader::applyPatch(patch, objects, &sceneDb, nullptr, removed);
+        return patch;
+    }
+};
+
+#endif
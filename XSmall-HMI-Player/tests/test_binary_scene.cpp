@@ -0,0 +1,181 @@
+#include <gtest/gtest.h>
+#include <SFML/Graphics.hpp>
+#include <filesystem>
+#include <fstream>
+
+#include "VariableDatabase.h"
+#include "BinaryScene.h"
+#include "RenderBatch.h"
+
+class BinarySceneTest : public ::testing::Test {
+protected:
+    const std::string jsonFile = "test_binary_scene.json";
+    const std::string sceneFile = "test_binary_scene.hmiscene";
+
+    void SetUp() override {
+        std::ofstream(jsonFile) << "{\"objects\": []}";
+    }
+
+    void TearDown() override {
+        std::filesystem::remove(jsonFile);
+        std::filesystem::remove(sceneFile);
+    }
+
+    // Сцена из нескольких типов объектов, в том числе с хвостами переменной длины
+    bool writeScene() {
+        SceneWriter writer;
+        std::uint64_t size = 0;
+        std::int64_t time = 0;
+        if (!BinaryScene::getSourceStamp(jsonFile, size, time)) {
+            return false;
+        }
+        writer.setSource(size, time);
+        writer.setHistoryCapacity(300);
+
+        PlayerSettings settings;
+        settings.scheduler.renderRate = 30.0;
+        settings.scheduler.maxTicksPerFrame = 3;
+        settings.demoIntervalMs = 500;
+        settings.atlasCacheDir = "cache";
+        settings.stateTags = {"scene_status", "setpoint"};
+        settings.historianDir = "archive";
+        settings.historianRetentionDays = 30;
+        writer.setSettings(settings);
+
+        SceneRectangleRecord rect = {};
+        rect.header.x = 10;
+        rect.header.y = 20;
+        rect.header.name = writer.intern("Panel");
+        rect.header.tag = writer.tag("scene_status");
+        rect.width = 100;
+        rect.height = 50;
+        rect.color = sf::Color(1, 2, 3).toInteger();
+        SceneConditionRecord conditions[2] = {};
+        conditions[0].value = 1.0;
+        conditions[0].color = sf::Color::Red.toInteger();
+        conditions[1].value = 2.0;
+        conditions[1].color = sf::Color::Green.toInteger();
+        rect.conditionCount = 2;
+        writer.add(rect, conditions, sizeof(conditions));
+
+        ScenePolylineRecord polyline = {};
+        polyline.header.name = writer.intern("Trend");
+        polyline.header.tag = SCENE_NO_INDEX;
+        polyline.color = sf::Color::White.toInteger();
+        float points[6] = {0, 0, 40, 10, 80, 30};
+        polyline.pointCount = 3;
+        writer.add(polyline, points, sizeof(points));
+
+        SceneLineRecord line = {};
+        line.header.x = 5;
+        line.header.y = 5;
+        line.header.name = writer.intern("Separator");
+        line.header.tag = SCENE_NO_INDEX;
+        line.x2 = 205;
+        line.y2 = 5;
+        writer.add(line);
+
+        SceneHistoryGraphRecord graph = {};
+        graph.header.x = 300;
+        graph.header.y = 300;
+        graph.header.name = writer.intern("Graph");
+        graph.header.tag = writer.tag("scene_history");
+        graph.width = 400;
+        graph.height = 200;
+        graph.maxHistory = 500;
+        graph.timeWindow = 30;
+        graph.sampleRate = 4;
+        writer.add(graph);
+
+        return writer.write(sceneFile);
+    }
+};
+
+TEST_F(BinarySceneTest, RoundTripsObjectsAndSettings) {
+    ASSERT_TRUE(writeScene());
+
+    BinaryScene scene;
+    ASSERT_TRUE(scene.open(sceneFile));
+    EXPECT_TRUE(scene.isUpToDate(jsonFile));
+    EXPECT_EQ(scene.getObjectCount(), 4u);
+
+    PlayerSettings settings;
+    scene.readPlayerSettings(settings);
+    EXPECT_DOUBLE_EQ(settings.scheduler.renderRate, 30.0);
+    EXPECT_DOUBLE_EQ(settings.scheduler.tickRate, PlayerSettings().scheduler.tickRate);
+    EXPECT_EQ(settings.scheduler.maxTicksPerFrame, 3);
+    EXPECT_EQ(settings.demoIntervalMs, 500);
+    EXPECT_EQ(settings.atlasCacheDir, "cache");
+    EXPECT_EQ(settings.stateTags, std::vector<std::string>({"scene_status", "setpoint"}));
+    EXPECT_EQ(settings.historianDir, "archive");
+    EXPECT_EQ(settings.historianRetentionDays, 30);
+    EXPECT_EQ(settings.historianChunkSeconds, 60);
+
+    VariableDatabase db;
+    auto objects = scene.instantiate(&db, nullptr);
+    ASSERT_EQ(objects.size(), 4u);
+
+    // Порядок записей сохраняется
+    EXPECT_EQ(objects[0]->getName(), "Panel");
+    EXPECT_EQ(objects[1]->getName(), "Trend");
+    EXPECT_EQ(objects[2]->getName(), "Separator");
+    EXPECT_EQ(objects[3]->getName(), "Graph");
+
+    sf::FloatRect panel = objects[0]->getBounds();
+    EXPECT_FLOAT_EQ(panel.left, 10);
+    EXPECT_FLOAT_EQ(panel.top, 20);
+    EXPECT_FLOAT_EQ(panel.width, 100);
+    EXPECT_FLOAT_EQ(panel.height, 50);
+    // Точки ломаной из хвоста записи (рамка на полпикселя шире линии)
+    EXPECT_FLOAT_EQ(objects[1]->getBounds().width, 81);
+    EXPECT_FLOAT_EQ(objects[1]->getBounds().height, 31);
+
+    // Переменные зарегистрированы, емкость истории применена
+    EXPECT_NE(db.findTag("scene_status"), INVALID_TAG);
+    TagId history = db.findTag("scene_history");
+    ASSERT_NE(history, INVALID_TAG);
+    EXPECT_GE(db.getHistoryCapacity(history), 500u);
+    EXPECT_GE(db.getHistoryCapacity(db.findTag("scene_status")), 300u);
+
+    // График с осью времени передискретизирует историю
+    EXPECT_EQ(db.getHistoryResampling(history), std::chrono::milliseconds(250));
+
+    // Условия прямоугольника восстановлены вместе с цветами
+    RenderBatch batch;
+    objects[0]->attachToBatch(batch);
+    EXPECT_EQ(batch.getVertex(0).color, sf::Color(1, 2, 3));
+    db.setVariable("scene_status", 2.0);
+    EXPECT_EQ(batch.getVertex(0).color, sf::Color::Green);
+}
+
+TEST_F(BinarySceneTest, DetectsChangedSource) {
+    ASSERT_TRUE(writeScene());
+
+    // JSON изменился после компиляции - сцену нужно собрать заново
+    std::ofstream(jsonFile, std::ios::app) << "\n";
+
+    BinaryScene scene;
+    ASSERT_TRUE(scene.open(sceneFile));
+    EXPECT_FALSE(scene.isUpToDate(jsonFile));
+    EXPECT_FALSE(scene.isUpToDate("missing.json"));
+}
+
+TEST_F(BinarySceneTest, RejectsDamagedFiles) {
+    BinaryScene scene;
+    EXPECT_FALSE(scene.open("missing.hmiscene"));
+
+    std::ofstream(sceneFile, std::ios::binary) << "not a compiled scene";
+    EXPECT_FALSE(scene.open(sceneFile));
+
+    // Обрезанный файл не совпадает с размером из заголовка
+    ASSERT_TRUE(writeScene());
+    std::filesystem::resize_file(sceneFile, std::filesystem::file_size(sceneFile) - 8);
+    EXPECT_FALSE(scene.open(sceneFile));
+    EXPECT_FALSE(scene.isOpen());
+    EXPECT_TRUE(scene.instantiate(nullptr, nullptr).empty());
+}
+
+TEST(BinaryScenePathTest, SitsNextToJson) {
+    EXPECT_EQ(BinaryScene::pathFor("objects.json"), "objects.hmiscene");
+    EXPECT_EQ(BinaryScene::pathFor("screens/main.json"), std::filesystem::path("screens/main.hmiscene").string());
+}
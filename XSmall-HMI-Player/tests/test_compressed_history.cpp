@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "CompressedHistory.h"
+#include "HistoryGraph.h"
+#include "VariableDatabase.h"
+
+namespace {
+
+std::vector<double> readAll(const CompressedHistory& history, std::uint64_t from = 0) {
+    std::vector<double> values;
+    for (CompressedHistory::Cursor cursor(history, from); cursor.next();) {
+        EXPECT_EQ(cursor.index(), std::max<std::uint64_t>(from, history.firstIndex()) + values.size());
+        values.insert(values.end(), cursor.data(), cursor.data() + cursor.size());
+    }
+    return values;
+}
+
+bool sameBits(double a, double b) {
+    return std::memcmp(&a, &b, sizeof(double)) == 0;
+}
+
+} // namespace
+
+TEST(CompressedHistoryTest, RoundTripsValuesBitExactly) {
+    std::vector<double> values = {0.0, -0.0, 1.0, 1.0, 1.0, 21.5, 21.55, 21.6,
+                                  std::numeric_limits<double>::infinity(),
+                                  std::numeric_limits<double>::quiet_NaN(),
+                                  std::numeric_limits<double>::denorm_min(),
+                                  -1e300, 1e-300};
+    std::mt19937_64 random(7);
+    std::uniform_real_distribution<double> noise(-1000.0, 1000.0);
+    for (int i = 0; i < 1000; ++i) {
+        values.push_back(i % 3 == 0 ? noise(random) : 70.0 + std::round(std::sin(i * 0.01) * 100) / 10);
+    }
+
+    CompressedHistory history(values.size());
+    for (double value : values) {
+        history.push(value);
+    }
+
+    std::vector<double> decoded = readAll(history);
+    ASSERT_EQ(decoded.size(), values.size());
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        EXPECT_TRUE(sameBits(decoded[i], values[i])) << "sample " << i;
+    }
+}
+
+TEST(CompressedHistoryTest, EvictsWholeBlocksAndKeepsCapacity) {
+    const std::size_t capacity = 300;
+    CompressedHistory history(capacity);
+    for (int i = 0; i < 2000; ++i) {
+        history.push(i);
+    }
+
+    EXPECT_EQ(history.total(), 2000u);
+    EXPECT_GE(history.size(), capacity);
+    EXPECT_LT(history.size(), capacity + CompressedHistory::BLOCK_SAMPLES);
+
+    std::vector<double> decoded = readAll(history);
+    ASSERT_EQ(decoded.size(), history.size());
+    EXPECT_DOUBLE_EQ(decoded.front(), static_cast<double>(history.firstIndex()));
+    EXPECT_DOUBLE_EQ(decoded.back(), 1999.0);
+
+    // Курсор с середины блока начинает с нужного значения
+    std::vector<double> tail = readAll(history, 1900);
+    ASSERT_EQ(tail.size(), 100u);
+    EXPECT_DOUBLE_EQ(tail.front(), 1900.0);
+}
+
+TEST(CompressedHistoryTest, SlowlyChangingValuesTakeFewBytes) {
+    CompressedHistory history(100000);
+    double temperature = 20.0;
+    for (int i = 0; i < 100000; ++i) {
+        // Плавный выход на уставку и долгое удержание, как у демо-температуры
+        double setpoint = (i / 10000) % 2 ? 75.0 : 70.0;
+        double difference = setpoint - temperature;
+        temperature += std::abs(difference) > 1.0 ? (difference > 0 ? 0.2 : -0.2) : difference * 0.8;
+        history.push(temperature);
+    }
+    EXPECT_LT(history.memoryUsage(), 100000u * sizeof(double) / 4);
+}
+
+TEST(CompressedHistoryTest, DatabaseSwitchesStorageKeepingValues) {
+    VariableDatabase db;
+    TagId tag = db.resolveTag("compressed_var");
+    db.requestHistoryCapacity(tag, 1000);
+    for (int i = 0; i < 10; ++i) {
+        db.set(tag, i);
+    }
+
+    db.setHistoryCompression(tag, true);
+    ASSERT_NE(db.getCompressedHistory(tag), nullptr);
+    EXPECT_TRUE(db.getHistory(tag).empty());
+    EXPECT_EQ(db.getHistoryTotal(tag), 10u);
+    EXPECT_EQ(db.getHistoryCapacity(tag), 1000u);
+
+    for (int i = 10; i < 500; ++i) {
+        db.set(tag, i);
+    }
+    std::vector<double> decoded = readAll(*db.getCompressedHistory(tag));
+    ASSERT_EQ(decoded.size(), 500u);
+    EXPECT_DOUBLE_EQ(decoded[0], 0.0);
+    EXPECT_DOUBLE_EQ(decoded[499], 499.0);
+
+    db.setHistoryCompression(tag, false);
+    EXPECT_EQ(db.getCompressedHistory(tag), nullptr);
+    HistoryView history = db.getHistory(tag);
+    ASSERT_EQ(history.size(), 500u);
+    EXPECT_DOUBLE_EQ(history.back(), 499.0);
+}
+
+TEST(CompressedHistoryTest, GraphOfCompressedHistoryMatchesPlainHistory) {
+    VariableDatabase db;
+    TagId plainTag = db.resolveTag("graph_plain");
+    TagId compressedTag = db.resolveTag("graph_compressed");
+    HistoryGraph plain(0, 0, 200, 100, "Plain", &db, "graph_plain", 1000);
+    HistoryGraph compressed(0, 0, 200, 100, "Compressed", &db, "graph_compressed", 1000);
+    db.setHistoryCompression(compressedTag, true);
+
+    // Кривые сравниваются и по ходу записи (дописывание), и после вытеснения старых блоков
+    for (int i = 0; i < 3000; ++i) {
+        double value = 50 + 20 * std::sin(i * 0.05);
+        db.set(plainTag, value);
+        db.set(compressedTag, value);
+        if (i % 250 == 0 || i == 2999) {
+            std::vector<sf::Vector2f> expected = plain.getCurvePoints();
+            std::vector<sf::Vector2f> actual = compressed.getCurvePoints();
+            ASSERT_EQ(actual.size(), expected.size()) << "after " << i;
+            for (std::size_t p = 0; p < expected.size(); ++p) {
+                EXPECT_FLOAT_EQ(actual[p].x, expected[p].x);
+                EXPECT_FLOAT_EQ(actual[p].y, expected[p].y);
+            }
+        }
+    }
+}
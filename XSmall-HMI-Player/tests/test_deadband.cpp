@@ -0,0 +1,256 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "SceneConfigTest.h"
+#include "SwingingDoor.h"
+#include "HistoryGraph.h"
+#include "HistoryTags.h"
+
+using json = nlohmann::json;
+using namespace std::chrono;
+
+namespace {
+
+// Отметки времени через год от эпохи часов (как в тестах агрегатов)
+HistoryClock::time_point at(HistoryClock::duration offset) {
+    return HistoryClock::time_point(hours(24 * 365)) + offset;
+}
+
+double toSeconds(HistoryClock::time_point time) {
+    return duration<double>(time.time_since_epoch()).count();
+}
+
+// Линейная интерполяция сохраненных точек в момент time
+double interpolate(const std::vector<HistoryClock::time_point>& times, const std::vector<double>& values,
+                   HistoryClock::time_point time) {
+    std::size_t i = std::upper_bound(times.begin(), times.end(), time) - times.begin();
+    if (i == 0) return values.front();
+    if (i == times.size()) return values.back();
+    double t0 = toSeconds(times[i - 1]);
+    double t1 = toSeconds(times[i]);
+    return values[i - 1] + (values[i] - values[i - 1]) * (toSeconds(time) - t0) / (t1 - t0);
+}
+
+} // namespace
+
+TEST(DeadbandTest, SwingingDoorKeepsInterpolationWithinDeviation) {
+    const double deviation = 0.2;
+    std::mt19937 random(5);
+    std::normal_distribution<double> noise(0.0, 0.03);
+
+    // Медленный процесс с шумом и скачками уставки, 100 мс
+    SwingingDoor door(deviation);
+    std::vector<HistoryClock::time_point> inputTimes, times;
+    std::vector<double> inputs, values;
+    double level = 50.0;
+    for (int i = 0; i < 20000; ++i) {
+        double setpoint = (i / 2500) % 2 ? 60.0 : 50.0;
+        level += (setpoint - level) * 0.01;
+        double value = level + 2.0 * std::sin(i * 0.002) + noise(random);
+        HistoryClock::time_point time = at(milliseconds(i * 100));
+        inputTimes.push_back(time);
+        inputs.push_back(value);
+
+        HistoryClock::time_point archivedTime;
+        double archivedValue = 0.0;
+        if (door.add(time, value, archivedTime, archivedValue)) {
+            times.push_back(archivedTime);
+            values.push_back(archivedValue);
+        }
+    }
+    ASSERT_TRUE(door.hasHeld());
+    EXPECT_GT(door.getHeldTime(), times.back());
+
+    // Точки излома - на порядок меньше значений, а линия через них не дальше допуска
+    // (значения после последней сохраненной точки еще не зафиксированы)
+    EXPECT_LT(values.size(), inputs.size() / 10);
+    for (std::size_t i = 0; i < inputs.size() && inputTimes[i] <= times.back(); ++i) {
+        EXPECT_NEAR(interpolate(times, values, inputTimes[i]), inputs[i], deviation + 1e-6) << "sample " << i;
+    }
+
+    // Первое значение сохраняется сразу, после reset - снова
+    door.reset();
+    HistoryClock::time_point archivedTime;
+    double archivedValue = 0.0;
+    EXPECT_TRUE(door.add(at(seconds(5000)), 1.0, archivedTime, archivedValue));
+    EXPECT_FALSE(door.hasHeld());
+}
+
+TEST(DeadbandTest, NotifyDeadbandSuppressesSmallChanges) {
+    VariableDatabase db;
+    TagId absolute = historyTag(db, "deadband_absolute");
+    TagId percent = db.resolveTag("deadband_percent");
+    NotifyDeadband band;
+    band.absolute = 0.5;
+    db.setNotifyDeadband(absolute, band);
+    band = NotifyDeadband();
+    band.percent = 1.0;
+    band.span = 200.0;  // Порог 2 единицы
+    db.setNotifyDeadband(percent, band);
+
+    std::vector<double> seen;
+    db.subscribe(absolute, [&seen](double value) { seen.push_back(value); });
+    int percentCalls = 0;
+    db.subscribe(percent, [&percentCalls](double) { ++percentCalls; });
+
+    // Дрожание вокруг последнего доставленного значения не доходит до подписчиков и истории
+    for (double value : {10.0, 10.2, 9.7, 10.4, 10.6, 10.9, 11.2, 3.0}) {
+        db.set(absolute, value);
+    }
+    ASSERT_EQ(seen.size(), 4u);
+    EXPECT_DOUBLE_EQ(seen[1], 10.6);
+    EXPECT_DOUBLE_EQ(seen[2], 11.2);
+    EXPECT_EQ(db.getHistory(absolute).size(), 4u);
+    EXPECT_DOUBLE_EQ(db.get(absolute), 3.0);  // Текущее значение от зоны не зависит
+
+    for (int i = 0; i <= 40; ++i) {
+        db.set(percent, 100.0 + i * 0.25);
+    }
+    EXPECT_EQ(percentCalls, 6);  // Первое значение и каждые 2 единицы
+
+    // Ввод оператора доставляется всегда
+    db.set(absolute, 3.1, WriteSource::Operator);
+    EXPECT_EQ(seen.size(), 5u);
+    db.set(absolute, 3.2);
+    EXPECT_EQ(seen.size(), 5u);
+
+    // Снятая зона - снова каждая запись
+    db.setNotifyDeadband(absolute, NotifyDeadband());
+    EXPECT_DOUBLE_EQ(db.getNotifyDeadband(absolute).absolute, 0.0);
+    db.set(absolute, 3.25);
+    EXPECT_EQ(seen.size(), 6u);
+}
+
+TEST(DeadbandTest, SwingingDoorHistoryAndGraphShowHeldValue) {
+    VariableDatabase db;
+    TagId tag = db.resolveTag("deadband_trend");
+    HistoryPolicy policy;
+    policy.swingingDoor = 0.1;
+    policy.compressed = true;
+    db.setHistoryPolicy(tag, policy);
+    HistoryGraph graph(0, 0, 200, 100, "Trend", &db, "deadband_trend", 100);
+    graph.setTimeWindow(100);
+    db.enableRollups(tag);
+
+    // Линейный рост: сохраняется только первая точка, последняя удерживается дверью
+    for (int i = 0; i <= 50; ++i) {
+        db.addToHistory(tag, i * 0.5, at(seconds(i)));
+    }
+    EXPECT_EQ(db.getHistoryTotal(tag), 1u);
+    HistoryClock::time_point heldTime;
+    double heldValue = 0.0;
+    ASSERT_TRUE(db.getPendingHistory(tag, heldTime, heldValue));
+    EXPECT_EQ(heldTime, at(seconds(50)));
+    EXPECT_DOUBLE_EQ(heldValue, 25.0);
+
+    // Агрегаты получают каждое значение
+    EXPECT_EQ(db.getAggregated(tag, at(seconds(0)), at(seconds(60)), 1)[0].count, 51u);
+
+    // Тренд рисует линию до удержанного значения: правый край - на максимуме
+    std::vector<sf::Vector2f> points = graph.getCurvePoints(at(seconds(60)));
+    ASSERT_EQ(points.size(), 3u);
+    EXPECT_NEAR(points[0].y, 100.0f, 1e-3f);
+    EXPECT_NEAR(points[1].x, 180.0f, 1e-3f);
+    EXPECT_NEAR(points[1].y, 0.0f, 1e-3f);
+    EXPECT_NEAR(points[2].x, 200.0f, 1e-3f);
+
+    // Копия истории (сохранение состояния) включает удержанное значение
+    std::vector<double> values;
+    std::vector<HistoryClock::time_point> times;
+    db.copyHistory(tag, values, times);
+    ASSERT_EQ(values.size(), 2u);
+    EXPECT_DOUBLE_EQ(values.back(), 25.0);
+
+    // Излом сохраняет удержанное значение; без двери оно тоже не теряется
+    db.addToHistory(tag, 0.0, at(seconds(51)));
+    EXPECT_EQ(db.getHistoryTotal(tag), 2u);
+    policy.swingingDoor = 0.0;
+    db.setHistoryPolicy(tag, policy);
+    EXPECT_EQ(db.getHistoryTotal(tag), 3u);
+    EXPECT_FALSE(db.getPendingHistory(tag, heldTime, heldValue));
+}
+
+TEST(DeadbandTest, ResampledHistoryPassesFilters) {
+    VariableDatabase db;
+    TagId door = db.resolveTag("deadband_resampled_door");
+    TagId band = db.resolveTag("deadband_resampled_band");
+    HistoryPolicy policy;
+    policy.swingingDoor = 0.1;
+    db.setHistoryPolicy(door, policy);
+    policy = HistoryPolicy();
+    policy.deadband = 1.0;
+    db.setHistoryPolicy(band, policy);
+    NotifyDeadband deadband;
+    deadband.absolute = 0.5;
+    db.setNotifyDeadband(door, deadband);
+    db.requestHistoryResampling(door, milliseconds(100));
+    db.requestHistoryResampling(band, milliseconds(100));
+
+    db.set(door, 10.0);
+    db.set(band, 5.0);
+    HistoryClock::time_point start = HistoryClock::now();
+    EXPECT_GE(db.sampleHistory(start + seconds(10)), 200u);
+
+    // Постоянное значение: дверь сохраняет первый отсчет и удерживает последний
+    EXPECT_EQ(db.getHistoryTotal(door), 1u);
+    HistoryClock::time_point heldTime;
+    double heldValue = 0.0;
+    ASSERT_TRUE(db.getPendingHistory(door, heldTime, heldValue));
+    EXPECT_DOUBLE_EQ(heldValue, 10.0);
+    EXPECT_EQ(db.getHistoryTotal(band), 1u);
+
+    // Изменение в зоне уведомлений не доходит до отсчетов, в зоне политики - не пишется
+    db.set(door, 10.3);
+    db.set(band, 5.5);
+    db.sampleHistory(start + seconds(20));
+    EXPECT_EQ(db.getHistoryTotal(door), 1u);
+    ASSERT_TRUE(db.getPendingHistory(door, heldTime, heldValue));
+    EXPECT_DOUBLE_EQ(heldValue, 10.0);
+    EXPECT_EQ(db.getHistoryTotal(band), 1u);
+
+    db.set(band, 7.0);
+    db.sampleHistory(start + seconds(21));
+    EXPECT_EQ(db.getHistoryTotal(band), 2u);
+    EXPECT_DOUBLE_EQ(db.getHistory(band).back(), 7.0);
+}
+
+class DeadbandConfigTest : public SceneConfigTest {
+protected:
+    DeadbandConfigTest() : SceneConfigTest("test_deadband") {}
+
+    void expectConfig(const VariableDatabase& db) {
+        TagId flow = db.findTag("deadband_flow");
+        TagId level = db.findTag("deadband_level");
+        ASSERT_NE(flow, INVALID_TAG);
+        EXPECT_DOUBLE_EQ(db.getNotifyDeadband(flow).absolute, 0.5);
+        EXPECT_DOUBLE_EQ(db.getHistoryPolicy(flow).swingingDoor, 0.2);
+        EXPECT_DOUBLE_EQ(db.getNotifyDeadband(level).percent, 2.0);
+        EXPECT_DOUBLE_EQ(db.getNotifyDeadband(level).span, 150.0);
+        EXPECT_FALSE(db.isHistoryEnabled(level));
+    }
+};
+
+TEST_F(DeadbandConfigTest, ConfigAppliesFromJsonSceneAndReload) {
+    json scene = {{"tags", {{"deadband_flow", {{"deadband", 0.5}, {"history", {{"swingingDoor", 0.2}}}}},
+                            {"deadband_level", {{"deadband", {{"percent", 2}, {"range", {0, 150}}}}}}}},
+                  {"objects", {{{"type", "Text"}, {"name", "Label"}, {"variable", "deadband_level"}}}}};
+    EXPECT_EQ(diff(scene).notifyDeadbands.size(), 2u);
+
+    ASSERT_NO_FATAL_FAILURE(load(scene, 1));
+    expectConfig(jsonDb);
+    expectConfig(sceneDb);
+
+    // Перезагрузка: измененная зона применяется, снятая - отключается
+    scene["tags"]["deadband_flow"]["deadband"] = 1.5;
+    scene["tags"]["deadband_level"] = json::object();
+    ScenePatch patch = reload(scene);
+    ASSERT_EQ(patch.notifyDeadbands.size(), 2u);
+    EXPECT_EQ(patch.historyPolicies.size(), 1u);  // Запись переменной в секции изменилась целиком
+    EXPECT_DOUBLE_EQ(sceneDb.getNotifyDeadband(sceneDb.findTag("deadband_flow")).absolute, 1.5);
+    EXPECT_DOUBLE_EQ(sceneDb.getNotifyDeadband(sceneDb.findTag("deadband_level")).percent, 0.0);
+    EXPECT_TRUE(diff(scene).empty());
+}
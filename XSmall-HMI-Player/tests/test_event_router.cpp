@@ -0,0 +1,234 @@
+#include <gtest/gtest.h>
+#include <SFML/Graphics.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "EventRouter.h"
+#include "VariableDatabase.h"
+#include "Button.h"
+
+namespace {
+
+// Интерактивный объект, запоминающий доставленные ему события
+class Probe : public VisualObject {
+public:
+    sf::FloatRect rect;
+    bool focusable;
+    std::vector<sf::Event::EventType> events;
+    int hoverChanges = 0;
+    bool hovered = false;
+    bool focused = false;
+    static int containsCalls;
+
+    Probe(float x, float y, float width, float height, VariableDatabase* db, bool focusable = false)
+        : VisualObject(x, y, "Probe", db), rect(x, y, width, height), focusable(focusable) {}
+
+    void draw(sf::RenderTarget& target) override {}
+    void update() override {}
+    void handleEvent(const sf::Event& event, sf::RenderWindow& window) override { events.push_back(event.type); }
+    sf::FloatRect getBounds() const override { return rect; }
+    bool isInteractive() const override { return true; }
+    bool acceptsFocus() const override { return focusable; }
+    void setHovered(bool value) override { hovered = value; ++hoverChanges; }
+    void setFocused(bool value) override { focused = value; }
+    bool contains(float pointX, float pointY) const override {
+        ++containsCalls;
+        return rect.contains(pointX, pointY);
+    }
+};
+
+int Probe::containsCalls = 0;
+
+sf::Event mouseEvent(sf::Event::EventType type, int x, int y) {
+    sf::Event event;
+    event.type = type;
+    if (type == sf::Event::MouseMoved) {
+        event.mouseMove.x = x;
+        event.mouseMove.y = y;
+    } else {
+        event.mouseButton.button = sf::Mouse::Left;
+        event.mouseButton.x = x;
+        event.mouseButton.y = y;
+    }
+    return event;
+}
+
+sf::Event textEvent(sf::Uint32 unicode) {
+    sf::Event event;
+    event.type = sf::Event::TextEntered;
+    event.text.unicode = unicode;
+    return event;
+}
+
+} // namespace
+
+class EventRouterTest : public ::testing::Test {
+protected:
+    VariableDatabase db;
+    std::vector<std::unique_ptr<VisualObject>> objects;
+    EventRouter router;
+    sf::RenderWindow window;
+
+    Probe* addProbe(float x, float y, float width, float height, bool focusable = false) {
+        objects.push_back(std::make_unique<Probe>(x, y, width, height, &db, focusable));
+        return static_cast<Probe*>(objects.back().get());
+    }
+
+    void send(const sf::Event& event) {
+        sf::Vector2i pixel;
+        sf::Vector2f point;
+        if (EventRouter::getPixelPosition(event, pixel)) {
+            point = sf::Vector2f(static_cast<float>(pixel.x), static_cast<float>(pixel.y));
+        }
+        router.route(event, point, window);
+    }
+};
+
+TEST_F(EventRouterTest, HitTestPicksTopmostObject) {
+    Probe* bottom = addProbe(0, 0, 200, 200);
+    Probe* top = addProbe(100, 100, 200, 200);
+    router.build(objects);
+
+    EXPECT_EQ(router.getIndexedCount(), 2u);
+    EXPECT_EQ(router.hitTest(sf::Vector2f(50, 50)), bottom);
+    // Пересечение - объект, нарисованный позже
+    EXPECT_EQ(router.hitTest(sf::Vector2f(150, 150)), top);
+    EXPECT_EQ(router.hitTest(sf::Vector2f(250, 250)), top);
+    EXPECT_EQ(router.hitTest(sf::Vector2f(250, 50)), nullptr);
+    EXPECT_EQ(router.hitTest(sf::Vector2f(-10, 50)), nullptr);
+}
+
+TEST_F(EventRouterTest, MouseButtonsGoToObjectUnderCursor) {
+    Probe* first = addProbe(0, 0, 100, 100);
+    Probe* second = addProbe(200, 0, 100, 100);
+    router.build(objects);
+
+    send(mouseEvent(sf::Event::MouseButtonPressed, 50, 50));
+    // Кнопку отпустили над другим объектом - отпускание получает тот, на ком нажали
+    send(mouseEvent(sf::Event::MouseButtonReleased, 250, 50));
+
+    ASSERT_EQ(first->events.size(), 2u);
+    EXPECT_EQ(first->events[0], sf::Event::MouseButtonPressed);
+    EXPECT_EQ(first->events[1], sf::Event::MouseButtonReleased);
+    EXPECT_TRUE(second->events.empty());
+    EXPECT_EQ(router.getHovered(), second);
+}
+
+TEST_F(EventRouterTest, MouseMovesAreCoalesced) {
+    Probe* first = addProbe(0, 0, 100, 100);
+    Probe* second = addProbe(200, 0, 100, 100);
+    router.build(objects);
+
+    // Курсор пересек первый объект и остановился на втором - наведение меняется один раз
+    for (int x = 0; x < 250; x += 5) {
+        send(mouseEvent(sf::Event::MouseMoved, x, 50));
+    }
+    EXPECT_EQ(first->hoverChanges, 0);
+    EXPECT_EQ(router.getHovered(), nullptr);
+
+    router.flush();
+    EXPECT_EQ(first->hoverChanges, 0);
+    EXPECT_EQ(second->hoverChanges, 1);
+    EXPECT_TRUE(second->hovered);
+    EXPECT_TRUE(first->events.empty());
+    EXPECT_TRUE(second->events.empty());
+}
+
+TEST_F(EventRouterTest, KeyboardGoesToFocusedObject) {
+    Probe* field = addProbe(0, 0, 100, 30, true);
+    Probe* other = addProbe(0, 100, 100, 30, true);
+    Probe* button = addProbe(200, 0, 100, 30);
+    router.build(objects);
+
+    // Без фокуса ввод никому не доставляется
+    send(textEvent('1'));
+    EXPECT_TRUE(field->events.empty());
+
+    send(mouseEvent(sf::Event::MouseButtonPressed, 10, 10));
+    send(mouseEvent(sf::Event::MouseButtonReleased, 10, 10));
+    EXPECT_TRUE(field->focused);
+    EXPECT_EQ(router.getFocused(), field);
+
+    send(textEvent('2'));
+    EXPECT_EQ(field->events.back(), sf::Event::TextEntered);
+    EXPECT_TRUE(other->events.empty());
+    EXPECT_TRUE(button->events.empty());
+
+    // Нажатие на объект без фокуса снимает фокус с поля
+    send(mouseEvent(sf::Event::MouseButtonPressed, 210, 10));
+    EXPECT_FALSE(field->focused);
+    EXPECT_EQ(router.getFocused(), nullptr);
+    std::size_t fieldEvents = field->events.size();
+    send(textEvent('3'));
+    EXPECT_EQ(field->events.size(), fieldEvents);
+}
+
+TEST_F(EventRouterTest, HitTestCostIndependentOfObjectCount) {
+    // Сетка 100x100 кнопок 20x20 с шагом 30px
+    for (int row = 0; row < 100; ++row) {
+        for (int column = 0; column < 100; ++column) {
+            addProbe(column * 30.0f, row * 30.0f, 20, 20);
+        }
+    }
+    router.build(objects);
+    ASSERT_EQ(router.getIndexedCount(), 10000u);
+
+    Probe::containsCalls = 0;
+    const int queries = 1000;
+    for (int i = 0; i < queries; ++i) {
+        float x = static_cast<float>((i * 37) % 3000);
+        float y = static_cast<float>((i * 91) % 3000);
+        router.hitTest(sf::Vector2f(x, y));
+    }
+    // Проверяются только объекты одной ячейки, а не все 10 000
+    EXPECT_LE(Probe::containsCalls, queries * 9);
+}
+
+TEST_F(EventRouterTest, ButtonClickThroughRouter) {
+    sf::Font font;
+    if (!font.loadFromFile("assets/fonts/helveticabold.ttf") &&
+        !font.loadFromFile("../assets/fonts/helveticabold.ttf")) {
+        GTEST_SKIP() << "Font cannot be loaded, skip the test ButtonClickThroughRouter";
+    }
+
+    int clicks = 0;
+    objects.push_back(std::make_unique<Button>(0, 0, 100, 30, "OK", &font, 14, sf::Color::Green, "Button", &db,
+                                               "", [&clicks]() { ++clicks; }));
+    router.build(objects);
+
+    send(mouseEvent(sf::Event::MouseButtonPressed, 50, 15));
+    send(mouseEvent(sf::Event::MouseButtonReleased, 50, 15));
+    EXPECT_EQ(clicks, 1);
+
+    // Нажали на кнопке, отпустили за ее пределами - клика нет
+    send(mouseEvent(sf::Event::MouseButtonPressed, 50, 15));
+    send(mouseEvent(sf::Event::MouseMoved, 300, 300));
+    send(mouseEvent(sf::Event::MouseButtonReleased, 300, 300));
+    EXPECT_EQ(clicks, 1);
+}
+
+TEST_F(EventRouterTest, RebuildKeepsFocusOnRemainingObjects) {
+    Probe* field = addProbe(0, 0, 100, 30, true);
+    addProbe(200, 0, 100, 30);
+    router.build(objects);
+
+    send(mouseEvent(sf::Event::MouseButtonPressed, 50, 10));
+    send(mouseEvent(sf::Event::MouseButtonReleased, 50, 10));
+    ASSERT_EQ(router.getFocused(), field);
+
+    // Сцену перезагрузили, поле ввода осталось - фокус и наведение сохраняются
+    addProbe(400, 0, 100, 30);
+    router.build(objects);
+    EXPECT_EQ(router.getFocused(), field);
+    EXPECT_EQ(router.getHovered(), field);
+    send(textEvent('7'));
+    EXPECT_EQ(field->events.back(), sf::Event::TextEntered);
+
+    // Поле удалили - фокус снимается
+    std::unique_ptr<VisualObject> removed = std::move(objects.front());
+    objects.erase(objects.begin());
+    router.build(objects);
+    EXPECT_EQ(router.getFocused(), nullptr);
+    EXPECT_EQ(router.getHovered(), nullptr);
+}
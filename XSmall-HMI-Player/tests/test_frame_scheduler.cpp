@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <vector>
+#include <string>
+
+#include "TimerWheel.h"
+#include "FrameScheduler.h"
+
+using namespace std::chrono;
+
+TEST(TimerWheelTest, PeriodicAndOneShotTimers) {
+    TimerWheel wheel(milliseconds(10), 16);
+    int periodic = 0;
+    int once = 0;
+    wheel.scheduleEvery(milliseconds(50), [&]() { ++periodic; });
+    wheel.scheduleOnce(milliseconds(30), [&]() { ++once; });
+
+    // Продвигаем по 5 мс: таймеры срабатывают строго по сроку
+    for (int i = 0; i < 100; ++i) {
+        wheel.advance(milliseconds(5));
+    }
+
+    EXPECT_EQ(periodic, 10);  // 500 мс / 50 мс
+    EXPECT_EQ(once, 1);
+    EXPECT_EQ(wheel.getTimerCount(), 1u);
+}
+
+TEST(TimerWheelTest, LongIntervalsSpanSeveralTurns) {
+    // Период больше оборота колеса (16 слотов по 10 мс)
+    TimerWheel wheel(milliseconds(10), 16);
+    int calls = 0;
+    wheel.scheduleEvery(milliseconds(1000), [&]() { ++calls; });
+
+    wheel.advance(milliseconds(990));
+    EXPECT_EQ(calls, 0);
+    wheel.advance(milliseconds(10));
+    EXPECT_EQ(calls, 1);
+}
+
+TEST(TimerWheelTest, CancelAndMissedPeriods) {
+    TimerWheel wheel(milliseconds(10), 16);
+    int calls = 0;
+    TimerWheel::TimerId id = wheel.scheduleEvery(milliseconds(20), [&]() { ++calls; });
+
+    // После долгой паузы пропущенные периоды не навёрстываются
+    wheel.advance(seconds(5));
+    EXPECT_EQ(calls, 1);
+
+    wheel.cancel(id);
+    wheel.advance(seconds(1));
+    EXPECT_EQ(calls, 1);
+    EXPECT_EQ(wheel.getTimerCount(), 0u);
+}
+
+TEST(TimerWheelTest, CancelFromOwnCallback) {
+    TimerWheel wheel(milliseconds(10), 16);
+    int calls = 0;
+    TimerWheel::TimerId id = TimerWheel::INVALID_TIMER;
+    id = wheel.scheduleEvery(milliseconds(10), [&]() {
+        if (++calls == 3) {
+            wheel.cancel(id);
+        }
+    });
+
+    for (int i = 0; i < 10; ++i) {
+        wheel.advance(milliseconds(10));
+    }
+    EXPECT_EQ(calls, 3);
+}
+
+TEST(FrameSchedulerTest, IndependentRates) {
+    SchedulerConfig config;
+    config.renderRate = 50;
+    config.tickRate = 100;
+    config.inputRate = 200;
+
+    FrameScheduler scheduler(config);
+    std::vector<std::string> order;
+    scheduler.setInputHandler([&]() { order.push_back("input"); });
+    scheduler.setTickHandler([&]() { order.push_back("tick"); });
+    scheduler.setRenderHandler([&]() { order.push_back("render"); });
+
+    // Один момент: ввод, затем логика, затем кадр
+    FrameScheduler::Clock::time_point start;
+    scheduler.step(start);
+    ASSERT_EQ(order.size(), 3u);
+    EXPECT_EQ(order[0], "input");
+    EXPECT_EQ(order[1], "tick");
+    EXPECT_EQ(order[2], "render");
+
+    // Ровно секунда модельного времени, шагая по ближайшим срокам
+    FrameScheduler::Clock::time_point now = start;
+    while (true) {
+        now = scheduler.step(now);
+        if (now >= start + seconds(1)) {
+            break;
+        }
+    }
+
+    EXPECT_EQ(scheduler.getInputPollCount(), 200u);
+    EXPECT_EQ(scheduler.getTickCount(), 100u);
+    EXPECT_EQ(scheduler.getFrameCount(), 50u);
+}
+
+TEST(FrameSchedulerTest, CatchUpIsBounded) {
+    SchedulerConfig config;
+    config.tickRate = 100;
+    config.maxTicksPerFrame = 5;
+
+    FrameScheduler scheduler(config);
+    int renders = 0;
+    scheduler.setRenderHandler([&]() { ++renders; });
+
+    FrameScheduler::Clock::time_point start;
+    scheduler.step(start);
+    EXPECT_EQ(scheduler.getTickCount(), 1u);
+
+    // Задержка на 1 секунду: догоняем не больше 5 тактов и один кадр
+    scheduler.step(start + seconds(1));
+    EXPECT_EQ(scheduler.getTickCount(), 6u);
+    EXPECT_EQ(renders, 2);
+}
+
+TEST(FrameSchedulerTest, RequestedFrameIsNotDelayed) {
+    FrameScheduler scheduler;
+    int renders = 0;
+    scheduler.setRenderHandler([&]() { ++renders; });
+
+    FrameScheduler::Clock::time_point start;
+    scheduler.step(start);
+    EXPECT_EQ(renders, 1);
+
+    // До срока следующего кадра (16.7 мс) кадр выводится только по запросу
+    scheduler.step(start + milliseconds(4));
+    EXPECT_EQ(renders, 1);
+
+    scheduler.requestFrame();
+    FrameScheduler::Clock::time_point next = scheduler.step(start + milliseconds(8));
+    EXPECT_EQ(renders, 2);
+    EXPECT_LE(next, start + milliseconds(8) + scheduler.getTickInterval());
+}
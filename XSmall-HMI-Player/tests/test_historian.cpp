@@ -0,0 +1,234 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <vector>
+
+#include "Historian.h"
+#include "VariableDatabase.h"
+#include "HistoryTags.h"
+
+using namespace std::chrono;
+
+class HistorianTest : public ::testing::Test {
+protected:
+    const std::string directory = "test_historian_archive";
+    HistoryClock::time_point start = HistoryClock::now() - hours(3);
+
+    void SetUp() override {
+        std::filesystem::remove_all(directory);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(directory);
+        std::filesystem::remove_all(directory + "_single");
+    }
+
+    std::string segment(const std::string& fileName, int number) const {
+        return (std::filesystem::path(directory) / (fileName + "." + std::to_string(number) + ".hist")).string();
+    }
+
+    // Отметки архива - миллисекунды: сравниваем с точностью до миллисекунды
+    static void expectTime(HistoryClock::time_point actual, HistoryClock::time_point expected) {
+        EXPECT_LT(std::abs(duration_cast<microseconds>(actual - expected).count()), 1000);
+    }
+};
+
+TEST_F(HistorianTest, QueriesWrittenAndPendingChunks) {
+    Historian historian(directory);
+    historian.setChunkAge(minutes(10));
+    for (int i = 0; i < 3000; ++i) {
+        historian.append("hist_flow", i * 0.25, start + seconds(i));
+    }
+    historian.append("hist level", 7.5, start);
+
+    // Закрытые куски в очереди и открытый кусок видны до записи
+    std::vector<double> values;
+    std::vector<HistoryClock::time_point> times;
+    ASSERT_EQ(historian.query("hist_flow", start, start + hours(1), values, times), 3000u);
+    EXPECT_DOUBLE_EQ(values[2999], 2999 * 0.25);
+
+    historian.flush();
+    EXPECT_EQ(historian.getChunksWritten(), 2u);  // По CHUNK_SAMPLES значений, остальное - в открытых кусках
+    EXPECT_TRUE(std::filesystem::exists(segment("hist_flow", 1)));
+    EXPECT_TRUE(std::filesystem::exists(segment("hist%20level", 1)));
+
+    ASSERT_EQ(historian.query("hist_flow", start + seconds(100), start + seconds(200), values, times), 100u);
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        EXPECT_DOUBLE_EQ(values[i], (100 + i) * 0.25);
+        expectTime(times[i], start + seconds(100 + i));
+    }
+
+    // Последние значения диапазона разжимаются с конца
+    ASSERT_EQ(historian.query("hist_flow", start, start + seconds(2500), values, times, 50), 50u);
+    EXPECT_DOUBLE_EQ(values.front(), 2450 * 0.25);
+    EXPECT_DOUBLE_EQ(values.back(), 2499 * 0.25);
+
+    ASSERT_EQ(historian.query("hist level", start, start + seconds(1), values, times), 1u);
+    EXPECT_DOUBLE_EQ(values[0], 7.5);
+    EXPECT_EQ(historian.query("hist_missing", start, start + hours(1), values, times), 0u);
+}
+
+TEST_F(HistorianTest, PeriodicWritesExtendOpenChunk) {
+    std::mt19937 random(5);
+    std::normal_distribution<double> noise(0.0, 1.0);
+    std::vector<double> written;
+    for (int i = 0; i < 1000; ++i) {
+        written.push_back(20.0 + noise(random));
+    }
+
+    // Раз в минуту новые значения дописываются в тот же кусок: архив совпадает
+    // байт в байт с записанным за один раз
+    {
+        Historian historian(directory);
+        historian.setChunkAge(minutes(1));
+        for (int i = 0; i < 1000; ++i) {
+            historian.append("hist_open", written[i], start + seconds(i));
+            if (i % 60 == 59) {
+                historian.poll(start + seconds(i + 1));
+            }
+        }
+        historian.flush();
+        EXPECT_EQ(historian.getChunksWritten(), 0u);
+    }
+    {
+        Historian historian(directory + "_single");
+        historian.setChunkAge(hours(1));
+        for (int i = 0; i < 1000; ++i) {
+            historian.append("hist_open", written[i], start + seconds(i));
+        }
+    }
+    std::uintmax_t size = std::filesystem::file_size(segment("hist_open", 1));
+    EXPECT_EQ(size, std::filesystem::file_size(directory + "_single/hist_open.1.hist"));
+
+    // После перезапуска кусок не продолжается, новый пишется в тот же сегмент
+    Historian historian(directory);
+    for (int i = 1000; i < 1100; ++i) {
+        historian.append("hist_open", i, start + seconds(i));
+    }
+    historian.flush();
+    EXPECT_GT(std::filesystem::file_size(segment("hist_open", 1)), size);
+    EXPECT_FALSE(std::filesystem::exists(segment("hist_open", 2)));
+
+    std::vector<double> values;
+    std::vector<HistoryClock::time_point> times;
+    ASSERT_EQ(historian.query("hist_open", start, start + hours(1), values, times), 1100u);
+    EXPECT_EQ(std::vector<double>(values.begin(), values.begin() + 1000), written);
+    EXPECT_DOUBLE_EQ(values.back(), 1099.0);
+}
+
+TEST_F(HistorianTest, ReopenReadsSegmentsAndBackfillsHistory) {
+    std::mt19937 random(3);
+    std::normal_distribution<double> noise(0.0, 1.0);
+    std::vector<double> written;
+    {
+        Historian historian(directory);
+        historian.setSegmentBytes(2048);
+        historian.setChunkAge(minutes(1));
+        for (int i = 0; i < 5000; ++i) {
+            written.push_back(50.0 + noise(random));
+            historian.append("hist_reopen", written.back(), start + seconds(i));
+        }
+    }
+    EXPECT_TRUE(std::filesystem::exists(segment("hist_reopen", 5)));
+
+    Historian historian(directory);
+    std::vector<double> values;
+    std::vector<HistoryClock::time_point> times;
+    ASSERT_EQ(historian.query("hist_reopen", start, start + hours(2), values, times), written.size());
+    EXPECT_EQ(values, written);
+    expectTime(times.back(), start + seconds(4999));
+
+    // Пустая история переменной заполняется последними значениями в пределах емкости
+    VariableDatabase db;
+    TagId tag = db.resolveTag("hist_reopen");
+    db.requestHistoryCapacity(tag, 300);
+    TagId fresh = historyTag(db, "hist_fresh");
+    historian.attach(db);
+    EXPECT_EQ(historian.backfill(db, hours(24)), 1u);
+    HistoryView history = db.getHistory(tag);
+    ASSERT_EQ(history.size(), 300u);
+    EXPECT_DOUBLE_EQ(history[0], written[4700]);
+    EXPECT_DOUBLE_EQ(history.back(), written.back());
+    expectTime(history.time(0), start + seconds(4700));
+    expectTime(history.time(299), start + seconds(4999));
+    EXPECT_FALSE(db.getHistoryPolicy(tag).persistent);  // Архив не делает историю частью состояния
+    EXPECT_EQ(db.getHistory(fresh).size(), 0u);
+
+    // Дальше архив получает все, что база записывает в историю
+    db.addToHistory(tag, 42.0);
+    db.set(fresh, 5.0);
+    historian.flush();
+    HistoryClock::time_point now = HistoryClock::now() + seconds(1);
+    ASSERT_EQ(historian.query("hist_reopen", start, now, values, times), written.size() + 1);
+    EXPECT_DOUBLE_EQ(values.back(), 42.0);
+    ASSERT_EQ(historian.query("hist_fresh", start, now, values, times), 1u);
+    EXPECT_DOUBLE_EQ(values[0], 5.0);
+}
+
+TEST_F(HistorianTest, DamagedChunksAreSkipped) {
+    {
+        Historian historian(directory);
+        for (int i = 0; i < 2100; ++i) {
+            historian.append("hist_torn", i, start + seconds(i));
+        }
+    }
+
+    // Недописанный кусок после сбоя: читается все до него, а запись идет в новый сегмент
+    {
+        std::ofstream(segment("hist_torn", 1), std::ios::binary | std::ios::app) << "torn chunk";
+    }
+    std::vector<double> values;
+    std::vector<HistoryClock::time_point> times;
+    {
+        Historian historian(directory);
+        EXPECT_EQ(historian.query("hist_torn", start, start + hours(1), values, times), 2100u);
+        for (int i = 2100; i < 2160; ++i) {
+            historian.append("hist_torn", i, start + seconds(i));
+        }
+        historian.flush();
+        EXPECT_TRUE(std::filesystem::exists(segment("hist_torn", 2)));
+        EXPECT_EQ(historian.query("hist_torn", start, start + hours(1), values, times), 2160u);
+    }
+
+    // Испорченный бит в первом куске: кусок отбрасывается по crc, остальные читаются
+    {
+        std::fstream file(segment("hist_torn", 1), std::ios::binary | std::ios::in | std::ios::out);
+        file.seekg(40);
+        char byte = static_cast<char>(file.get() ^ 0x10);
+        file.seekp(40);
+        file.put(byte);
+    }
+    Historian historian(directory);
+    ASSERT_EQ(historian.query("hist_torn", start, start + hours(1), values, times), 2160u - Historian::CHUNK_SAMPLES);
+    EXPECT_DOUBLE_EQ(values.front(), double(Historian::CHUNK_SAMPLES));
+    EXPECT_DOUBLE_EQ(values.back(), 2159.0);
+}
+
+TEST_F(HistorianTest, RetentionRemovesOldSegments) {
+    {
+        Historian historian(directory);
+        historian.setSegmentBytes(256);
+        for (int i = 0; i < 3100; ++i) {
+            historian.append("hist_old", i + std::sin(i), start + seconds(i));
+        }
+    }
+    ASSERT_TRUE(std::filesystem::exists(segment("hist_old", 4)));
+
+    // Сегменты, не менявшиеся больше недели, удаляются при открытии
+    auto old = std::filesystem::file_time_type::clock::now() - hours(24 * 8);
+    std::filesystem::last_write_time(segment("hist_old", 1), old);
+    std::filesystem::last_write_time(segment("hist_old", 2), old);
+
+    Historian historian(directory, hours(24 * 7));
+    EXPECT_FALSE(std::filesystem::exists(segment("hist_old", 1)));
+    EXPECT_FALSE(std::filesystem::exists(segment("hist_old", 2)));
+    std::vector<double> values;
+    std::vector<HistoryClock::time_point> times;
+    historian.query("hist_old", start, start + hours(1), values, times);
+    ASSERT_EQ(values.size(), 3100u - 2 * Historian::CHUNK_SAMPLES);
+    EXPECT_DOUBLE_EQ(values.front(), 2048 + std::sin(2048));
+    EXPECT_DOUBLE_EQ(values.back(), 3099 + std::sin(3099));
+}
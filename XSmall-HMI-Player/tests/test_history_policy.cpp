@@ -0,0 +1,163 @@
+#include <gtest/gtest.h>
+#include <SFML/Graphics.hpp>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+
+#include "SceneConfigTest.h"
+#include "HistoryTags.h"
+#include "HistoryGraph.h"
+#include "StateManager.h"
+
+using json = nlohmann::json;
+using namespace std::chrono;
+
+class HistoryPolicyTest : public SceneConfigTest {
+protected:
+    const std::string stateFile = "test_history_policy_state.json";
+
+    HistoryPolicyTest() : SceneConfigTest("test_history_policy") {}
+
+    void TearDown() override {
+        SceneConfigTest::TearDown();
+        std::filesystem::remove(stateFile);
+        std::filesystem::remove(stateFile + ".tmp");
+    }
+
+    // Сцена с графиком, текстом без истории и секцией политик
+    json makeScene() {
+        return {{"historyCapacity", 50},
+                {"tags", {{"policy_archive", {{"history", {{"capacity", 400}, {"deadband", 0.5},
+                                                           {"compression", true}, {"persist", true}}}}},
+                          {"policy_plain", {{"history", true}}},
+                          {"policy_off", {{"history", false}}}}},
+                {"objects", {{{"type", "HistoryGraph"}, {"name", "Graph"}, {"variable", "policy_graph"},
+                              {"maxHistory", 200}},
+                             {{"type", "Text"}, {"name", "Label"}, {"variable", "policy_off"}}}}};
+    }
+
+    void expectPolicies(const VariableDatabase& db) {
+        TagId archive = db.findTag("policy_archive");
+        ASSERT_NE(archive, INVALID_TAG);
+        HistoryPolicy policy = db.getHistoryPolicy(archive);
+        EXPECT_TRUE(db.isHistoryEnabled(archive));
+        EXPECT_EQ(policy.capacity, 400u);
+        EXPECT_DOUBLE_EQ(policy.deadband, 0.5);
+        EXPECT_TRUE(policy.compressed);
+        EXPECT_TRUE(policy.persistent);
+        EXPECT_NE(db.getCompressedHistory(archive), nullptr);
+
+        EXPECT_TRUE(db.isHistoryEnabled(db.findTag("policy_plain")));
+        EXPECT_EQ(db.getHistoryCapacity(db.findTag("policy_plain")), 50u);
+        EXPECT_TRUE(db.isHistoryEnabled(db.findTag("policy_graph")));
+        EXPECT_EQ(db.getHistoryCapacity(db.findTag("policy_graph")), 200u);
+        EXPECT_FALSE(db.isHistoryEnabled(db.findTag("policy_off")));
+    }
+};
+
+TEST_F(HistoryPolicyTest, OnlyConsumersAndPoliciesRecordHistory) {
+    VariableDatabase db;
+    std::size_t baseline = db.getHistoryMemoryUsage();
+    TagId plain = db.resolveTag("policy_value");
+    TagId graphed = db.resolveTag("policy_trend");
+    HistoryGraph graph(0, 0, 200, 100, "Trend", &db, "policy_trend", 100);
+
+    for (int i = 0; i < 100; ++i) {
+        db.set(plain, i);
+        db.set(graphed, i);
+    }
+
+    // Значение и подписчики обновляются, но история без потребителя не занимает памяти
+    EXPECT_DOUBLE_EQ(db.get(plain), 99.0);
+    EXPECT_FALSE(db.isHistoryEnabled(plain));
+    EXPECT_EQ(db.getHistoryTotal(plain), 0u);
+    EXPECT_EQ(db.getHistoryCapacity(plain), DEFAULT_HISTORY_CAPACITY);
+    EXPECT_EQ(db.getHistoryTotal(graphed), 100u);
+    EXPECT_GE(db.getHistoryMemoryUsage(), baseline + 100 * (sizeof(double) + sizeof(HistoryClock::time_point)));
+
+    // Явная запись в историю тоже включает ее
+    db.addToHistory(plain, 5.0);
+    EXPECT_TRUE(db.isHistoryEnabled(plain));
+    EXPECT_EQ(db.getHistory(plain).size(), 1u);
+}
+
+TEST_F(HistoryPolicyTest, DeadbandSkipsSmallChanges) {
+    VariableDatabase db;
+    TagId tag = db.resolveTag("policy_noisy");
+    HistoryPolicy policy;
+    policy.deadband = 1.0;
+    db.setHistoryPolicy(tag, policy);
+
+    // Дрожание меньше зоны вокруг последнего записанного значения не пишется
+    const double values[] = {10.0, 10.4, 9.3, 10.9, 11.0, 11.5, 12.2, 12.2, 5.0};
+    for (double value : values) {
+        db.set(tag, value);
+    }
+    HistoryView history = db.getHistory(tag);
+    ASSERT_EQ(history.size(), 4u);
+    EXPECT_DOUBLE_EQ(history[0], 10.0);
+    EXPECT_DOUBLE_EQ(history[1], 11.0);
+    EXPECT_DOUBLE_EQ(history[2], 12.2);
+    EXPECT_DOUBLE_EQ(history[3], 5.0);
+    EXPECT_DOUBLE_EQ(db.get(tag), 5.0);  // Текущее значение от зоны не зависит
+}
+
+TEST_F(HistoryPolicyTest, ConfigPoliciesApplyFromJsonSceneAndReload) {
+    json scene = makeScene();
+    EXPECT_EQ(diff(scene).historyPolicies.size(), 2u);  // "history": false политикой не считается
+
+    // JSON и бинарная сцена дают одни и те же политики
+    ASSERT_NO_FATAL_FAILURE(load(scene, 2));
+    expectPolicies(jsonDb);
+    expectPolicies(sceneDb);
+
+    // Перезагрузка применяет только новые и измененные политики
+    scene["tags"]["policy_plain"] = {{"history", {{"capacity", 800}}}};
+    scene["tags"]["policy_off"] = {{"history", true}};
+    ScenePatch patch = reload(scene);
+    ASSERT_EQ(patch.historyPolicies.size(), 2u);
+    EXPECT_FALSE(patch.empty());
+    EXPECT_EQ(sceneDb.getHistoryCapacity(sceneDb.findTag("policy_plain")), 800u);
+    EXPECT_TRUE(sceneDb.isHistoryEnabled(sceneDb.findTag("policy_off")));
+    EXPECT_TRUE(diff(scene).empty());
+}
+
+TEST_F(HistoryPolicyTest, PersistentHistorySurvivesRestart) {
+    HistoryClock::time_point start = HistoryClock::now() - seconds(60);
+    {
+        VariableDatabase db;
+        TagId kept = db.resolveTag("policy_kept");
+        TagId transient = historyTag(db, "policy_transient");
+        HistoryPolicy policy;
+        policy.persistent = true;
+        policy.compressed = true;
+        db.setHistoryPolicy(kept, policy);
+        for (int i = 0; i < 30; ++i) {
+            db.addToHistory(kept, i * 1.5, start + seconds(i));
+            db.addToHistory(transient, i, start + seconds(i));
+        }
+        db.set(kept, 44.0);
+
+        StateManager manager(stateFile);
+        manager.saveState(db);
+        manager.flush();
+    }
+
+    VariableDatabase restored;
+    StateManager manager(stateFile);
+    ASSERT_TRUE(manager.loadState(restored));
+    TagId kept = restored.findTag("policy_kept");
+    ASSERT_NE(kept, INVALID_TAG);
+    EXPECT_TRUE(restored.getHistoryPolicy(kept).persistent);
+    EXPECT_FALSE(restored.isHistoryEnabled(restored.findTag("policy_transient")));
+
+    // Значения на месте, отметки - с точностью до миллисекунды Unix-времени
+    HistoryView history = restored.getHistory(kept);
+    ASSERT_EQ(history.size(), 31u);
+    EXPECT_DOUBLE_EQ(history[10], 15.0);
+    EXPECT_DOUBLE_EQ(history.back(), 44.0);
+    for (std::size_t i = 0; i < 30; ++i) {
+        auto error = duration_cast<milliseconds>(history.time(i) - (start + seconds(i))).count();
+        EXPECT_LE(std::abs(error), 5) << "sample " << i;
+    }
+}
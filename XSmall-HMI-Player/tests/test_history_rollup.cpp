@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include "HistoryRollup.h"
+#include "VariableDatabase.h"
+
+using namespace std::chrono;
+
+namespace {
+
+// Отметки времени через год от эпохи часов (часы монотонные, эпоха не важна)
+HistoryClock::time_point at(HistoryClock::duration offset) {
+    return HistoryClock::time_point(hours(24 * 365)) + offset;
+}
+
+} // namespace
+
+TEST(HistoryRollupTest, AggregatesMatchRawValues) {
+    HistoryRollup rollup;
+    std::vector<double> values;
+    for (int i = 0; i < 600; ++i) {
+        double value = (i * 37) % 101;
+        values.push_back(value);
+        rollup.add(at(milliseconds(i * 250)), value);  // 4 значения в секунду
+    }
+
+    // 150 с по 10 столбцов: уровень 1 с, в столбце 15 секунд = 60 значений
+    std::vector<HistoryAggregate> result = rollup.query(at(seconds(0)), at(seconds(150)), 10);
+    ASSERT_EQ(result.size(), 10u);
+    for (std::size_t column = 0; column < result.size(); ++column) {
+        auto begin = values.begin() + column * 60;
+        auto end = begin + 60;
+        EXPECT_EQ(result[column].count, 60u);
+        EXPECT_DOUBLE_EQ(result[column].min, *std::min_element(begin, end));
+        EXPECT_DOUBLE_EQ(result[column].max, *std::max_element(begin, end));
+        double sum = 0;
+        for (auto it = begin; it != end; ++it) sum += *it;
+        EXPECT_DOUBLE_EQ(result[column].average(), sum / 60);
+    }
+}
+
+TEST(HistoryRollupTest, SelectsCoarsestLevelForResolution) {
+    HistoryRollup rollup;
+    EXPECT_EQ(rollup.selectLevel(milliseconds(100)), 0u);
+    EXPECT_EQ(rollup.selectLevel(seconds(59)), 0u);
+    EXPECT_EQ(rollup.selectLevel(minutes(1)), 1u);
+    EXPECT_EQ(rollup.selectLevel(minutes(59)), 1u);
+    EXPECT_EQ(rollup.selectLevel(hours(2)), 2u);
+
+    // 30 суток по 1 значению в 10 с: час уже вытеснен с уровня 1 с, но месяц есть в часовом
+    for (int i = 0; i < 30 * 24 * 360; ++i) {
+        rollup.add(at(seconds(i * 10)), i < 15 * 24 * 360 ? 1.0 : 2.0);
+    }
+    std::vector<HistoryAggregate> month = rollup.query(at(seconds(0)), at(hours(30 * 24)), 30);
+    ASSERT_EQ(month.size(), 30u);
+    for (std::size_t day = 0; day < 30; ++day) {
+        EXPECT_EQ(month[day].count, 24u * 360u) << "day " << day;
+        EXPECT_DOUBLE_EQ(month[day].average(), day < 15 ? 1.0 : 2.0);
+    }
+
+    // Столбец 54 минуты отвечается минутным уровнем (2 суток), остальное - часовым
+    std::vector<HistoryAggregate> zoomed = rollup.query(at(seconds(0)), at(hours(30 * 24)), 800);
+    std::uint64_t total = 0;
+    for (const HistoryAggregate& bucket : zoomed) {
+        total += bucket.count;
+    }
+    EXPECT_EQ(total, 30u * 24u * 360u);
+    EXPECT_GT(zoomed.front().count, 0u);
+    EXPECT_GT(zoomed.back().count, 0u);
+
+    // Первая минута вытеснена и с секундного, и с минутного уровня: отвечает часовой
+    // интервал целиком - детализация грубее запрошенной, но окно не пустое
+    std::vector<HistoryAggregate> firstMinute = rollup.query(at(seconds(0)), at(seconds(60)), 60);
+    EXPECT_EQ(firstMinute.front().count, 360u);
+}
+
+TEST(HistoryRollupTest, GapLongerThanLevelClearsOldBuckets) {
+    HistoryRollup rollup;
+    rollup.add(at(seconds(10)), 5.0);
+    rollup.add(at(seconds(10) + hours(2)), 7.0);
+
+    // Номер интервала через 2 часа попадает в ту же ячейку кольца - старое значение не всплывает
+    std::vector<HistoryAggregate> now = rollup.query(at(seconds(10) + hours(2)), at(seconds(11) + hours(2)), 1);
+    ASSERT_EQ(now[0].count, 1u);
+    EXPECT_DOUBLE_EQ(now[0].max, 7.0);
+
+    // Поздно пришедшее значение в пределах уровня учитывается
+    rollup.add(at(seconds(5) + hours(2)), 1.0);
+    now = rollup.query(at(hours(2)), at(seconds(20) + hours(2)), 1);
+    EXPECT_EQ(now[0].count, 2u);
+    EXPECT_DOUBLE_EQ(now[0].min, 1.0);
+}
+
+TEST(HistoryRollupTest, WindowBeforeMinuteBoundaryCountsValuesOnce) {
+    HistoryRollup rollup;
+    for (int i = 0; i < 4; ++i) {
+        rollup.add(at(milliseconds(60014 + i * 1000)), 10.0 * i);
+    }
+
+    // Окно начинается за 5 с до первой минуты: секундный уровень отвечает с 60 с, а более
+    // старую часть окна (55..60 с) ищут минутный и часовой уровни. Их интервалы содержат
+    // те же значения и заходят за границу, уже покрытую секундным уровнем, - не учитываются
+    std::vector<HistoryAggregate> result = rollup.query(at(milliseconds(55014)), at(milliseconds(65014)), 5);
+    ASSERT_EQ(result.size(), 5u);
+    std::uint64_t total = 0;
+    for (const HistoryAggregate& bucket : result) {
+        total += bucket.count;
+    }
+    EXPECT_EQ(total, 4u);
+    EXPECT_EQ(result[0].count, 0u);
+    EXPECT_EQ(result[1].count, 0u);
+    EXPECT_DOUBLE_EQ(result[2].min, 0.0);
+    EXPECT_DOUBLE_EQ(result[3].max, 30.0);
+
+    // Один столбец: одно значение
+    HistoryRollup single;
+    single.add(at(milliseconds(60014)), 100.0);
+    EXPECT_EQ(single.query(at(milliseconds(55014)), at(milliseconds(65014)), 1)[0].count, 1u);
+}
+
+TEST(HistoryRollupTest, DatabaseMaintainsRollupsOnWrites) {
+    VariableDatabase db;
+    TagId tag = db.resolveTag("rollup_var");
+    EXPECT_EQ(db.getAggregated(tag, at(seconds(0)), at(seconds(10)), 5)[0].count, 0u);
+
+    db.enableRollups(tag);
+    for (int i = 0; i < 10; ++i) {
+        db.addToHistory(tag, i, at(seconds(i)));
+    }
+    std::vector<HistoryAggregate> result = db.getAggregated(tag, at(seconds(0)), at(seconds(10)), 2);
+    ASSERT_EQ(result.size(), 2u);
+    EXPECT_EQ(result[0].count, 5u);
+    EXPECT_DOUBLE_EQ(result[0].max, 4.0);
+    EXPECT_DOUBLE_EQ(result[1].min, 5.0);
+
+    // Запись через set() учитывается с текущим временем
+    TagId live = db.resolveTag("rollup_live");
+    db.enableRollups(live);
+    db.set(live, 100.0);
+    HistoryClock::time_point now = HistoryClock::now();
+    result = db.getAggregated(live, now - seconds(5), now + seconds(5), 1);
+    EXPECT_EQ(result[0].count, 1u);
+    EXPECT_DOUBLE_EQ(result[0].max, 100.0);
+}
@@ -0,0 +1,59 @@
+#include <gtest/gtest.h>
+#include "logger.h"
+#include <sstream>
+#include <string>
+
+class LoggerTest : public ::testing::Test {
+protected:
+    std::ostringstream out;
+    std::ostringstream err;
+    
+    void SetUp() override {
+        Logger::flush();
+        Logger::setStreams(out, err);
+        Logger::setLevel(LogLevel::Info);
+    }
+    
+    void TearDown() override {
+        Logger::flush();
+        Logger::setStreams(std::cout, std::cerr);
+        Logger::setLevel(LogLevel::Info);
+    }
+};
+
+TEST_F(LoggerTest, DisabledLevelDoesNotFormatMessage) {
+    int formatted = 0;
+    auto expensive = [&formatted]() {
+        ++formatted;
+        return std::string("expensive");
+    };
+    
+    // DEBUG выключен - выражение сообщения не вычисляется
+    LOG_DEBUG(expensive());
+    EXPECT_EQ(formatted, 0);
+    
+    LOG_INFO(expensive());
+    EXPECT_EQ(formatted, 1);
+    
+    Logger::flush();
+    EXPECT_NE(out.str().find("[INFO] expensive"), std::string::npos);
+    EXPECT_EQ(out.str().find("[DEBUG]"), std::string::npos);
+}
+
+TEST_F(LoggerTest, ErrorsGoToErrorStream) {
+    Logger::error("broken");
+    Logger::flush();
+    EXPECT_NE(err.str().find("[ERROR] broken"), std::string::npos);
+}
+
+TEST_F(LoggerTest, RateLimitedCallSite) {
+    // 100 сообщений подряд из одного места - выводится только первое
+    for (int i = 0; i < 100; ++i) {
+        LOG_WARNING_RATE_LIMITED(1.0, "noisy " + std::to_string(i));
+    }
+    Logger::flush();
+    
+    std::string text = out.str();
+    EXPECT_NE(text.find("noisy 0"), std::string::npos);
+    EXPECT_EQ(text.find("noisy 1"), std::string::npos);
+}
@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <iomanip>
+#include <sstream>
+#include <string>
+
+#include "NumberFormat.h"
+
+namespace {
+
+// Прежнее форматирование Text::update (до NumberFormat)
+std::string legacyFormat(const std::string& formatString, double value) {
+    if (formatString.empty()) {
+        return std::to_string(value);
+    }
+    std::size_t pos = formatString.find("%f");
+    if (pos == std::string::npos) {
+        return formatString + std::to_string(value);
+    }
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(1) << value;
+    return formatString.substr(0, pos) + ss.str() + formatString.substr(pos + 2);
+}
+
+std::string printfFormat(const char* pattern, double value) {
+    char buffer[128];
+    std::snprintf(buffer, sizeof(buffer), pattern, value);
+    return buffer;
+}
+
+const double VALUES[] = {0.0, 72.5, -1.25, 3.14159265, 1e6 + 0.05, -0.004, 123456.789};
+
+} // namespace
+
+TEST(NumberFormatTest, MatchesLegacyTextFormatting) {
+    const std::string patterns[] = {"", "Temperature: %f", "%f C", "Pressure: ", "%f", "Level %f%"};
+    for (const std::string& pattern : patterns) {
+        NumberFormat format(pattern);
+        for (double value : VALUES) {
+            EXPECT_EQ(format.format(value), legacyFormat(pattern, value))
+                << "pattern '" << pattern << "', value " << value;
+        }
+    }
+}
+
+TEST(NumberFormatTest, MatchesPrintfForWidthAndPrecision) {
+    const char* patterns[] = {"%.2f", "%8.3f", "%-8.1f|", "%08.2f", "T=%.0f K", "%.3f %%"};
+    for (const char* pattern : patterns) {
+        NumberFormat format(pattern);
+        for (double value : VALUES) {
+            EXPECT_EQ(format.format(value), printfFormat(pattern, value))
+                << "pattern '" << pattern << "', value " << value;
+        }
+    }
+}
+
+TEST(NumberFormatTest, IntegerSpecifierRoundsValue) {
+    NumberFormat format("%5d rpm");
+    EXPECT_EQ(format.getPrecision(), 0);
+    EXPECT_EQ(format.format(1499.6), " 1500 rpm");
+    EXPECT_EQ(format.format(-7.2), "   -7 rpm");
+}
+
+TEST(NumberFormatTest, ReusesOutputBuffer) {
+    NumberFormat format("Value: %.2f units");
+    std::string out;
+    format.format(12345.678, out);
+    EXPECT_EQ(out, "Value: 12345.68 units");
+
+    // Емкость уже достаточна - повторное форматирование не перевыделяет строку
+    const char* data = out.data();
+    format.format(1.0, out);
+    EXPECT_EQ(out, "Value: 1.00 units");
+    EXPECT_EQ(out.data(), data);
+}
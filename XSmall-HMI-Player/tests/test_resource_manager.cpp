@@ -0,0 +1,152 @@
+#include <gtest/gtest.h>
+#include <SFML/Graphics.hpp>
+#include <memory>
+#include <vector>
+#include <filesystem>
+
+#include "VariableDatabase.h"
+#include "ResourceManager.h"
+#include "TextureAtlas.h"
+#include "SceneRenderer.h"
+#include "Image.h"
+
+class ResourceManagerTest : public ::testing::Test {
+protected:
+    ResourceManager resources;
+    const std::string logoPath = "assets/images/logo.png";
+
+    void SetUp() override {
+        // Логотип копируется рядом со сборкой вместе с остальными ресурсами
+        if (resources.resolvePath(logoPath).empty()) {
+            GTEST_SKIP() << "Test image not found: " << logoPath;
+        }
+    }
+};
+
+TEST_F(ResourceManagerTest, TexturesAreSharedByResolvedPath) {
+    auto first = resources.getTexture(logoPath);
+    auto second = resources.getTexture("assets/images/../images/logo.png");
+    ASSERT_NE(first, nullptr);
+
+    // Разные записи одного файла - одна загрузка и одна текстура
+    EXPECT_EQ(first.get(), second.get());
+    EXPECT_EQ(resources.getLoadCount(), 1u);
+    EXPECT_EQ(resources.getTextureCount(), 1u);
+
+    // Последний владелец отпустил текстуру - она выгружается и при запросе читается заново
+    first.reset();
+    second.reset();
+    EXPECT_EQ(resources.getTextureCount(), 0u);
+    EXPECT_NE(resources.getTexture(logoPath), nullptr);
+    EXPECT_EQ(resources.getLoadCount(), 2u);
+}
+
+TEST_F(ResourceManagerTest, MissingFilesAreResolvedOnce) {
+    EXPECT_TRUE(resources.resolvePath("assets/images/missing.png").empty());
+    EXPECT_EQ(resources.getTexture("assets/images/missing.png"), nullptr);
+    EXPECT_EQ(resources.getFont("assets/fonts/missing.ttf"), nullptr);
+
+    // Файл, которого нет, не читается с диска
+    EXPECT_EQ(resources.getLoadCount(), 0u);
+}
+
+TEST_F(ResourceManagerTest, ImagesShareOneTexture) {
+    VariableDatabase db;
+    ResourceManager& shared = ResourceManager::instance();
+    std::size_t loadsBefore = shared.getLoadCount();
+
+    std::vector<std::unique_ptr<Image>> images;
+    for (int i = 0; i < 20; ++i) {
+        images.push_back(std::make_unique<Image>(i * 10.0f, 0, 50, 50, logoPath, "Logo", &db));
+    }
+    auto missing = std::make_unique<Image>(0, 100, 50, 50, "assets/images/missing.png", "Missing", &db);
+
+    EXPECT_EQ(shared.getLoadCount(), loadsBefore + 1);
+    for (const auto& image : images) {
+        EXPECT_TRUE(image->isLoaded());
+        EXPECT_EQ(image->getTexture(), images[0]->getTexture());
+    }
+    EXPECT_FALSE(missing->isLoaded());
+    EXPECT_EQ(missing->getTexture(), nullptr);
+}
+
+TEST(TextureAtlasTest, PacksImagesWithoutOverlap) {
+    TextureAtlas atlas(256, 1);
+    std::vector<sf::Vector2u> sizes;
+    for (unsigned int i = 0; i < 40; ++i) {
+        sizes.push_back(sf::Vector2u(10 + (i * 37) % 90, 8 + (i * 53) % 70));
+        sf::Image image;
+        image.create(sizes.back().x, sizes.back().y, sf::Color::Red);
+        atlas.add("image" + std::to_string(i), image);
+    }
+
+    // Суммарная площадь больше одной страницы 256x256
+    ASSERT_TRUE(atlas.pack());
+    EXPECT_EQ(atlas.getEntryCount(), sizes.size());
+    EXPECT_GT(atlas.getPageCount(), 1u);
+
+    std::vector<const TextureAtlas::Entry*> entries;
+    for (std::size_t i = 0; i < sizes.size(); ++i) {
+        const TextureAtlas::Entry* entry = atlas.find("image" + std::to_string(i));
+        ASSERT_NE(entry, nullptr);
+        EXPECT_EQ(entry->rect.width, static_cast<int>(sizes[i].x));
+        EXPECT_EQ(entry->rect.height, static_cast<int>(sizes[i].y));
+        EXPECT_GE(entry->rect.left, 0);
+        EXPECT_GE(entry->rect.top, 0);
+        EXPECT_LE(entry->rect.left + entry->rect.width, 256);
+        EXPECT_LE(entry->rect.top + entry->rect.height, static_cast<int>(atlas.getPage(entry->page).getSize().y));
+        for (const TextureAtlas::Entry* other : entries) {
+            EXPECT_FALSE(other->page == entry->page && other->rect.intersects(entry->rect));
+        }
+        entries.push_back(entry);
+    }
+    EXPECT_EQ(atlas.find("unknown"), nullptr);
+}
+
+TEST_F(ResourceManagerTest, AtlasCacheIsReused) {
+    std::string starWars = resources.resolvePath("assets/images/logostarwars.png");
+    if (starWars.empty()) {
+        GTEST_SKIP() << "Second test image not found";
+    }
+    std::vector<std::string> files = {resources.resolvePath(logoPath), starWars};
+    std::filesystem::path cacheDir = std::filesystem::temp_directory_path() / "hmi_atlas_cache_test";
+    std::filesystem::remove_all(cacheDir);
+
+    TextureAtlas built;
+    ASSERT_TRUE(built.loadFiles(files, cacheDir.string()));
+    EXPECT_FALSE(built.isLoadedFromCache());
+
+    // Те же файлы - атлас читается из кэша с той же раскладкой
+    TextureAtlas cached;
+    ASSERT_TRUE(cached.loadFiles(files, cacheDir.string()));
+    EXPECT_TRUE(cached.isLoadedFromCache());
+    ASSERT_EQ(cached.getPageCount(), built.getPageCount());
+    for (const auto& file : files) {
+        ASSERT_NE(cached.find(file), nullptr);
+        EXPECT_EQ(cached.find(file)->page, built.find(file)->page);
+        EXPECT_EQ(cached.find(file)->rect, built.find(file)->rect);
+    }
+    std::filesystem::remove_all(cacheDir);
+}
+
+TEST_F(ResourceManagerTest, AtlasImagesShareOneDrawCall) {
+    VariableDatabase db;
+    ResourceManager& shared = ResourceManager::instance();
+    ASSERT_EQ(shared.buildAtlas({logoPath, "assets/images/logostarwars.png"}),
+              shared.resolvePath("assets/images/logostarwars.png").empty() ? 1u : 2u);
+
+    std::vector<std::unique_ptr<VisualObject>> objects;
+    for (int i = 0; i < 10; ++i) {
+        std::string path = i % 2 ? "assets/images/logostarwars.png" : logoPath;
+        objects.push_back(std::make_unique<Image>(i * 60.0f, 0, 50, 50, path, "Image", &db));
+    }
+
+    // Все спрайты - участки одной страницы атласа: один пакет и один вызов отрисовки
+    SceneRenderer renderer;
+    renderer.build(objects);
+    EXPECT_EQ(renderer.getBatchCount(), 1u);
+    EXPECT_EQ(renderer.getStepCount(), 1u);
+    EXPECT_EQ(renderer.getBatch(0).getVertexCount(), 10 * RenderBatch::QUAD_VERTICES);
+    EXPECT_EQ(renderer.getBatch(0).getTexture(), static_cast<Image*>(objects[0].get())->getTexture());
+    shared.buildAtlas({});
+}
@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+#include <SFML/Graphics.hpp>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+#include "VariableDatabase.h"
+#include "HistoryTags.h"
+#include "SceneReloader.h"
+#include "FileWatcher.h"
+#include "JSONLoader.h"
+
+using json = nlohmann::json;
+
+namespace {
+
+json rectangle(const std::string& name, float x, const std::string& variable = "") {
+    return {{"type", "Rectangle"}, {"name", name}, {"x", x}, {"y", 0},
+            {"width", 10}, {"height", 10}, {"variable", variable}};
+}
+
+} // namespace
+
+TEST(SceneReloaderTest, DiffFindsAddedChangedAndRemovedObjects) {
+    SceneSnapshot snapshot;
+    json first = {{"objects", {rectangle("A", 0), rectangle("B", 20), rectangle("C", 40), rectangle("A", 60)}}};
+    ScenePatch initial = SceneReloader::diff(snapshot, first);
+    EXPECT_EQ(initial.added, 4u);
+
+    json second = {{"objects", {rectangle("A", 0), rectangle("B", 25), rectangle("A", 60), rectangle("D", 80)}},
+                   {"historyCapacity", 500}};
+    ScenePatch patch = SceneReloader::diff(snapshot, second);
+
+    // Одноименные объекты различаются по порядку: второй "A" не изменился
+    EXPECT_EQ(patch.added, 1u);
+    EXPECT_EQ(patch.changed, 1u);
+    EXPECT_EQ(patch.removed, 1u);
+    ASSERT_EQ(patch.order.size(), 4u);
+    EXPECT_EQ(patch.created.size(), 2u);
+    EXPECT_EQ(patch.created.count(patch.order[1]), 1u);
+    EXPECT_EQ(patch.created.count(patch.order[3]), 1u);
+    EXPECT_TRUE(patch.hasHistoryCapacity);
+    EXPECT_EQ(patch.historyCapacity, 500u);
+
+    // Повторное сохранение без изменений ничего не меняет
+    EXPECT_TRUE(SceneReloader::diff(snapshot, second).empty());
+}
+
+TEST(SceneReloaderTest, ApplyKeepsUnchangedObjectsAndDatabase) {
+    VariableDatabase db;
+    SceneSnapshot snapshot;
+    json first = {{"objects", {rectangle("Kept", 0, "reload_kept"), rectangle("Moved", 20, "reload_moved"),
+                               rectangle("Gone", 40, "reload_gone")}}};
+    SceneReloader::diff(snapshot, first);
+
+    std::vector<std::unique_ptr<VisualObject>> objects;
+    for (const auto& objJson : first["objects"]) {
+        objects.push_back(JSONLoader::createObject(objJson, &db, nullptr));
+    }
+    VisualObject* kept = objects[0].get();
+    VisualObject* moved = objects[1].get();
+    db.setVariable("reload_kept", 3.0);
+    historyTag(db, "reload_gone");
+    db.setVariable("reload_gone", 1.0);
+
+    json second = {{"objects", {rectangle("New", 100), rectangle("Kept", 0, "reload_kept"),
+                                rectangle("Moved", 30, "reload_moved")}}};
+    std::vector<std::unique_ptr<VisualObject>> removed;
+    SceneReloader::applyPatch(SceneReloader::diff(snapshot, second), objects, &db, nullptr, removed);
+
+    ASSERT_EQ(objects.size(), 3u);
+    EXPECT_EQ(objects[0]->getName(), "New");
+    EXPECT_EQ(objects[1].get(), kept);
+    EXPECT_NE(objects[2].get(), moved);
+    EXPECT_FLOAT_EQ(objects[2]->getBounds().left, 30);
+    EXPECT_EQ(removed.size(), 2u);
+
+    // Удаленные объекты отписаны: уведомления идут только оставшимся
+    removed.clear();
+    db.setVariable("reload_gone", 2.0);
+    db.setVariable("reload_moved", 2.0);
+
+    // Значения и история переменных пережили перезагрузку
+    EXPECT_DOUBLE_EQ(db.getVariable("reload_kept"), 3.0);
+    EXPECT_EQ(db.getHistory("reload_gone").size(), 2u);
+}
+
+TEST(FileWatcherTest, ReportsInitialStateAndChanges) {
+    const std::string path = "test_file_watcher.json";
+    std::ofstream(path) << "{}";
+
+    std::atomic<int> calls{0};
+    FileWatcher watcher(path);
+    watcher.start([&calls]() { ++calls; });
+
+    auto waitFor = [&calls](int expected) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(3);
+        while (calls < expected && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return calls.load();
+    };
+
+    EXPECT_EQ(waitFor(1), 1);
+
+    // Сохранение через временный файл и переименование, как в большинстве редакторов
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    std::ofstream("test_file_watcher.json.tmp") << "{\"objects\": []}";
+    std::filesystem::rename("test_file_watcher.json.tmp", path);
+    EXPECT_EQ(waitFor(2), 2);
+
+    watcher.stop();
+    EXPECT_FALSE(watcher.isRunning());
+    std::filesystem::remove(path);
+}
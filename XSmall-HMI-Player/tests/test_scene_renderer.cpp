@@ -0,0 +1,259 @@
+#include <gtest/gtest.h>
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "VariableDatabase.h"
+#include "SceneRenderer.h"
+#include "Rectangle.h"
+#include "Line.h"
+#include "Text.h"
+#include "Button.h"
+#include "InputField.h"
+#include "HistoryGraph.h"
+
+// Объект, который целиком рисуется поверх пакетов (как текст)
+class OverlayOnly : public VisualObject {
+public:
+    OverlayOnly(float x, float y, const std::string& name, VariableDatabase* db) : VisualObject(x, y, name, db) {}
+    void draw(sf::RenderTarget& target) override {}
+    void update() override {}
+    sf::FloatRect getBounds() const override { return sf::FloatRect(x, y, 100, 100); }
+};
+
+// Спрайт 100x100 с участком общей текстуры
+class TexturedSprite : public VisualObject {
+    const sf::Texture* texture;
+public:
+    TexturedSprite(float x, float y, const sf::Texture* texture, VariableDatabase* db)
+        : VisualObject(x, y, "Sprite", db), texture(texture) {}
+    void draw(sf::RenderTarget& target) override {}
+    void update() override {}
+    void attachToBatch(RenderBatch& batch) override {
+        BatchRange range = batch.allocate(RenderBatch::QUAD_VERTICES);
+        RenderBatch::writeTexturedQuad(batch.data(range), getBounds(), sf::IntRect(0, 0, 16, 16));
+    }
+    const sf::Texture* getBatchTexture() const override { return texture; }
+    bool hasOverlay() const override { return false; }
+    bool isStatic() const override { return true; }
+    sf::FloatRect getBounds() const override { return sf::FloatRect(x, y, 100, 100); }
+};
+
+class SceneRendererTest : public ::testing::Test {
+protected:
+    VariableDatabase db;
+    std::vector<std::unique_ptr<VisualObject>> objects;
+    SceneRenderer renderer;
+    sf::Font font;
+
+    bool loadFont() {
+        return font.loadFromFile("assets/fonts/helveticabold.ttf") ||
+               font.loadFromFile("../assets/fonts/helveticabold.ttf") ||
+               font.loadFromFile("../../assets/fonts/helveticabold.ttf");
+    }
+};
+
+TEST_F(SceneRendererTest, PrimitivesShareOneBatch) {
+    objects.push_back(std::make_unique<Rectangle>(0, 0, 100, 50, sf::Color::Red, "Rect1", &db));
+    objects.push_back(std::make_unique<Rectangle>(50, 20, 100, 50, sf::Color::Green, "Rect2", &db));
+    objects.push_back(std::make_unique<Line>(0, 100, 200, 100, sf::Color::White, "Line1", &db));
+    objects.push_back(std::make_unique<Line>(0, 0, 200, 200, sf::Color::White, "Line2", &db));
+
+    renderer.build(objects);
+
+    // Вся геометрия - один пакет и один вызов отрисовки
+    EXPECT_EQ(renderer.getBatchCount(), 1u);
+    EXPECT_EQ(renderer.getStepCount(), 1u);
+    EXPECT_EQ(renderer.getBatch(0).getVertexCount(), 4 * RenderBatch::QUAD_VERTICES);
+}
+
+TEST_F(SceneRendererTest, OverlayKeepsDrawingOrder) {
+    objects.push_back(std::make_unique<Rectangle>(0, 0, 300, 300, sf::Color::Blue, "Background", &db));
+    objects.push_back(std::make_unique<OverlayOnly>(10, 10, "Picture", &db));
+    // Не пересекается с изображением - может лечь в первый пакет
+    objects.push_back(std::make_unique<Rectangle>(200, 200, 50, 50, sf::Color::Red, "Side", &db));
+    // Перекрывает изображение - должен рисоваться после него
+    objects.push_back(std::make_unique<Rectangle>(50, 50, 20, 20, sf::Color::Green, "Marker", &db));
+
+    renderer.build(objects);
+
+    // Пакет (фон + Side), изображение, пакет (Marker)
+    EXPECT_EQ(renderer.getBatchCount(), 2u);
+    EXPECT_EQ(renderer.getStepCount(), 3u);
+    EXPECT_EQ(renderer.getBatch(0).getVertexCount(), 2 * RenderBatch::QUAD_VERTICES);
+    EXPECT_EQ(renderer.getBatch(1).getVertexCount(), RenderBatch::QUAD_VERTICES);
+}
+
+TEST_F(SceneRendererTest, TexturedBatchesKeepDrawingOrder) {
+    sf::Texture atlas;
+    atlas.create(16, 16);
+    objects.push_back(std::make_unique<TexturedSprite>(0, 0, &atlas, &db));
+    objects.push_back(std::make_unique<Rectangle>(200, 0, 50, 50, sf::Color::Red, "Plain", &db));
+    // Не перекрывает прямоугольник - в тот же пакет, что и первый спрайт
+    objects.push_back(std::make_unique<TexturedSprite>(400, 0, &atlas, &db));
+    // Рисуется после пакета спрайтов - может перекрывать первый спрайт
+    objects.push_back(std::make_unique<Rectangle>(50, 50, 20, 20, sf::Color::Green, "OverSprite", &db));
+    // Перекрывает прямоугольник - нужен новый пакет спрайтов после него
+    objects.push_back(std::make_unique<TexturedSprite>(220, 10, &atlas, &db));
+
+    renderer.build(objects);
+
+    ASSERT_EQ(renderer.getBatchCount(), 3u);
+    EXPECT_EQ(renderer.getStepCount(), 3u);
+    EXPECT_EQ(renderer.getBatch(0).getTexture(), &atlas);
+    EXPECT_EQ(renderer.getBatch(0).getVertexCount(), 2 * RenderBatch::QUAD_VERTICES);
+    EXPECT_EQ(renderer.getBatch(1).getTexture(), nullptr);
+    EXPECT_EQ(renderer.getBatch(1).getVertexCount(), 2 * RenderBatch::QUAD_VERTICES);
+    EXPECT_EQ(renderer.getBatch(2).getTexture(), &atlas);
+    EXPECT_EQ(renderer.getBatch(2).getVertexCount(), RenderBatch::QUAD_VERTICES);
+
+    // Координаты текстуры - углы участка
+    EXPECT_EQ(renderer.getBatch(0).getVertex(2).texCoords, sf::Vector2f(16, 16));
+}
+
+TEST_F(SceneRendererTest, ColorChangeUpdatesOwnVertices) {
+    auto status = std::make_unique<Rectangle>(0, 0, 10, 10, sf::Color::White, "Status", &db, "batch_status");
+    status->addCondition(1.0, sf::Color::Red);
+    objects.push_back(std::move(status));
+    objects.push_back(std::make_unique<Rectangle>(20, 0, 10, 10, sf::Color::White, "Other", &db, "batch_other"));
+
+    renderer.build(objects);
+    db.setVariable("batch_status", 1.0);
+
+    const RenderBatch& batch = renderer.getBatch(0);
+    for (std::size_t i = 0; i < RenderBatch::QUAD_VERTICES; ++i) {
+        EXPECT_EQ(batch.getVertex(i).color, sf::Color::Red);
+        EXPECT_EQ(batch.getVertex(RenderBatch::QUAD_VERTICES + i).color, sf::Color::White);
+    }
+}
+
+TEST_F(SceneRendererTest, StaticObjectsGoToStaticLayer) {
+    objects.push_back(std::make_unique<Rectangle>(0, 0, 1024, 768, sf::Color::Blue, "Background", &db));
+    objects.push_back(std::make_unique<Rectangle>(10, 10, 100, 100, sf::Color::White, "Indicator", &db, "layer_status"));
+    // Рисуется поверх динамического индикатора - должен остаться над ним
+    objects.push_back(std::make_unique<Line>(0, 50, 200, 50, sf::Color::Black, "Cross", &db));
+    // Ни с чем динамическим не пересекается
+    objects.push_back(std::make_unique<Line>(0, 300, 200, 300, sf::Color::Black, "Separator", &db));
+
+    renderer.build(objects);
+
+    EXPECT_EQ(renderer.getStaticObjectCount(), 2u);
+    EXPECT_EQ(renderer.getDynamicObjectCount(), 2u);
+    ASSERT_EQ(renderer.getBatchCount(), 2u);
+    EXPECT_EQ(renderer.getBatch(0).getVertexCount(), 2 * RenderBatch::QUAD_VERTICES);
+    EXPECT_EQ(renderer.getBatch(1).getVertexCount(), 2 * RenderBatch::QUAD_VERTICES);
+}
+
+TEST_F(SceneRendererTest, TimeAxisGraphNeedsFrameWithoutWrites) {
+    objects.push_back(std::make_unique<Rectangle>(0, 0, 100, 50, sf::Color::Red, "Indicator", &db, "frame_status"));
+    objects.push_back(std::make_unique<HistoryGraph>(0, 100, 200, 100, "Counted", &db, "frame_counted"));
+    auto timed = std::make_unique<HistoryGraph>(300, 100, 200, 100, "Timed", &db, "frame_timed");
+    timed->setTimeWindow(60);  // 0.3 с на пиксель
+    HistoryGraph* graph = timed.get();
+    objects.push_back(std::move(timed));
+    renderer.build(objects);
+
+    db.set(db.resolveTag("frame_timed"), 1.0);
+    db.set(db.resolveTag("frame_counted"), 1.0);
+    HistoryClock::time_point now = HistoryClock::now();
+    graph->getCurvePoints(now);
+    std::uint64_t revision = db.getRevision();
+
+    // Записей нет: кадр нужен, только когда окно сдвинулось на пиксель
+    EXPECT_FALSE(renderer.needsFrame(now));
+    EXPECT_FALSE(renderer.needsFrame(now + std::chrono::milliseconds(100)));
+    EXPECT_TRUE(renderer.needsFrame(now + std::chrono::milliseconds(300)));
+    EXPECT_EQ(db.getRevision(), revision);
+
+    // После кадра - снова ждем следующего пикселя
+    graph->getCurvePoints(now + std::chrono::milliseconds(300));
+    EXPECT_FALSE(renderer.needsFrame(now + std::chrono::milliseconds(400)));
+
+    // График по числу значений без записей не меняется
+    EXPECT_FALSE(objects[1]->needsFrame(now + std::chrono::hours(1)));
+}
+
+TEST_F(SceneRendererTest, TextSharesGlyphAtlasBatch) {
+    if (!loadFont()) {
+        GTEST_SKIP() << "Font cannot be loaded, skip the test TextSharesGlyphAtlasBatch";
+    }
+
+    const int labelCount = 200;
+    for (int i = 0; i < labelCount; ++i) {
+        objects.push_back(std::make_unique<Text>((i % 10) * 100.0f, (i / 10) * 30.0f, "", &font, 14,
+                                                 sf::Color::White, "Label", &db,
+                                                 "label_" + std::to_string(i), "%f C"));
+    }
+    objects.push_back(std::make_unique<Button>(0, 650, 100, 30, "Apply", &font, 14, sf::Color::Green,
+                                               "Button", &db));
+    objects.push_back(std::make_unique<InputField>(200, 650, 100, 30, &font, 14, "Input", &db, "input_value"));
+
+    renderer.build(objects);
+
+    // Все надписи, фон кнопки и поля - один пакет со страницей атласа шрифта и один вызов draw
+    ASSERT_EQ(renderer.getBatchCount(), 1u);
+    EXPECT_EQ(renderer.getStepCount(), 1u);
+    EXPECT_EQ(renderer.getBatch(0).getTexture(), &font.getTexture(14));
+
+    // Фон кнопки берет цвет из белого участка атласа
+    const RenderBatch& batch = renderer.getBatch(0);
+    std::size_t buttonOffset = 0;
+    while (batch.getVertex(buttonOffset).color != sf::Color::Green) {
+        ++buttonOffset;
+    }
+    EXPECT_EQ(batch.getVertex(buttonOffset).texCoords, TextRun::SOLID_TEX_COORDS);
+
+    // Новое значение переписывает только глифы своей надписи, размер пакета не меняется
+    std::size_t vertexCount = batch.getVertexCount();
+    std::vector<sf::Vertex> before(&batch.getVertex(0), &batch.getVertex(0) + vertexCount);
+    db.setVariable("label_1", 12345.6);
+
+    EXPECT_EQ(batch.getVertexCount(), vertexCount);
+    std::size_t changedFrom = vertexCount, changedTo = 0;
+    for (std::size_t i = 0; i < vertexCount; ++i) {
+        const sf::Vertex& vertex = batch.getVertex(i);
+        if (vertex.position != before[i].position || vertex.texCoords != before[i].texCoords) {
+            changedFrom = std::min(changedFrom, i);
+            changedTo = i + 1;
+        }
+    }
+    ASSERT_LT(changedFrom, changedTo);
+    EXPECT_LE(changedTo - changedFrom, 32 * RenderBatch::QUAD_VERTICES);
+}
+
+TEST(TextRunTest, GrowsPastCapacityWithoutMovingOtherText) {
+    sf::Font font;
+    if (!font.loadFromFile("assets/fonts/helveticabold.ttf") &&
+        !font.loadFromFile("../assets/fonts/helveticabold.ttf")) {
+        GTEST_SKIP() << "Font cannot be loaded, skip the test GrowsPastCapacityWithoutMovingOtherText";
+    }
+
+    sf::Text first("ab", font, 14);
+    sf::Text second("cd", font, 14);
+    RenderBatch batch(TextRun::getTexture(first));
+    TextRun firstRun, secondRun;
+    firstRun.attach(batch, first);
+    secondRun.attach(batch, second);
+    ASSERT_EQ(batch.getVertexCount(), 4 * RenderBatch::QUAD_VERTICES);
+
+    // Пробелы геометрии не дают, строка короче емкости - лишний глиф вырождается
+    first.setString("a ");
+    firstRun.update(first);
+    EXPECT_EQ(batch.getVertexCount(), 4 * RenderBatch::QUAD_VERTICES);
+    for (std::size_t i = RenderBatch::QUAD_VERTICES; i < 2 * RenderBatch::QUAD_VERTICES; ++i) {
+        EXPECT_EQ(batch.getVertex(i).position, sf::Vector2f(0, 0));
+    }
+
+    // Не помещается: старый участок гаснет, новый - в конце пакета, вторая надпись на месте
+    sf::Vertex secondGlyph = batch.getVertex(2 * RenderBatch::QUAD_VERTICES);
+    first.setString("abcde");
+    firstRun.update(first);
+    EXPECT_EQ(firstRun.getCapacity(), 5u);
+    EXPECT_EQ(batch.getVertexCount(), 9 * RenderBatch::QUAD_VERTICES);
+    EXPECT_EQ(batch.getVertex(2 * RenderBatch::QUAD_VERTICES).position, secondGlyph.position);
+    for (std::size_t i = 0; i < 2 * RenderBatch::QUAD_VERTICES; ++i) {
+        EXPECT_EQ(batch.getVertex(i).position, sf::Vector2f(0, 0));
+    }
+}
@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+
+#include "VariableDatabase.h"
+#include "StateManager.h"
+
+class StateManagerTest : public ::testing::Test {
+protected:
+    const std::string stateFile = "test_saved_state.json";
+
+    void TearDown() override {
+        std::filesystem::remove(stateFile);
+        std::filesystem::remove(stateFile + ".tmp");
+    }
+};
+
+TEST_F(StateManagerTest, SavesAllAssignedVariablesInBackground) {
+    VariableDatabase db;
+    db.setVariable("state_pressure", 1.2345678901);
+    db.setVariable("state_status", 3.0);
+    db.resolveTag("state_unassigned");
+
+    {
+        StateManager manager(stateFile);
+        manager.saveState(db);
+
+        // Снимок снят в момент вызова: последующие изменения в него не попадают
+        db.setVariable("state_status", 4.0);
+        manager.flush();
+    }
+    EXPECT_FALSE(std::filesystem::exists(stateFile + ".tmp"));
+
+    VariableDatabase restored;
+    StateManager manager(stateFile);
+    ASSERT_TRUE(manager.loadState(restored));
+    EXPECT_DOUBLE_EQ(restored.getVariable("state_pressure"), 1.2345678901);
+    EXPECT_DOUBLE_EQ(restored.getVariable("state_status"), 3.0);
+    EXPECT_FALSE(restored.variableExists("state_unassigned"));
+}
+
+TEST_F(StateManagerTest, SavesOnlyConfiguredVariables) {
+    VariableDatabase db;
+    db.setVariable("state_setpoint", 55.0);
+    db.setVariable("state_noise", 1.0);
+
+    StateManager manager(stateFile);
+    manager.setTags(db, {"state_setpoint", "state_missing"});
+    manager.saveState(db);
+    manager.flush();
+
+    VariableDatabase restored;
+    ASSERT_TRUE(manager.loadState(restored));
+    EXPECT_DOUBLE_EQ(restored.getVariable("state_setpoint"), 55.0);
+    EXPECT_FALSE(restored.variableExists("state_noise"));
+    EXPECT_FALSE(restored.variableExists("state_missing"));
+}
+
+TEST_F(StateManagerTest, ReplacesPreviousSnapshotWhole) {
+    VariableDatabase db;
+    StateManager manager(stateFile);
+    for (int i = 0; i < 5; ++i) {
+        db.setVariable("state_counter", i);
+        manager.saveState(db);
+    }
+    manager.flush();
+
+    VariableDatabase restored;
+    ASSERT_TRUE(manager.loadState(restored));
+    EXPECT_DOUBLE_EQ(restored.getVariable("state_counter"), 4.0);
+}
+
+TEST_F(StateManagerTest, ReadsLegacyFormatAndRejectsDamagedFile) {
+    std::ofstream(stateFile) << "{\n  \"temperature_value\": 21.50,\n  \"panel_status\": 1,\n"
+                                "  \"saved_at\": \"2024-01-01 00:00:00\",\n  \"timestamp\": 1704067200\n}\n";
+
+    VariableDatabase db;
+    StateManager manager(stateFile);
+    ASSERT_TRUE(manager.loadState(db));
+    EXPECT_DOUBLE_EQ(db.getVariable("temperature_value"), 21.5);
+    EXPECT_DOUBLE_EQ(db.getVariable("panel_status"), 1.0);
+    EXPECT_FALSE(db.variableExists("timestamp"));
+
+    // Обрезанный файл не применяется частично
+    std::ofstream(stateFile) << "{\"variables\": {\"state_a\": 1, \"state_b\": ";
+    VariableDatabase damaged;
+    EXPECT_FALSE(manager.loadState(damaged));
+    EXPECT_FALSE(damaged.variableExists("state_a"));
+    EXPECT_FALSE(StateManager("missing_state.json").loadState(damaged));
+}
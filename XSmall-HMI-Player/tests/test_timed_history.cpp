@@ -0,0 +1,194 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "CompressedHistory.h"
+#include "HistoryBuffer.h"
+#include "HistoryGraph.h"
+#include "VariableDatabase.h"
+
+using namespace std::chrono;
+
+namespace {
+
+// Отметки времени через год от эпохи часов (как в тестах агрегатов)
+HistoryClock::time_point at(HistoryClock::duration offset) {
+    return HistoryClock::time_point(hours(24 * 365)) + offset;
+}
+
+} // namespace
+
+TEST(TimedHistoryTest, BufferKeepsTimestampsAcrossWrapAndResize) {
+    HistoryBuffer buffer(5);
+    for (int i = 0; i < 8; ++i) {
+        buffer.push(i, at(seconds(i * 10)));
+    }
+
+    HistoryView view = buffer.view();
+    ASSERT_EQ(view.size(), 5u);
+    for (std::size_t i = 0; i < view.size(); ++i) {
+        EXPECT_DOUBLE_EQ(view[i], 3.0 + i);
+        EXPECT_EQ(view.time(i), at(seconds(30 + 10 * i)));
+    }
+
+    // Окно по времени: первое значение не раньше 45 с - значение 5 (50 с)
+    EXPECT_EQ(view.lowerBound(at(seconds(45))), 2u);
+    EXPECT_EQ(view.lowerBound(at(seconds(50))), 2u);
+    EXPECT_EQ(view.lowerBound(at(seconds(0))), 0u);
+    EXPECT_EQ(view.lowerBound(at(seconds(100))), 5u);
+    HistoryView recent = view.since(at(seconds(55)));
+    ASSERT_EQ(recent.size(), 2u);
+    EXPECT_DOUBLE_EQ(recent.front(), 6.0);
+    EXPECT_EQ(recent.time(1), at(seconds(70)));
+
+    // Отметка в прошлом не ломает порядок
+    buffer.push(8, at(seconds(5)));
+    EXPECT_EQ(buffer.view().time(4), at(seconds(70)));
+
+    buffer.setCapacity(3);
+    view = buffer.view();
+    ASSERT_EQ(view.size(), 3u);
+    EXPECT_DOUBLE_EQ(view[0], 6.0);
+    EXPECT_EQ(view.time(0), at(seconds(60)));
+}
+
+TEST(TimedHistoryTest, CompressedHistoryRoundTripsTimestamps) {
+    std::mt19937_64 random(11);
+    std::uniform_int_distribution<int> jitter(-3000, 3000);
+
+    CompressedHistory history(1000);
+    std::vector<HistoryClock::time_point> times;
+    HistoryClock::time_point time = at(seconds(0));
+    for (int i = 0; i < 1000; ++i) {
+        // Период 100 мс с дрожанием в микросекунды, иногда длинные паузы и повторы отметок
+        time += i % 97 == 0 ? seconds(30) : (i % 50 == 0 ? HistoryClock::duration(0)
+                                                         : milliseconds(100) + microseconds(jitter(random)));
+        times.push_back(time);
+        history.push(i, time);
+    }
+
+    std::size_t index = 0;
+    for (CompressedHistory::Cursor cursor(history, 0); cursor.next();) {
+        for (std::size_t i = 0; i < cursor.size(); ++i, ++index) {
+            EXPECT_EQ(cursor.times()[i], times[index]) << "sample " << index;
+        }
+    }
+    EXPECT_EQ(index, times.size());
+
+    // Двоичный поиск по блокам совпадает с поиском по исходным отметкам
+    for (int probe = 0; probe < 300; ++probe) {
+        HistoryClock::time_point target = times.front() - seconds(1) +
+                                          (times.back() - times.front() + seconds(2)) * probe / 300;
+        std::uint64_t expected = std::lower_bound(times.begin(), times.end(), target) - times.begin();
+        EXPECT_EQ(history.lowerBound(target), expected) << "probe " << probe;
+    }
+}
+
+TEST(TimedHistoryTest, ResamplingHoldsValueAtFixedRate) {
+    VariableDatabase db;
+    TagId tag = db.resolveTag("resampled_var");
+    db.requestHistoryCapacity(tag, 100000);
+    db.requestHistoryResampling(tag, milliseconds(250));
+    db.requestHistoryResampling(tag, seconds(1));  // Действует самый частый запрос
+    EXPECT_EQ(db.getHistoryResampling(tag), milliseconds(250));
+
+    // Запись не попадает в историю сама по себе
+    db.set(tag, 5.0);
+    EXPECT_EQ(db.getHistoryTotal(tag), 0u);
+
+    HistoryClock::time_point start = HistoryClock::now();
+    EXPECT_GE(db.sampleHistory(start + seconds(1)), 4u);
+    std::uint64_t total = db.getHistoryTotal(tag);
+    db.set(tag, 7.0);
+    db.set(tag, 8.0);
+    EXPECT_EQ(db.sampleHistory(start + seconds(2)), 4u);
+
+    HistoryView history = db.getHistory(tag);
+    ASSERT_EQ(history.size(), total + 4);
+    for (std::size_t i = 1; i < history.size(); ++i) {
+        EXPECT_EQ(history.time(i) - history.time(i - 1), milliseconds(250));
+    }
+    EXPECT_DOUBLE_EQ(history[total - 1], 5.0);
+    EXPECT_DOUBLE_EQ(history.back(), 8.0);  // Удерживается последнее значение на момент отсчета
+
+    // Отсчеты с постоянным периодом почти ничего не стоят в сжатой истории
+    db.setHistoryCompression(tag, true);
+    db.sampleHistory(start + seconds(2000));
+    const CompressedHistory* compressed = db.getCompressedHistory(tag);
+    ASSERT_NE(compressed, nullptr);
+    EXPECT_GT(compressed->size(), 7000u);
+    EXPECT_LT(compressed->memoryUsage(), compressed->size() * sizeof(double) / 4);
+}
+
+TEST(TimedHistoryTest, TimeAxisGraphPlacesSamplesByTime) {
+    VariableDatabase db;
+    TagId tag = db.resolveTag("timed_graph");
+    HistoryGraph graph(0, 0, 200, 100, "Timed", &db, "timed_graph", 100);
+    graph.setTimeWindow(10);
+
+    // Неравномерные записи в 2, 4, 6 и 12 с; окно [5, 15)
+    db.addToHistory(tag, 0.0, at(seconds(2)));
+    db.addToHistory(tag, 10.0, at(seconds(4)));
+    db.addToHistory(tag, 20.0, at(seconds(6)));
+    db.addToHistory(tag, 30.0, at(seconds(12)));
+    std::vector<sf::Vector2f> points = graph.getCurvePoints(at(seconds(15)));
+
+    // Значение перед окном - на левом краю (интерполяция 10 -> 20 в 5 с), последнее - до правого
+    ASSERT_EQ(points.size(), 4u);
+    EXPECT_FLOAT_EQ(points[0].x, 0.0f);
+    EXPECT_NEAR(points[0].y, 75.0f, 1e-3f);
+    EXPECT_NEAR(points[1].x, 20.0f, 1e-3f);
+    EXPECT_NEAR(points[2].x, 140.0f, 1e-3f);
+    EXPECT_NEAR(points[3].x, 200.0f, 1e-3f);
+    EXPECT_FLOAT_EQ(points[2].y, points[3].y);
+    EXPECT_NEAR(points[2].y, 0.0f, 1e-3f);  // Максимум окна - у верхнего края
+
+    // Без новых записей окно сдвигается со временем: запись 12 с теперь в середине
+    points = graph.getCurvePoints(at(seconds(17)));
+    ASSERT_FALSE(points.empty());
+    EXPECT_FLOAT_EQ(points.front().x, 0.0f);
+    EXPECT_NEAR(points[points.size() - 2].x, 100.0f, 1e-3f);
+    EXPECT_NEAR(points.back().x, 200.0f, 1e-3f);
+}
+
+TEST(TimedHistoryTest, TimeAxisGraphDecimatesLongWindow) {
+    VariableDatabase db;
+    TagId plainTag = db.resolveTag("timed_plain");
+    TagId compressedTag = db.resolveTag("timed_compressed");
+    db.requestHistoryCapacity(plainTag, 200000);
+    db.requestHistoryCapacity(compressedTag, 200000);
+    db.setHistoryCompression(compressedTag, true);
+    HistoryGraph plain(0, 0, 200, 100, "Plain", &db, "timed_plain");
+    HistoryGraph compressed(0, 0, 200, 100, "Compressed", &db, "timed_compressed");
+    plain.setTimeWindow(60);
+    compressed.setTimeWindow(60);
+
+    // 1 кГц: в окне 60000 значений на 200 пикселей
+    for (int i = 0; i < 120000; ++i) {
+        double value = 50 + 20 * std::sin(i * 0.001) + (i % 7919 == 0 ? 40 : 0);
+        db.addToHistory(plainTag, value, at(milliseconds(i)));
+        db.addToHistory(compressedTag, value, at(milliseconds(i)));
+        if (i % 20000 == 19999) {
+            HistoryClock::time_point now = at(milliseconds(i + 1));
+            std::vector<sf::Vector2f> expected = plain.getCurvePoints(now);
+            std::vector<sf::Vector2f> actual = compressed.getCurvePoints(now);
+            ASSERT_EQ(actual.size(), expected.size()) << "after " << i;
+            EXPECT_LE(expected.size(), 4u * 201u + 2u);
+            for (std::size_t p = 0; p < expected.size(); ++p) {
+                EXPECT_FLOAT_EQ(actual[p].x, expected[p].x);
+                EXPECT_FLOAT_EQ(actual[p].y, expected[p].y);
+            }
+
+            // Все точки в области графика, выбросы видны на верхнем краю
+            float top = 100.0f;
+            for (const sf::Vector2f& point : expected) {
+                EXPECT_GE(point.x, -1e-3f);
+                EXPECT_LE(point.x, 200.0f + 1e-3f);
+                top = std::min(top, point.y);
+            }
+            EXPECT_NEAR(top, 0.0f, 1e-3f);
+        }
+    }
+}
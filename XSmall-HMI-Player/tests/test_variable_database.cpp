@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include "VariableDatabase.h"
+#include "HistoryTags.h"
 #include <VisualObject.h>
 
 TEST(VariableDatabaseTest, SetAndGetVariable) {
@@ -20,7 +21,13 @@ TEST(VariableDatabaseTest, VariableExists) {
 TEST(VariableDatabaseTest, HistoryStorage) {
     VariableDatabase db;
     
-    // Проверяем, что история сохраняется
+    // Без потребителя история не ведется
+    db.setVariable("history_var", 1.0);
+    EXPECT_TRUE(db.getHistory("history_var").empty());
+    EXPECT_FALSE(db.isHistoryEnabled(db.findTag("history_var")));
+    
+    // Проверяем, что включенная история сохраняется
+    historyTag(db, "history_var");
     db.setVariable("history_var", 1.0);
     db.setVariable("history_var", 2.0);
     db.setVariable("history_var", 3.0);
@@ -41,3 +48,144 @@ TEST(VariableDatabaseTest, Subscription) {
     db.setVariable("sub_var", 99.9);
     EXPECT_DOUBLE_EQ(callbackValue, 99.9);
 }
+
+TEST(VariableDatabaseTest, TagIdResolution) {
+    VariableDatabase db;
+    
+    // Дескриптор стабилен и совпадает при повторном разрешении
+    TagId tag = db.resolveTag("tag_var");
+    EXPECT_NE(tag, INVALID_TAG);
+    EXPECT_EQ(db.resolveTag("tag_var"), tag);
+    EXPECT_EQ(db.findTag("tag_var"), tag);
+    EXPECT_EQ(db.getTagName(tag), "tag_var");
+    EXPECT_EQ(db.findTag("unknown_var"), INVALID_TAG);
+    
+    // Регистрация дескриптора еще не создает значение
+    EXPECT_FALSE(db.variableExists("tag_var"));
+}
+
+TEST(VariableDatabaseTest, TagIdAndStringApiShareStorage) {
+    VariableDatabase db;
+    TagId tag = historyTag(db, "shared_var");
+    double callbackValue = 0.0;
+    db.subscribe(tag, [&callbackValue](double value) {
+        callbackValue = value;
+    });
+    
+    db.set(tag, 12.5);
+    EXPECT_DOUBLE_EQ(db.getVariable("shared_var"), 12.5);
+    EXPECT_DOUBLE_EQ(callbackValue, 12.5);
+    
+    db.setVariable("shared_var", 7.0);
+    EXPECT_DOUBLE_EQ(db.get(tag), 7.0);
+    EXPECT_DOUBLE_EQ(callbackValue, 7.0);
+    EXPECT_EQ(db.getHistory(tag).size(), 2u);
+    EXPECT_DOUBLE_EQ(db.get(INVALID_TAG), 0.0);
+}
+
+TEST(VariableDatabaseTest, UnsubscribeRemovesOnlyOwnerCallbacks) {
+    VariableDatabase db;
+    TagId tag = db.resolveTag("owned_var");
+    int ownerA = 0, ownerB = 0;
+    int callsA = 0, callsB = 0, callsAnonymous = 0;
+    db.subscribe(tag, [&callsA](double) { ++callsA; }, &ownerA);
+    db.subscribe(tag, [&callsB](double) { ++callsB; }, &ownerB);
+    db.subscribe(tag, [&callsAnonymous](double) { ++callsAnonymous; });
+
+    // Удаленный объект больше не вызывается, остальные подписчики остаются
+    db.unsubscribe(tag, &ownerA);
+    db.unsubscribe(tag, nullptr);
+    db.set(tag, 1.0);
+    EXPECT_EQ(callsA, 0);
+    EXPECT_EQ(callsB, 1);
+    EXPECT_EQ(callsAnonymous, 1);
+}
+
+TEST(VariableDatabaseTest, HistoryRingBufferKeepsNewestValues) {
+    HistoryBuffer buffer(4);
+    for (int i = 1; i <= 6; ++i) {
+        buffer.push(i);
+    }
+    
+    // После переполнения остаются 4 последних значения в порядке от старых к новым
+    HistoryView view = buffer.view();
+    ASSERT_EQ(view.size(), 4u);
+    EXPECT_DOUBLE_EQ(view[0], 3.0);
+    EXPECT_DOUBLE_EQ(view[3], 6.0);
+    EXPECT_EQ(view.firstSize + view.secondSize, 4u);
+    
+    HistoryView tail = view.last(2);
+    ASSERT_EQ(tail.size(), 2u);
+    EXPECT_DOUBLE_EQ(tail.front(), 5.0);
+    EXPECT_DOUBLE_EQ(tail.back(), 6.0);
+    
+    // Увеличение емкости сохраняет порядок значений
+    buffer.setCapacity(8);
+    buffer.push(7);
+    view = buffer.view();
+    ASSERT_EQ(view.size(), 5u);
+    EXPECT_DOUBLE_EQ(view.front(), 3.0);
+    EXPECT_DOUBLE_EQ(view.back(), 7.0);
+}
+
+TEST(VariableDatabaseTest, HistoryCapacityUsesLargestRequest) {
+    VariableDatabase db;
+    TagId tag = db.resolveTag("trend_var");
+    EXPECT_EQ(db.getHistoryCapacity(tag), DEFAULT_HISTORY_CAPACITY);
+    
+    db.requestHistoryCapacity(tag, 500);
+    db.requestHistoryCapacity(tag, 50);
+    EXPECT_EQ(db.getHistoryCapacity(tag), 500u);
+    
+    for (int i = 0; i < 1000; ++i) {
+        db.set(tag, i);
+    }
+    HistoryView history = db.getHistory(tag);
+    EXPECT_EQ(history.size(), 500u);
+    EXPECT_DOUBLE_EQ(history.back(), 999.0);
+}
+
+TEST(VariableDatabaseTest, DeferredModeCoalescesWrites) {
+    VariableDatabase db;
+    db.setNotifyMode(NotifyMode::Deferred);
+    TagId tag = db.resolveTag("dirty_var");
+    int calls = 0;
+    double lastValue = 0.0;
+    db.subscribe(tag, [&](double value) {
+        ++calls;
+        lastValue = value;
+    });
+    
+    // 50 записей между кадрами - одно уведомление с последним значением
+    for (int i = 1; i <= 50; ++i) {
+        db.set(tag, i);
+    }
+    EXPECT_DOUBLE_EQ(db.get(tag), 50.0);
+    EXPECT_EQ(calls, 0);
+    
+    EXPECT_EQ(db.dispatchPending(), 1u);
+    EXPECT_EQ(calls, 1);
+    EXPECT_DOUBLE_EQ(lastValue, 50.0);
+    
+    // Без изменений кадр ничего не доставляет
+    EXPECT_EQ(db.dispatchPending(), 0u);
+    EXPECT_EQ(calls, 1);
+}
+
+TEST(VariableDatabaseTest, RevisionTracksVisibleChanges) {
+    VariableDatabase db;
+    TagId tag = db.resolveTag("revision_value");
+    std::uint64_t start = db.getRevision();
+
+    // Отложенная запись видна на экране только после доставки
+    db.setNotifyMode(NotifyMode::Deferred);
+    db.set(tag, 1.0);
+    EXPECT_EQ(db.getRevision(), start);
+
+    db.dispatchPending();
+    EXPECT_GT(db.getRevision(), start);
+
+    std::uint64_t afterDispatch = db.getRevision();
+    db.addToHistory(tag, 2.0);
+    EXPECT_GT(db.getRevision(), afterDispatch);
+}
\ No newline at end of file
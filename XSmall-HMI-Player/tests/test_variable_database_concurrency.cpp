@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+#include "VariableDatabase.h"
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <vector>
+#include <string>
+
+// Стресс-тест: несколько потоков сбора данных пишут через post(),
+// а "цикл отрисовки" с частотой 60 Гц читает значения и доставляет уведомления
+TEST(VariableDatabaseConcurrencyTest, WritersAndRenderLoop) {
+    VariableDatabase db;
+    
+    const int writerCount = 4;
+    const int tagsPerWriter = 16;
+    const int writesPerTag = 20000;
+    
+    // Часть переменных регистрирует UI-поток, часть - сами писатели
+    std::vector<std::vector<TagId>> writerTags(writerCount);
+    for (int w = 0; w < writerCount; ++w) {
+        for (int t = 0; t < tagsPerWriter / 2; ++t) {
+            writerTags[w].push_back(db.resolveTag("w" + std::to_string(w) + "_t" + std::to_string(t)));
+        }
+    }
+    
+    // Последнее доставленное значение каждой переменной (только UI-поток)
+    std::vector<double> lastDelivered(writerCount * tagsPerWriter, -1.0);
+    std::vector<TagId> subscribedTags;
+    bool monotonic = true;
+    const std::thread::id uiThread = std::this_thread::get_id();
+    std::atomic<bool> wrongThread(false);
+    
+    auto subscribeTag = [&](TagId tag, int index) {
+        db.subscribe(tag, [&, index](double value) {
+            if (std::this_thread::get_id() != uiThread) wrongThread = true;
+            if (value < lastDelivered[index]) monotonic = false;
+            lastDelivered[index] = value;
+        });
+    };
+    for (int w = 0; w < writerCount; ++w) {
+        for (int t = 0; t < tagsPerWriter / 2; ++t) {
+            subscribeTag(writerTags[w][t], w * tagsPerWriter + t);
+        }
+    }
+    
+    std::atomic<int> finishedWriters(0);
+    std::vector<std::thread> writers;
+    for (int w = 0; w < writerCount; ++w) {
+        writers.emplace_back([&, w]() {
+            std::vector<TagId> tags = writerTags[w];
+            for (int t = tagsPerWriter / 2; t < tagsPerWriter; ++t) {
+                tags.push_back(db.resolveTag("w" + std::to_string(w) + "_t" + std::to_string(t)));
+            }
+            for (int i = 1; i <= writesPerTag; ++i) {
+                for (TagId tag : tags) {
+                    db.post(tag, static_cast<double>(i));
+                }
+            }
+            ++finishedWriters;
+        });
+    }
+    
+    // Цикл отрисовки: раз в кадр читаем значения и доставляем изменения
+    int frames = 0;
+    std::vector<double> lastRead(writerCount * (tagsPerWriter / 2), 0.0);
+    bool readsMonotonic = true;
+    while (finishedWriters.load() < writerCount || frames < 5) {
+        db.dispatchPending();
+        for (int w = 0; w < writerCount; ++w) {
+            for (int t = 0; t < tagsPerWriter / 2; ++t) {
+                double value = db.get(writerTags[w][t]);
+                int index = w * (tagsPerWriter / 2) + t;
+                if (value < lastRead[index]) readsMonotonic = false;
+                lastRead[index] = value;
+            }
+        }
+        ++frames;
+        std::this_thread::sleep_for(std::chrono::milliseconds(16));
+    }
+    
+    for (auto& writer : writers) {
+        writer.join();
+    }
+    db.dispatchPending();
+    
+    EXPECT_FALSE(wrongThread.load()) << "Callbacks must run on the UI thread";
+    EXPECT_TRUE(monotonic) << "Delivered values must not go back in time";
+    EXPECT_TRUE(readsMonotonic) << "Lock-free reads must not go back in time";
+    
+    // После последней доставки все подписчики видят финальное значение
+    for (int w = 0; w < writerCount; ++w) {
+        for (int t = 0; t < tagsPerWriter; ++t) {
+            TagId tag = db.findTag("w" + std::to_string(w) + "_t" + std::to_string(t));
+            ASSERT_NE(tag, INVALID_TAG);
+            EXPECT_DOUBLE_EQ(db.get(tag), static_cast<double>(writesPerTag));
+            if (t < tagsPerWriter / 2) {
+                EXPECT_DOUBLE_EQ(lastDelivered[w * tagsPerWriter + t], static_cast<double>(writesPerTag));
+            }
+        }
+    }
+    EXPECT_EQ(db.dispatchPending(), 0u);
+}
+
+TEST(VariableDatabaseConcurrencyTest, PostCoalescesNotifications) {
+    VariableDatabase db;
+    TagId tag = db.resolveTag("coalesced_var");
+    int calls = 0;
+    double lastValue = 0.0;
+    db.subscribe(tag, [&](double value) {
+        ++calls;
+        lastValue = value;
+    });
+    
+    // Значение видно сразу, а уведомление одно - с последним значением
+    for (int i = 1; i <= 50; ++i) {
+        db.post(tag, i);
+    }
+    EXPECT_DOUBLE_EQ(db.get(tag), 50.0);
+    EXPECT_EQ(calls, 0);
+    
+    EXPECT_EQ(db.dispatchPending(), 1u);
+    EXPECT_EQ(calls, 1);
+    EXPECT_DOUBLE_EQ(lastValue, 50.0);
+    EXPECT_EQ(db.dispatchPending(), 0u);
+}
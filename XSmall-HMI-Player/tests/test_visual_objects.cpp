@@ -7,6 +7,10 @@
 #include "Rectangle.h"
 #include "Text.h"
 #include "SceneFactory.h"
+#include "HistoryGraph.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
 
 class VisualObjectsTest : public ::testing::Test {
 protected:
@@ -91,3 +95,119 @@ TEST_F(VisualObjectsTest, XmlLoaderCreatesObjects) {
     EXPECT_TRUE(hasText);
     EXPECT_TRUE(hasButton);
 }
+
+TEST_F(VisualObjectsTest, HistoryGraphTracksSlidingWindow) {
+    const size_t window = 20;
+    HistoryGraph graph(10.0f, 20.0f, 400.0f, 200.0f, "TestGraph", &db, "graph_history", window);
+    TagId tag = db.resolveTag("graph_history");
+
+    // Кривая, построенная с нуля по последним значениям истории
+    auto reference = [&]() {
+        HistoryView history = db.getHistory(tag).last(window);
+        std::vector<sf::Vector2f> points;
+        if (history.size() < 2) {
+            return points;  // Линию из одной точки график не рисует
+        }
+        double maxVal = *std::max_element(history.begin(), history.end());
+        double minVal = *std::min_element(history.begin(), history.end());
+        double range = maxVal - minVal;
+        if (range == 0) range = 1;
+        float xStep = 400.0f / (history.size() - 1);
+        for (size_t i = 0; i < history.size(); ++i) {
+            points.push_back(sf::Vector2f(10.0f + i * xStep,
+                                          static_cast<float>(20.0 + 200.0 - (history[i] - minVal) / range * 200.0)));
+        }
+        return points;
+    };
+
+    // Добавляем значения порциями разного размера (в т.ч. больше окна) и сверяем после каждой
+    int step = 0;
+    for (int chunk : {1, 1, 3, 7, 1, 25, 2, 1, 40, 5, 1, 1}) {
+        for (int i = 0; i < chunk; ++i, ++step) {
+            db.addToHistory(tag, std::sin(step * 0.3) * 50.0 + (step % 7));
+        }
+
+        std::vector<sf::Vector2f> expected = reference();
+        std::vector<sf::Vector2f> actual = graph.getCurvePoints();
+        ASSERT_EQ(actual.size(), expected.size());
+        for (size_t i = 0; i < expected.size(); ++i) {
+            EXPECT_NEAR(actual[i].x, expected[i].x, 1e-3);
+            EXPECT_NEAR(actual[i].y, expected[i].y, 1e-3);
+        }
+    }
+}
+
+// Программная растеризация ломаной (без окна и OpenGL): для каждого столбца пикселей -
+// самая верхняя и самая нижняя закрашенная строка
+static std::vector<std::pair<int, int>> rasterizeColumns(const std::vector<sf::Vector2f>& points,
+                                                         const sf::FloatRect& area) {
+    int columns = static_cast<int>(area.width) + 1;
+    std::vector<std::pair<int, int>> extents(columns, std::make_pair(INT32_MAX, INT32_MIN));
+    auto mark = [&](float px, float py) {
+        int column = std::min(std::max(static_cast<int>(std::floor(px - area.left)), 0), columns - 1);
+        int row = static_cast<int>(std::floor(py - area.top));
+        extents[column].first = std::min(extents[column].first, row);
+        extents[column].second = std::max(extents[column].second, row);
+    };
+    for (size_t i = 1; i < points.size(); ++i) {
+        sf::Vector2f a = points[i - 1], b = points[i];
+        int steps = static_cast<int>(std::ceil(std::max(std::fabs(b.x - a.x), std::fabs(b.y - a.y)) * 4)) + 1;
+        for (int s = 0; s <= steps; ++s) {
+            float t = static_cast<float>(s) / steps;
+            mark(a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t);
+        }
+    }
+    return extents;
+}
+
+TEST_F(VisualObjectsTest, HistoryGraphDecimationMatchesFullRendering) {
+    const size_t window = 1000000;
+    const sf::FloatRect area(10.0f, 20.0f, 400.0f, 200.0f);
+    HistoryGraph graph(area.left, area.top, area.width, area.height, "BigGraph", &db, "big_history", window);
+    HistoryGraph smallGraph(area.left, area.top, area.width, area.height, "SmallGraph", &db, "small_history", 1600);
+    TagId tag = db.resolveTag("big_history");
+    TagId smallTag = db.resolveTag("small_history");
+
+    // Та же кривая без прореживания - по вершине на значение
+    auto fullRendering = [&]() {
+        HistoryView history = db.getHistory(tag).last(window);
+        double maxVal = *std::max_element(history.begin(), history.end());
+        double minVal = *std::min_element(history.begin(), history.end());
+        double range = maxVal - minVal;
+        if (range == 0) range = 1;
+        std::vector<sf::Vector2f> points;
+        points.reserve(history.size());
+        float xStep = area.width / (history.size() - 1);
+        for (size_t i = 0; i < history.size(); ++i) {
+            points.push_back(sf::Vector2f(area.left + i * xStep,
+                                          static_cast<float>(area.top + area.height - (history[i] - minVal) / range * area.height)));
+        }
+        return points;
+    };
+
+    // Случайное блуждание с редкими выбросами: выбросы должны остаться на экране
+    std::mt19937 random(42);
+    std::uniform_real_distribution<double> walk(-1.0, 1.0);
+    double value = 0;
+    int step = 0;
+    for (int chunk : {300000, 700000, 123457, 1, 250000}) {
+        for (int i = 0; i < chunk; ++i, ++step) {
+            value += walk(random);
+            db.addToHistory(tag, step % 99991 == 0 ? value + 400.0 : value);
+            db.addToHistory(smallTag, value);
+        }
+
+        // Не больше ~4 вершин на пиксель ширины независимо от длины истории
+        std::size_t vertexCount = graph.getCurveVertexCount();
+        EXPECT_LE(vertexCount, 4 * (static_cast<size_t>(area.width) + 2));
+        EXPECT_LE(vertexCount, 4 * (smallGraph.getCurveVertexCount() + 2));
+
+        auto expected = rasterizeColumns(fullRendering(), area);
+        auto actual = rasterizeColumns(graph.getCurvePoints(), area);
+        ASSERT_EQ(actual.size(), expected.size());
+        for (size_t column = 0; column < expected.size(); ++column) {
+            EXPECT_EQ(actual[column].first, expected[column].first) << "column " << column;
+            EXPECT_EQ(actual[column].second, expected[column].second) << "column " << column;
+        }
+    }
+}
@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+#include <SFML/Graphics.hpp>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+
+#include "VariableDatabase.h"
+#include "WidgetRegistry.h"
+#include "JsonScanner.h"
+#include "ThreadPool.h"
+#include "JSONLoader.h"
+#include "Rectangle.h"
+
+using json = nlohmann::json;
+
+namespace {
+
+JsonSlice slice(const std::string& text) {
+    return JsonSlice{text.data(), text.size()};
+}
+
+} // namespace
+
+TEST(JsonScannerTest, SplitsMembersAndElements) {
+    // Скобки и экранированные кавычки внутри строк не влияют на границы
+    std::string text = "\xEF\xBB\xBF { \"a\" : 1, \"b\\\"q\": \"x]}\\\"\", "
+                       "\"objects\": [ {\"n\": [1, {\"m\": \"[\"}]}, true , -2.5e3 ] }\n";
+    std::vector<JsonScanner::Member> members;
+    ASSERT_TRUE(JsonScanner::scanObject(slice(text), members));
+    ASSERT_EQ(members.size(), 3u);
+    EXPECT_EQ(members[0].key, "a");
+    EXPECT_EQ(members[0].value.str(), "1");
+    EXPECT_EQ(members[1].key, "b\"q");
+    EXPECT_EQ(members[1].value.str(), "\"x]}\\\"\"");
+
+    std::vector<JsonSlice> elements;
+    ASSERT_TRUE(JsonScanner::scanArray(members[2].value, elements));
+    ASSERT_EQ(elements.size(), 3u);
+    EXPECT_EQ(elements[0].str(), "{\"n\": [1, {\"m\": \"[\"}]}");
+    EXPECT_EQ(elements[1].str(), "true");
+    EXPECT_EQ(elements[2].str(), "-2.5e3");
+
+    std::vector<JsonSlice> empty;
+    EXPECT_TRUE(JsonScanner::scanArray(slice(" [ ] "), empty));
+    EXPECT_TRUE(empty.empty());
+}
+
+TEST(JsonScannerTest, RejectsBrokenStructure) {
+    std::vector<JsonScanner::Member> members;
+    EXPECT_FALSE(JsonScanner::scanObject(slice("{\"a\": [1, 2}"), members));
+    EXPECT_FALSE(JsonScanner::scanObject(slice("{\"a\": \"open}"), members));
+    EXPECT_FALSE(JsonScanner::scanObject(slice("{\"a\": 1 \"b\": 2}"), members));
+    EXPECT_FALSE(JsonScanner::scanObject(slice("{\"a\": 1} x"), members));
+    EXPECT_FALSE(JsonScanner::scanObject(slice("[1]"), members));
+
+    std::vector<JsonSlice> elements;
+    EXPECT_FALSE(JsonScanner::scanArray(slice("[1, , 2]"), elements));
+    EXPECT_FALSE(JsonScanner::scanArray(slice("[{}"), elements));
+}
+
+TEST(ThreadPoolTest, VisitsEveryIndexOnce) {
+    ThreadPool pool(3);
+    std::vector<std::atomic<int>> visits(10000);
+    pool.parallelFor(visits.size(), [&visits](std::size_t i) { ++visits[i]; });
+    pool.parallelFor(visits.size(), [&visits](std::size_t i) { ++visits[i]; });
+
+    for (const auto& count : visits) {
+        ASSERT_EQ(count.load(), 2);
+    }
+}
+
+class WidgetLoadTest : public ::testing::Test {
+protected:
+    const std::string jsonFile = "test_widget_load.json";
+    const std::string sceneFile = "test_widget_load.hmiscene";
+
+    void TearDown() override {
+        std::filesystem::remove(jsonFile);
+        std::filesystem::remove(sceneFile);
+    }
+
+    void write(const json& scene) {
+        std::ofstream(jsonFile) << scene.dump();
+    }
+};
+
+TEST_F(WidgetLoadTest, KeepsFileOrderAndSkipsUnknownTypes) {
+    json scene = {{"historyCapacity", 250}, {"objects", json::array()}};
+    for (int i = 0; i < 3000; ++i) {
+        json obj = {{"name", std::to_string(i)}, {"x", i}, {"y", 0}};
+        obj["type"] = i % 2 ? "Line" : "Rectangle";
+        obj["variable"] = i % 2 ? "" : "load_tag";
+        scene["objects"].push_back(obj);
+    }
+    scene["objects"].push_back({{"type", "NoSuchWidget"}, {"name", "unknown"}});
+    write(scene);
+
+    VariableDatabase db;
+    auto objects = JSONLoader::loadFromFile(jsonFile, &db, nullptr);
+
+    ASSERT_EQ(objects.size(), 3000u);
+    for (std::size_t i = 0; i < objects.size(); ++i) {
+        ASSERT_EQ(objects[i]->getName(), std::to_string(i));
+    }
+    EXPECT_GE(db.getHistoryCapacity(db.findTag("load_tag")), 250u);
+}
+
+TEST_F(WidgetLoadTest, RejectsMalformedObject) {
+    std::ofstream(jsonFile) << "{\"objects\": [{\"type\": \"Line\"}, {\"type\": \"Line\", \"x\": }]}";
+
+    VariableDatabase db;
+    EXPECT_TRUE(JSONLoader::loadFromFile(jsonFile, &db, nullptr).empty());
+    EXPECT_FALSE(JSONLoader::compileScene(jsonFile, sceneFile));
+}
+
+TEST_F(WidgetLoadTest, RegisteredTypeLoadsWithoutLoaderChanges) {
+    // Новый тип добавляется из своего модуля: загрузчик о нем не знает
+    WidgetTypeId id = WidgetRegistry::instance().add("TestIndicator",
+        [](const json& objJson, VariableDatabase* db, sf::Font*) -> std::unique_ptr<VisualObject> {
+            return std::make_unique<Rectangle>(objJson.value("x", 0.0f), objJson.value("y", 0.0f), 12, 12,
+                                               sf::Color::Green, objJson.value("name", ""), db);
+        });
+    ASSERT_NE(id, INVALID_WIDGET_TYPE);
+    EXPECT_EQ(WidgetRegistry::instance().find("TestIndicator"), id);
+    EXPECT_EQ(WidgetRegistry::instance().getTypeName(id), "TestIndicator");
+
+    write({{"objects", {{{"type", "TestIndicator"}, {"name", "Lamp"}, {"x", 5}, {"y", 7}},
+                        {{"type", "Line"}, {"name", "Wire"}}}}});
+
+    VariableDatabase db;
+    auto objects = JSONLoader::loadFromFile(jsonFile, &db, nullptr);
+    ASSERT_EQ(objects.size(), 2u);
+    EXPECT_EQ(objects[0]->getName(), "Lamp");
+    EXPECT_FLOAT_EQ(objects[0]->getBounds().width, 12);
+    EXPECT_FLOAT_EQ(objects[0]->getBounds().left, 5);
+
+    // У нового типа нет бинарной записи: сцена не компилируется и читается из JSON
+    EXPECT_FALSE(JSONLoader::compileScene(jsonFile, sceneFile));
+    EXPECT_FALSE(std::filesystem::exists(sceneFile));
+}
@@ -0,0 +1,158 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <map>
+
+#include "VariableDatabase.h"
+#include "StateManager.h"
+#include "WriteAheadLog.h"
+
+class WriteAheadLogTest : public ::testing::Test {
+protected:
+    const std::string basePath = "test_journal.wal";
+    const std::string stateFile = "test_journal_state.json";
+
+    void TearDown() override {
+        removeSegments("test_journal.wal.");
+        removeSegments("test_journal_state.wal.");
+        std::filesystem::remove(stateFile);
+    }
+
+    static void removeSegments(const std::string& prefix) {
+        for (const auto& entry : std::filesystem::directory_iterator(".")) {
+            if (entry.path().filename().string().rfind(prefix, 0) == 0) {
+                std::filesystem::remove(entry.path());
+            }
+        }
+    }
+
+    std::map<std::string, double> replay(std::uint64_t afterSequence, std::size_t* applied = nullptr) {
+        std::map<std::string, double> values;
+        WriteAheadLog log(basePath);
+        std::size_t count = log.recover(afterSequence, [&values](const std::string& name, double value) {
+            values[name] = value;
+        });
+        if (applied) {
+            *applied = count;
+        }
+        return values;
+    }
+};
+
+TEST_F(WriteAheadLogTest, ReplaysRecordsAfterSequence) {
+    {
+        WriteAheadLog log(basePath);
+        EXPECT_EQ(log.append("wal_a", 1.0), 1u);
+        EXPECT_EQ(log.append("wal_b", 2.0), 2u);
+        EXPECT_EQ(log.append("wal_a", 3.0), 3u);
+        log.flush();
+        EXPECT_GE(log.getCommitCount(), 1u);
+    }
+
+    std::size_t applied = 0;
+    auto values = replay(0, &applied);
+    EXPECT_EQ(applied, 3u);
+    EXPECT_DOUBLE_EQ(values["wal_a"], 3.0);
+    EXPECT_DOUBLE_EQ(values["wal_b"], 2.0);
+
+    values = replay(2, &applied);
+    EXPECT_EQ(applied, 1u);
+    EXPECT_EQ(values.count("wal_b"), 0u);
+
+    // Номера продолжаются после перезапуска
+    WriteAheadLog log(basePath);
+    log.recover(0, nullptr);
+    EXPECT_EQ(log.append("wal_c", 4.0), 4u);
+}
+
+TEST_F(WriteAheadLogTest, DropsTornAndCorruptedTail) {
+    {
+        WriteAheadLog log(basePath);
+        log.append("wal_a", 1.0);
+        log.append("wal_b", 2.0);
+        log.flush();
+    }
+    std::string segment = basePath + ".1";
+    ASSERT_TRUE(std::filesystem::exists(segment));
+    auto size = std::filesystem::file_size(segment);
+
+    // Запись, оборванная на середине
+    std::filesystem::resize_file(segment, size - 3);
+    std::size_t applied = 0;
+    auto values = replay(0, &applied);
+    EXPECT_EQ(applied, 1u);
+    EXPECT_DOUBLE_EQ(values["wal_a"], 1.0);
+    EXPECT_EQ(values.count("wal_b"), 0u);
+
+    // Поврежденное значение не проходит проверку crc
+    removeSegments("test_journal.wal.");
+    {
+        WriteAheadLog log(basePath);
+        log.append("wal_a", 1.0);
+        log.flush();
+    }
+    {
+        std::fstream file(segment, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(-8, std::ios::end);  // Байт значения
+        file.put('X');
+    }
+    values = replay(0, &applied);
+    EXPECT_EQ(applied, 0u);
+}
+
+TEST_F(WriteAheadLogTest, OperatorWritesSurviveCrashBetweenSnapshots) {
+    {
+        VariableDatabase db;
+        StateManager manager(stateFile);
+        manager.enableJournal(db);
+        manager.loadState(db);
+
+        TagId setpoint = db.resolveTag("wal_setpoint");
+        TagId sensor = db.resolveTag("wal_sensor");
+        db.set(setpoint, 10.0, WriteSource::Operator);
+        manager.saveState(db);
+        manager.flush();
+
+        // После снимка: запись оператора журналируется, значение процесса - нет
+        db.set(setpoint, 42.0, WriteSource::Operator);
+        db.set(sensor, 7.0);
+        manager.getJournal()->flush();
+        // Сбой: следующего снимка нет
+    }
+
+    VariableDatabase restored;
+    StateManager manager(stateFile);
+    manager.enableJournal(restored);
+    ASSERT_TRUE(manager.loadState(restored));
+    EXPECT_DOUBLE_EQ(restored.getVariable("wal_setpoint"), 42.0);
+    EXPECT_FALSE(restored.variableExists("wal_sensor"));
+}
+
+TEST_F(WriteAheadLogTest, SnapshotRemovesCoveredSegments) {
+    VariableDatabase db;
+    StateManager manager(stateFile);
+    manager.enableJournal(db);
+    manager.loadState(db);
+
+    TagId tag = db.resolveTag("wal_value");
+    for (int i = 0; i < 3; ++i) {
+        db.set(tag, i, WriteSource::Operator);
+        manager.saveState(db);
+        manager.flush();
+    }
+    db.set(tag, 100.0, WriteSource::Operator);
+    manager.flush();
+
+    // Остался только сегмент с записью после последнего снимка
+    std::size_t segments = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(".")) {
+        segments += entry.path().filename().string().rfind("test_journal_state.wal.", 0) == 0;
+    }
+    EXPECT_EQ(segments, 1u);
+
+    VariableDatabase restored;
+    StateManager reloaded(stateFile);
+    reloaded.enableJournal(restored);
+    ASSERT_TRUE(reloaded.loadState(restored));
+    EXPECT_DOUBLE_EQ(restored.getVariable("wal_value"), 100.0);
+}